@@ -2,6 +2,7 @@
 #include "core_types.h"
 #include <functional>
 #include <memory>
+#include <string_view>
 
 namespace Audio
 {
@@ -21,6 +22,7 @@ namespace Audio
 	};
 
 	using BackendRenderCallback = std::function<void(i16* outputBuffer, const u32 bufferFrameCount, const u32 bufferChannelCount)>;
+	using BackendBufferSink = std::function<void(const i16* renderedBuffer, const u32 bufferFrameCount, const u32 bufferChannelCount)>;
 
 	struct IAudioBackend
 	{
@@ -45,4 +47,58 @@ namespace Audio
 		struct Impl;
 		std::unique_ptr<Impl> impl;
 	};
+
+	enum class NullBackendClock : u8
+	{
+		// NOTE: Paced by a render thread to the stream sample rate, same as an actual device would
+		RealTime,
+		// NOTE: Render thread calling back again as soon as the previous buffer is done
+		FastAsPossible,
+		// NOTE: No render thread at all, buffers are only rendered by explicitly calling RenderFrames() on the calling thread
+		Manual,
+		Count
+	};
+
+	// NOTE: Drives the render callback without any audio device, so that the engine can also run headless.
+	//		 Every rendered buffer is optionally handed to a sink (still on the render thread) instead of being played back
+	class NullBackend : public IAudioBackend
+	{
+	public:
+		NullBackend(NullBackendClock clock = NullBackendClock::RealTime, BackendBufferSink sink = nullptr);
+		~NullBackend();
+
+	public:
+		b8 OpenStartStream(const BackendStreamParam& param, BackendRenderCallback callback) override;
+		b8 StopCloseStream() override;
+		b8 IsOpenRunning() const override;
+
+		// NOTE: Only for NullBackendClock::Manual, renders (at least) the requested number of frames in buffers of the stream DesiredFrameCount
+		i64 RenderFrames(i64 frameCount);
+		i64 GetRenderedFrameCount() const;
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl;
+	};
+
+	// NOTE: NullBackend writing everything rendered between opening and closing the stream into a 16-bit PCM WAV file, streamed to disk buffer by buffer
+	class FileSinkBackend : public IAudioBackend
+	{
+	public:
+		FileSinkBackend(std::string_view wavFilePath, NullBackendClock clock = NullBackendClock::FastAsPossible);
+		~FileSinkBackend();
+
+	public:
+		b8 OpenStartStream(const BackendStreamParam& param, BackendRenderCallback callback) override;
+		b8 StopCloseStream() override;
+		b8 IsOpenRunning() const override;
+
+		i64 RenderFrames(i64 frameCount);
+		i64 GetRenderedFrameCount() const;
+		b8 GetLastFileWriteSucceeded() const;
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl;
+	};
 }
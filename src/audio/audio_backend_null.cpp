@@ -0,0 +1,192 @@
+#include "audio_backend.h"
+#include "audio_common.h"
+#include "audio_file_formats.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace Audio
+{
+	struct NullBackend::Impl
+	{
+	public:
+		b8 OpenStartStream(const BackendStreamParam& param, BackendRenderCallback callback)
+		{
+			if (isOpenRunning)
+				return false;
+
+			streamParam = param;
+			if (streamParam.DesiredFrameCount == 0)
+				streamParam.DesiredFrameCount = DefaultBufferFrameCount;
+			if (streamParam.SampleRate == 0 || streamParam.ChannelCount == 0)
+				return false;
+
+			renderCallback = std::move(callback);
+			outputBuffer = std::make_unique<i16[]>(static_cast<size_t>(streamParam.DesiredFrameCount) * streamParam.ChannelCount);
+			renderedFrameCount = 0;
+
+			isOpenRunning = true;
+			if (clock != NullBackendClock::Manual)
+				renderThread = std::thread([this] { RenderThreadEntryPoint(); });
+
+			return true;
+		}
+
+		b8 StopCloseStream()
+		{
+			if (!isOpenRunning)
+				return false;
+
+			renderThreadStopRequested = true;
+			if (renderThread.joinable())
+				renderThread.join();
+			renderThreadStopRequested = false;
+
+			isOpenRunning = false;
+			return true;
+		}
+
+		b8 IsOpenRunning() const
+		{
+			return isOpenRunning;
+		}
+
+		i64 RenderFrames(i64 frameCount)
+		{
+			assert(clock == NullBackendClock::Manual);
+			if (!isOpenRunning || clock != NullBackendClock::Manual)
+				return 0;
+
+			i64 framesRendered = 0;
+			while (framesRendered < frameCount)
+			{
+				RenderBuffer();
+				framesRendered += streamParam.DesiredFrameCount;
+			}
+			return framesRendered;
+		}
+
+		i64 GetRenderedFrameCount() const
+		{
+			return renderedFrameCount;
+		}
+
+	private:
+		void RenderThreadEntryPoint()
+		{
+			const auto bufferDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<f64>(static_cast<f64>(streamParam.DesiredFrameCount) / static_cast<f64>(streamParam.SampleRate)));
+
+			// NOTE: Sleeping until an absolute deadline instead of for a relative duration so that the render time itself doesn't make the clock drift
+			auto nextBufferDeadline = std::chrono::steady_clock::now();
+			while (!renderThreadStopRequested)
+			{
+				RenderBuffer();
+
+				if (clock == NullBackendClock::RealTime)
+				{
+					nextBufferDeadline += bufferDuration;
+					std::this_thread::sleep_until(nextBufferDeadline);
+				}
+			}
+		}
+
+		void RenderBuffer()
+		{
+			const u32 frameCount = streamParam.DesiredFrameCount, channelCount = streamParam.ChannelCount;
+			if (renderCallback)
+				renderCallback(outputBuffer.get(), frameCount, channelCount);
+			else
+				::memset(outputBuffer.get(), 0, static_cast<size_t>(frameCount) * channelCount * sizeof(i16));
+
+			if (sink)
+				sink(outputBuffer.get(), frameCount, channelCount);
+
+			renderedFrameCount += frameCount;
+		}
+
+	public:
+		static constexpr u32 DefaultBufferFrameCount = 512;
+
+		NullBackendClock clock = NullBackendClock::RealTime;
+		BackendBufferSink sink = nullptr;
+
+	private:
+		std::atomic<b8> isOpenRunning = false;
+		std::atomic<b8> renderThreadStopRequested = false;
+		std::atomic<i64> renderedFrameCount = 0;
+
+		BackendStreamParam streamParam = {};
+		BackendRenderCallback renderCallback = nullptr;
+		std::unique_ptr<i16[]> outputBuffer = nullptr;
+		std::thread renderThread = {};
+	};
+
+	NullBackend::NullBackend(NullBackendClock clock, BackendBufferSink sink) : impl(std::make_unique<Impl>()) { impl->clock = clock; impl->sink = std::move(sink); }
+	NullBackend::~NullBackend() { impl->StopCloseStream(); }
+	b8 NullBackend::OpenStartStream(const BackendStreamParam& param, BackendRenderCallback callback) { return impl->OpenStartStream(param, std::move(callback)); }
+	b8 NullBackend::StopCloseStream() { return impl->StopCloseStream(); }
+	b8 NullBackend::IsOpenRunning() const { return impl->IsOpenRunning(); }
+	i64 NullBackend::RenderFrames(i64 frameCount) { return impl->RenderFrames(frameCount); }
+	i64 NullBackend::GetRenderedFrameCount() const { return impl->GetRenderedFrameCount(); }
+}
+
+namespace Audio
+{
+	struct FileSinkBackend::Impl
+	{
+		Impl(std::string_view wavFilePath, NullBackendClock clock) : WavFilePath(wavFilePath), Backend(clock, [this](const i16* renderedBuffer, const u32 bufferFrameCount, const u32 bufferChannelCount)
+		{
+			if (!WavWriter.WriteFrames(renderedBuffer, bufferFrameCount))
+				AllFramesWritten = false;
+		})
+		{
+		}
+
+		std::string WavFilePath;
+		WAVFileWriter WavWriter;
+		// NOTE: Only written to by the render thread while the stream is open
+		b8 AllFramesWritten = false;
+		b8 LastFileWriteSucceeded = false;
+		NullBackend Backend;
+	};
+
+	FileSinkBackend::FileSinkBackend(std::string_view wavFilePath, NullBackendClock clock) : impl(std::make_unique<Impl>(wavFilePath, clock)) {}
+	FileSinkBackend::~FileSinkBackend() { StopCloseStream(); }
+
+	b8 FileSinkBackend::OpenStartStream(const BackendStreamParam& param, BackendRenderCallback callback)
+	{
+		if (impl->Backend.IsOpenRunning())
+			return false;
+
+		impl->LastFileWriteSucceeded = false;
+		if (!impl->WavWriter.Open(impl->WavFilePath, param.ChannelCount, param.SampleRate))
+			return false;
+
+		impl->AllFramesWritten = true;
+		if (!impl->Backend.OpenStartStream(param, std::move(callback)))
+		{
+			impl->WavWriter.Close();
+			return false;
+		}
+		return true;
+	}
+
+	b8 FileSinkBackend::StopCloseStream()
+	{
+		if (!impl->Backend.StopCloseStream())
+			return false;
+
+		// NOTE: With the render thread (if any) joined nothing is being written anymore, leaving only the header to be finalized
+		const b8 closeSucceeded = impl->WavWriter.Close();
+		impl->LastFileWriteSucceeded = (impl->AllFramesWritten && closeSucceeded);
+		return true;
+	}
+
+	b8 FileSinkBackend::IsOpenRunning() const { return impl->Backend.IsOpenRunning(); }
+	i64 FileSinkBackend::RenderFrames(i64 frameCount) { return impl->Backend.RenderFrames(frameCount); }
+	i64 FileSinkBackend::GetRenderedFrameCount() const { return impl->Backend.GetRenderedFrameCount(); }
+	b8 FileSinkBackend::GetLastFileWriteSucceeded() const { return impl->LastFileWriteSucceeded; }
+}
@@ -2,6 +2,8 @@
 #include "core_types.h"
 #include <memory>
 #include <vector>
+#include <array>
+#include <atomic>
 
 namespace Audio
 {
@@ -169,7 +171,7 @@ namespace Audio
 		const SampleType endValue = SampleAtFrameIndexOrZero<SampleType>(endFrame, atChannel, samples, sampleCount, channelCount);
 		const f64 inbetween = (frameFaction - static_cast<f64>(startFrame));
 
-		static constexpr f64 maxSampleValueF64 = static_cast<f64>(std::numeric_limits<SampleType>::max());
+		constexpr f64 maxSampleValueF64 = static_cast<f64>(std::numeric_limits<SampleType>::max());
 		const f64 normalizedStart = static_cast<f64>(startValue / maxSampleValueF64);
 		const f64 normalizedEnd = static_cast<f64>(endValue / maxSampleValueF64);
 
@@ -180,51 +182,6 @@ namespace Audio
 		return sampleTypeResult;
 	}
 
-	// NOTE: Low quallity linear resampling lacking a low pass filter, should however still be better than having sped up audio for now
-	template <typename SampleType>
-	void LinearlyResampleBuffer(std::unique_ptr<SampleType[]>& inOutSamples, size_t& inOutFrameCount, u32& inOutSampleRate, const u32 inChannelCount, const u32 targetSampleRate)
-	{
-		if (inOutSampleRate == targetSampleRate) { assert(false); return; }
-
-		const SampleType* inSamples = inOutSamples.get();
-		const size_t inSampleCount = (inOutFrameCount * inChannelCount);
-
-		const f64 sourceRate = static_cast<f64>(inOutSampleRate);
-		const f64 targetRate = static_cast<f64>(targetSampleRate);
-
-		const size_t inFrameCount = (inSampleCount / inChannelCount);
-		const size_t outFrameCount = static_cast<size_t>(inFrameCount * targetRate / sourceRate + 0.5);
-
-		const size_t outSampleCount = (outFrameCount * inChannelCount);
-		// auto outSamples = std::make_unique<SampleType[]>(outSampleCount);
-		auto outSamples = std::unique_ptr<SampleType[]>(new SampleType[outSampleCount]);
-
-		const f64 outFrameToSecond = (1.0 / targetRate);
-		SampleType* outSampleWriteHead = outSamples.get();
-
-		for (size_t frame = 0; frame < outFrameCount; frame++)
-		{
-			const f64 second = (static_cast<f64>(frame) * outFrameToSecond);
-
-			for (u32 channel = 0; channel < inChannelCount; channel++)
-				outSampleWriteHead[channel] = LinearSampleAtTimeOrZero<SampleType>(second, channel, inSamples, inSampleCount, sourceRate, inChannelCount);
-
-			outSampleWriteHead += inChannelCount;
-		}
-
-		inOutSamples = std::move(outSamples);
-		inOutFrameCount = outFrameCount;
-		inOutSampleRate = targetSampleRate;
-	}
-
-	template <typename SampleType>
-	void LinearlyResampleBuffer(std::unique_ptr<SampleType[]>& inOutSamples, i64& inOutFrameCount, u32& inOutSampleRate, const u32 inChannelCount, const u32 targetSampleRate)
-	{
-		size_t inOutFrameCountSizeT = static_cast<size_t>(inOutFrameCount);
-		Audio::LinearlyResampleBuffer(inOutSamples, inOutFrameCountSizeT, inOutSampleRate, inChannelCount, targetSampleRate);
-		inOutFrameCount = static_cast<i64>(inOutFrameCountSizeT);
-	}
-
 	template <typename T>
 	constexpr T NextRingBufferIndex(T index, size_t size) {
 		auto res = (index + 1 >= size) ? index + 1 - static_cast<T>(size) : index + 1;
@@ -244,6 +201,42 @@ namespace Audio
 		return res;
 	}
 
+	// NOTE: Fixed capacity lock-free FIFO for passing values from exactly one producer thread to exactly one consumer thread (such as the audio render thread).
+	//		 The read and write indices increase monotonically and are only wrapped when indexing into the slots
+	template <typename T, size_t Capacity>
+	struct SPSCRingQueue
+	{
+		static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+		std::array<T, Capacity> Slots = {};
+		alignas(64) std::atomic<size_t> WriteIndex = 0;
+		alignas(64) std::atomic<size_t> ReadIndex = 0;
+
+		// NOTE: Producer thread only, returns false if the queue is full
+		b8 TryPush(const T& value)
+		{
+			const size_t writeIndex = WriteIndex.load(std::memory_order_relaxed);
+			if ((writeIndex - ReadIndex.load(std::memory_order_acquire)) >= Capacity)
+				return false;
+
+			Slots[writeIndex & (Capacity - 1)] = value;
+			WriteIndex.store(writeIndex + 1, std::memory_order_release);
+			return true;
+		}
+
+		// NOTE: Consumer thread only, returns false if the queue is empty
+		b8 TryPop(T& outValue)
+		{
+			const size_t readIndex = ReadIndex.load(std::memory_order_relaxed);
+			if (readIndex == WriteIndex.load(std::memory_order_acquire))
+				return false;
+
+			outValue = Slots[readIndex & (Capacity - 1)];
+			ReadIndex.store(readIndex + 1, std::memory_order_release);
+			return true;
+		}
+	};
+
 	// <https://signalsmith-audio.co.uk/writing/2022/constant-time-peak-hold/#constant-time-peak-hold>
 	template <typename SampleType>
 	struct PeakHoldFX
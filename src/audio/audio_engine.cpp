@@ -1,13 +1,17 @@
 #include "audio_engine.h"
 #include "audio_file_formats.h"
 #include "audio_backend.h"
+#include "audio_mix_kernels.h"
+#include "audio_resampler.h"
 #include "core_io.h"
 #include <mutex>
+#include <thread>
 
 namespace Audio
 {
-	constexpr HandleBaseType VoiceHandleToIndex(VoiceHandle handle) { return static_cast<HandleBaseType>(handle); }
-	constexpr VoiceHandle IndexToVoiceHandle(HandleBaseType index) { return static_cast<VoiceHandle>(index); }
+	constexpr HandleBaseType VoiceHandleToIndex(VoiceHandle handle) { return static_cast<HandleBaseType>(static_cast<u32>(handle) & 0xFFFF); }
+	constexpr u16 VoiceHandleToGeneration(VoiceHandle handle) { return static_cast<u16>(static_cast<u32>(handle) >> 16); }
+	constexpr VoiceHandle IndexToVoiceHandle(HandleBaseType index, u16 generation) { return static_cast<VoiceHandle>((static_cast<u32>(generation) << 16) | index); }
 
 	constexpr HandleBaseType SourceHandleToIndex(SourceHandle handle) { return static_cast<HandleBaseType>(handle); }
 	constexpr SourceHandle IndexToSourceHandle(HandleBaseType index) { return static_cast<SourceHandle>(index); }
@@ -18,7 +22,14 @@ namespace Audio
 		{
 		case Backend::WASAPI_Shared:
 		case Backend::WASAPI_Exclusive:
+#if PEEPO_WIN32
 			return std::make_unique<WASAPIBackend>();
+#else
+			// NOTE: No device backend outside of Windows (yet), so that the engine can still be built and run headless
+			return std::make_unique<NullBackend>(NullBackendClock::RealTime);
+#endif
+		case Backend::Null:
+			return std::make_unique<NullBackend>(NullBackendClock::RealTime);
 		}
 
 		assert(false);
@@ -38,9 +49,21 @@ namespace Audio
 		VoiceFlags_VariablePlaybackSpeed = 1 << 6,
 	};
 
-	// NOTE: Indexed into by VoiceHandle, slot valid if Flags != VoiceFlags_Dead
+	// NOTE: Bit index of each single VoiceParamBatch field flag, used for counting the commands still pending per field
+	static constexpr size_t VoiceParamFieldCount = 12;
+	static_assert(VoiceParamBatch::Field_PauseOnEnd == (1 << (VoiceParamFieldCount - 1)));
+
+	constexpr size_t VoiceParamFieldIndex(VoiceParamBatch::FieldFlags field)
+	{
+		size_t index = 0;
+		while (field > 1) { field >>= 1; index++; }
+		return index;
+	}
+
+	// NOTE: Indexed into by VoiceHandle, slot valid if Flags != VoiceFlags_Dead and the generation matches that of the handle
 	struct VoiceData
 	{
+		std::atomic<u16> Generation;
 		// NOTE: Automatically resets to SourceHandle::Invalid when the source is unloaded
 		std::atomic<VoiceFlags> Flags;
 		std::atomic<SourceHandle> Source;
@@ -69,18 +92,97 @@ namespace Audio
 			std::atomic<f32> StartVolume, EndVolume;
 		} VolumeMap;
 
+		// NOTE: Most recently requested state written by the producer, returned by the getters instead for as long as any command changing it hasn't been applied yet.
+		//		 Otherwise reading the state right after setting it would return the old value until the next buffer has been rendered
+		struct PendingStateData
+		{
+			std::atomic<u32> CommandCounts[VoiceParamFieldCount];
+			std::atomic<SourceHandle> Source;
+			std::atomic<i32> SoundGroup;
+			std::atomic<f32> Volume, Pan, PlaybackSpeed;
+			std::atomic<f64> PositionSec;
+			std::atomic<bool> IsPlaying, IsLooping, PlayPastEnd, RemoveOnEnd, PauseOnEnd;
+
+			inline b8 IsPending(VoiceParamBatch::FieldFlags field) const { return (CommandCounts[VoiceParamFieldIndex(field)] > 0); }
+		} PendingState;
+
+		// NOTE: Link to the next slot in the free list, only accessed by the producer side and only while the slot is part of the list
+		HandleBaseType NextFreeIndex;
+
 		char Name[64];
 	};
 
+	// NOTE: Only the encoded file content is kept in memory, with the worker thread decoding ahead of the position the render thread reads at into a ring buffer.
+	//		 The ring is addressed by absolute source frame and only ever written to by the worker. Instead of waiting on it the render thread validates
+	//		 its copy afterwards (in the style of a seqlock) and treats any frames that might have been overwritten in the meantime as not yet decoded, so as silence
+	struct StreamingSourceData
+	{
+		std::shared_ptr<const u8[]> FileContent;
+		size_t FileSize;
+		u32 ChannelCount;
+		i64 FrameCount;
+
+		// NOTE: Only ever accessed while holding the DecoderMutex once the source has been loaded, which the worker thread does for each of its updates.
+		//		 Offline renders take it too to decode synchronously, as they can't afford to skip over any frames the worker hasn't caught up with yet
+		std::mutex DecoderMutex;
+		StreamingDecoder Decoder;
+		i64 DecoderFramePosition;
+		std::unique_ptr<i16[]> DecodeScratchSamples;
+
+		i64 RingFrameCapacity;
+		std::unique_ptr<i16[]> RingSamples;
+		std::atomic<i64> RingStartFrame, RingEndFrame;
+		std::atomic<u32> RingResetCount;
+
+		// NOTE: Earliest frame the render thread is going to read next, published for each buffer to let the worker know where to decode ahead from
+		std::atomic<i64> ReadCursorFrame;
+
+		// NOTE: Render thread only, holding the frames copied out of the ring for the voice currently being rendered
+		PCMSampleBuffer RenderWindow;
+		i64 RenderWindowFrameCapacity;
+	};
+
 	// NOTE: Indexed into by SourceHandle, slot valid if SlotUsed
 	struct SourceData
 	{
 		std::atomic<bool> SlotUsed;
+		std::atomic<bool> PendingRenderRelease;
+		// NOTE: Only holds the format (without any samples) for streaming sources
 		PCMSampleBuffer Buffer;
+		std::shared_ptr<StreamingSourceData> Stream;
 		std::atomic<f32> BaseVolume = 0.0f;
 		char Name[256];
 	};
 
+	// NOTE: Owned by the render thread and continuing from the exact fractional position it last left off at,
+	//		 for as long as the position of its voice hasn't been changed by anything else in the meantime
+	struct VoiceResamplerState
+	{
+		SincResampler Resampler;
+		b8 IsInSync;
+		i64 LastFramePosition;
+		f64 LastTimePositionSec;
+	};
+
+	enum class VoiceCommandType : u8
+	{
+		AddVoice,
+		RemoveVoice,
+		SetParams,
+		UnloadSource,
+		ScheduleSound,
+		ClearScheduledSounds,
+	};
+
+	// NOTE: Pushed by the UI thread(s) and applied by the render thread at the start of each buffer.
+	//		 Scheduled sounds reuse the params for their source, volume, pan, sound group and clock time (as the position), with the index being that of the clock voice
+	struct VoiceCommand
+	{
+		VoiceCommandType Type;
+		HandleBaseType Index;
+		VoiceParamBatch Params;
+	};
+
 	struct AudioEngine::Impl
 	{
 	public:
@@ -88,22 +190,94 @@ namespace Audio
 		std::array<std::atomic<f32>, MaxSoundGroups> SoundGroupVolume = InitializedArray<std::atomic<f32>, MaxSoundGroups>(AudioEngine::MaxVolume);
 
 	public:
-		ChannelMixer ChannelMixer = {};
+		Audio::ChannelMixer ChannelMixer = {};
 
 		Backend CurrentBackendType = {};
 		std::unique_ptr<IAudioBackend> CurrentBackend = nullptr;
 
 	public:
-		std::mutex VoiceRenderMutex;
+		// NOTE: Taken by the threads *producing* voice commands (and allocating slots) to serialize them into a single producer.
+		//		 The render thread only ever *tries* to take it for draining the overflow commands and never waits on it
+		std::mutex ProducerMutex;
+
+		// NOTE: Whether the render thread is currently responsible for draining the command queue, otherwise commands are applied immediately by the producer.
+		//		 Only modified while holding the ProducerMutex
+		b8 RenderThreadConsumesCommands = false;
+		SPSCRingQueue<VoiceCommand, VoiceCommandQueueCapacity> CommandQueue;
+
+		// NOTE: Commands that didn't fit into the queue (only ever if the render thread has stalled), which are never dropped as that could leak voice slots.
+		//		 Only accessed while holding the ProducerMutex, with all commands being pushed here instead of the queue for as long as it isn't empty to keep them in order
+		std::vector<VoiceCommand> OverflowCommands;
+		std::atomic<bool> HasOverflowCommands = false;
 
 		// NOTE: Slot maps indexed into via handles
 		std::array<VoiceData, MaxSimultaneousVoices> VoicePool;
 		std::array<SourceData, MaxLoadedSources> LoadedSources;
 
+		// NOTE: Intrusive list of unused voice slots for constant time allocation, owned by the producer side (so only accessed while holding the ProducerMutex).
+		//		 Slots released by the command consumer are handed back through a queue first, as the consumer usually is the render thread
+		static constexpr HandleBaseType InvalidVoiceIndex = 0xFFFF;
+		HandleBaseType FreeVoiceListHead = InvalidVoiceIndex;
+		SPSCRingQueue<HandleBaseType, MaxSimultaneousVoices> ReleasedVoiceIndices;
+
+		// NOTE: Densely packed (unordered) indices of all voices owned by the render thread so that rendering doesn't have to scan the entire pool.
+		//		 Only accessed by the command consumer, with each voice knowing its own position in the list for constant time removal
+		static constexpr HandleBaseType InvalidActiveVoicePosition = 0xFFFF;
+		std::array<HandleBaseType, MaxSimultaneousVoices> ActiveVoiceIndices = {};
+		std::array<HandleBaseType, MaxSimultaneousVoices> ActiveVoicePositions = InitializedArray<HandleBaseType, MaxSimultaneousVoices>(InvalidActiveVoicePosition);
+		size_t ActiveVoiceCount = 0;
+
+		// NOTE: Indexed by voice index as well but only ever used by voices requiring resampling
+		std::array<VoiceResamplerState, MaxSimultaneousVoices> VoiceResamplers = {};
+
+	public:
+		// NOTE: Sorted by clock time and only accessed by the command consumer, same as the active voices
+		std::array<ScheduledSound, MaxScheduledSounds> ScheduledSounds = {};
+		size_t ScheduledSoundCount = 0;
+		HandleBaseType ScheduleClockVoiceIndex = InvalidActiveVoicePosition;
+
+		// NOTE: Clock time up until which all due sounds have already been started (or skipped), so that nothing rescheduled can ever be started twice.
+		//		 Only reset to the current clock position when the clock voice has been seeked or (re)started, with some leeway for sounds scheduled right at that position
+		static constexpr Time ScheduleClockResyncThreshold = Time::FromMS(1.0);
+		b8 ScheduleClockWasPlaying = false;
+		f64 ScheduleClockExpectedStartSec = 0.0;
+		f64 ScheduleClockStartedUntilSec = 0.0;
+		std::atomic<i64> SkippedScheduledSoundCount = {};
+
+		// NOTE: Voices started by the schedule, owned by the render thread and not reachable through any handle.
+		//		 Once all of them are playing the one started the longest ago is cut off
+		std::array<VoiceData, MaxScheduledVoices> ScheduledVoices;
+		std::array<VoiceResamplerState, MaxScheduledVoices> ScheduledVoiceResamplers = {};
+		size_t ScheduledVoiceRingIndex = 0;
+
+	public:
+		// NOTE: Enough to comfortably get through any hiccups of the worker, with some frames kept behind the read cursor for short backwards seeks
+		static constexpr Time StreamingRingBufferDuration = Time::FromSec(8.0);
+		static constexpr Time StreamingKeepBehindCursorDuration = Time::FromSec(1.0);
+		static constexpr i64 StreamingDecodeChunkFrameCount = 4096;
+		static constexpr Time StreamingWorkerIdleInterval = Time::FromMS(5.0);
+
+		// NOTE: Reading faster than this ratio (of source to output frames) results in the remaining frames of a buffer being silent
+		static constexpr i64 StreamingMaxSourceFramesPerOutputFrame = 4;
+		static constexpr i64 StreamingRenderWindowFrameCapacity = (MaxBufferFrameCount * StreamingMaxSourceFramesPerOutputFrame) + SincResampler::MaxTapCount + 4;
+
+		// NOTE: Single worker thread decoding ahead for all streaming sources, only started once the first one has been loaded.
+		//		 The worker holds its own references so that sources can be unloaded (and released) at any point without having to wait on it
+		std::thread StreamingWorkerThread;
+		std::atomic<bool> StreamingWorkerStopRequested = false;
+		std::mutex StreamingSourcesMutex;
+		std::vector<std::shared_ptr<StreamingSourceData>> StreamingSources;
+
+		// NOTE: Only set for the duration of RenderOffline(), while the render callback runs on the calling thread instead of the backend
+		b8 IsRenderingOffline = false;
+
 	public:
 		std::array<i16, (MaxBufferFrameCount * OutputChannelCount)> TempOutputBuffer = {};
 		std::array<f32, (MaxBufferFrameCount* OutputChannelCount)> MasterBuffer = {};
-		std::array<f32, (MaxBufferFrameCount* OutputChannelCount)> SoundGroupBuffer = {};
+		// NOTE: Sound group 0 renders directly to master so only the remaining groups need their own buffer
+		std::array<std::array<f32, (MaxBufferFrameCount* OutputChannelCount)>, (MaxSoundGroups - 1)> SoundGroupBuffers = {};
+		// NOTE: Scratch buffer for the per frame voice volumes and limiter gains of the block currently being mixed
+		std::array<f32, MaxBufferFrameCount> FrameGainBuffer = {};
 		u32 CurrentBufferFrameSize = DefaultBufferFrameCount;
 		u32 TargetBufferFrameSize = DefaultBufferFrameCount;
 
@@ -122,6 +296,12 @@ namespace Audio
 		Time CallbackFrequency = {};
 		Time CallbackStreamTime = {}, LastCallbackStreamTime = {};
 
+		// NOTE: A callback arriving later than the previous buffer could have lasted (or taking longer to render than its own buffer lasts)
+		//		 has most likely caused an audible underrun, with some leeway for the (shared mode) device period jitter
+		static constexpr f64 LateCallbackThresholdFactor = 2.0;
+		u32 LastCallbackBufferFrameCount = 0;
+		std::atomic<i64> LateCallbackCount = {};
+
 		std::atomic<i64> TotalRenderedFrames = {};
 
 	public:
@@ -132,7 +312,55 @@ namespace Audio
 				return nullptr;
 
 			VoiceData* voiceData = &VoicePool[handleIndex];
-			return (voiceData->Flags & VoiceFlags_Alive) ? voiceData : nullptr;
+			return ((voiceData->Flags & VoiceFlags_Alive) && voiceData->Generation == VoiceHandleToGeneration(handle)) ? voiceData : nullptr;
+		}
+
+		void InitializeFreeVoiceList()
+		{
+			for (size_t i = 0; i < VoicePool.size(); i++)
+				VoicePool[i].NextFreeIndex = (i + 1 < VoicePool.size()) ? static_cast<HandleBaseType>(i + 1) : InvalidVoiceIndex;
+			FreeVoiceListHead = 0;
+		}
+
+		// NOTE: Must be called while holding the ProducerMutex, with the returned slot then being owned by the caller until its AddVoice command has been pushed
+		HandleBaseType TryAllocateVoiceSlot()
+		{
+			for (HandleBaseType releasedIndex; ReleasedVoiceIndices.TryPop(releasedIndex);)
+			{
+				VoicePool[releasedIndex].NextFreeIndex = FreeVoiceListHead;
+				FreeVoiceListHead = releasedIndex;
+			}
+
+			const HandleBaseType voiceIndex = FreeVoiceListHead;
+			if (voiceIndex == InvalidVoiceIndex)
+				return InvalidVoiceIndex;
+
+			FreeVoiceListHead = VoicePool[voiceIndex].NextFreeIndex;
+			VoicePool[voiceIndex].Generation++;
+			return voiceIndex;
+		}
+
+		VoiceHandle AllocateAndAddVoice(VoiceFlags flags, SourceHandle source, std::string_view name, f32 volume, f32 pan, i32 soundGroup)
+		{
+			const HandleBaseType voiceIndex = TryAllocateVoiceSlot();
+			if (voiceIndex == InvalidVoiceIndex)
+				return VoiceHandle::Invalid;
+
+			VoiceData& voiceData = VoicePool[voiceIndex];
+			voiceData.Flags = flags;
+			voiceData.Source = source;
+			voiceData.SoundGroup = soundGroup;
+			voiceData.Volume = volume;
+			voiceData.Pan = pan;
+			voiceData.FramePosition = 0;
+			voiceData.VolumeMap.StartVolume = 0.0f;
+			voiceData.VolumeMap.EndVolume = 0.0f;
+			for (auto& commandCount : voiceData.PendingState.CommandCounts)
+				commandCount = 0;
+			CopyStringViewIntoFixedBuffer(voiceData.Name, name);
+			PushVoiceCommand(VoiceCommand { VoiceCommandType::AddVoice, voiceIndex });
+
+			return IndexToVoiceHandle(voiceIndex, voiceData.Generation);
 		}
 
 		enum class GetSourceDataParam : u8 { None, ValidateBuffer };
@@ -147,7 +375,7 @@ namespace Audio
 				return nullptr;
 
 			if (param == GetSourceDataParam::ValidateBuffer)
-				return (sourceData->Buffer.InterleavedSamples != nullptr) && (sourceData->Buffer.SampleRate > 0) ? sourceData : nullptr;
+				return (sourceData->Buffer.InterleavedSamples != nullptr || sourceData->Stream != nullptr) && (sourceData->Buffer.SampleRate > 0) ? sourceData : nullptr;
 			else
 				return sourceData;
 		}
@@ -178,6 +406,473 @@ namespace Audio
 				CopyStringViewIntoFixedBuffer(sourceData->Name, newName);
 		}
 
+		SourceHandle AllocateSourceSlot(std::string_view sourceName, PCMSampleBuffer bufferToMove, std::shared_ptr<StreamingSourceData> streamToMove)
+		{
+			const auto lock = std::scoped_lock(ProducerMutex);
+			for (HandleBaseType index = 0; index < static_cast<HandleBaseType>(LoadedSources.size()); index++)
+			{
+				SourceData& sourceData = LoadedSources[index];
+				if (sourceData.SlotUsed || sourceData.PendingRenderRelease)
+					continue;
+
+				// NOTE: Only publish the slot to the render thread after the buffer has been fully moved in
+				sourceData.Buffer = std::move(bufferToMove);
+				sourceData.Stream = std::move(streamToMove);
+				sourceData.BaseVolume = 1.0f;
+				CopyStringViewIntoFixedBuffer(sourceData.Name, sourceName);
+				sourceData.SlotUsed = true;
+
+				return IndexToSourceHandle(index);
+			}
+
+#if PEEPO_DEBUG
+			assert(!"Consider increasing MaxLoadedSources");
+#endif
+
+			return SourceHandle::Invalid;
+		}
+
+		void StartStreamingWorkerThreadIfNotRunning()
+		{
+			if (StreamingWorkerThread.joinable())
+				return;
+
+			StreamingWorkerStopRequested = false;
+			StreamingWorkerThread = std::thread([this] { StreamingWorkerThreadEntry(); });
+		}
+
+		void StopStreamingWorkerThread()
+		{
+			if (!StreamingWorkerThread.joinable())
+				return;
+
+			StreamingWorkerStopRequested = true;
+			StreamingWorkerThread.join();
+		}
+
+		void StreamingWorkerThreadEntry()
+		{
+			std::vector<std::shared_ptr<StreamingSourceData>> sourcesToUpdate;
+			while (!StreamingWorkerStopRequested)
+			{
+				{
+					const auto lock = std::scoped_lock(StreamingSourcesMutex);
+					sourcesToUpdate = StreamingSources;
+				}
+
+				b8 anyFramesDecoded = false;
+				for (const auto& stream : sourcesToUpdate)
+				{
+					const auto lock = std::scoped_lock(stream->DecoderMutex);
+					anyFramesDecoded |= StreamingWorkerUpdateSource(*stream);
+				}
+				sourcesToUpdate.clear();
+
+				if (!anyFramesDecoded)
+					std::this_thread::sleep_for(std::chrono::duration<f64>(StreamingWorkerIdleInterval.ToSec()));
+			}
+		}
+
+		// NOTE: Returns true if any frames have been decoded
+		static b8 StreamingWorkerUpdateSource(StreamingSourceData& stream)
+		{
+			const i64 behindCursorFrameCount = Min(TimeToFrames(StreamingKeepBehindCursorDuration, stream.Decoder.GetSampleRate()), stream.RingFrameCapacity / 2);
+			i64 cursorFrame = Clamp<i64>(stream.ReadCursorFrame.load(std::memory_order_acquire), 0, stream.FrameCount);
+			i64 ringStartFrame = stream.RingStartFrame.load(std::memory_order_relaxed);
+			i64 ringEndFrame = stream.RingEndFrame.load(std::memory_order_relaxed);
+
+			// NOTE: Anything already inside the ring can't be reused after having seeked outside of it, so start decoding anew at the cursor.
+			//		 The reset count is increased *before* writing any new frames so that the render thread can detect having raced with it
+			if (cursorFrame < ringStartFrame || cursorFrame > ringEndFrame)
+			{
+				stream.RingResetCount.fetch_add(1, std::memory_order_relaxed);
+				stream.RingStartFrame.store(cursorFrame, std::memory_order_relaxed);
+				stream.RingEndFrame.store(cursorFrame, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				ringStartFrame = ringEndFrame = cursorFrame;
+			}
+
+			if (stream.DecoderFramePosition != ringEndFrame)
+			{
+				if (!stream.Decoder.SeekToFrame(ringEndFrame))
+					return false;
+				stream.DecoderFramePosition = ringEndFrame;
+			}
+
+			const u32 channelCount = stream.ChannelCount;
+			b8 anyFramesDecoded = false;
+			while (true)
+			{
+				const i64 targetEndFrame = Min(stream.FrameCount, (cursorFrame - behindCursorFrameCount) + stream.RingFrameCapacity);
+				if (ringEndFrame >= targetEndFrame)
+					break;
+
+				const i64 framesDecoded = stream.Decoder.ReadFrames(stream.DecodeScratchSamples.get(), Min(StreamingDecodeChunkFrameCount, targetEndFrame - ringEndFrame));
+				if (framesDecoded <= 0)
+					break;
+				stream.DecoderFramePosition += framesDecoded;
+
+				// NOTE: Writing a frame overwrites the one a full ring capacity before it, which therefore has to be invalidated first
+				const i64 newRingEndFrame = (ringEndFrame + framesDecoded);
+				if ((newRingEndFrame - stream.RingFrameCapacity) > ringStartFrame)
+				{
+					ringStartFrame = (newRingEndFrame - stream.RingFrameCapacity);
+					stream.RingStartFrame.store(ringStartFrame, std::memory_order_relaxed);
+					std::atomic_thread_fence(std::memory_order_release);
+				}
+
+				for (i64 frame = ringEndFrame; frame < newRingEndFrame;)
+				{
+					const i64 ringIndex = (frame % stream.RingFrameCapacity);
+					const i64 framesToCopy = Min(newRingEndFrame - frame, stream.RingFrameCapacity - ringIndex);
+					memcpy(&stream.RingSamples[ringIndex * channelCount], &stream.DecodeScratchSamples[(frame - ringEndFrame) * channelCount], framesToCopy * channelCount * sizeof(i16));
+					frame += framesToCopy;
+				}
+
+				ringEndFrame = newRingEndFrame;
+				stream.RingEndFrame.store(ringEndFrame, std::memory_order_release);
+				anyFramesDecoded = true;
+
+				// NOTE: Stop early if the render thread has seeked away in the meantime, so that the reset happens as soon as possible
+				cursorFrame = Clamp<i64>(stream.ReadCursorFrame.load(std::memory_order_acquire), 0, stream.FrameCount);
+				if (cursorFrame < ringStartFrame || cursorFrame > ringEndFrame)
+					break;
+			}
+
+			return anyFramesDecoded;
+		}
+
+		// NOTE: Makes the frames [windowStartFrame, windowStartFrame + frameCount) of the source available to the render thread, returning a buffer that starts at outWindowStartFrame.
+		//		 Regular sources simply return their entire buffer (starting at frame 0) while streaming sources copy the requested range out of their ring,
+		//		 with any frames that haven't been decoded yet being silent (unless rendering offline, in which case they're decoded on the spot)
+		PCMSampleBuffer& CallbackGetSourceFrameWindow(SourceData& sourceData, i64 windowStartFrame, i64 frameCount, i64& outWindowStartFrame)
+		{
+			StreamingSourceData* stream = sourceData.Stream.get();
+			if (stream == nullptr)
+			{
+				outWindowStartFrame = 0;
+				return sourceData.Buffer;
+			}
+
+			// NOTE: The read cursor has already been published for this buffer, so this decodes (at least) everything up to the end of the window
+			if (IsRenderingOffline)
+			{
+				const auto lock = std::scoped_lock(stream->DecoderMutex);
+				StreamingWorkerUpdateSource(*stream);
+			}
+
+			PCMSampleBuffer& window = stream->RenderWindow;
+			const u32 channelCount = stream->ChannelCount;
+			i16* windowSamples = window.InterleavedSamples.get();
+			window.FrameCount = Clamp<i64>(frameCount, 0, stream->RenderWindowFrameCapacity);
+			std::fill(windowSamples, windowSamples + (window.FrameCount * channelCount), static_cast<i16>(0));
+			outWindowStartFrame = windowStartFrame;
+
+			const u32 resetCountBefore = stream->RingResetCount.load(std::memory_order_acquire);
+			const i64 ringStartFrame = stream->RingStartFrame.load(std::memory_order_acquire);
+			const i64 ringEndFrame = stream->RingEndFrame.load(std::memory_order_acquire);
+			const i64 copyStartFrame = Max(windowStartFrame, ringStartFrame);
+			const i64 copyEndFrame = Min(windowStartFrame + window.FrameCount, ringEndFrame);
+			if (copyStartFrame >= copyEndFrame)
+				return window;
+
+			for (i64 frame = copyStartFrame; frame < copyEndFrame;)
+			{
+				const i64 ringIndex = (frame % stream->RingFrameCapacity);
+				const i64 framesToCopy = Min(copyEndFrame - frame, stream->RingFrameCapacity - ringIndex);
+				memcpy(&windowSamples[(frame - windowStartFrame) * channelCount], &stream->RingSamples[ringIndex * channelCount], framesToCopy * channelCount * sizeof(i16));
+				frame += framesToCopy;
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			const u32 resetCountAfter = stream->RingResetCount.load(std::memory_order_relaxed);
+			const i64 ringStartFrameAfter = stream->RingStartFrame.load(std::memory_order_relaxed);
+
+			const i64 invalidEndFrame = (resetCountAfter != resetCountBefore) ? copyEndFrame : Min(ringStartFrameAfter, copyEndFrame);
+			if (invalidEndFrame > copyStartFrame)
+				std::fill(&windowSamples[(copyStartFrame - windowStartFrame) * channelCount], &windowSamples[(invalidEndFrame - windowStartFrame) * channelCount], static_cast<i16>(0));
+
+			return window;
+		}
+
+		b8 IsActiveVoice(HandleBaseType voiceIndex) const
+		{
+			return (ActiveVoicePositions[voiceIndex] != InvalidActiveVoicePosition);
+		}
+
+		void AddActiveVoice(HandleBaseType voiceIndex)
+		{
+			assert(ActiveVoiceCount < ActiveVoiceIndices.size() && !IsActiveVoice(voiceIndex));
+			ActiveVoicePositions[voiceIndex] = static_cast<HandleBaseType>(ActiveVoiceCount);
+			ActiveVoiceIndices[ActiveVoiceCount++] = voiceIndex;
+			VoiceResamplers[voiceIndex].IsInSync = false;
+		}
+
+		// NOTE: Also releases the slot back to the producer side so that it can be reused for a new voice
+		void RemoveActiveVoice(HandleBaseType voiceIndex)
+		{
+			const HandleBaseType position = ActiveVoicePositions[voiceIndex];
+			if (position == InvalidActiveVoicePosition)
+				return;
+
+			const HandleBaseType lastVoiceIndex = ActiveVoiceIndices[--ActiveVoiceCount];
+			ActiveVoiceIndices[position] = lastVoiceIndex;
+			ActiveVoicePositions[lastVoiceIndex] = position;
+			ActiveVoicePositions[voiceIndex] = InvalidActiveVoicePosition;
+
+			// NOTE: Otherwise a new voice reusing the slot would silently take over as the clock
+			if (voiceIndex == ScheduleClockVoiceIndex)
+			{
+				ScheduledSoundCount = 0;
+				ScheduleClockVoiceIndex = InvalidActiveVoicePosition;
+			}
+
+			const b8 releasedVoiceIndexPushed = ReleasedVoiceIndices.TryPush(voiceIndex);
+			assert(releasedVoiceIndexPushed && "Each slot can only ever be released once per allocation, so the queue can't possibly be full");
+		}
+
+		u32 GetVoiceSourceSampleRate(const VoiceData& voiceData)
+		{
+			const SourceData* sourceData = TryGetSourceData(voiceData.Source, GetSourceDataParam::ValidateBuffer);
+			return (sourceData != nullptr) ? sourceData->Buffer.SampleRate : OutputSampleRate;
+		}
+
+		void ApplyVoiceParams(VoiceData& voiceData, const VoiceParamBatch& params)
+		{
+			if (params.Fields & VoiceParamBatch::Field_Source)
+				voiceData.Source = params.Source;
+			if (params.Fields & VoiceParamBatch::Field_SoundGroup)
+				voiceData.SoundGroup = params.SoundGroup;
+			if (params.Fields & VoiceParamBatch::Field_Volume)
+				voiceData.Volume = params.Volume;
+			if (params.Fields & VoiceParamBatch::Field_Pan)
+				voiceData.Pan = params.Pan;
+
+			if (params.Fields & VoiceParamBatch::Field_PlaybackSpeed)
+			{
+				const u32 sampleRate = GetVoiceSourceSampleRate(voiceData);
+				if (ApproxmiatelySame(params.PlaybackSpeed, 1.0f))
+				{
+					if (voiceData.Flags & VoiceFlags_VariablePlaybackSpeed)
+						voiceData.FramePosition = TimeToFrames(Time::FromSec(voiceData.TimePositionSec), sampleRate);
+
+					voiceData.Flags &= ~VoiceFlags_VariablePlaybackSpeed;
+				}
+				else
+				{
+					if (!(voiceData.Flags & VoiceFlags_VariablePlaybackSpeed))
+						voiceData.TimePositionSec = FramesToTime(voiceData.FramePosition, sampleRate).ToSec();
+
+					voiceData.Flags |= VoiceFlags_VariablePlaybackSpeed;
+				}
+
+				voiceData.PlaybackSpeed = params.PlaybackSpeed;
+				voiceData.SmoothTime.RequestUpdate = true;
+			}
+
+			if (params.Fields & VoiceParamBatch::Field_Position)
+			{
+				voiceData.FramePosition = TimeToFrames(params.Position, GetVoiceSourceSampleRate(voiceData));
+				voiceData.TimePositionSec = params.Position.ToSec();
+				voiceData.SmoothTime.RequestUpdate = true;
+			}
+
+			if (params.Fields & VoiceParamBatch::Field_VolumeMap)
+			{
+				const u32 sampleRate = GetVoiceSourceSampleRate(voiceData);
+				voiceData.VolumeMap.StartFrame = TimeToFrames(params.VolumeMapStartTime, sampleRate);
+				voiceData.VolumeMap.EndFrame = TimeToFrames(params.VolumeMapEndTime, sampleRate);
+				voiceData.VolumeMap.StartVolume = params.VolumeMapStartVolume;
+				voiceData.VolumeMap.EndVolume = params.VolumeMapEndVolume;
+			}
+
+			const auto applyFlag = [&](VoiceParamBatch::FieldFlags field, b8 value, VoiceFlags flag)
+			{
+				if (!(params.Fields & field))
+					return;
+
+				if (value)
+					voiceData.Flags |= flag;
+				else
+					voiceData.Flags &= ~flag;
+			};
+
+			applyFlag(VoiceParamBatch::Field_IsPlaying, params.IsPlaying, VoiceFlags_Playing);
+			applyFlag(VoiceParamBatch::Field_IsLooping, params.IsLooping, VoiceFlags_Looping);
+			applyFlag(VoiceParamBatch::Field_PlayPastEnd, params.PlayPastEnd, VoiceFlags_PlayPastEnd);
+			applyFlag(VoiceParamBatch::Field_RemoveOnEnd, params.RemoveOnEnd, VoiceFlags_RemoveOnEnd);
+			applyFlag(VoiceParamBatch::Field_PauseOnEnd, params.PauseOnEnd, VoiceFlags_PauseOnEnd);
+
+			if (params.Fields & VoiceParamBatch::Field_IsPlaying)
+				voiceData.SmoothTime.RequestUpdate = true;
+		}
+
+		// NOTE: Expected to be called while holding the ProducerMutex, right before pushing the command with the params
+		void AcquireVoicePendingState(VoiceData& voiceData, const VoiceParamBatch& params)
+		{
+			auto& pending = voiceData.PendingState;
+			if (params.Fields & VoiceParamBatch::Field_Source) pending.Source = params.Source;
+			if (params.Fields & VoiceParamBatch::Field_SoundGroup) pending.SoundGroup = params.SoundGroup;
+			if (params.Fields & VoiceParamBatch::Field_Volume) pending.Volume = params.Volume;
+			if (params.Fields & VoiceParamBatch::Field_Pan) pending.Pan = params.Pan;
+			if (params.Fields & VoiceParamBatch::Field_PlaybackSpeed) pending.PlaybackSpeed = params.PlaybackSpeed;
+			if (params.Fields & VoiceParamBatch::Field_Position) pending.PositionSec = params.Position.ToSec();
+			if (params.Fields & VoiceParamBatch::Field_IsPlaying) pending.IsPlaying = params.IsPlaying;
+			if (params.Fields & VoiceParamBatch::Field_IsLooping) pending.IsLooping = params.IsLooping;
+			if (params.Fields & VoiceParamBatch::Field_PlayPastEnd) pending.PlayPastEnd = params.PlayPastEnd;
+			if (params.Fields & VoiceParamBatch::Field_RemoveOnEnd) pending.RemoveOnEnd = params.RemoveOnEnd;
+			if (params.Fields & VoiceParamBatch::Field_PauseOnEnd) pending.PauseOnEnd = params.PauseOnEnd;
+
+			for (size_t i = 0; i < VoiceParamFieldCount; i++)
+			{
+				if (params.Fields & (1 << i))
+					pending.CommandCounts[i]++;
+			}
+		}
+
+		// NOTE: Called by the command consumer only after the params have been applied so that the getters never fall back to a state older than the pending one
+		void ReleaseVoicePendingState(VoiceData& voiceData, const VoiceParamBatch& params)
+		{
+			for (size_t i = 0; i < VoiceParamFieldCount; i++)
+			{
+				if (params.Fields & (1 << i))
+					voiceData.PendingState.CommandCounts[i]--;
+			}
+		}
+
+		void ApplyVoiceCommand(const VoiceCommand& command)
+		{
+			switch (command.Type)
+			{
+			case VoiceCommandType::AddVoice:
+			{
+				AddActiveVoice(command.Index);
+			} break;
+			case VoiceCommandType::RemoveVoice:
+			{
+				RemoveActiveVoice(command.Index);
+			} break;
+			case VoiceCommandType::SetParams:
+			{
+				// NOTE: The voice might have already been removed on end by the render thread and its slot be in the process of being reused
+				if (IsActiveVoice(command.Index) && (VoicePool[command.Index].Flags & VoiceFlags_Alive))
+				{
+					ApplyVoiceParams(VoicePool[command.Index], command.Params);
+					ReleaseVoicePendingState(VoicePool[command.Index], command.Params);
+				}
+			} break;
+			case VoiceCommandType::UnloadSource:
+			{
+				const SourceHandle source = IndexToSourceHandle(command.Index);
+				for (size_t i = 0; i < ActiveVoiceCount; i++)
+				{
+					VoiceData& voiceData = VoicePool[ActiveVoiceIndices[i]];
+					if (voiceData.Source == source)
+						voiceData.Source = SourceHandle::Invalid;
+				}
+				for (VoiceData& voiceData : ScheduledVoices)
+				{
+					if (voiceData.Source == source)
+						voiceData.Source = SourceHandle::Invalid;
+				}
+				for (size_t i = 0; i < ScheduledSoundCount; i++)
+				{
+					if (ScheduledSounds[i].Source == source)
+						ScheduledSounds[i].Source = SourceHandle::Invalid;
+				}
+				LoadedSources[command.Index].PendingRenderRelease = false;
+			} break;
+			case VoiceCommandType::ScheduleSound:
+			{
+				if (command.Index != ScheduleClockVoiceIndex)
+				{
+					ScheduledSoundCount = 0;
+					ScheduleClockVoiceIndex = command.Index;
+					ScheduleClockWasPlaying = false;
+				}
+				InsertScheduledSound(ScheduledSound { command.Params.Position, command.Params.Source, command.Params.Volume, command.Params.Pan, command.Params.SoundGroup });
+			} break;
+			case VoiceCommandType::ClearScheduledSounds:
+			{
+				ScheduledSoundCount = 0;
+			} break;
+			default:
+			{
+				assert(false);
+			} break;
+			}
+		}
+
+		void InsertScheduledSound(const ScheduledSound& sound)
+		{
+			if (ScheduledSoundCount >= ScheduledSounds.size())
+			{
+				SkippedScheduledSoundCount++;
+				return;
+			}
+
+			// NOTE: Almost always appended to the end, as the schedule is topped up in chronological order
+			const auto end = ScheduledSounds.begin() + ScheduledSoundCount;
+			const auto insertIt = std::upper_bound(ScheduledSounds.begin(), end, sound.ClockTime, [](Time time, const ScheduledSound& it) { return time < it.ClockTime; });
+			std::move_backward(insertIt, end, end + 1);
+			*insertIt = sound;
+			ScheduledSoundCount++;
+		}
+
+		// NOTE: Expected to be called while holding the ProducerMutex
+		void PushVoiceCommand(const VoiceCommand& command)
+		{
+			if (!RenderThreadConsumesCommands)
+			{
+				ApplyVoiceCommand(command);
+				return;
+			}
+
+			if (OverflowCommands.empty() && CommandQueue.TryPush(command))
+				return;
+
+			OverflowCommands.push_back(command);
+			HasOverflowCommands = true;
+		}
+
+		// NOTE: Called by the render thread at the start of each buffer, or by the producer once the stream has been stopped
+		void ConsumeAllVoiceCommands()
+		{
+			VoiceCommand command;
+			while (CommandQueue.TryPop(command))
+				ApplyVoiceCommand(command);
+		}
+
+		// NOTE: Expected to be called while holding the ProducerMutex, after the queue itself has been drained as all overflow commands were pushed after its contents
+		void ConsumeAllOverflowCommands()
+		{
+			for (const VoiceCommand& command : OverflowCommands)
+				ApplyVoiceCommand(command);
+			OverflowCommands.clear();
+			HasOverflowCommands = false;
+		}
+
+		void CallbackConsumeAllVoiceCommands()
+		{
+			ConsumeAllVoiceCommands();
+			if (!HasOverflowCommands)
+				return;
+
+			// NOTE: Simply trying again next buffer if a producer is currently holding on to the mutex
+			const auto lock = std::unique_lock(ProducerMutex, std::try_to_lock);
+			if (lock.owns_lock())
+			{
+				ConsumeAllVoiceCommands();
+				ConsumeAllOverflowCommands();
+			}
+		}
+
+		// NOTE: Sound group 0 (or any invalid group) renders directly to master
+		f32* GetSoundGroupRenderBuffer(i32 soundGroup)
+		{
+			return (soundGroup > 0 && soundGroup < MaxSoundGroups) ? SoundGroupBuffers[soundGroup - 1].data() : MasterBuffer.data();
+		}
+
 		template <typename T>
 		void CallbackClearOutBuffer(T* outputBuffer, const size_t sampleCount)
 		{
@@ -198,7 +893,8 @@ namespace Audio
 			return lerpVolume;
 		}
 
-		void CallbackApplyVoiceVolumeAndMixTempBufferIntoOutput(f32* outputBuffer, const i64 frameCount, const VoiceData& voiceData, const u32 sampleRate)
+		// NOTE: The volume map is defined in source frames, which start at startSourceFrame and advance by sourceFramesPerOutputFrame for each mixed frame
+		void CallbackApplyVoiceVolumeAndMixTempBufferIntoOutput(f32* outputBuffer, const i64 frameCount, const VoiceData& voiceData, const f64 startSourceFrame, const f64 sourceFramesPerOutputFrame)
 		{
 			const f32 voiceVolume = voiceData.Volume * GetSourceBaseVolume(voiceData.Source);
 			const f32 startVolume = voiceData.VolumeMap.StartVolume;
@@ -209,103 +905,199 @@ namespace Audio
 			const auto panGain = doPan ? GetPanGain(voiceData.Pan, PanLaw) : std::array{ 1.0f, 1.0f };
 			auto channelGain = [&](u32 iCh, f32 vol) { return (doPan && iCh < 2) ? vol * panGain[iCh] : vol; };
 
+			static_assert(OutputChannelCount == MixKernelChannelCount);
 			if (startVolume == endVolume)
 			{
-				for (i64 i = 0, n = (frameCount * OutputChannelCount); i < n;) {
-					for (u32 c = 0; c < OutputChannelCount; ++c, ++i)
-						outputBuffer[i] += TempOutputBuffer[i] * channelGain(c, voiceVolume);
-				}
+				MixSamplesI16IntoF32(outputBuffer, TempOutputBuffer.data(), frameCount, { channelGain(0, voiceVolume), channelGain(1, voiceVolume) });
 			}
 			else
 			{
 				const i64 volumeMapStartFrame = voiceData.VolumeMap.StartFrame;
 				const i64 volumeMapEndFrame = voiceData.VolumeMap.EndFrame;
 
-				if (voiceData.Flags & VoiceFlags_VariablePlaybackSpeed)
+				for (i64 f = 0; f < frameCount; ++f)
 				{
-					const Time frameDuration = FramesToTime(1, sampleRate) * voiceData.PlaybackSpeed;
-					const Time bufferDuration = Time::FromSec(frameDuration.ToSec() * frameCount);
-					const Time voiceStartTime = Time::FromSec(voiceData.TimePositionSec) - bufferDuration;
-
-					for (i64 f = 0, i = 0; f < frameCount; ++f)
-					{
-						const Time frameTime = Time::FromSec(voiceStartTime.ToSec() + (f * frameDuration.ToSec()));
-						const f32 frameVolume = SampleVolumeMapAt(volumeMapStartFrame, volumeMapEndFrame, startVolume, endVolume, TimeToFrames(frameTime, sampleRate)) * voiceVolume;
-						for (u32 c = 0; c < OutputChannelCount; ++c, ++i)
-							outputBuffer[i] += TempOutputBuffer[i] * channelGain(c, frameVolume);
-					}
+					const i64 sourceFrame = static_cast<i64>(Floor(startSourceFrame + (f * sourceFramesPerOutputFrame)));
+					FrameGainBuffer[f] = SampleVolumeMapAt(volumeMapStartFrame, volumeMapEndFrame, startVolume, endVolume, sourceFrame) * voiceVolume;
 				}
+
+				MixSamplesI16IntoF32PerFrameVolume(outputBuffer, TempOutputBuffer.data(), frameCount, FrameGainBuffer.data(), { channelGain(0, 1.0f), channelGain(1, 1.0f) });
+			}
+		}
+
+		// NOTE: Single pass over all active voices, each one being rendered into the buffer of its own sound group
+		void CallbackProcessVoices(const u32 bufferFrameCount)
+		{
+			for (size_t activeIndex = 0; activeIndex < ActiveVoiceCount;)
+			{
+				const HandleBaseType voiceIndex = ActiveVoiceIndices[activeIndex];
+				VoiceData& voiceData = VoicePool[voiceIndex];
+
+				// NOTE: Removing swaps the last active voice into the current position, which then has to be processed next
+				if (CallbackProcessVoice(GetSoundGroupRenderBuffer(voiceData.SoundGroup), bufferFrameCount, voiceData, VoiceResamplers[voiceIndex]))
+					activeIndex++;
 				else
-				{
-					const i64 voiceStartFrame = (voiceData.FramePosition - frameCount);
-
-					for (i64 f = 0, i = 0; f < frameCount; ++f)
-					{
-						const f32 frameVolume = SampleVolumeMapAt(volumeMapStartFrame, volumeMapEndFrame, startVolume, endVolume, voiceStartFrame + f) * voiceVolume;
-						for (u32 c = 0; c < OutputChannelCount; ++c, ++i)
-							outputBuffer[i] += TempOutputBuffer[i] * channelGain(c, frameVolume);
-					}
-				}
+					RemoveActiveVoice(voiceIndex);
 			}
+
+			for (size_t i = 0; i < ScheduledVoices.size(); i++)
+			{
+				if (ScheduledVoices[i].Flags & VoiceFlags_Alive)
+					CallbackProcessVoice(GetSoundGroupRenderBuffer(ScheduledVoices[i].SoundGroup), bufferFrameCount, ScheduledVoices[i], ScheduledVoiceResamplers[i]);
+			}
+
+			TotalRenderedFrames += bufferFrameCount;
 		}
 
-		void CallbackProcessVoices(f32* outputBuffer, const u32 bufferFrameCount, const u32 bufferSampleCount, i32 soundGroup)
+		// NOTE: Has to be called before rendering the clock voice, so that its position still is the one at the start of the buffer
+		void CallbackStartDueScheduledSounds(const u32 bufferFrameCount)
 		{
-			const auto lock = std::scoped_lock(VoiceRenderMutex);
+			if (ScheduleClockVoiceIndex == InvalidActiveVoicePosition)
+				return;
 
-			for (size_t voiceIndex = 0; voiceIndex < VoicePool.size(); voiceIndex++)
+			VoiceData& clockVoice = VoicePool[ScheduleClockVoiceIndex];
+			if (!IsActiveVoice(ScheduleClockVoiceIndex) || !(clockVoice.Flags & VoiceFlags_Alive))
 			{
-				VoiceData& voiceData = VoicePool[voiceIndex];
-				if (i32 group = voiceData.SoundGroup; !(group == soundGroup || ((soundGroup == 0) && !(group >= 0 && group < MaxSoundGroups))))
-					continue;
-				if (!(voiceData.Flags & VoiceFlags_Alive))
+				ScheduledSoundCount = 0;
+				ScheduleClockVoiceIndex = InvalidActiveVoicePosition;
+				return;
+			}
+
+			const b8 isPlaying = (clockVoice.Flags & VoiceFlags_Playing);
+			const b8 wasPlaying = ScheduleClockWasPlaying;
+			ScheduleClockWasPlaying = isPlaying;
+			if (!isPlaying)
+				return;
+
+			// NOTE: The resampler keeps track of the exact fractional position, whereas the frame position of the voice itself is truncated
+			const VoiceResamplerState& clockResampler = VoiceResamplers[ScheduleClockVoiceIndex];
+			const b8 variablePlaybackSpeed = (clockVoice.Flags & VoiceFlags_VariablePlaybackSpeed);
+			const f64 playbackSpeed = variablePlaybackSpeed ? Max(static_cast<f64>(clockVoice.PlaybackSpeed), 0.001) : 1.0;
+			const f64 sampleRate = static_cast<f64>(GetVoiceSourceSampleRate(clockVoice));
+			const f64 clockStartSec =
+				variablePlaybackSpeed ? clockVoice.TimePositionSec.load() :
+				(clockResampler.IsInSync && clockResampler.LastFramePosition == clockVoice.FramePosition) ? (clockResampler.Resampler.GetSourcePosition() / sampleRate) :
+				(static_cast<f64>(clockVoice.FramePosition) / sampleRate);
+			const f64 clockEndSec = clockStartSec + (static_cast<f64>(bufferFrameCount) * playbackSpeed / static_cast<f64>(OutputSampleRate));
+
+			if (!wasPlaying || Absolute(clockStartSec - ScheduleClockExpectedStartSec) > ScheduleClockResyncThreshold.ToSec())
+				ScheduleClockStartedUntilSec = (clockStartSec - ScheduleClockResyncThreshold.ToSec());
+			ScheduleClockExpectedStartSec = clockEndSec;
+
+			size_t dueCount = 0;
+			for (; dueCount < ScheduledSoundCount; dueCount++)
+			{
+				const ScheduledSound& sound = ScheduledSounds[dueCount];
+				const f64 soundSec = sound.ClockTime.ToSec();
+				if (soundSec >= clockEndSec)
+					break;
+
+				// NOTE: Either arrived too late or has already been started before being rescheduled
+				if (soundSec < ScheduleClockStartedUntilSec)
+				{
+					SkippedScheduledSoundCount++;
 					continue;
+				}
+
+				const f64 outputFrameOffset = Round((soundSec - clockStartSec) * static_cast<f64>(OutputSampleRate) / playbackSpeed);
+				CallbackStartScheduledVoice(sound, Clamp<i64>(static_cast<i64>(outputFrameOffset), 0, static_cast<i64>(bufferFrameCount) - 1));
+			}
+
+			std::move(ScheduledSounds.begin() + dueCount, ScheduledSounds.begin() + ScheduledSoundCount, ScheduledSounds.begin());
+			ScheduledSoundCount -= dueCount;
+			ScheduleClockStartedUntilSec = Max(ScheduleClockStartedUntilSec, clockEndSec);
+		}
 
-				// TODO: Handle sample rate mismatch (by always setting variable playback speed?)
-				SourceData* sourceData = TryGetSourceData(voiceData.Source, GetSourceDataParam::ValidateBuffer);
+		void CallbackStartScheduledVoice(const ScheduledSound& sound, const i64 outputFrameOffset)
+		{
+			size_t voiceIndex = ScheduledVoiceRingIndex;
+			for (size_t i = 0; i < ScheduledVoices.size(); i++)
+			{
+				const size_t candidateIndex = (ScheduledVoiceRingIndex + i) % ScheduledVoices.size();
+				if (!(ScheduledVoices[candidateIndex].Flags & VoiceFlags_Alive)) { voiceIndex = candidateIndex; break; }
+			}
+			ScheduledVoiceRingIndex = (voiceIndex + 1) % ScheduledVoices.size();
+
+			// NOTE: Starting "before" the source by the offset into the buffer, which is then rendered as silence
+			const SourceData* sourceData = TryGetSourceData(sound.Source, GetSourceDataParam::ValidateBuffer);
+			const f64 sampleRate = static_cast<f64>((sourceData != nullptr) ? sourceData->Buffer.SampleRate : OutputSampleRate);
+			const f64 startSourceFrame = -(static_cast<f64>(outputFrameOffset) * sampleRate / static_cast<f64>(OutputSampleRate));
+
+			VoiceData& voiceData = ScheduledVoices[voiceIndex];
+			voiceData.Flags = (VoiceFlags_Alive | VoiceFlags_Playing | VoiceFlags_RemoveOnEnd);
+			voiceData.Source = sound.Source;
+			voiceData.SoundGroup = sound.SoundGroup;
+			voiceData.Volume = sound.Volume;
+			voiceData.Pan = sound.Pan;
+			voiceData.PlaybackSpeed = 1.0f;
+			voiceData.FramePosition = static_cast<i64>(Floor(startSourceFrame));
+			voiceData.TimePositionSec = (startSourceFrame / sampleRate);
+			voiceData.SmoothTime.RequestUpdate = false;
+			voiceData.VolumeMap.StartVolume = 0.0f;
+			voiceData.VolumeMap.EndVolume = 0.0f;
+			ScheduledVoiceResamplers[voiceIndex].IsInSync = false;
+		}
+
+		// NOTE: Returns false if the voice has been removed
+		b8 CallbackProcessVoice(f32* outputBuffer, const u32 bufferFrameCount, VoiceData& voiceData, VoiceResamplerState& resampler)
+		{
+			if (!(voiceData.Flags & VoiceFlags_Alive))
+				return false;
 
-				const b8 variablePlaybackSpeed = (voiceData.Flags & VoiceFlags_VariablePlaybackSpeed);
-				const b8 playPastEnd = (voiceData.Flags & VoiceFlags_PlayPastEnd);
-				b8 hasReachedEnd = (sourceData == nullptr) ? false :
-					(variablePlaybackSpeed ? (voiceData.TimePositionSec >= FramesToTime(sourceData->Buffer.FrameCount, sourceData->Buffer.SampleRate).ToSec()) :
-					(voiceData.FramePosition >= sourceData->Buffer.FrameCount));
+			SourceData* sourceData = TryGetSourceData(voiceData.Source, GetSourceDataParam::ValidateBuffer);
 
-				if (sourceData == nullptr && (voiceData.Flags & VoiceFlags_RemoveOnEnd))
-					hasReachedEnd = true;
+			const b8 variablePlaybackSpeed = (voiceData.Flags & VoiceFlags_VariablePlaybackSpeed);
+			const b8 sampleRateMismatch = (sourceData != nullptr) && (sourceData->Buffer.SampleRate != OutputSampleRate);
+			const b8 playPastEnd = (voiceData.Flags & VoiceFlags_PlayPastEnd);
+			b8 hasReachedEnd = (sourceData == nullptr) ? false :
+				(variablePlaybackSpeed ? (voiceData.TimePositionSec >= FramesToTime(sourceData->Buffer.FrameCount, sourceData->Buffer.SampleRate).ToSec()) :
+				(voiceData.FramePosition >= sourceData->Buffer.FrameCount));
 
-				if (voiceData.SmoothTime.RequestUpdate.exchange(false))
+			if (sourceData == nullptr && (voiceData.Flags & VoiceFlags_RemoveOnEnd))
+				hasReachedEnd = true;
+
+			// NOTE: Also published while paused so that the worker can already decode ahead of wherever playback is going to start
+			if (sourceData != nullptr && sourceData->Stream != nullptr)
+			{
+				const i64 positionFrame = variablePlaybackSpeed ? static_cast<i64>(voiceData.TimePositionSec * sourceData->Buffer.SampleRate) : voiceData.FramePosition.load();
+				sourceData->Stream->ReadCursorFrame.store(positionFrame - (SincResampler::MaxTapCount / 2) - 1, std::memory_order_release);
+			}
+
+			if (voiceData.SmoothTime.RequestUpdate.exchange(false))
+			{
+				voiceData.SmoothTime.BaseCPUTimeTicks = CPUTime::GetNow().Ticks;
+				voiceData.SmoothTime.BaseVoiceTimeSec =
+					variablePlaybackSpeed ? voiceData.TimePositionSec.load() :
+					FramesToTime(voiceData.FramePosition, (sourceData != nullptr) ? sourceData->Buffer.SampleRate : OutputSampleRate).ToSec();
+			}
+
+			if (voiceData.Flags & VoiceFlags_Playing)
+			{
+				if (variablePlaybackSpeed || sampleRateMismatch)
 				{
-					voiceData.SmoothTime.BaseCPUTimeTicks = CPUTime::GetNow().Ticks;
-					voiceData.SmoothTime.BaseVoiceTimeSec =
-						variablePlaybackSpeed ? voiceData.TimePositionSec.load() :
-						FramesToTime(voiceData.FramePosition, (sourceData != nullptr) ? sourceData->Buffer.SampleRate : OutputSampleRate).ToSec();
+					CallbackProcessResampledVoiceSamples(outputBuffer, bufferFrameCount, playPastEnd, hasReachedEnd, voiceData, sourceData, resampler);
 				}
-
-				if (voiceData.Flags & VoiceFlags_Playing)
+				else
 				{
-					if (variablePlaybackSpeed)
-						CallbackProcessVariableSpeedVoiceSamples(outputBuffer, bufferFrameCount, playPastEnd, hasReachedEnd, voiceData, sourceData);
-					else
-						CallbackProcessNormalSpeedVoiceSamples(outputBuffer, bufferFrameCount, playPastEnd, hasReachedEnd, voiceData, sourceData);
+					resampler.IsInSync = false;
+					CallbackProcessNormalSpeedVoiceSamples(outputBuffer, bufferFrameCount, playPastEnd, hasReachedEnd, voiceData, sourceData);
 				}
+			}
 
-				if (hasReachedEnd)
+			if (hasReachedEnd)
+			{
+				if (!playPastEnd && (voiceData.Flags & VoiceFlags_RemoveOnEnd))
 				{
-					if (!playPastEnd && (voiceData.Flags & VoiceFlags_RemoveOnEnd))
-					{
-						voiceData.Flags = VoiceFlags_Dead;
-						continue;
-					}
-					else if (voiceData.Flags & VoiceFlags_PauseOnEnd)
-					{
-						voiceData.Flags &= ~VoiceFlags_Playing;
-						continue;
-					}
+					voiceData.Flags = VoiceFlags_Dead;
+					return false;
+				}
+				else if (voiceData.Flags & VoiceFlags_PauseOnEnd)
+				{
+					voiceData.Flags &= ~VoiceFlags_Playing;
 				}
 			}
 
-			if (soundGroup == 0)
-				TotalRenderedFrames += bufferFrameCount;
+			return true;
 		}
 
 		void CallbackProcessNormalSpeedVoiceSamples(f32* outputBuffer, const u32 bufferFrameCount, const b8 playPastEnd, const b8 hasReachedEnd, VoiceData& voiceData, SourceData* sourceData)
@@ -316,69 +1108,78 @@ namespace Audio
 				return;
 			}
 
+			const i64 startFrame = voiceData.FramePosition;
+			i64 windowStartFrame = 0;
+			PCMSampleBuffer& window = CallbackGetSourceFrameWindow(*sourceData, startFrame, bufferFrameCount, windowStartFrame);
+
 			i64 framesRead = 0;
-			if (sourceData->Buffer.ChannelCount != 0 && sourceData->Buffer.ChannelCount != OutputChannelCount)
-				framesRead = ChannelMixer.MixChannels(sourceData->Buffer, TempOutputBuffer.data(), voiceData.FramePosition, bufferFrameCount);
+			if (window.ChannelCount != 0 && window.ChannelCount != OutputChannelCount)
+				framesRead = ChannelMixer.MixChannels(window, TempOutputBuffer.data(), startFrame - windowStartFrame, bufferFrameCount);
 			else
-				framesRead = sourceData->Buffer.ReadAtOrFillSilence(voiceData.FramePosition, bufferFrameCount, TempOutputBuffer.data());
+				framesRead = window.ReadAtOrFillSilence(startFrame - windowStartFrame, bufferFrameCount, TempOutputBuffer.data());
 
 			voiceData.FramePosition += framesRead;
 			if (hasReachedEnd && !playPastEnd)
 				voiceData.FramePosition = (voiceData.Flags & VoiceFlags_Looping) ? 0 : sourceData->Buffer.FrameCount;
 
-			CallbackApplyVoiceVolumeAndMixTempBufferIntoOutput(outputBuffer, framesRead, voiceData, sourceData->Buffer.SampleRate);
+			CallbackApplyVoiceVolumeAndMixTempBufferIntoOutput(outputBuffer, framesRead, voiceData, static_cast<f64>(startFrame), 1.0);
 		}
 
-		void CallbackProcessVariableSpeedVoiceSamples(f32* outputBuffer, const u32 bufferFrameCount, const b8 playPastEnd, const b8 hasReachedEnd, VoiceData& voiceData, SourceData* sourceData)
+		// NOTE: Used for both variable playback speeds and sources not matching the output sample rate, with both position representations being kept up to date
+		void CallbackProcessResampledVoiceSamples(f32* outputBuffer, const u32 bufferFrameCount, const b8 playPastEnd, const b8 hasReachedEnd, VoiceData& voiceData, SourceData* sourceData, VoiceResamplerState& resampler)
 		{
+			const b8 variablePlaybackSpeed = (voiceData.Flags & VoiceFlags_VariablePlaybackSpeed);
 			const u32 sampleRate = (sourceData != nullptr) ? sourceData->Buffer.SampleRate : OutputSampleRate;
-			const f64 bufferDurationSec = (FramesToTime(bufferFrameCount, sampleRate).ToSec() * voiceData.PlaybackSpeed);
-
-			const i16* rawSamples = (sourceData != nullptr) ? sourceData->Buffer.InterleavedSamples.get() : nullptr;
-
-			if (sourceData == nullptr || rawSamples == nullptr)
-			{
-				voiceData.TimePositionSec = voiceData.TimePositionSec + bufferDurationSec;
-				return;
-			}
+			const f64 playbackSpeed = variablePlaybackSpeed ? static_cast<f64>(voiceData.PlaybackSpeed) : 1.0;
+			const f64 sourceFramesPerOutputFrame = (playbackSpeed * static_cast<f64>(sampleRate) / static_cast<f64>(OutputSampleRate));
 
-			const f64 sampleDurationSec = (1.0 / static_cast<i64>(sampleRate)) * voiceData.PlaybackSpeed;
-			const i64 framesRead = static_cast<i64>(Round(bufferDurationSec / sampleDurationSec));
+			// NOTE: Only resync to the (less precise) voice position if it has been changed since the last buffer, by seeking or switching playback speeds for example
+			const i64 framePosition = voiceData.FramePosition;
+			const f64 timePositionSec = voiceData.TimePositionSec;
+			if (!resampler.IsInSync || framePosition != resampler.LastFramePosition || timePositionSec != resampler.LastTimePositionSec)
+				resampler.Resampler.SetSourcePosition(variablePlaybackSpeed ? (timePositionSec * static_cast<f64>(sampleRate)) : static_cast<f64>(framePosition));
 
-			const size_t providerSampleCount = sourceData->Buffer.SampleCount();
-			const u32 providerChannelCount = sourceData->Buffer.ChannelCount;
+			const f64 startSourceFrame = resampler.Resampler.GetSourcePosition();
+			const b8 hasSamples = (sourceData != nullptr);
 
-			const f64 sampleRateF64 = static_cast<f64>(sampleRate);
-			const f64 voiceStartTimeSec = voiceData.TimePositionSec;
-
-			if (providerChannelCount != OutputChannelCount)
+			if (!hasSamples)
 			{
-				i16* mixBuffer = ChannelMixer.GetMixSampleBufferWithMinSize(framesRead * providerChannelCount);
-
-				for (i64 f = 0; f < framesRead; f++)
-				{
-					const f64 frameTimeSec = voiceStartTimeSec + (f * sampleDurationSec);
-					for (u32 c = 0; c < providerChannelCount; c++)
-						mixBuffer[(f * providerChannelCount) + c] = LinearSampleAtTimeOrZero<i16>(frameTimeSec, c, rawSamples, providerSampleCount, sampleRateF64, providerChannelCount);
-				}
-
-				ChannelMixer.MixChannels(providerChannelCount, mixBuffer, framesRead, TempOutputBuffer.data(), 0, framesRead);
+				resampler.Resampler.SetSourcePosition(startSourceFrame + (bufferFrameCount * sourceFramesPerOutputFrame));
 			}
 			else
 			{
-				for (i64 f = 0; f < framesRead; f++)
+				// NOTE: Covering every frame any of the kernel taps could possibly reach, with the resampler temporarily reading relative to the start of the window
+				const i64 firstTapFrame = static_cast<i64>(Floor(startSourceFrame)) - (SincResampler::MaxTapCount / 2) - 1;
+				const i64 lastTapFrame = static_cast<i64>(Floor(startSourceFrame + (bufferFrameCount * sourceFramesPerOutputFrame))) + (SincResampler::MaxTapCount / 2) + 1;
+				i64 windowStartFrame = 0;
+				const PCMSampleBuffer& window = CallbackGetSourceFrameWindow(*sourceData, firstTapFrame, (lastTapFrame - firstTapFrame) + 1, windowStartFrame);
+				resampler.Resampler.SourceFrame -= windowStartFrame;
+
+				if (window.ChannelCount != OutputChannelCount)
 				{
-					const f64 frameTimeSec = voiceStartTimeSec + (f * sampleDurationSec);
-					for (u32 c = 0; c < OutputChannelCount; c++)
-						TempOutputBuffer[(f * OutputChannelCount) + c] = LinearSampleAtTimeOrZero<i16>(frameTimeSec, c, rawSamples, providerSampleCount, sampleRateF64, OutputChannelCount);
+					const u32 providerChannelCount = window.ChannelCount;
+					i16* mixBuffer = ChannelMixer.GetMixSampleBufferWithMinSize(bufferFrameCount * providerChannelCount);
+
+					resampler.Resampler.Process(window, sourceFramesPerOutputFrame, mixBuffer, bufferFrameCount);
+					ChannelMixer.MixChannels(providerChannelCount, mixBuffer, bufferFrameCount, TempOutputBuffer.data(), 0, bufferFrameCount);
+				}
+				else
+				{
+					resampler.Resampler.Process(window, sourceFramesPerOutputFrame, TempOutputBuffer.data(), bufferFrameCount);
 				}
+
+				resampler.Resampler.SourceFrame += windowStartFrame;
 			}
 
-			voiceData.TimePositionSec = voiceData.TimePositionSec + bufferDurationSec;
-			if (hasReachedEnd && !playPastEnd)
-				voiceData.TimePositionSec = (voiceData.Flags & VoiceFlags_Looping) ? 0.0 : FramesToTime(sourceData->Buffer.FrameCount, sampleRate).ToSec();
+			if (hasSamples && hasReachedEnd && !playPastEnd)
+				resampler.Resampler.SetSourcePosition((voiceData.Flags & VoiceFlags_Looping) ? 0.0 : static_cast<f64>(sourceData->Buffer.FrameCount));
 
-			CallbackApplyVoiceVolumeAndMixTempBufferIntoOutput(outputBuffer, framesRead, voiceData, sampleRate);
+			resampler.IsInSync = true;
+			resampler.LastFramePosition = voiceData.FramePosition = resampler.Resampler.SourceFrame;
+			resampler.LastTimePositionSec = voiceData.TimePositionSec = (resampler.Resampler.GetSourcePosition() / static_cast<f64>(sampleRate));
+
+			if (hasSamples)
+				CallbackApplyVoiceVolumeAndMixTempBufferIntoOutput(outputBuffer, bufferFrameCount, voiceData, startSourceFrame, sourceFramesPerOutputFrame);
 		}
 
 		template <typename T>
@@ -386,23 +1187,24 @@ namespace Audio
 		{
 			const f32 limitMin = (std::is_integral_v<T> || soundGroup == 0) ? I16Min : SoundGroupVolumeLimit * I16Min;
 			const f32 limitMax = (std::is_integral_v<T> || soundGroup == 0) ? I16Max : SoundGroupVolumeLimit * I16Max;
-			std::array<f32, OutputChannelCount> frame;
-			for (size_t f = 0, i = 0; f < frameCount; ++f) {
-				// get gain for all channels first
-				f32 frameMaxValue = 0;
-				for (i32 c = 0; c < OutputChannelCount; ++c) {
-					frame[c] = mixedBuffer[i + c] * preGain;
-					if (std::abs(frame[c]) > std::abs(frameMaxValue))
-						frameMaxValue = frame[c];
-				}
-				auto gain = Limiter[soundGroup].GetGain(frameMaxValue, limitMin, limitMax);
-				// apply gain
-				for (i32 c = 0; c < OutputChannelCount; ++c, ++i) {
-					if constexpr (std::is_integral_v<T>)
-						outputBuffer[i] += ClampSampleI<T>(frame[c] * gain * postGain);
-					else
-						outputBuffer[i] += frame[c] * gain * postGain;
-				}
+
+			// pre-scale in place (all mix buffers are cleared at the start of each callback anyway) and find the peak of each frame
+			ScaleSamplesF32(mixedBuffer, (frameCount * OutputChannelCount), preGain);
+			FindFramePeaksF32(mixedBuffer, frameCount, FrameGainBuffer.data());
+
+			// then compute the limiter gain envelope for the entire block, which has to be done sequentially
+			for (size_t f = 0; f < frameCount; ++f)
+				FrameGainBuffer[f] = Limiter[soundGroup].GetGain(FrameGainBuffer[f], limitMin, limitMax);
+
+			// and finally apply it
+			if constexpr (std::is_integral_v<T>)
+			{
+				static_assert(std::is_same_v<T, i16>);
+				MixSamplesF32IntoI16PerFrameGainClamped(outputBuffer, mixedBuffer, frameCount, FrameGainBuffer.data(), postGain);
+			}
+			else
+			{
+				MixSamplesF32IntoF32PerFrameGain(outputBuffer, mixedBuffer, frameCount, FrameGainBuffer.data(), postGain);
 			}
 		}
 
@@ -437,6 +1239,7 @@ namespace Audio
 		void OnOpenStream()
 		{
 			RequestUpdateSmoothTimeForAllAliveVoices();
+			LastCallbackBufferFrameCount = 0;
 		}
 
 		void OnCloseStream()
@@ -457,21 +1260,32 @@ namespace Audio
 			CallbackFrequency = (CallbackStreamTime - LastCallbackStreamTime);
 			LastCallbackStreamTime = CallbackStreamTime;
 
+			const b8 isLateCallback = (LastCallbackBufferFrameCount > 0) && (CallbackFrequency > (FramesToTime(LastCallbackBufferFrameCount, OutputSampleRate) * LateCallbackThresholdFactor));
+			LastCallbackBufferFrameCount = bufferFrameCount;
+
+			CallbackConsumeAllVoiceCommands();
+			CallbackStartDueScheduledSounds(bufferFrameCount);
+
 			CallbackClearOutBuffer(outputBuffer, bufferSampleCount);
 			CallbackClearOutBuffer(MasterBuffer.data(), bufferSampleCount);
+			for (i32 g = 1; g < MaxSoundGroups; ++g)
+				CallbackClearOutBuffer(GetSoundGroupRenderBuffer(g), bufferSampleCount);
 
-			// render each sound group separately, adjust volume, and then to master (except group 0)
-			for (i32 g = 1; g < MaxSoundGroups; ++g) {
-				CallbackClearOutBuffer(SoundGroupBuffer.data(), bufferSampleCount);
-				CallbackProcessVoices(SoundGroupBuffer.data(), bufferFrameCount, bufferSampleCount, g);
-				CallbackAdjustVolumeAndMix(MasterBuffer.data(), SoundGroupBuffer.data(), bufferFrameCount, 1, SoundGroupVolume[g], g);
-			}
+			// render all voices at once into the buffer of their sound group (with group 0 or any invalid group rendering directly to master)
+			CallbackProcessVoices(bufferFrameCount);
+
+			// then adjust the volume of each sound group separately and mix to master (except group 0)
+			for (i32 g = 1; g < MaxSoundGroups; ++g)
+				CallbackAdjustVolumeAndMix(MasterBuffer.data(), GetSoundGroupRenderBuffer(g), bufferFrameCount, 1, SoundGroupVolume[g], g);
 
-			// sound group 0 (or any invalid group) renders directly to master
-			CallbackProcessVoices(MasterBuffer.data(), bufferFrameCount, bufferSampleCount, 0);
 			CallbackAdjustVolumeAndMix(outputBuffer, MasterBuffer.data(), bufferFrameCount, SoundGroupVolume[0], 1, 0);
 			CallbackUpdateLastPlayedSamplesRingBuffer(outputBuffer, bufferFrameCount);
-			CallbackUpdateCallbackDurationRingBuffer(stopwatch.Stop());
+
+			const Time renderDuration = stopwatch.Stop();
+			if (isLateCallback || renderDuration > FramesToTime(bufferFrameCount, OutputSampleRate))
+				LateCallbackCount++;
+
+			CallbackUpdateCallbackDurationRingBuffer(renderDuration);
 		}
 	};
 
@@ -490,17 +1304,24 @@ namespace Audio
 	{
 		assert(impl == nullptr && "ApplicationStartup() has already been called (?)");
 		impl = std::make_unique<Impl>();
+		impl->InitializeFreeVoiceList();
 
 		SetBackend(Backend::Default);
 		impl->ChannelMixer.TargetChannels = OutputChannelCount;
 		impl->ChannelMixer.MixingBehavior = ChannelMixingBehavior::Combine;
 		impl->ChannelMixer.MixBuffer.reserve(MaxBufferFrameCount * OutputChannelCount);
+
+		// NOTE: Build the kernel table up front instead of inside the first render callback needing it
+		SincResamplerKernelTable::Get();
 	}
 
 	void AudioEngine::ApplicationShutdown()
 	{
 		if (impl != nullptr)
+		{
 			StopCloseStream();
+			impl->StopStreamingWorkerThread();
+		}
 		impl = nullptr;
 	}
 
@@ -523,13 +1344,25 @@ namespace Audio
 
 		impl->OnOpenStream();
 
+		// NOTE: Hand the command queue over to the render thread before it could possibly start calling back
+		const auto lock = std::scoped_lock(impl->ProducerMutex);
+		impl->RenderThreadConsumesCommands = true;
+
 		const b8 openStreamSuccess = impl->CurrentBackend->OpenStartStream(streamParam, [this](i16* outputBuffer, const u32 bufferFrameCount, const u32 bufferChannelCount)
 		{
 			impl->RenderAudioCallback(outputBuffer, bufferFrameCount, bufferChannelCount);
 		});
 
 		if (openStreamSuccess)
+		{
 			impl->StreamTimeStopwatch.Restart();
+		}
+		else
+		{
+			impl->RenderThreadConsumesCommands = false;
+			impl->ConsumeAllVoiceCommands();
+			impl->ConsumeAllOverflowCommands();
+		}
 
 		impl->IsStreamOpenRunning = openStreamSuccess;
 	}
@@ -542,6 +1375,14 @@ namespace Audio
 		if (impl->CurrentBackend != nullptr)
 			impl->CurrentBackend->StopCloseStream();
 
+		// NOTE: With the render thread no longer running take back ownership of the voices, including any commands it didn't get around to
+		{
+			const auto lock = std::scoped_lock(impl->ProducerMutex);
+			impl->RenderThreadConsumesCommands = false;
+			impl->ConsumeAllVoiceCommands();
+			impl->ConsumeAllOverflowCommands();
+		}
+
 		impl->OnCloseStream();
 		impl->StreamTimeStopwatch.Stop();
 
@@ -586,27 +1427,51 @@ namespace Audio
 
 	SourceHandle AudioEngine::LoadSourceFromBufferMove(std::string_view sourceName, PCMSampleBuffer bufferToMove)
 	{
-		const auto lock = std::scoped_lock(impl->VoiceRenderMutex);
-		for (HandleBaseType index = 0; index < static_cast<HandleBaseType>(impl->LoadedSources.size()); index++)
-		{
-			const SourceHandle handleIt = IndexToSourceHandle(index);
-			SourceData& sourceData = impl->LoadedSources[index];
-			if (sourceData.SlotUsed)
-				continue;
-
-			sourceData.SlotUsed = true;
-			sourceData.Buffer = std::move(bufferToMove);
-			sourceData.BaseVolume = 1.0f;
-			CopyStringViewIntoFixedBuffer(sourceData.Name, sourceName);
+		return impl->AllocateSourceSlot(sourceName, std::move(bufferToMove), nullptr);
+	}
 
-			return static_cast<SourceHandle>(index);
-		}
+	SourceHandle AudioEngine::LoadStreamingSourceFromFileContent(std::string_view fileName, std::shared_ptr<const u8[]> fileContent, size_t fileSize)
+	{
+		auto stream = std::make_shared<StreamingSourceData>();
+		if (stream->Decoder.OpenMemory(fileName, fileContent.get(), fileSize) != DecodeFileResult::FeelsGoodMan)
+			return SourceHandle::Invalid;
 
-#if PEEPO_DEBUG
-		assert(!"Consider increasing MaxLoadedSources");
-#endif
+		const u32 channelCount = stream->Decoder.GetChannelCount();
+		const u32 sampleRate = stream->Decoder.GetSampleRate();
+		stream->FileContent = std::move(fileContent);
+		stream->FileSize = fileSize;
+		stream->ChannelCount = channelCount;
+		stream->FrameCount = stream->Decoder.GetFrameCount();
+		stream->DecoderFramePosition = 0;
+		stream->DecodeScratchSamples = std::make_unique<i16[]>(Impl::StreamingDecodeChunkFrameCount * channelCount);
+
+		// NOTE: The ring has to be able to hold at least the largest possible render window (plus what is kept behind the cursor) to ever make progress
+		stream->RingFrameCapacity = Max(TimeToFrames(Impl::StreamingRingBufferDuration, sampleRate), Impl::StreamingRenderWindowFrameCapacity * 2);
+		stream->RingSamples = std::make_unique<i16[]>(stream->RingFrameCapacity * channelCount);
+		stream->RingStartFrame = 0;
+		stream->RingEndFrame = 0;
+		stream->RingResetCount = 0;
+		stream->ReadCursorFrame = 0;
+
+		stream->RenderWindowFrameCapacity = Impl::StreamingRenderWindowFrameCapacity;
+		stream->RenderWindow.ChannelCount = channelCount;
+		stream->RenderWindow.SampleRate = sampleRate;
+		stream->RenderWindow.FrameCount = 0;
+		stream->RenderWindow.InterleavedSamples = std::make_unique<i16[]>(stream->RenderWindowFrameCapacity * channelCount);
+
+		PCMSampleBuffer formatOnlyBuffer = {};
+		formatOnlyBuffer.ChannelCount = channelCount;
+		formatOnlyBuffer.SampleRate = sampleRate;
+		formatOnlyBuffer.FrameCount = stream->FrameCount;
+
+		const SourceHandle source = impl->AllocateSourceSlot(fileName, std::move(formatOnlyBuffer), stream);
+		if (source == SourceHandle::Invalid)
+			return SourceHandle::Invalid;
 
-		return SourceHandle::Invalid;
+		const auto lock = std::scoped_lock(impl->StreamingSourcesMutex);
+		impl->StreamingSources.push_back(std::move(stream));
+		impl->StartStreamingWorkerThreadIfNotRunning();
+		return source;
 	}
 
 	void AudioEngine::UnloadSource(SourceHandle source)
@@ -614,17 +1479,21 @@ namespace Audio
 		if (source == SourceHandle::Invalid)
 			return;
 
-		const auto lock = std::scoped_lock(impl->VoiceRenderMutex);
+		const auto lock = std::scoped_lock(impl->ProducerMutex);
 		SourceData* sourceData = impl->TryGetSourceData(source, Impl::GetSourceDataParam::None);
 		if (sourceData == nullptr)
 			return;
 
-		sourceData->SlotUsed = false;
-		for (VoiceData& voice : impl->VoicePool)
+		if (sourceData->Stream != nullptr)
 		{
-			if ((voice.Flags & VoiceFlags_Alive) && voice.Source == source)
-				voice.Source = SourceHandle::Invalid;
+			const auto streamingLock = std::scoped_lock(impl->StreamingSourcesMutex);
+			erase_remove_if(impl->StreamingSources, [&](const auto& stream) { return (stream == sourceData->Stream); });
 		}
+
+		// NOTE: The buffer itself stays alive until the slot is reused, which won't happen before the render thread has stopped referencing it
+		sourceData->SlotUsed = false;
+		sourceData->PendingRenderRelease = true;
+		impl->PushVoiceCommand(VoiceCommand { VoiceCommandType::UnloadSource, SourceHandleToIndex(source) });
 	}
 
 	const PCMSampleBuffer* AudioEngine::GetSourceSampleBufferView(SourceHandle source)
@@ -655,35 +1524,18 @@ namespace Audio
 
 	VoiceHandle AudioEngine::AddVoice(SourceHandle source, std::string_view name, b8 playing, f32 volume, f32 pan, b8 playPastEnd, i32 soundGroup)
 	{
-		const auto lock = std::scoped_lock(impl->VoiceRenderMutex);
+		const auto lock = std::scoped_lock(impl->ProducerMutex);
 
-		for (size_t i = 0; i < impl->VoicePool.size(); i++)
-		{
-			VoiceData& voiceToUpdate = impl->VoicePool[i];
-			if (voiceToUpdate.Flags & VoiceFlags_Alive)
-				continue;
-
-			voiceToUpdate.Flags = VoiceFlags_Alive;
-			if (playing) voiceToUpdate.Flags |= VoiceFlags_Playing;
-			if (playPastEnd) voiceToUpdate.Flags |= VoiceFlags_PlayPastEnd;
-
-			voiceToUpdate.Source = source;
-			voiceToUpdate.SoundGroup = soundGroup;
-			voiceToUpdate.Volume = volume;
-			voiceToUpdate.Pan = pan;
-			voiceToUpdate.FramePosition = 0;
-			voiceToUpdate.VolumeMap.StartVolume = 0.0f;
-			voiceToUpdate.VolumeMap.EndVolume = 0.0f;
-			CopyStringViewIntoFixedBuffer(voiceToUpdate.Name, name);
-
-			return static_cast<VoiceHandle>(i);
-		}
+		VoiceFlags flags = VoiceFlags_Alive;
+		if (playing) flags |= VoiceFlags_Playing;
+		if (playPastEnd) flags |= VoiceFlags_PlayPastEnd;
 
+		const VoiceHandle handle = impl->AllocateAndAddVoice(flags, source, name, volume, pan, soundGroup);
 #if PEEPO_DEBUG
-		assert(!"Consider increasing MaxSimultaneousVoices");
+		assert(handle != VoiceHandle::Invalid && "Consider increasing MaxSimultaneousVoices");
 #endif
 
-		return VoiceHandle::Invalid;
+		return handle;
 	}
 
 	void AudioEngine::RemoveVoice(VoiceHandle voice)
@@ -691,37 +1543,63 @@ namespace Audio
 		if (voice == VoiceHandle::Invalid)
 			return;
 
-		// TODO: Think these locks through again
-		const auto lock = std::scoped_lock(impl->VoiceRenderMutex);
+		const auto lock = std::scoped_lock(impl->ProducerMutex);
 
+		// NOTE: Immediately stop rendering the voice, with the slot only being released once the render thread has processed the command
 		VoiceData* voiceData = impl->TryGetVoiceData(voice);
 		if (voiceData != nullptr)
+		{
 			voiceData->Flags = VoiceFlags_Dead;
+			impl->PushVoiceCommand(VoiceCommand { VoiceCommandType::RemoveVoice, VoiceHandleToIndex(voice) });
+		}
 	}
 
-	void AudioEngine::PlayOneShotSound(SourceHandle source, std::string_view name, f32 volume, f32 pan, i32 soundGroup)
+	b8 AudioEngine::PlayOneShotSound(SourceHandle source, std::string_view name, f32 volume, f32 pan, i32 soundGroup)
 	{
 		if (source == SourceHandle::Invalid)
-			return;
+			return false;
+
+		const auto lock = std::scoped_lock(impl->ProducerMutex);
+		return (impl->AllocateAndAddVoice(VoiceFlags_Alive | VoiceFlags_Playing | VoiceFlags_RemoveOnEnd, source, name, volume, pan, soundGroup) != VoiceHandle::Invalid);
+	}
 
-		const auto lock = std::scoped_lock(impl->VoiceRenderMutex);
+	void AudioEngine::ScheduleSounds(VoiceHandle clockVoice, const ScheduledSound* sounds, size_t soundCount)
+	{
+		const auto lock = std::scoped_lock(impl->ProducerMutex);
+		if (impl->TryGetVoiceData(clockVoice) == nullptr)
+			return;
 
-		for (VoiceData& voiceToUpdate : impl->VoicePool)
+		for (size_t i = 0; i < soundCount; i++)
 		{
-			if (voiceToUpdate.Flags & VoiceFlags_Alive)
-				continue;
+			const ScheduledSound& sound = sounds[i];
+			impl->PushVoiceCommand(VoiceCommand { VoiceCommandType::ScheduleSound, VoiceHandleToIndex(clockVoice), VoiceParamBatch {}
+				.SetPosition(sound.ClockTime)
+				.SetSource(sound.Source)
+				.SetVolume(sound.Volume)
+				.SetPan(sound.Pan)
+				.SetSoundGroup(sound.SoundGroup) });
+		}
+	}
+
+	void AudioEngine::ClearScheduledSounds()
+	{
+		const auto lock = std::scoped_lock(impl->ProducerMutex);
+		impl->PushVoiceCommand(VoiceCommand { VoiceCommandType::ClearScheduledSounds });
+	}
 
-			voiceToUpdate.Flags = VoiceFlags_Alive | VoiceFlags_Playing | VoiceFlags_RemoveOnEnd;
-			voiceToUpdate.Source = source;
-			voiceToUpdate.SoundGroup = soundGroup;
-			voiceToUpdate.Volume = volume;
-			voiceToUpdate.Pan = pan;
-			voiceToUpdate.FramePosition = 0;
-			voiceToUpdate.VolumeMap.StartVolume = 0.0f;
-			voiceToUpdate.VolumeMap.EndVolume = 0.0f;
-			CopyStringViewIntoFixedBuffer(voiceToUpdate.Name, name);
+	void AudioEngine::RenderOffline(i16* outputBuffer, u32 bufferFrameCount)
+	{
+		assert(!impl->IsStreamOpenRunning);
+		if (impl->IsStreamOpenRunning)
 			return;
-		}
+
+		// NOTE: With the stream stopped all commands are applied immediately by the producer, which is therefore also what the render has to be serialized with
+		const auto lock = std::scoped_lock(impl->ProducerMutex);
+		const u32 bufferFrameSizeBefore = impl->CurrentBufferFrameSize;
+		impl->IsRenderingOffline = true;
+		impl->RenderAudioCallback(outputBuffer, Min(bufferFrameCount, MaxBufferFrameCount), OutputChannelCount);
+		impl->IsRenderingOffline = false;
+		impl->CurrentBufferFrameSize = bufferFrameSizeBefore;
 	}
 
 	Backend AudioEngine::GetBackend() const
@@ -817,7 +1695,7 @@ namespace Audio
 		{
 			const VoiceData& voice = impl->VoicePool[i];
 			if (voice.Flags & VoiceFlags_Alive)
-				out.Slots[out.Count++] = static_cast<VoiceHandle>(i);
+				out.Slots[out.Count++] = IndexToVoiceHandle(static_cast<HandleBaseType>(i), voice.Generation);
 		}
 		return out;
 	}
@@ -849,11 +1727,45 @@ namespace Audio
 		return instanceCount;
 	}
 
+	size_t AudioEngine::DebugGetSourceMemoryByteSize(SourceHandle source)
+	{
+		const SourceData* sourceData = impl->TryGetSourceData(source, Impl::GetSourceDataParam::None);
+		if (sourceData == nullptr)
+			return 0;
+
+		const StreamingSourceData* stream = sourceData->Stream.get();
+		if (stream == nullptr)
+			return (sourceData->Buffer.InterleavedSamples != nullptr) ? sourceData->Buffer.ByteSize() : 0;
+
+		const size_t decodeBufferFrameCount = (Impl::StreamingDecodeChunkFrameCount + stream->RingFrameCapacity + stream->RenderWindowFrameCapacity);
+		return stream->FileSize + (decodeBufferFrameCount * stream->ChannelCount * sizeof(i16));
+	}
+
+	i64 AudioEngine::DebugGetSourceDecodedFrameCount(SourceHandle source)
+	{
+		const SourceData* sourceData = impl->TryGetSourceData(source, Impl::GetSourceDataParam::ValidateBuffer);
+		if (sourceData == nullptr)
+			return 0;
+
+		const StreamingSourceData* stream = sourceData->Stream.get();
+		return (stream != nullptr) ? (stream->RingEndFrame.load() - stream->RingStartFrame.load()) : sourceData->Buffer.FrameCount;
+	}
+
 	std::array<Time, AudioEngine::CallbackDurationRingBufferSize> AudioEngine::DebugGetRenderPerformanceHistory()
 	{
 		return impl->CallbackDurationsRingBuffer;
 	}
 
+	i64 AudioEngine::DebugGetLateCallbackCount() const
+	{
+		return impl->LateCallbackCount;
+	}
+
+	i64 AudioEngine::DebugGetSkippedScheduledSoundCount() const
+	{
+		return impl->SkippedScheduledSoundCount;
+	}
+
 	std::array<std::array<i16, AudioEngine::LastPlayedSamplesRingBufferFrameCount>, AudioEngine::OutputChannelCount> AudioEngine::DebugGetLastPlayedSamples()
 	{
 		return impl->LastPlayedSamplesRingBuffer;
@@ -865,29 +1777,22 @@ namespace Audio
 		return (impl->TryGetVoiceData(Handle) != nullptr);
 	}
 
-	template <typename T, auto VoiceData::* Memb, typename Impl>
+	template <typename T, auto VoiceData::* Memb, auto VoiceData::PendingStateData::* PendingMemb, VoiceParamBatch::FieldFlags Field, typename Impl>
 	T GetVoiceDataGeneric(const Audio::Voice& self, Impl&& impl, T&& dflt)
 	{
 		if (VoiceData* voice = impl->TryGetVoiceData(self.Handle); voice != nullptr)
-			return voice->*Memb;
+			return voice->PendingState.IsPending(Field) ? (voice->PendingState.*PendingMemb).load() : (voice->*Memb).load();
 		return dflt;
 	}
 
-	template <auto VoiceData::* Memb, typename T, typename Impl>
-	void SetVoiceDataGeneric(Audio::Voice& self, Impl&& impl, T&& value)
-	{
-		if (VoiceData* voice = impl->TryGetVoiceData(self.Handle); voice != nullptr)
-			voice->*Memb = value;
-	}
+	i32 Voice::GetSoundGroup() const { return GetVoiceDataGeneric<i32, &VoiceData::SoundGroup, &VoiceData::PendingStateData::SoundGroup, VoiceParamBatch::Field_SoundGroup>(*this, Engine.impl, 0); }
+	void Voice::SetSoundGroup(i32 value) { SetParams(VoiceParamBatch {}.SetSoundGroup(value)); }
 
-	i32 Voice::GetSoundGroup() const { return GetVoiceDataGeneric<i32, &VoiceData::SoundGroup>(*this, Engine.impl, 0); }
-	void Voice::SetSoundGroup(i32 value) { return SetVoiceDataGeneric<&VoiceData::SoundGroup>(*this, Engine.impl, value); }
+	f32 Voice::GetVolume() const { return GetVoiceDataGeneric<f32, &VoiceData::Volume, &VoiceData::PendingStateData::Volume, VoiceParamBatch::Field_Volume>(*this, Engine.impl, 0.0f); }
+	void Voice::SetVolume(f32 value) { SetParams(VoiceParamBatch {}.SetVolume(value)); }
 
-	f32 Voice::GetVolume() const { return GetVoiceDataGeneric<f32, &VoiceData::Volume>(*this, Engine.impl, 0.0f); }
-	void Voice::SetVolume(f32 value) { SetVoiceDataGeneric<&VoiceData::Volume>(*this, Engine.impl, value); }
-
-	f32 Voice::GetPan() const { return GetVoiceDataGeneric<f32, &VoiceData::Pan>(*this, Engine.impl, 0.0f); }
-	void Voice::SetPan(f32 value) { SetVoiceDataGeneric<&VoiceData::Pan>(*this, Engine.impl, value); }
+	f32 Voice::GetPan() const { return GetVoiceDataGeneric<f32, &VoiceData::Pan, &VoiceData::PendingStateData::Pan, VoiceParamBatch::Field_Pan>(*this, Engine.impl, 0.0f); }
+	void Voice::SetPan(f32 value) { SetParams(VoiceParamBatch {}.SetPan(value)); }
 
 	f32 Voice::GetPlaybackSpeed() const
 	{
@@ -895,6 +1800,8 @@ namespace Audio
 
 		if (const VoiceData* voice = impl->TryGetVoiceData(Handle); voice != nullptr)
 		{
+			if (voice->PendingState.IsPending(VoiceParamBatch::Field_PlaybackSpeed))
+				return voice->PendingState.PlaybackSpeed;
 			if (voice->Flags & VoiceFlags_VariablePlaybackSpeed)
 				return voice->PlaybackSpeed;
 		}
@@ -903,31 +1810,7 @@ namespace Audio
 
 	void Voice::SetPlaybackSpeed(f32 value)
 	{
-		auto& impl = Engine.impl;
-
-		if (VoiceData* voice = impl->TryGetVoiceData(Handle); voice != nullptr)
-		{
-			const SourceData* source = impl->TryGetSourceData(voice->Source, AudioEngine::Impl::GetSourceDataParam::ValidateBuffer);
-			const u32 sampleRate = (source != nullptr) ? source->Buffer.SampleRate : AudioEngine::OutputSampleRate;
-
-			if (ApproxmiatelySame(value, 1.0f))
-			{
-				if (voice->Flags & VoiceFlags_VariablePlaybackSpeed)
-					voice->FramePosition = TimeToFrames(Time::FromSec(voice->TimePositionSec), sampleRate);
-
-				voice->Flags &= ~VoiceFlags_VariablePlaybackSpeed;
-			}
-			else
-			{
-				if (!(voice->Flags & VoiceFlags_VariablePlaybackSpeed))
-					voice->TimePositionSec = FramesToTime(voice->FramePosition, sampleRate).ToSec();
-
-				voice->Flags |= VoiceFlags_VariablePlaybackSpeed;
-			}
-
-			voice->PlaybackSpeed = value;
-			voice->SmoothTime.RequestUpdate = true;
-		}
+		SetParams(VoiceParamBatch {}.SetPlaybackSpeed(value));
 	}
 
 	Time Voice::GetPosition() const
@@ -936,6 +1819,9 @@ namespace Audio
 
 		if (VoiceData* voice = impl->TryGetVoiceData(Handle); voice != nullptr)
 		{
+			if (voice->PendingState.IsPending(VoiceParamBatch::Field_Position))
+				return Time::FromSec(voice->PendingState.PositionSec);
+
 			const SourceData* source = impl->TryGetSourceData(voice->Source, AudioEngine::Impl::GetSourceDataParam::ValidateBuffer);
 			const u32 sampleRate = (source != nullptr) ? source->Buffer.SampleRate : AudioEngine::OutputSampleRate;
 
@@ -953,7 +1839,10 @@ namespace Audio
 
 		if (const VoiceData* voice = impl->TryGetVoiceData(Handle); voice != nullptr)
 		{
-			if ((voice->Flags & VoiceFlags_Playing) && !voice->SmoothTime.RequestUpdate)
+			// NOTE: The smooth time is only (re)based by the render thread once the pending state has been applied
+			const auto& pending = voice->PendingState;
+			const b8 hasPendingState = (pending.IsPending(VoiceParamBatch::Field_Position) || pending.IsPending(VoiceParamBatch::Field_IsPlaying) || pending.IsPending(VoiceParamBatch::Field_PlaybackSpeed));
+			if ((voice->Flags & VoiceFlags_Playing) && !voice->SmoothTime.RequestUpdate && !hasPendingState)
 			{
 				const f64 playbackSpeed = (voice->Flags & VoiceFlags_VariablePlaybackSpeed) ? voice->PlaybackSpeed.load() : 1.0;
 
@@ -976,20 +1865,11 @@ namespace Audio
 
 	void Voice::SetPosition(Time value)
 	{
-		auto& impl = Engine.impl;
-
-		if (VoiceData* voice = impl->TryGetVoiceData(Handle); voice != nullptr)
-		{
-			const SourceData* source = impl->TryGetSourceData(voice->Source, AudioEngine::Impl::GetSourceDataParam::ValidateBuffer);
-			const u32 sampleRate = (source != nullptr) ? source->Buffer.SampleRate : AudioEngine::OutputSampleRate;
-			voice->FramePosition = TimeToFrames(value, sampleRate);
-			voice->TimePositionSec = value.ToSec();
-			voice->SmoothTime.RequestUpdate = true;
-		}
+		SetParams(VoiceParamBatch {}.SetPosition(value));
 	}
 
-	SourceHandle Voice::GetSource() const { return GetVoiceDataGeneric<SourceHandle, &VoiceData::Source>(*this, Engine.impl, SourceHandle::Invalid); }
-	void Voice::SetSource(SourceHandle value) { SetVoiceDataGeneric<&VoiceData::Source>(*this, Engine.impl, value); }
+	SourceHandle Voice::GetSource() const { return GetVoiceDataGeneric<SourceHandle, &VoiceData::Source, &VoiceData::PendingStateData::Source, VoiceParamBatch::Field_Source>(*this, Engine.impl, SourceHandle::Invalid); }
+	void Voice::SetSource(SourceHandle value) { SetParams(VoiceParamBatch {}.SetSource(value)); }
 
 	Time Voice::GetSourceDuration() const
 	{
@@ -997,7 +1877,7 @@ namespace Audio
 
 		if (const VoiceData* voice = impl->TryGetVoiceData(Handle); voice != nullptr)
 		{
-			if (const SourceData* source = impl->TryGetSourceData(voice->Source, AudioEngine::Impl::GetSourceDataParam::ValidateBuffer); source != nullptr)
+			if (const SourceData* source = impl->TryGetSourceData(GetSource(), AudioEngine::Impl::GetSourceDataParam::ValidateBuffer); source != nullptr)
 				return FramesToTime(source->Buffer.FrameCount, source->Buffer.SampleRate);
 		}
 		return Time::Zero();
@@ -1005,58 +1885,62 @@ namespace Audio
 
 	b8 Voice::GetIsPlaying() const
 	{
+		if (const VoiceData* voice = Engine.impl->TryGetVoiceData(Handle); voice != nullptr && voice->PendingState.IsPending(VoiceParamBatch::Field_IsPlaying))
+			return voice->PendingState.IsPlaying;
 		return GetInternalFlag(VoiceFlags_Playing);
 	}
 
 	void Voice::SetIsPlaying(b8 value)
 	{
-		// TODO: Allow manual render thread locking from outside code to then be used for playback sounds
-		//		 This should then become lockfree again!
-
-		// HACK: Prevent randomly "stacking" playback button sounds... need to find a better solution, definitely don't want any locks like this
-		const auto lock = std::scoped_lock(Engine.impl->VoiceRenderMutex);
-
-		SetInternalFlag(VoiceFlags_Playing, value);
+		SetParams(VoiceParamBatch {}.SetIsPlaying(value));
 	}
 
 	b8 Voice::GetIsLooping() const
 	{
+		if (const VoiceData* voice = Engine.impl->TryGetVoiceData(Handle); voice != nullptr && voice->PendingState.IsPending(VoiceParamBatch::Field_IsLooping))
+			return voice->PendingState.IsLooping;
 		return GetInternalFlag(VoiceFlags_Looping);
 	}
 
 	void Voice::SetIsLooping(b8 value)
 	{
-		SetInternalFlag(VoiceFlags_Looping, value);
+		SetParams(VoiceParamBatch {}.SetIsLooping(value));
 	}
 
 	b8 Voice::GetPlayPastEnd() const
 	{
+		if (const VoiceData* voice = Engine.impl->TryGetVoiceData(Handle); voice != nullptr && voice->PendingState.IsPending(VoiceParamBatch::Field_PlayPastEnd))
+			return voice->PendingState.PlayPastEnd;
 		return GetInternalFlag(VoiceFlags_PlayPastEnd);
 	}
 
 	void Voice::SetPlayPastEnd(b8 value)
 	{
-		SetInternalFlag(VoiceFlags_PlayPastEnd, value);
+		SetParams(VoiceParamBatch {}.SetPlayPastEnd(value));
 	}
 
 	b8 Voice::GetRemoveOnEnd() const
 	{
+		if (const VoiceData* voice = Engine.impl->TryGetVoiceData(Handle); voice != nullptr && voice->PendingState.IsPending(VoiceParamBatch::Field_RemoveOnEnd))
+			return voice->PendingState.RemoveOnEnd;
 		return GetInternalFlag(VoiceFlags_RemoveOnEnd);
 	}
 
 	void Voice::SetRemoveOnEnd(b8 value)
 	{
-		SetInternalFlag(VoiceFlags_RemoveOnEnd, value);
+		SetParams(VoiceParamBatch {}.SetRemoveOnEnd(value));
 	}
 
 	b8 Voice::GetPauseOnEnd() const
 	{
+		if (const VoiceData* voice = Engine.impl->TryGetVoiceData(Handle); voice != nullptr && voice->PendingState.IsPending(VoiceParamBatch::Field_PauseOnEnd))
+			return voice->PendingState.PauseOnEnd;
 		return GetInternalFlag(VoiceFlags_PauseOnEnd);
 	}
 
 	void Voice::SetPauseOnEnd(b8 value)
 	{
-		SetInternalFlag(VoiceFlags_PauseOnEnd, value);
+		SetParams(VoiceParamBatch {}.SetPauseOnEnd(value));
 	}
 
 	std::string_view Voice::GetName() const
@@ -1070,28 +1954,23 @@ namespace Audio
 
 	void Voice::ResetVolumeMap()
 	{
-		if (VoiceData* voice = Engine.impl->TryGetVoiceData(Handle); voice != nullptr)
-		{
-			voice->VolumeMap.StartFrame = 0;
-			voice->VolumeMap.EndFrame = 0;
-			voice->VolumeMap.StartVolume = 0.0f;
-			voice->VolumeMap.EndVolume = 0.0f;
-		}
+		SetParams(VoiceParamBatch {}.SetVolumeMap(Time::Zero(), Time::Zero(), 0.0f, 0.0f));
 	}
 
 	void Voice::SetVolumeMap(Time startTime, Time endTime, f32 startVolume, f32 endVolume)
+	{
+		SetParams(VoiceParamBatch {}.SetVolumeMap(startTime, endTime, startVolume, endVolume));
+	}
+
+	void Voice::SetParams(const VoiceParamBatch& params)
 	{
 		auto& impl = Engine.impl;
 
+		const auto lock = std::scoped_lock(impl->ProducerMutex);
 		if (VoiceData* voice = impl->TryGetVoiceData(Handle); voice != nullptr)
 		{
-			const SourceData* source = impl->TryGetSourceData(voice->Source, AudioEngine::Impl::GetSourceDataParam::ValidateBuffer);
-			const u32 sampleRate = (source != nullptr) ? source->Buffer.SampleRate : AudioEngine::OutputSampleRate;
-
-			voice->VolumeMap.StartFrame = TimeToFrames(startTime, sampleRate);
-			voice->VolumeMap.EndFrame = TimeToFrames(endTime, sampleRate);
-			voice->VolumeMap.StartVolume = startVolume;
-			voice->VolumeMap.EndVolume = endVolume;
+			impl->AcquireVoicePendingState(*voice, params);
+			impl->PushVoiceCommand(VoiceCommand { VoiceCommandType::SetParams, VoiceHandleToIndex(Handle), params });
 		}
 	}
 
@@ -1104,21 +1983,4 @@ namespace Audio
 			return (voice->Flags & voiceFlag);
 		return false;
 	}
-
-	void Voice::SetInternalFlag(u16 flag, b8 value)
-	{
-		static_assert(sizeof(flag) == sizeof(VoiceFlags));
-		const auto voiceFlag = static_cast<VoiceFlags>(flag);
-
-		if (VoiceData* voice = Engine.impl->TryGetVoiceData(Handle); voice != nullptr)
-		{
-			if (value)
-				voice->Flags |= voiceFlag;
-			else
-				voice->Flags &= ~voiceFlag;
-
-			if (flag & VoiceFlags_Playing)
-				voice->SmoothTime.RequestUpdate = true;
-		}
-	}
 }
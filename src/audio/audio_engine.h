@@ -11,16 +11,72 @@
 // NOTE: Terminology:
 //		 "Sample" -> Raw PCM value for a single point in time
 //		 "Frame"  -> Pair of samples for each channel
-//		 "Source" -> Buffer of decoded samples (or potentially a file stream)
+//		 "Source" -> Buffer of decoded samples (or a file stream decoded on demand)
 //		 "Voice"  -> Instance of a source, rendered to the output stream
 namespace Audio
 {
 	// NOTE: Opaque types for referncing data stored in the AudioEngine, internally interpreted as in index.
-	//		 A genertion ID could easily be tagged on for extra safety but so far it hasn't felt necessary
+	//		 Voice slots are recycled far more often (one-shot sounds) so their handles also carry the generation of the slot in the upper bits,
+	//		 with a handle kept around after its voice has been removed no longer resolving to whichever voice reuses the slot next
 	using HandleBaseType = u16;
-	enum class VoiceHandle : HandleBaseType { Invalid = 0xFFFF };
+	enum class VoiceHandle : u32 { Invalid = 0xFFFFFFFF };
 	enum class SourceHandle : HandleBaseType { Invalid = 0xFFFF };
 
+	// NOTE: Set of voice parameters to be applied all at once by the render thread at the start of the next buffer,
+	//		 so that for example changing the source and position of a voice can't ever be heard "half applied"
+	struct VoiceParamBatch
+	{
+		using FieldFlags = u16;
+		enum FieldFlagsEnum : FieldFlags
+		{
+			Field_None = 0,
+			Field_Source = 1 << 0,
+			Field_SoundGroup = 1 << 1,
+			Field_Volume = 1 << 2,
+			Field_Pan = 1 << 3,
+			Field_PlaybackSpeed = 1 << 4,
+			Field_Position = 1 << 5,
+			Field_VolumeMap = 1 << 6,
+			Field_IsPlaying = 1 << 7,
+			Field_IsLooping = 1 << 8,
+			Field_PlayPastEnd = 1 << 9,
+			Field_RemoveOnEnd = 1 << 10,
+			Field_PauseOnEnd = 1 << 11,
+		};
+
+		FieldFlags Fields = Field_None;
+		b8 IsPlaying, IsLooping, PlayPastEnd, RemoveOnEnd, PauseOnEnd;
+		SourceHandle Source;
+		i32 SoundGroup;
+		f32 Volume, Pan, PlaybackSpeed;
+		Time Position;
+		Time VolumeMapStartTime, VolumeMapEndTime;
+		f32 VolumeMapStartVolume, VolumeMapEndVolume;
+
+		constexpr VoiceParamBatch& SetSource(SourceHandle value) { Fields |= Field_Source; Source = value; return *this; }
+		constexpr VoiceParamBatch& SetSoundGroup(i32 value) { Fields |= Field_SoundGroup; SoundGroup = value; return *this; }
+		constexpr VoiceParamBatch& SetVolume(f32 value) { Fields |= Field_Volume; Volume = value; return *this; }
+		constexpr VoiceParamBatch& SetPan(f32 value) { Fields |= Field_Pan; Pan = value; return *this; }
+		constexpr VoiceParamBatch& SetPlaybackSpeed(f32 value) { Fields |= Field_PlaybackSpeed; PlaybackSpeed = value; return *this; }
+		constexpr VoiceParamBatch& SetPosition(Time value) { Fields |= Field_Position; Position = value; return *this; }
+		constexpr VoiceParamBatch& SetVolumeMap(Time startTime, Time endTime, f32 startVolume, f32 endVolume) { Fields |= Field_VolumeMap; VolumeMapStartTime = startTime; VolumeMapEndTime = endTime; VolumeMapStartVolume = startVolume; VolumeMapEndVolume = endVolume; return *this; }
+		constexpr VoiceParamBatch& SetIsPlaying(b8 value) { Fields |= Field_IsPlaying; IsPlaying = value; return *this; }
+		constexpr VoiceParamBatch& SetIsLooping(b8 value) { Fields |= Field_IsLooping; IsLooping = value; return *this; }
+		constexpr VoiceParamBatch& SetPlayPastEnd(b8 value) { Fields |= Field_PlayPastEnd; PlayPastEnd = value; return *this; }
+		constexpr VoiceParamBatch& SetRemoveOnEnd(b8 value) { Fields |= Field_RemoveOnEnd; RemoveOnEnd = value; return *this; }
+		constexpr VoiceParamBatch& SetPauseOnEnd(b8 value) { Fields |= Field_PauseOnEnd; PauseOnEnd = value; return *this; }
+	};
+
+	// NOTE: Sound to be started by the render thread at the exact output frame the position of the (playing) clock voice reaches ClockTime,
+	//		 rather than at the start of whichever buffer happens to be rendered next after it has been requested
+	struct ScheduledSound
+	{
+		Time ClockTime;
+		SourceHandle Source;
+		f32 Volume, Pan;
+		i32 SoundGroup;
+	};
+
 	// NOTE: Lightweight non-owning wrapper around a VoiceHandle providing a convenient OOP interface
 	struct Voice
 	{
@@ -75,15 +131,20 @@ namespace Audio
 		void ResetVolumeMap();
 		void SetVolumeMap(Time startTime, Time endTime, f32 startVolume, f32 endVolume);
 
+		// NOTE: All of the setters above are applied asynchronously by the render thread at the start of the next buffer.
+		//		 Until then the getters return the most recently set value instead, with GetPositionSmooth() falling back to GetPosition()
+		void SetParams(const VoiceParamBatch& params);
+
 	private:
 		b8 GetInternalFlag(u16 flag) const;
-		void SetInternalFlag(u16 flag, b8 value);
 	};
 
 	enum class Backend : u8
 	{
 		WASAPI_Shared,
 		WASAPI_Exclusive,
+		// NOTE: No audio device at all, rendering paced to real time all the same (for headless use)
+		Null,
 		Count,
 		// TEMP: Switching to shared during early developement where there isn't actually any charting to do yet
 		// Default = WASAPI_Exclusive,
@@ -94,6 +155,7 @@ namespace Audio
 	{
 		"WASAPI (Shared)",
 		"WASAPI (Exclusive)",
+		"Null (No Output)",
 	};
 
 	enum class PanLaw : u8
@@ -127,10 +189,12 @@ namespace Audio
 		static constexpr f32 MinVolume = 0.0f, MaxVolume = 1.0f;
 		static constexpr f32 SoundGroupVolumeLimit = 2.0f;
 		static constexpr f32 MinPan = -1, MaxPan = 1;
-		static constexpr PanLaw PanLaw = PanLaw::db3;
+		static constexpr Audio::PanLaw PanLaw = Audio::PanLaw::db3;
 		static constexpr size_t MaxSoundGroups = 3;
 		static constexpr size_t MaxSimultaneousVoices = 128;
 		static constexpr size_t MaxLoadedSources = 256;
+		static constexpr size_t MaxScheduledSounds = 1024;
+		static constexpr size_t MaxScheduledVoices = 64;
 
 		static constexpr u32 OutputChannelCount = 2;
 		static constexpr u32 OutputSampleRate = 44100;
@@ -140,6 +204,7 @@ namespace Audio
 		static constexpr u32 MaxBufferFrameCount = OutputSampleRate;
 
 		static constexpr size_t CallbackDurationRingBufferSize = 64;
+		static constexpr size_t VoiceCommandQueueCapacity = 1024;
 		static constexpr size_t LastPlayedSamplesRingBufferFrameCount = MaxBufferFrameCount;
 
 	public:
@@ -161,8 +226,14 @@ namespace Audio
 		SourceHandle LoadSourceFromFileSync(std::string_view filePath);
 		SourceHandle LoadSourceFromFileContentSync(std::string_view fileName, const void* fileContent, size_t fileSize);
 		SourceHandle LoadSourceFromBufferMove(std::string_view sourceName, PCMSampleBuffer bufferToMove);
+
+		// NOTE: For long files (such as the song) of which only the encoded content is kept in memory, to then be decoded ahead of the playback position on a worker thread.
+		//		 The content is shared so that it can be decoded elsewhere at the same time (to generate a waveform for example).
+		//		 Only meant to be played back by a single voice at a time, as each one seeking to a different position would cause constant redecoding
+		SourceHandle LoadStreamingSourceFromFileContent(std::string_view fileName, std::shared_ptr<const u8[]> fileContent, size_t fileSize);
 		void UnloadSource(SourceHandle source);
 
+		// NOTE: Streaming sources only provide their format, without any samples
 		const PCMSampleBuffer* GetSourceSampleBufferView(SourceHandle source);
 
 		f32 GetSourceBaseVolume(SourceHandle source);
@@ -175,8 +246,19 @@ namespace Audio
 		VoiceHandle AddVoice(SourceHandle source, std::string_view name, b8 playing, f32 volume = MaxVolume, f32 pan = 0, b8 playPastEnd = false, i32 soundGroup = 0);
 		void RemoveVoice(VoiceHandle voice);
 
-		// NOTE: Add a voice, play it once then discard
-		void PlayOneShotSound(SourceHandle source, std::string_view name, f32 volume = MaxVolume, f32 pan = 0, i32 soundGroup = 0);
+		// NOTE: Add a voice, play it once then discard. Returns false if there was no free voice slot left to play it with
+		b8 PlayOneShotSound(SourceHandle source, std::string_view name, f32 volume = MaxVolume, f32 pan = 0, i32 soundGroup = 0);
+
+		// NOTE: Meant to be topped up a bit ahead of the clock voice position every now and then, in chronological order.
+		//		 Sounds the clock voice has already passed by the time they reach the render thread are skipped instead of being started late,
+		//		 which also makes it safe to clear and reschedule sounds that might have already been started in the meantime.
+		//		 Scheduling for a different clock voice discards all sounds scheduled for the previous one
+		void ScheduleSounds(VoiceHandle clockVoice, const ScheduledSound* sounds, size_t soundCount);
+		void ClearScheduledSounds();
+
+		// NOTE: Renders the next buffer directly on the calling thread instead of the backend, only possible while the stream is stopped (for offline measurements and exports).
+		//		 Streaming sources are decoded synchronously as needed, so unlike a live render this never skips over frames the worker hasn't decoded yet
+		void RenderOffline(i16* outputBuffer, u32 bufferFrameCount);
 
 	public:
 		Backend GetBackend() const;
@@ -206,14 +288,21 @@ namespace Audio
 		DebugSourcesArray DebugGetAllLoadedSources();
 		i32 DebugGetSourceVoiceInstanceCount(SourceHandle source);
 
+		// NOTE: Decoded samples (or for streaming sources their file content and decode buffers) held in memory by the source
+		size_t DebugGetSourceMemoryByteSize(SourceHandle source);
+		// NOTE: Frames ready to be rendered without waiting on any decoding, always all of them for regular sources
+		i64 DebugGetSourceDecodedFrameCount(SourceHandle source);
+
 		std::array<Time, CallbackDurationRingBufferSize> DebugGetRenderPerformanceHistory();
+		i64 DebugGetLateCallbackCount() const;
+		i64 DebugGetSkippedScheduledSoundCount() const;
 		std::array<std::array<i16, LastPlayedSamplesRingBufferFrameCount>, OutputChannelCount> DebugGetLastPlayedSamples();
 
 	private:
 		friend Voice;
 
 		struct Impl;
-		std::unique_ptr<Impl> impl = nullptr;
+		std::unique_ptr<Impl> impl;
 	};
 
 	// NOTE: Single global instance
@@ -17,7 +17,13 @@
 
 // TODO: Forward declare because visual studio is having a stroke parsing the C header (something about the typedef union { ... } Floor; ???)
 //		 even though it was working perfectly fine in a different C++ project before :PeepoShrug:
-extern "C" int stb_vorbis_decode_memory(const unsigned char* mem, int len, int* channels, int* sample_rate, short** output);
+struct stb_vorbis;
+extern "C" stb_vorbis* stb_vorbis_open_memory(const unsigned char* data, int len, int* error, const void* alloc_buffer);
+extern "C" void stb_vorbis_close(stb_vorbis* f);
+extern "C" void stb_vorbis_get_channels_and_sample_rate(stb_vorbis* f, int* channels, unsigned int* sample_rate);
+extern "C" unsigned int stb_vorbis_stream_length_in_samples(stb_vorbis* f);
+extern "C" int stb_vorbis_get_samples_short_interleaved(stb_vorbis* f, int channels, short* buffer, int num_shorts);
+extern "C" int stb_vorbis_seek(stb_vorbis* f, unsigned int sample_number);
 
 namespace Audio
 {
@@ -35,114 +41,264 @@ namespace Audio
 	{
 		outBuffer = {};
 
+		// NOTE: Decoding in chunks straight into the final buffer, instead of letting the decoding library allocate one of its own which would then have to be copied
+		StreamingDecoder decoder;
+		if (decoder.OpenMemory(fileNameWithExtension, inFileContent, inFileSize) != DecodeFileResult::FeelsGoodMan)
+			return DecodeFileResult::Sadge;
+
+		const u32 channelCount = decoder.GetChannelCount();
+		static constexpr i64 maxFramesPerRead = (1 << 20);
+		static constexpr i64 endOfFileProbeFrameCount = 1024;
+
+		// NOTE: The frame count is exact for all formats as long as it's known at all, which it might not be for some FLAC streams.
+		//		 Only then does the buffer have to grow (and be copied) after all, starting out with a few seconds worth of frames
+		i64 capacityFrameCount = (decoder.GetFrameCount() > 0) ? decoder.GetFrameCount() : (static_cast<i64>(decoder.GetSampleRate()) * 8);
+		std::unique_ptr<i16[]> samples = std::unique_ptr<i16[]>(new i16[capacityFrameCount * channelCount]);
+		std::unique_ptr<i16[]> probeSamples = nullptr;
+		i64 frameCount = 0;
+
+		while (true)
+		{
+			if (frameCount < capacityFrameCount)
+			{
+				const i64 framesRead = decoder.ReadFrames(&samples[frameCount * channelCount], Min(capacityFrameCount - frameCount, maxFramesPerRead));
+				if (framesRead <= 0)
+					break;
+				frameCount += framesRead;
+				continue;
+			}
+
+			// NOTE: Check for any remaining frames past the expected end without having to grow the buffer up front
+			if (probeSamples == nullptr)
+				probeSamples = std::unique_ptr<i16[]>(new i16[endOfFileProbeFrameCount * channelCount]);
+
+			const i64 probeFramesRead = decoder.ReadFrames(probeSamples.get(), endOfFileProbeFrameCount);
+			if (probeFramesRead <= 0)
+				break;
+
+			capacityFrameCount = Max(capacityFrameCount * 2, frameCount + probeFramesRead);
+			std::unique_ptr<i16[]> grownSamples = std::unique_ptr<i16[]>(new i16[capacityFrameCount * channelCount]);
+			::memcpy(grownSamples.get(), samples.get(), frameCount * channelCount * sizeof(i16));
+			::memcpy(&grownSamples[frameCount * channelCount], probeSamples.get(), probeFramesRead * channelCount * sizeof(i16));
+			samples = std::move(grownSamples);
+			frameCount += probeFramesRead;
+		}
+
+		outBuffer.ChannelCount = channelCount;
+		outBuffer.SampleRate = decoder.GetSampleRate();
+		outBuffer.FrameCount = frameCount;
+		outBuffer.InterleavedSamples = std::move(samples);
+		return DecodeFileResult::FeelsGoodMan;
+	}
+
+	struct WAVFileWriter::Impl
+	{
+		b8 IsOpen = false;
+		::drwav Wav = {};
+	};
+
+	WAVFileWriter::WAVFileWriter() : impl(std::make_unique<Impl>()) {}
+	WAVFileWriter::~WAVFileWriter() { Close(); }
+
+	b8 WAVFileWriter::Open(std::string_view filePath, u32 channelCount, u32 sampleRate)
+	{
+		if (impl->IsOpen || filePath.empty())
+			return false;
+
+		::drwav_data_format format = {};
+		format.container = ::drwav_container_riff;
+		format.format = DR_WAVE_FORMAT_PCM;
+		format.channels = channelCount;
+		format.sampleRate = sampleRate;
+		format.bitsPerSample = (sizeof(i16) * BitsPerByte);
+
+		// NOTE: Going through the wide char version to support unicode paths, same as the regular file IO
+		impl->IsOpen = ::drwav_init_file_write_w(&impl->Wav, UTF8::WideArg(filePath).c_str(), &format, nullptr);
+		return impl->IsOpen;
+	}
+
+	b8 WAVFileWriter::Close()
+	{
+		if (!impl->IsOpen)
+			return false;
+
+		impl->IsOpen = false;
+		return (::drwav_uninit(&impl->Wav) == DRWAV_SUCCESS);
+	}
+
+	b8 WAVFileWriter::IsOpen() const
+	{
+		return impl->IsOpen;
+	}
+
+	b8 WAVFileWriter::WriteFrames(const i16* interleavedSamples, i64 frameCount)
+	{
+		if (!impl->IsOpen)
+			return false;
+
+		const i64 framesWritten = static_cast<i64>(::drwav_write_pcm_frames(&impl->Wav, static_cast<::drwav_uint64>(frameCount), interleavedSamples));
+		return (framesWritten == frameCount);
+	}
+
+	struct StreamingDecoder::Impl
+	{
+		SupportedFileFormat Format = SupportedFileFormat::Count;
+		u32 ChannelCount = 0;
+		u32 SampleRate = 0;
+		i64 FrameCount = 0;
+
+		stb_vorbis* Vorbis = nullptr;
+		::drwav Wav = {};
+		::drflac* Flac = nullptr;
+		::drmp3 Mp3 = {};
+		// NOTE: Without a seek table dr_mp3 has to decode everything from the start of the file up to the target frame.
+		//		 Only calculated once actually seeking as it requires scanning through the entire file
+		b8 Mp3SeekTableCalculated = false;
+		std::vector<::drmp3_seek_point> Mp3SeekPoints;
+	};
+
+	StreamingDecoder::StreamingDecoder() : impl(std::make_unique<Impl>()) {}
+	StreamingDecoder::~StreamingDecoder() { Close(); }
+
+	DecodeFileResult StreamingDecoder::OpenMemory(std::string_view fileNameWithExtension, const void* inFileContent, size_t inFileSize)
+	{
+		Close();
+
 		if (inFileContent == nullptr || inFileSize == 0)
 			return DecodeFileResult::Sadge;
 
 		// TODO: Check for magic bytes instead, though shouldn't really matter for now
 		const SupportedFileFormat fileFormat = TryToDetermineFileFormatFromExtension(fileNameWithExtension);
-		if (fileFormat == SupportedFileFormat::Count)
-			return DecodeFileResult::Sadge;
-
 		switch (fileFormat)
 		{
 		case SupportedFileFormat::OggVorbis:
 		{
-			i32 outChannels = {};
-			i32 outSampleRate = {};
-			i16* outSamplesI16 = {};
-			i32 outFrameCount = ::stb_vorbis_decode_memory(static_cast<const unsigned char*>(inFileContent), static_cast<int>(inFileSize), &outChannels, &outSampleRate, &outSamplesI16);
-			defer { ::free(outSamplesI16); };
-			if (outSamplesI16 == nullptr || outFrameCount < 0)
+			i32 error = 0;
+			impl->Vorbis = ::stb_vorbis_open_memory(static_cast<const unsigned char*>(inFileContent), static_cast<int>(inFileSize), &error, nullptr);
+			if (impl->Vorbis == nullptr)
 				return DecodeFileResult::Sadge;
 
-			const size_t totalSampleCount = static_cast<size_t>(outFrameCount * outChannels);
-			outBuffer.ChannelCount = static_cast<u32>(outChannels);
-			outBuffer.SampleRate = static_cast<u32>(outSampleRate);
-			outBuffer.FrameCount = static_cast<i64>(outFrameCount);
-			// outBuffer.InterleavedSamples = std::make_unique<i16[]>(totalSampleCount);
-			outBuffer.InterleavedSamples = std::unique_ptr<i16[]>(new i16[totalSampleCount]);
-			if (outBuffer.InterleavedSamples == nullptr)
-				return DecodeFileResult::Sadge;
-
-			// TODO: Prevent copy by.. overwriting malloc? or manually read chunks
-			::memcpy(outBuffer.InterleavedSamples.get(), outSamplesI16, totalSampleCount * sizeof(i16));
+			i32 channels = 0; u32 sampleRate = 0;
+			::stb_vorbis_get_channels_and_sample_rate(impl->Vorbis, &channels, &sampleRate);
+			impl->ChannelCount = static_cast<u32>(channels);
+			impl->SampleRate = sampleRate;
+			impl->FrameCount = static_cast<i64>(::stb_vorbis_stream_length_in_samples(impl->Vorbis));
 		} break;
 
 		case SupportedFileFormat::WAV:
 		{
-			u32 outChannels = {};
-			u32 outSampleRate = {};
-			u64 outFrameCount = {};
-			i16* outSamplesI16 = ::drwav_open_memory_and_read_pcm_frames_s16(inFileContent, inFileSize, &outChannels, &outSampleRate, &outFrameCount, nullptr);
-			defer { ::drwav_free(outSamplesI16, nullptr); };
-			if (outSamplesI16 == nullptr)
-				return DecodeFileResult::Sadge;
-
-			const size_t totalSampleCount = static_cast<size_t>(outFrameCount * outChannels);
-			outBuffer.ChannelCount = static_cast<u32>(outChannels);
-			outBuffer.SampleRate = static_cast<u32>(outSampleRate);
-			outBuffer.FrameCount = static_cast<i64>(outFrameCount);
-			// outBuffer.InterleavedSamples = std::make_unique<i16[]>(totalSampleCount);
-			outBuffer.InterleavedSamples = std::unique_ptr<i16[]>(new i16[totalSampleCount]);
-			if (outBuffer.InterleavedSamples == nullptr)
+			if (!::drwav_init_memory(&impl->Wav, inFileContent, inFileSize, nullptr))
 				return DecodeFileResult::Sadge;
 
-			// TODO: Prevent copy by passing down custom allocator or manually read chunks
-			::memcpy(outBuffer.InterleavedSamples.get(), outSamplesI16, totalSampleCount * sizeof(i16));
+			impl->ChannelCount = impl->Wav.channels;
+			impl->SampleRate = impl->Wav.sampleRate;
+			impl->FrameCount = static_cast<i64>(impl->Wav.totalPCMFrameCount);
 		} break;
 
 		case SupportedFileFormat::FLAC:
 		{
-			u32 outChannels = {};
-			u32 outSampleRate = {};
-			u64 outFrameCount = {};
-			i16* outSamplesI16 = ::drflac_open_memory_and_read_pcm_frames_s16(inFileContent, inFileSize, &outChannels, &outSampleRate, &outFrameCount, nullptr);
-			defer { ::drflac_free(outSamplesI16, nullptr); };
-			if (outSamplesI16 == nullptr)
-				return DecodeFileResult::Sadge;
-
-			const size_t totalSampleCount = static_cast<size_t>(outFrameCount * outChannels);
-			outBuffer.ChannelCount = static_cast<u32>(outChannels);
-			outBuffer.SampleRate = static_cast<u32>(outSampleRate);
-			outBuffer.FrameCount = static_cast<i64>(outFrameCount);
-			// outBuffer.InterleavedSamples = std::make_unique<i16[]>(totalSampleCount);
-			outBuffer.InterleavedSamples = std::unique_ptr<i16[]>(new i16[totalSampleCount]);
-			if (outBuffer.InterleavedSamples == nullptr)
+			impl->Flac = ::drflac_open_memory(inFileContent, inFileSize, nullptr);
+			if (impl->Flac == nullptr)
 				return DecodeFileResult::Sadge;
 
-			// TODO: Prevent copy by passing down custom allocator or manually read chunks
-			::memcpy(outBuffer.InterleavedSamples.get(), outSamplesI16, totalSampleCount * sizeof(i16));
+			impl->ChannelCount = impl->Flac->channels;
+			impl->SampleRate = impl->Flac->sampleRate;
+			impl->FrameCount = static_cast<i64>(impl->Flac->totalPCMFrameCount);
 		} break;
 
 		case SupportedFileFormat::MP3:
 		{
-			::drmp3_config outConfig = {};
-			::drmp3_uint64 outFrameCount = {};
-			::drmp3d_sample_t* outSamplesI16 = ::drmp3_open_memory_and_read_pcm_frames_s16(inFileContent, inFileSize, &outConfig, &outFrameCount, nullptr);
-			defer { ::drmp3_free(outSamplesI16, nullptr); };
-			if (outSamplesI16 == nullptr)
-				return DecodeFileResult::Sadge;
-
-			const size_t totalSampleCount = static_cast<size_t>(outFrameCount * outConfig.channels);
-			outBuffer.ChannelCount = static_cast<u32>(outConfig.channels);
-			outBuffer.SampleRate = static_cast<u32>(outConfig.sampleRate);
-			outBuffer.FrameCount = static_cast<i64>(outFrameCount);
-			// outBuffer.InterleavedSamples = std::make_unique<i16[]>(totalSampleCount);
-			outBuffer.InterleavedSamples = std::unique_ptr<i16[]>(new i16[totalSampleCount]);
-			if (outBuffer.InterleavedSamples == nullptr)
+			if (!::drmp3_init_memory(&impl->Mp3, inFileContent, inFileSize, nullptr))
 				return DecodeFileResult::Sadge;
 
-			// TODO: Prevent copy by passing down custom allocator or manually read chunks
-			::memcpy(outBuffer.InterleavedSamples.get(), outSamplesI16, totalSampleCount * sizeof(i16));
+			impl->ChannelCount = impl->Mp3.channels;
+			impl->SampleRate = impl->Mp3.sampleRate;
+			impl->FrameCount = static_cast<i64>(::drmp3_get_pcm_frame_count(&impl->Mp3));
 		} break;
 
 		default:
 		{
-			assert(!"Unhandled file format switch case");
 			return DecodeFileResult::Sadge;
 		} break;
 		}
 
+		impl->Format = fileFormat;
+		if (impl->ChannelCount == 0 || impl->SampleRate == 0)
+		{
+			Close();
+			return DecodeFileResult::Sadge;
+		}
+
 		return DecodeFileResult::FeelsGoodMan;
 	}
+
+	void StreamingDecoder::Close()
+	{
+		switch (impl->Format)
+		{
+		case SupportedFileFormat::OggVorbis: { ::stb_vorbis_close(impl->Vorbis); } break;
+		case SupportedFileFormat::WAV: { ::drwav_uninit(&impl->Wav); } break;
+		case SupportedFileFormat::FLAC: { ::drflac_close(impl->Flac); } break;
+		case SupportedFileFormat::MP3: { ::drmp3_uninit(&impl->Mp3); } break;
+		default: break;
+		}
+
+		impl->Format = SupportedFileFormat::Count;
+		impl->ChannelCount = 0;
+		impl->SampleRate = 0;
+		impl->FrameCount = 0;
+		impl->Vorbis = nullptr;
+		impl->Flac = nullptr;
+		impl->Mp3SeekTableCalculated = false;
+		impl->Mp3SeekPoints.clear();
+	}
+
+	b8 StreamingDecoder::IsOpen() const { return (impl->Format != SupportedFileFormat::Count); }
+	u32 StreamingDecoder::GetChannelCount() const { return impl->ChannelCount; }
+	u32 StreamingDecoder::GetSampleRate() const { return impl->SampleRate; }
+	i64 StreamingDecoder::GetFrameCount() const { return impl->FrameCount; }
+
+	i64 StreamingDecoder::ReadFrames(i16* outInterleavedSamples, i64 frameCount)
+	{
+		if (frameCount <= 0)
+			return 0;
+
+		switch (impl->Format)
+		{
+		case SupportedFileFormat::OggVorbis:
+		{
+			const i32 channels = static_cast<i32>(impl->ChannelCount);
+			return static_cast<i64>(::stb_vorbis_get_samples_short_interleaved(impl->Vorbis, channels, outInterleavedSamples, static_cast<int>(frameCount * channels)));
+		}
+		case SupportedFileFormat::WAV: { return static_cast<i64>(::drwav_read_pcm_frames_s16(&impl->Wav, static_cast<::drwav_uint64>(frameCount), outInterleavedSamples)); }
+		case SupportedFileFormat::FLAC: { return static_cast<i64>(::drflac_read_pcm_frames_s16(impl->Flac, static_cast<::drflac_uint64>(frameCount), outInterleavedSamples)); }
+		case SupportedFileFormat::MP3: { return static_cast<i64>(::drmp3_read_pcm_frames_s16(&impl->Mp3, static_cast<::drmp3_uint64>(frameCount), outInterleavedSamples)); }
+		default: { return 0; }
+		}
+	}
+
+	b8 StreamingDecoder::SeekToFrame(i64 frameIndex)
+	{
+		frameIndex = Clamp<i64>(frameIndex, 0, impl->FrameCount);
+		switch (impl->Format)
+		{
+		case SupportedFileFormat::OggVorbis: { return ::stb_vorbis_seek(impl->Vorbis, static_cast<unsigned int>(frameIndex)) != 0; }
+		case SupportedFileFormat::WAV: { return ::drwav_seek_to_pcm_frame(&impl->Wav, static_cast<::drwav_uint64>(frameIndex)); }
+		case SupportedFileFormat::FLAC: { return ::drflac_seek_to_pcm_frame(impl->Flac, static_cast<::drflac_uint64>(frameIndex)); }
+		case SupportedFileFormat::MP3:
+		{
+			if (!impl->Mp3SeekTableCalculated)
+			{
+				// NOTE: Roughly one seek point per second is plenty as seeking only has to decode forward from the closest one
+				::drmp3_uint32 seekPointCount = static_cast<::drmp3_uint32>(Max<i64>(impl->FrameCount / Max<i64>(impl->SampleRate, 1), 1));
+				impl->Mp3SeekPoints.resize(seekPointCount);
+				if (::drmp3_calculate_seek_points(&impl->Mp3, &seekPointCount, impl->Mp3SeekPoints.data()))
+					::drmp3_bind_seek_table(&impl->Mp3, seekPointCount, impl->Mp3SeekPoints.data());
+				impl->Mp3SeekTableCalculated = true;
+			}
+			return ::drmp3_seek_to_pcm_frame(&impl->Mp3, static_cast<::drmp3_uint64>(frameIndex));
+		}
+		default: { return false; }
+		}
+	}
 }
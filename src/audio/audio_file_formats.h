@@ -33,8 +33,56 @@ namespace Audio
 
 	SupportedFileFormat TryToDetermineFileFormatFromExtension(std::string_view fileName);
 
-	// TODO: Also expose file streaming API if / when it's needed
-	//		 but for now everything will be stored in one big continuous buffer since it greatly reduces complexity.
-	//		 Instead of constantly reading a streamed file from disk it might also be an option to read the entire file upfront but then only decode chunks on demand (?)
+	// NOTE: Convenient for short sounds but the entire PCM data has to be kept in memory, see StreamingDecoder for longer files
 	DecodeFileResult DecodeEntireFile(std::string_view fileNameWithExtension, const void* inFileContent, size_t inFileSize, PCMSampleBuffer& outBuffer);
+
+	// NOTE: Always written as 16-bit PCM, the same format everything else is decoded to.
+	//		 Each write goes straight to the file so that (unlike encoding in memory first) long renders never have to be kept around in their entirety,
+	//		 with the sizes inside the header only being filled in once closed
+	class WAVFileWriter : NonCopyable
+	{
+	public:
+		WAVFileWriter();
+		~WAVFileWriter();
+
+	public:
+		b8 Open(std::string_view filePath, u32 channelCount, u32 sampleRate);
+		// NOTE: Returns false if the file couldn't be finalized, leaving it incomplete
+		b8 Close();
+
+		b8 IsOpen() const;
+
+		// NOTE: Returns false if not all frames could be written
+		b8 WriteFrames(const i16* interleavedSamples, i64 frameCount);
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl;
+	};
+
+	// NOTE: Decodes chunks of an entirely read (but still encoded) in-memory file on demand, so that only the much smaller encoded data has to be kept around.
+	//		 The file content has to stay alive and unmodified for as long as the decoder is open
+	class StreamingDecoder : NonCopyable
+	{
+	public:
+		StreamingDecoder();
+		~StreamingDecoder();
+
+	public:
+		DecodeFileResult OpenMemory(std::string_view fileNameWithExtension, const void* inFileContent, size_t inFileSize);
+		void Close();
+
+		b8 IsOpen() const;
+		u32 GetChannelCount() const;
+		u32 GetSampleRate() const;
+		i64 GetFrameCount() const;
+
+		// NOTE: Returns the number of frames read, which is only less than requested once the end of the file has been reached
+		i64 ReadFrames(i16* outInterleavedSamples, i64 frameCount);
+		b8 SeekToFrame(i64 frameIndex);
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> impl;
+	};
 }
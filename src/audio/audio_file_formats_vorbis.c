@@ -1 +1,9 @@
 #include <stb/stb_vorbis.c>
+
+// NOTE: Exposed so that the C++ side doesn't have to replicate the layout of stb_vorbis_info (see the forward declarations inside audio_file_formats.cpp)
+void stb_vorbis_get_channels_and_sample_rate(stb_vorbis* f, int* channels, unsigned int* sample_rate)
+{
+	const stb_vorbis_info info = stb_vorbis_get_info(f);
+	*channels = info.channels;
+	*sample_rate = info.sample_rate;
+}
@@ -0,0 +1,247 @@
+#include "audio_mix_kernels.h"
+#include "audio_common.h"
+
+#if PEEPO_AUDIO_MIX_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Audio
+{
+	static_assert(MixKernelChannelCount == 2, "All kernels assume interleaved stereo samples");
+
+	static void MixSamplesI16IntoF32_Scalar(f32* inOutMix, const i16* samples, size_t frameCount, std::array<f32, MixKernelChannelCount> channelGains)
+	{
+		for (size_t f = 0, i = 0; f < frameCount; f++)
+		{
+			for (u32 c = 0; c < MixKernelChannelCount; c++, i++)
+				inOutMix[i] += static_cast<f32>(samples[i]) * channelGains[c];
+		}
+	}
+
+	static void MixSamplesI16IntoF32PerFrameVolume_Scalar(f32* inOutMix, const i16* samples, size_t frameCount, const f32* frameVolumes, std::array<f32, MixKernelChannelCount> channelGains)
+	{
+		for (size_t f = 0, i = 0; f < frameCount; f++)
+		{
+			for (u32 c = 0; c < MixKernelChannelCount; c++, i++)
+				inOutMix[i] += static_cast<f32>(samples[i]) * (frameVolumes[f] * channelGains[c]);
+		}
+	}
+
+	static void ScaleSamplesF32_Scalar(f32* inOutSamples, size_t sampleCount, f32 gain)
+	{
+		for (size_t i = 0; i < sampleCount; i++)
+			inOutSamples[i] *= gain;
+	}
+
+	static void FindFramePeaksF32_Scalar(const f32* samples, size_t frameCount, f32* outFramePeaks)
+	{
+		for (size_t f = 0, i = 0; f < frameCount; f++)
+		{
+			f32 framePeak = 0.0f;
+			for (u32 c = 0; c < MixKernelChannelCount; c++, i++)
+			{
+				if (std::abs(samples[i]) > std::abs(framePeak))
+					framePeak = samples[i];
+			}
+			outFramePeaks[f] = framePeak;
+		}
+	}
+
+	static void MixSamplesF32IntoF32PerFrameGain_Scalar(f32* inOutMix, const f32* samples, size_t frameCount, const f32* frameGains, f32 postGain)
+	{
+		for (size_t f = 0, i = 0; f < frameCount; f++)
+		{
+			for (u32 c = 0; c < MixKernelChannelCount; c++, i++)
+				inOutMix[i] += (samples[i] * frameGains[f]) * postGain;
+		}
+	}
+
+	static void MixSamplesF32IntoI16PerFrameGainClamped_Scalar(i16* inOutMix, const f32* samples, size_t frameCount, const f32* frameGains, f32 postGain)
+	{
+		for (size_t f = 0, i = 0; f < frameCount; f++)
+		{
+			for (u32 c = 0; c < MixKernelChannelCount; c++, i++)
+				inOutMix[i] += ClampSampleI<i16>((samples[i] * frameGains[f]) * postGain);
+		}
+	}
+
+#if PEEPO_AUDIO_MIX_SSE2
+	// NOTE: All SSE2 kernels process 4 frames (8 samples) per iteration and leave the remaining frames to the scalar path
+	static constexpr size_t SSE2FramesPerIteration = 4;
+
+	static inline void SSE2LoadI16x8AsF32x4x2(const i16* samples, __m128& outLow, __m128& outHigh)
+	{
+		// NOTE: Interleave each value with itself and then arithmetic shift right to sign extend to 32-bit
+		const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples));
+		outLow = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16));
+		outHigh = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16));
+	}
+
+	static void MixSamplesI16IntoF32_SSE2(f32* inOutMix, const i16* samples, size_t frameCount, std::array<f32, MixKernelChannelCount> channelGains)
+	{
+		const __m128 gains = _mm_setr_ps(channelGains[0], channelGains[1], channelGains[0], channelGains[1]);
+
+		size_t f = 0;
+		for (; (f + SSE2FramesPerIteration) <= frameCount; f += SSE2FramesPerIteration)
+		{
+			const size_t i = (f * MixKernelChannelCount);
+			__m128 samplesLow, samplesHigh;
+			SSE2LoadI16x8AsF32x4x2(&samples[i], samplesLow, samplesHigh);
+
+			_mm_storeu_ps(&inOutMix[i + 0], _mm_add_ps(_mm_loadu_ps(&inOutMix[i + 0]), _mm_mul_ps(samplesLow, gains)));
+			_mm_storeu_ps(&inOutMix[i + 4], _mm_add_ps(_mm_loadu_ps(&inOutMix[i + 4]), _mm_mul_ps(samplesHigh, gains)));
+		}
+
+		const size_t i = (f * MixKernelChannelCount);
+		MixSamplesI16IntoF32_Scalar(&inOutMix[i], &samples[i], (frameCount - f), channelGains);
+	}
+
+	static void MixSamplesI16IntoF32PerFrameVolume_SSE2(f32* inOutMix, const i16* samples, size_t frameCount, const f32* frameVolumes, std::array<f32, MixKernelChannelCount> channelGains)
+	{
+		const __m128 gains = _mm_setr_ps(channelGains[0], channelGains[1], channelGains[0], channelGains[1]);
+
+		size_t f = 0;
+		for (; (f + SSE2FramesPerIteration) <= frameCount; f += SSE2FramesPerIteration)
+		{
+			const size_t i = (f * MixKernelChannelCount);
+			__m128 samplesLow, samplesHigh;
+			SSE2LoadI16x8AsF32x4x2(&samples[i], samplesLow, samplesHigh);
+
+			// NOTE: [v0, v1, v2, v3] -> [v0, v0, v1, v1] and [v2, v2, v3, v3] to match the interleaved sample layout
+			const __m128 volumes = _mm_loadu_ps(&frameVolumes[f]);
+			const __m128 volumesLow = _mm_mul_ps(_mm_unpacklo_ps(volumes, volumes), gains);
+			const __m128 volumesHigh = _mm_mul_ps(_mm_unpackhi_ps(volumes, volumes), gains);
+
+			_mm_storeu_ps(&inOutMix[i + 0], _mm_add_ps(_mm_loadu_ps(&inOutMix[i + 0]), _mm_mul_ps(samplesLow, volumesLow)));
+			_mm_storeu_ps(&inOutMix[i + 4], _mm_add_ps(_mm_loadu_ps(&inOutMix[i + 4]), _mm_mul_ps(samplesHigh, volumesHigh)));
+		}
+
+		const size_t i = (f * MixKernelChannelCount);
+		MixSamplesI16IntoF32PerFrameVolume_Scalar(&inOutMix[i], &samples[i], (frameCount - f), &frameVolumes[f], channelGains);
+	}
+
+	static void ScaleSamplesF32_SSE2(f32* inOutSamples, size_t sampleCount, f32 gain)
+	{
+		const __m128 gains = _mm_set1_ps(gain);
+
+		size_t i = 0;
+		for (; (i + 4) <= sampleCount; i += 4)
+			_mm_storeu_ps(&inOutSamples[i], _mm_mul_ps(_mm_loadu_ps(&inOutSamples[i]), gains));
+
+		ScaleSamplesF32_Scalar(&inOutSamples[i], (sampleCount - i), gain);
+	}
+
+	static void FindFramePeaksF32_SSE2(const f32* samples, size_t frameCount, f32* outFramePeaks)
+	{
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		const __m128 zero = _mm_setzero_ps();
+
+		size_t f = 0;
+		for (; (f + SSE2FramesPerIteration) <= frameCount; f += SSE2FramesPerIteration)
+		{
+			const size_t i = (f * MixKernelChannelCount);
+			const __m128 samplesLow = _mm_loadu_ps(&samples[i + 0]);
+			const __m128 samplesHigh = _mm_loadu_ps(&samples[i + 4]);
+			const __m128 left = _mm_shuffle_ps(samplesLow, samplesHigh, _MM_SHUFFLE(2, 0, 2, 0));
+			const __m128 right = _mm_shuffle_ps(samplesLow, samplesHigh, _MM_SHUFFLE(3, 1, 3, 1));
+
+			// NOTE: Replicates the scalar comparisons exactly, starting with a peak of zero which is only replaced by a strictly larger magnitude
+			const __m128 leftIsLarger = _mm_cmpgt_ps(_mm_and_ps(left, absMask), zero);
+			const __m128 leftPeak = _mm_and_ps(left, leftIsLarger);
+			const __m128 rightIsLarger = _mm_cmpgt_ps(_mm_and_ps(right, absMask), _mm_and_ps(leftPeak, absMask));
+			const __m128 peak = _mm_or_ps(_mm_and_ps(rightIsLarger, right), _mm_andnot_ps(rightIsLarger, leftPeak));
+
+			_mm_storeu_ps(&outFramePeaks[f], peak);
+		}
+
+		const size_t i = (f * MixKernelChannelCount);
+		FindFramePeaksF32_Scalar(&samples[i], (frameCount - f), &outFramePeaks[f]);
+	}
+
+	static void MixSamplesF32IntoF32PerFrameGain_SSE2(f32* inOutMix, const f32* samples, size_t frameCount, const f32* frameGains, f32 postGain)
+	{
+		const __m128 postGains = _mm_set1_ps(postGain);
+
+		size_t f = 0;
+		for (; (f + SSE2FramesPerIteration) <= frameCount; f += SSE2FramesPerIteration)
+		{
+			const size_t i = (f * MixKernelChannelCount);
+			const __m128 gains = _mm_loadu_ps(&frameGains[f]);
+			const __m128 samplesLow = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&samples[i + 0]), _mm_unpacklo_ps(gains, gains)), postGains);
+			const __m128 samplesHigh = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&samples[i + 4]), _mm_unpackhi_ps(gains, gains)), postGains);
+
+			_mm_storeu_ps(&inOutMix[i + 0], _mm_add_ps(_mm_loadu_ps(&inOutMix[i + 0]), samplesLow));
+			_mm_storeu_ps(&inOutMix[i + 4], _mm_add_ps(_mm_loadu_ps(&inOutMix[i + 4]), samplesHigh));
+		}
+
+		const size_t i = (f * MixKernelChannelCount);
+		MixSamplesF32IntoF32PerFrameGain_Scalar(&inOutMix[i], &samples[i], (frameCount - f), &frameGains[f], postGain);
+	}
+
+	static void MixSamplesF32IntoI16PerFrameGainClamped_SSE2(i16* inOutMix, const f32* samples, size_t frameCount, const f32* frameGains, f32 postGain)
+	{
+		const __m128 postGains = _mm_set1_ps(postGain);
+		const __m128 sampleMin = _mm_set1_ps(static_cast<f32>(I16Min));
+		const __m128 sampleMax = _mm_set1_ps(static_cast<f32>(I16Max));
+
+		size_t f = 0;
+		for (; (f + SSE2FramesPerIteration) <= frameCount; f += SSE2FramesPerIteration)
+		{
+			const size_t i = (f * MixKernelChannelCount);
+			const __m128 gains = _mm_loadu_ps(&frameGains[f]);
+			const __m128 samplesLow = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&samples[i + 0]), _mm_unpacklo_ps(gains, gains)), postGains);
+			const __m128 samplesHigh = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&samples[i + 4]), _mm_unpackhi_ps(gains, gains)), postGains);
+
+			// NOTE: Clamp to the i16 range first so that the truncating conversion and the (then lossless) saturating pack match ClampSampleI
+			const __m128i clampedLow = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(samplesLow, sampleMin), sampleMax));
+			const __m128i clampedHigh = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(samplesHigh, sampleMin), sampleMax));
+			const __m128i packed = _mm_packs_epi32(clampedLow, clampedHigh);
+
+			// NOTE: Wrapping add, same as the implicit narrowing of the scalar i16 addition
+			__m128i* mix = reinterpret_cast<__m128i*>(&inOutMix[i]);
+			_mm_storeu_si128(mix, _mm_add_epi16(_mm_loadu_si128(mix), packed));
+		}
+
+		const size_t i = (f * MixKernelChannelCount);
+		MixSamplesF32IntoI16PerFrameGainClamped_Scalar(&inOutMix[i], &samples[i], (frameCount - f), &frameGains[f], postGain);
+	}
+#endif
+
+#if PEEPO_AUDIO_MIX_SSE2
+#define DISPATCH_MIX_KERNEL(functionName, ...) do { if (path == MixKernelPath::SSE2) functionName##_SSE2(__VA_ARGS__); else functionName##_Scalar(__VA_ARGS__); } while (false)
+#else
+#define DISPATCH_MIX_KERNEL(functionName, ...) do { functionName##_Scalar(__VA_ARGS__); } while (false)
+#endif
+
+	void MixSamplesI16IntoF32(f32* inOutMix, const i16* samples, size_t frameCount, std::array<f32, MixKernelChannelCount> channelGains, MixKernelPath path)
+	{
+		DISPATCH_MIX_KERNEL(MixSamplesI16IntoF32, inOutMix, samples, frameCount, channelGains);
+	}
+
+	void MixSamplesI16IntoF32PerFrameVolume(f32* inOutMix, const i16* samples, size_t frameCount, const f32* frameVolumes, std::array<f32, MixKernelChannelCount> channelGains, MixKernelPath path)
+	{
+		DISPATCH_MIX_KERNEL(MixSamplesI16IntoF32PerFrameVolume, inOutMix, samples, frameCount, frameVolumes, channelGains);
+	}
+
+	void ScaleSamplesF32(f32* inOutSamples, size_t sampleCount, f32 gain, MixKernelPath path)
+	{
+		DISPATCH_MIX_KERNEL(ScaleSamplesF32, inOutSamples, sampleCount, gain);
+	}
+
+	void FindFramePeaksF32(const f32* samples, size_t frameCount, f32* outFramePeaks, MixKernelPath path)
+	{
+		DISPATCH_MIX_KERNEL(FindFramePeaksF32, samples, frameCount, outFramePeaks);
+	}
+
+	void MixSamplesF32IntoF32PerFrameGain(f32* inOutMix, const f32* samples, size_t frameCount, const f32* frameGains, f32 postGain, MixKernelPath path)
+	{
+		DISPATCH_MIX_KERNEL(MixSamplesF32IntoF32PerFrameGain, inOutMix, samples, frameCount, frameGains, postGain);
+	}
+
+	void MixSamplesF32IntoI16PerFrameGainClamped(i16* inOutMix, const f32* samples, size_t frameCount, const f32* frameGains, f32 postGain, MixKernelPath path)
+	{
+		DISPATCH_MIX_KERNEL(MixSamplesF32IntoI16PerFrameGainClamped, inOutMix, samples, frameCount, frameGains, postGain);
+	}
+
+#undef DISPATCH_MIX_KERNEL
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "core_types.h"
+#include <array>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define PEEPO_AUDIO_MIX_SSE2 1
+#else
+#define PEEPO_AUDIO_MIX_SSE2 0
+#endif
+
+// NOTE: Block based kernels for mixing interleaved stereo buffers inside the render callback.
+//		 The SIMD paths perform the exact same (non-fused) floating point operations in the same order as the scalar reference path
+//		 so that both always produce bit-identical results
+namespace Audio
+{
+	constexpr u32 MixKernelChannelCount = 2;
+
+	enum class MixKernelPath : u8
+	{
+		Scalar,
+		SSE2,
+		Count,
+#if PEEPO_AUDIO_MIX_SSE2
+		Default = SSE2,
+#else
+		Default = Scalar,
+#endif
+	};
+
+	constexpr cstr MixKernelPathNames[EnumCount<MixKernelPath>] =
+	{
+		"Scalar",
+		"SSE2",
+	};
+
+	constexpr b8 IsMixKernelPathSupported(MixKernelPath path) { return (path == MixKernelPath::Scalar) || (path == MixKernelPath::SSE2 && PEEPO_AUDIO_MIX_SSE2); }
+
+	// NOTE: inOutMix[i] += samples[i] * channelGains[channel]
+	void MixSamplesI16IntoF32(f32* inOutMix, const i16* samples, size_t frameCount, std::array<f32, MixKernelChannelCount> channelGains, MixKernelPath path = MixKernelPath::Default);
+
+	// NOTE: inOutMix[i] += samples[i] * (frameVolumes[frame] * channelGains[channel])
+	void MixSamplesI16IntoF32PerFrameVolume(f32* inOutMix, const i16* samples, size_t frameCount, const f32* frameVolumes, std::array<f32, MixKernelChannelCount> channelGains, MixKernelPath path = MixKernelPath::Default);
+
+	// NOTE: inOutSamples[i] *= gain
+	void ScaleSamplesF32(f32* inOutSamples, size_t sampleCount, f32 gain, MixKernelPath path = MixKernelPath::Default);
+
+	// NOTE: outFramePeaks[frame] = sample of the frame with the largest magnitude (keeping its sign, preferring the first channel if equal)
+	void FindFramePeaksF32(const f32* samples, size_t frameCount, f32* outFramePeaks, MixKernelPath path = MixKernelPath::Default);
+
+	// NOTE: inOutMix[i] += (samples[i] * frameGains[frame]) * postGain
+	void MixSamplesF32IntoF32PerFrameGain(f32* inOutMix, const f32* samples, size_t frameCount, const f32* frameGains, f32 postGain, MixKernelPath path = MixKernelPath::Default);
+
+	// NOTE: inOutMix[i] += ClampSampleI<i16>((samples[i] * frameGains[frame]) * postGain)
+	void MixSamplesF32IntoI16PerFrameGainClamped(i16* inOutMix, const f32* samples, size_t frameCount, const f32* frameGains, f32 postGain, MixKernelPath path = MixKernelPath::Default);
+}
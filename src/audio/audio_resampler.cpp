@@ -0,0 +1,164 @@
+#include "audio_resampler.h"
+
+namespace Audio
+{
+	// NOTE: Zeroth order modified bessel function of the first kind, only used for building the kaiser window once
+	static f64 BesselI0(f64 x)
+	{
+		f64 sum = 1.0, term = 1.0;
+		for (i32 k = 1; k < 64 && term > (sum * 1e-17); k++)
+		{
+			const f64 halfXOverK = (x * 0.5) / static_cast<f64>(k);
+			term *= (halfXOverK * halfXOverK);
+			sum += term;
+		}
+		return sum;
+	}
+
+	const SincResamplerKernelTable& SincResamplerKernelTable::Get()
+	{
+		// NOTE: Heap allocated as it's a bit too large to comfortably build on the stack
+		static const std::unique_ptr<SincResamplerKernelTable> table = []()
+		{
+			auto result = std::make_unique<SincResamplerKernelTable>();
+			const f64 besselI0Beta = BesselI0(KaiserBeta);
+
+			for (i32 i = 0; i < TableSize; i++)
+			{
+				const f64 x = static_cast<f64>(i) / static_cast<f64>(TableResolution);
+				const f64 windowX = (x / static_cast<f64>(ZeroCrossings));
+				const f64 window = BesselI0(KaiserBeta * ::sqrt(Max(0.0, 1.0 - (windowX * windowX)))) / besselI0Beta;
+				const f64 sincX = (PI * Rolloff * x);
+				const f64 sinc = (i == 0) ? 1.0 : (::sin(sincX) / sincX);
+				result->Values[i] = static_cast<f32>(Rolloff * sinc * window);
+			}
+
+			for (i32 i = 0; i < TableSize - 1; i++)
+				result->Deltas[i] = (result->Values[i + 1] - result->Values[i]);
+			result->Deltas[TableSize - 1] = 0.0f;
+
+			// NOTE: Tap j is applied to source frame (SourceFrame - ZeroCrossings + 1 + j), so its distance to the position in table units is
+			//		 ((ZeroCrossings - 1 - j) * TableResolution + phase), which for the right wing is negative and mirrored
+			for (i32 phase = 0; phase <= TableResolution; phase++)
+			{
+				for (i32 j = 0; j < PhaseTapCount; j++)
+				{
+					const i32 distance = ((ZeroCrossings - 1 - j) * TableResolution) + phase;
+					result->Phases[phase][j] = result->Values[Min(Absolute(distance), TableSize - 1)];
+				}
+			}
+
+			return result;
+		}();
+		return *table;
+	}
+
+	void SincResampler::Process(const PCMSampleBuffer& source, f64 sourceFramesPerOutputFrame, i16* outSamples, i64 outFrameCount)
+	{
+		using Table = SincResamplerKernelTable;
+		const Table& table = Table::Get();
+		const i16* samples = source.InterleavedSamples.get();
+		const u32 channelCount = source.ChannelCount;
+		const i64 sourceFrameCount = (samples != nullptr) ? source.FrameCount : 0;
+		const size_t sourceSampleCount = static_cast<size_t>(sourceFrameCount * channelCount);
+
+		// NOTE: Relative to the nyquist frequency of the source, which has to be lowered to the one of the output when downsampling
+		const b8 isDownsampling = (sourceFramesPerOutputFrame > 1.0);
+		const f64 cutoff = isDownsampling ? (1.0 / Min(sourceFramesPerOutputFrame, MaxDownsamplingRatio)) : 1.0;
+		const f64 tablePositionPerTap = (cutoff * Table::TableResolution);
+		const f64 tableEnd = static_cast<f64>(Table::TableSize - 1);
+		const f32 kernelGain = static_cast<f32>(cutoff);
+		const i32 fixedPositionPerTap = static_cast<i32>(tablePositionPerTap * 65536.0);
+
+		// NOTE: Ordered by the source frame they are applied to, starting at firstTapFrame
+		f32 weights[MaxTapCount];
+
+		for (i64 frame = 0; frame < outFrameCount; frame++)
+		{
+			// NOTE: Only depends on the fractional position so the weights are calculated once and then shared by all channels
+			i32 tapCount = 0;
+			i64 firstTapFrame = 0;
+			if (!isDownsampling)
+			{
+				const f64 phasePosition = (SourceFrameFraction * Table::TableResolution);
+				const i32 phase = static_cast<i32>(phasePosition);
+				const f32 phaseFraction = static_cast<f32>(phasePosition - phase);
+				const f32* phaseA = table.Phases[phase].data();
+				const f32* phaseB = table.Phases[phase + 1].data();
+
+				for (i32 j = 0; j < Table::PhaseTapCount; j++)
+					weights[j] = phaseA[j] + (phaseFraction * (phaseB[j] - phaseA[j]));
+
+				tapCount = Table::PhaseTapCount;
+				firstTapFrame = (SourceFrame - Table::ZeroCrossings + 1);
+			}
+			else
+			{
+				// NOTE: The kernel is stretched by the downsampling ratio, so the wings have to be walked individually.
+				//		 The left one covers the source frames at and before the current position, the right one those after it
+				// NOTE: Walking the table in 16.16 fixed point is noticeably cheaper than converting every tap position from floating point
+				const auto tableWingToWeights = [&](f64 startPosition, i32 tapCount, f32* outWeights, i32 outStride)
+				{
+					i32 fixedPosition = static_cast<i32>(startPosition * 65536.0);
+					for (i32 k = 0; k < tapCount; k++, fixedPosition += fixedPositionPerTap)
+					{
+						const i32 index = Min(fixedPosition >> 16, Table::TableSize - 1);
+						const f32 fraction = static_cast<f32>(fixedPosition & 0xFFFF) * (1.0f / 65536.0f);
+						outWeights[k * outStride] = (table.Values[index] + (fraction * table.Deltas[index])) * kernelGain;
+					}
+				};
+
+				const i32 leftTapCount = static_cast<i32>(Ceil((tableEnd / tablePositionPerTap) - SourceFrameFraction));
+				const i32 rightTapCount = static_cast<i32>(Ceil((tableEnd / tablePositionPerTap) - (1.0 - SourceFrameFraction)));
+				tableWingToWeights(SourceFrameFraction * tablePositionPerTap, leftTapCount, &weights[leftTapCount - 1], -1);
+				tableWingToWeights((1.0 - SourceFrameFraction) * tablePositionPerTap, rightTapCount, &weights[leftTapCount], +1);
+
+				tapCount = (leftTapCount + rightTapCount);
+
+				firstTapFrame = (SourceFrame - leftTapCount + 1);
+			}
+
+			i16* outFrame = &outSamples[frame * channelCount];
+			const b8 allTapsInsideSource = (firstTapFrame >= 0) && ((firstTapFrame + tapCount) <= sourceFrameCount);
+
+			if (allTapsInsideSource && channelCount == 2)
+			{
+				const i16* firstTap = &samples[firstTapFrame * 2];
+				f32 sumL = 0.0f, sumR = 0.0f;
+				for (i32 j = 0; j < tapCount; j++)
+				{
+					sumL += weights[j] * static_cast<f32>(firstTap[(j * 2) + 0]);
+					sumR += weights[j] * static_cast<f32>(firstTap[(j * 2) + 1]);
+				}
+				outFrame[0] = ClampSampleI<i16>(Round(sumL));
+				outFrame[1] = ClampSampleI<i16>(Round(sumR));
+			}
+			else if (allTapsInsideSource)
+			{
+				for (u32 c = 0; c < channelCount; c++)
+				{
+					const i16* firstTap = &samples[(firstTapFrame * channelCount) + c];
+					f32 sum = 0.0f;
+					for (i32 j = 0; j < tapCount; j++)
+						sum += weights[j] * static_cast<f32>(firstTap[j * channelCount]);
+					outFrame[c] = ClampSampleI<i16>(Round(sum));
+				}
+			}
+			else
+			{
+				for (u32 c = 0; c < channelCount; c++)
+				{
+					f32 sum = 0.0f;
+					for (i32 j = 0; j < tapCount; j++)
+						sum += weights[j] * static_cast<f32>(SampleAtFrameIndexOrZero<i16>(firstTapFrame + j, c, samples, sourceSampleCount, channelCount));
+					outFrame[c] = ClampSampleI<i16>(Round(sum));
+				}
+			}
+
+			SourceFrameFraction += sourceFramesPerOutputFrame;
+			const f64 wholeFrames = Floor(SourceFrameFraction);
+			SourceFrame += static_cast<i64>(wholeFrames);
+			SourceFrameFraction -= wholeFrames;
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "core_types.h"
+#include "audio_common.h"
+
+// NOTE: Band-limited (windowed sinc) resampling for reading a source buffer at an arbitrary rate, used both for variable playback speeds
+//		 and for playing back sources whose sample rate doesn't match the output rate
+namespace Audio
+{
+	struct SincResamplerKernelTable
+	{
+		// NOTE: The kernel is symmetric so only its right wing is stored, sampled TableResolution times per zero crossing (in units of input samples)
+		static constexpr i32 ZeroCrossings = 24;
+		static constexpr i32 TableResolution = 256;
+		static constexpr i32 TableSize = (ZeroCrossings * TableResolution) + 1;
+
+		// NOTE: Slightly below nyquist so that the transition band of the window doesn't fold back into the audible range
+		static constexpr f64 Rolloff = 0.91;
+		static constexpr f64 KaiserBeta = 8.5;
+
+		static constexpr i32 PhaseTapCount = (ZeroCrossings * 2);
+
+		// NOTE: Deltas between adjacent values for linearly interpolating the table
+		std::array<f32, TableSize> Values;
+		std::array<f32, TableSize> Deltas;
+
+		// NOTE: The same kernel rearranged into all of its (TableResolution + 1) phases for the common non-downsampling case,
+		//		 with the taps of a phase being contiguous and ordered by the source frame they are applied to.
+		//		 The extra phase at the end is the first one shifted by a whole frame, for interpolating between the last phase and it
+		std::array<std::array<f32, PhaseTapCount>, TableResolution + 1> Phases;
+
+		static const SincResamplerKernelTable& Get();
+	};
+
+	// NOTE: Streaming resampler state of a single voice. The read position is tracked as an integer frame plus a fraction
+	//		 so that long sources don't lose precision and no drift builds up between consecutive blocks
+	struct SincResampler
+	{
+		// NOTE: When reading faster than the output rate the cutoff is lowered (and the kernel widened) accordingly to prevent aliasing,
+		//		 beyond this ratio the kernel stops getting any wider to bound the per frame cost
+		static constexpr f64 MaxDownsamplingRatio = 4.0;
+		static constexpr i32 MaxTapCount = 2 * (static_cast<i32>(SincResamplerKernelTable::ZeroCrossings * MaxDownsamplingRatio) + 1);
+
+		i64 SourceFrame = 0;
+		f64 SourceFrameFraction = 0.0;
+
+		inline void SetSourcePosition(f64 sourceFrame) { const f64 whole = Floor(sourceFrame); SourceFrame = static_cast<i64>(whole); SourceFrameFraction = (sourceFrame - whole); }
+		inline f64 GetSourcePosition() const { return static_cast<f64>(SourceFrame) + SourceFrameFraction; }
+
+		// NOTE: Writes outFrameCount interleaved frames (with the channel count of the source) starting at the current position,
+		//		 advancing by sourceFramesPerOutputFrame for each of them. Frames outside the source are treated as silence
+		void Process(const PCMSampleBuffer& source, f64 sourceFramesPerOutputFrame, i16* outSamples, i64 outFrameCount);
+	};
+}
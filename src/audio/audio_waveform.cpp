@@ -0,0 +1,354 @@
+#include "audio_waveform.h"
+#include <thread>
+
+#if PEEPO_AUDIO_MIX_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace Audio
+{
+	// NOTE: Unlike Absolute() this doesn't wrap around for I16Min
+	static inline u16 AbsoluteSampleU16(i16 sample)
+	{
+		return static_cast<u16>((sample < 0) ? -static_cast<i32>(sample) : static_cast<i32>(sample));
+	}
+
+	static inline u16 CombineRMSPair(f32 a, f32 b)
+	{
+		return static_cast<u16>(static_cast<i32>(::sqrtf(((a * a) + (b * b)) * 0.5f)));
+	}
+
+	// NOTE: Each bucket covers two frames of a single channel, with an odd last frame being paired with silence
+	static void ReduceFramePairsToBuckets_Scalar(const i16* interleavedSamples, size_t frameCount, u32 channelCount, u32 channelIndex, WaveformBucket* outBuckets)
+	{
+		for (size_t frame = 0; frame < frameCount; frame += 2)
+		{
+			const i16 a = interleavedSamples[(frame * channelCount) + channelIndex];
+			const i16 b = ((frame + 1) < frameCount) ? interleavedSamples[((frame + 1) * channelCount) + channelIndex] : static_cast<i16>(0);
+			outBuckets[frame / 2] = WaveformBucket { Max(AbsoluteSampleU16(a), AbsoluteSampleU16(b)), CombineRMSPair(static_cast<f32>(a), static_cast<f32>(b)) };
+		}
+	}
+
+	static void ReduceStereoFramePairsToBuckets_Scalar(const i16* interleavedSamples, size_t frameCount, WaveformBucket* outBucketsL, WaveformBucket* outBucketsR)
+	{
+		ReduceFramePairsToBuckets_Scalar(interleavedSamples, frameCount, 2, 0, outBucketsL);
+		ReduceFramePairsToBuckets_Scalar(interleavedSamples, frameCount, 2, 1, outBucketsR);
+	}
+
+	static void ReduceBucketPairs_Scalar(const WaveformBucket* buckets, size_t bucketCount, WaveformBucket* outBuckets)
+	{
+		for (size_t i = 0; i < bucketCount; i += 2)
+		{
+			const WaveformBucket a = buckets[i];
+			const WaveformBucket b = ((i + 1) < bucketCount) ? buckets[i + 1] : WaveformBucket {};
+			outBuckets[i / 2] = WaveformBucket { Max(a.Peak, b.Peak), CombineRMSPair(static_cast<f32>(a.RMS), static_cast<f32>(b.RMS)) };
+		}
+	}
+
+#if PEEPO_AUDIO_MIX_SSE2
+	static_assert(sizeof(WaveformBucket) == sizeof(u32) && offsetof(WaveformBucket, Peak) == 0 && offsetof(WaveformBucket, RMS) == 2, "Expected to match the layout of an interleaved stereo frame");
+
+	// NOTE: SSE2 only has signed 16-bit min/max, so flip the sign bit to compare unsigned values
+	static inline __m128i SSE2MaxU16x8(__m128i a, __m128i b)
+	{
+		const __m128i signBit = _mm_set1_epi16(static_cast<i16>(0x8000));
+		return _mm_xor_si128(_mm_max_epi16(_mm_xor_si128(a, signBit), _mm_xor_si128(b, signBit)), signBit);
+	}
+
+	static inline __m128i SSE2AbsoluteI16x8AsU16x8(__m128i samples)
+	{
+		const __m128i sign = _mm_srai_epi16(samples, 15);
+		return _mm_sub_epi16(_mm_xor_si128(samples, sign), sign);
+	}
+
+	// NOTE: Performs the exact same floating point operations as CombineRMSPair() does, returning 32-bit integers
+	static inline __m128i SSE2CombineRMSPairsI32x4(__m128 a, __m128 b)
+	{
+		return _mm_cvttps_epi32(_mm_sqrt_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)), _mm_set1_ps(0.5f))));
+	}
+
+	// NOTE: Treating each pair of 16-bit values as a single 32-bit lane to separate the even elements (0, 2, 4, 6) from the odd ones (1, 3, 5, 7)
+	static inline void SSE2SeparateEvenOddPairs(const void* eightPairs, __m128i& outEven, __m128i& outOdd)
+	{
+		const __m128i pairs0123 = _mm_loadu_si128(static_cast<const __m128i*>(eightPairs) + 0);
+		const __m128i pairs4567 = _mm_loadu_si128(static_cast<const __m128i*>(eightPairs) + 1);
+		const __m128i pairs0415 = _mm_unpacklo_epi32(pairs0123, pairs4567);
+		const __m128i pairs2637 = _mm_unpackhi_epi32(pairs0123, pairs4567);
+		outEven = _mm_unpacklo_epi32(pairs0415, pairs2637);
+		outOdd = _mm_unpackhi_epi32(pairs0415, pairs2637);
+	}
+
+	static inline __m128i SSE2PackBucketsU32x4(__m128i peaks, __m128i rms)
+	{
+		return _mm_or_si128(_mm_and_si128(peaks, _mm_set1_epi32(0xFFFF)), _mm_slli_epi32(rms, 16));
+	}
+
+	static void ReduceMonoFramePairsToBuckets_SSE2(const i16* samples, size_t frameCount, WaveformBucket* outBuckets)
+	{
+		// NOTE: 8 mono frames per iteration, with each pair of frames being a single 32-bit lane that is reduced to 1 bucket
+		const size_t simdFrameCount = (frameCount / 8) * 8;
+		for (size_t frame = 0; frame < simdFrameCount; frame += 8)
+		{
+			const __m128i framePairs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&samples[frame]));
+			const __m128i absoluteFrames = SSE2AbsoluteI16x8AsU16x8(framePairs);
+
+			const __m128i peaks = SSE2MaxU16x8(absoluteFrames, _mm_srli_epi32(absoluteFrames, 16));
+			const __m128i rms = SSE2CombineRMSPairsI32x4(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(framePairs, 16), 16)), _mm_cvtepi32_ps(_mm_srai_epi32(framePairs, 16)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&outBuckets[frame / 2]), SSE2PackBucketsU32x4(peaks, rms));
+		}
+		ReduceFramePairsToBuckets_Scalar(&samples[simdFrameCount], frameCount - simdFrameCount, 1, 0, &outBuckets[simdFrameCount / 2]);
+	}
+
+	static void ReduceStereoFramePairsToBuckets_SSE2(const i16* interleavedSamples, size_t frameCount, WaveformBucket* outBucketsL, WaveformBucket* outBucketsR)
+	{
+		// NOTE: 8 stereo frames per iteration, reduced to 4 buckets per channel
+		const size_t simdFrameCount = (frameCount / 8) * 8;
+		for (size_t frame = 0; frame < simdFrameCount; frame += 8)
+		{
+			__m128i evenFrames, oddFrames;
+			SSE2SeparateEvenOddPairs(&interleavedSamples[frame * 2], evenFrames, oddFrames);
+
+			const __m128i peaks = SSE2MaxU16x8(SSE2AbsoluteI16x8AsU16x8(evenFrames), SSE2AbsoluteI16x8AsU16x8(oddFrames));
+			const __m128i rmsL = SSE2CombineRMSPairsI32x4(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(evenFrames, 16), 16)), _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(oddFrames, 16), 16)));
+			const __m128i rmsR = SSE2CombineRMSPairsI32x4(_mm_cvtepi32_ps(_mm_srai_epi32(evenFrames, 16)), _mm_cvtepi32_ps(_mm_srai_epi32(oddFrames, 16)));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&outBucketsL[frame / 2]), SSE2PackBucketsU32x4(peaks, rmsL));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&outBucketsR[frame / 2]), SSE2PackBucketsU32x4(_mm_srli_epi32(peaks, 16), rmsR));
+		}
+		ReduceStereoFramePairsToBuckets_Scalar(&interleavedSamples[simdFrameCount * 2], frameCount - simdFrameCount, &outBucketsL[simdFrameCount / 2], &outBucketsR[simdFrameCount / 2]);
+	}
+
+	static void ReduceBucketPairs_SSE2(const WaveformBucket* buckets, size_t bucketCount, WaveformBucket* outBuckets)
+	{
+		// NOTE: 8 buckets per iteration, reduced to 4
+		const size_t simdBucketCount = (bucketCount / 8) * 8;
+		for (size_t i = 0; i < simdBucketCount; i += 8)
+		{
+			__m128i evenBuckets, oddBuckets;
+			SSE2SeparateEvenOddPairs(&buckets[i], evenBuckets, oddBuckets);
+
+			const __m128i peaks = SSE2MaxU16x8(evenBuckets, oddBuckets);
+			const __m128i rms = SSE2CombineRMSPairsI32x4(_mm_cvtepi32_ps(_mm_srli_epi32(evenBuckets, 16)), _mm_cvtepi32_ps(_mm_srli_epi32(oddBuckets, 16)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&outBuckets[i / 2]), SSE2PackBucketsU32x4(peaks, rms));
+		}
+		ReduceBucketPairs_Scalar(&buckets[simdBucketCount], bucketCount - simdBucketCount, &outBuckets[simdBucketCount / 2]);
+	}
+#endif
+
+	// NOTE: Only mono sources have a vectorized path, picking a single channel out of interleaved multi-channel frames always goes through the scalar loop
+	static void ReduceFramePairsToBuckets(const i16* interleavedSamples, size_t frameCount, u32 channelCount, u32 channelIndex, WaveformBucket* outBuckets, MixKernelPath path)
+	{
+#if PEEPO_AUDIO_MIX_SSE2
+		if (path == MixKernelPath::SSE2 && channelCount == 1)
+			return ReduceMonoFramePairsToBuckets_SSE2(interleavedSamples, frameCount, outBuckets);
+#endif
+		ReduceFramePairsToBuckets_Scalar(interleavedSamples, frameCount, channelCount, channelIndex, outBuckets);
+	}
+
+	static void ReduceStereoFramePairsToBuckets(const i16* interleavedSamples, size_t frameCount, WaveformBucket* outBucketsL, WaveformBucket* outBucketsR, MixKernelPath path)
+	{
+#if PEEPO_AUDIO_MIX_SSE2
+		if (path == MixKernelPath::SSE2)
+			return ReduceStereoFramePairsToBuckets_SSE2(interleavedSamples, frameCount, outBucketsL, outBucketsR);
+#endif
+		ReduceStereoFramePairsToBuckets_Scalar(interleavedSamples, frameCount, outBucketsL, outBucketsR);
+	}
+
+	static void ReduceBucketPairs(const WaveformBucket* buckets, size_t bucketCount, WaveformBucket* outBuckets, MixKernelPath path)
+	{
+#if PEEPO_AUDIO_MIX_SSE2
+		if (path == MixKernelPath::SSE2)
+			return ReduceBucketPairs_SSE2(buckets, bucketCount, outBuckets);
+#endif
+		ReduceBucketPairs_Scalar(buckets, bucketCount, outBuckets);
+	}
+
+	void WaveformMipChain::GenerateEntireMipChainFromSampleBuffer(const PCMSampleBuffer& inSampleBuffer, u32 channelIndex, b8 includeFullSizeMip, MixKernelPath path)
+	{
+		assert(inSampleBuffer.InterleavedSamples != nullptr && channelIndex < inSampleBuffer.ChannelCount);
+
+		if (includeFullSizeMip)
+		{
+			ClearAndSetupAllMips(inSampleBuffer.FrameCount, inSampleBuffer.SampleRate, true);
+
+			WaveformMip& baseMip = AllMips[0];
+			for (size_t frameIndex = 0; frameIndex < baseMip.BucketCount; frameIndex++)
+			{
+				const u16 absoluteSample = AbsoluteSampleU16(inSampleBuffer.InterleavedSamples[(frameIndex * inSampleBuffer.ChannelCount) + channelIndex]);
+				baseMip.Buckets[frameIndex] = WaveformBucket { absoluteSample, absoluteSample };
+			}
+
+			GenerateRemainingMips(path, baseMip.BucketCount);
+		}
+		else
+		{
+			BeginIncrementalGeneration(inSampleBuffer.FrameCount, inSampleBuffer.SampleRate);
+			AppendIncrementalFrames(inSampleBuffer.InterleavedSamples.get(), inSampleBuffer.FrameCount, inSampleBuffer.ChannelCount, channelIndex, path);
+			EndIncrementalGeneration(path);
+		}
+	}
+
+	void WaveformMipChain::GenerateStereoMipChainsFromSampleBuffer(const PCMSampleBuffer& inSampleBuffer, WaveformMipChain& outL, WaveformMipChain& outR, MixKernelPath path)
+	{
+		assert(inSampleBuffer.InterleavedSamples != nullptr && inSampleBuffer.ChannelCount == 2);
+
+		outL.BeginIncrementalGeneration(inSampleBuffer.FrameCount, inSampleBuffer.SampleRate);
+		outR.BeginIncrementalGeneration(inSampleBuffer.FrameCount, inSampleBuffer.SampleRate);
+
+		// NOTE: Splitting the base mip reduction in half across two threads too, at an even frame so that both halves produce whole base mip buckets
+		const i64 totalFrameCount = outL.GetIncrementalFramesToAppend(inSampleBuffer.FrameCount);
+		const i64 firstHalfFrameCount = (totalFrameCount / 4) * 2;
+		const i16* interleavedSamples = inSampleBuffer.InterleavedSamples.get();
+
+		std::thread secondHalfThread([&]
+		{
+			ReduceStereoFramePairsToBuckets(&interleavedSamples[firstHalfFrameCount * 2], static_cast<size_t>(totalFrameCount - firstHalfFrameCount),
+				&outL.AllMips[0].Buckets[firstHalfFrameCount / 2], &outR.AllMips[0].Buckets[firstHalfFrameCount / 2], path);
+		});
+		ReduceStereoFramePairsToBuckets(interleavedSamples, static_cast<size_t>(firstHalfFrameCount), outL.AllMips[0].Buckets, outR.AllMips[0].Buckets, path);
+		secondHalfThread.join();
+
+		outL.IncrementalFramesAppended = outR.IncrementalFramesAppended = inSampleBuffer.FrameCount;
+		EndIncrementalStereoGeneration(outL, outR, path);
+	}
+
+	void WaveformMipChain::BeginIncrementalGeneration(i64 totalFrameCount, u32 sampleRate)
+	{
+		// NOTE: No need to waste memory storing the full size mip if it won't even get sampled
+		ClearAndSetupAllMips(totalFrameCount, sampleRate, false);
+		IncrementalFramesAppended = 0;
+	}
+
+	void WaveformMipChain::AppendIncrementalFrames(const i16* interleavedSamples, i64 frameCount, u32 channelCount, u32 channelIndex, MixKernelPath path)
+	{
+		assert(IncrementalFramesAppended % 2 == 0 && channelIndex < channelCount);
+
+		const i64 framesToAppend = GetIncrementalFramesToAppend(frameCount);
+		ReduceFramePairsToBuckets(interleavedSamples, static_cast<size_t>(framesToAppend), channelCount, channelIndex, &AllMips[0].Buckets[IncrementalFramesAppended / 2], path);
+
+		IncrementalFramesAppended += frameCount;
+	}
+
+	void WaveformMipChain::EndIncrementalGeneration(MixKernelPath path)
+	{
+		GenerateRemainingMips(path, GetIncrementalBaseMipBucketsFilled());
+	}
+
+	void WaveformMipChain::AppendIncrementalStereoFrames(WaveformMipChain& outL, WaveformMipChain& outR, const i16* interleavedSamples, i64 frameCount, MixKernelPath path)
+	{
+		assert(outL.IncrementalFramesAppended % 2 == 0 && outL.IncrementalFramesAppended == outR.IncrementalFramesAppended && outL.AllMips[0].BucketCount == outR.AllMips[0].BucketCount);
+
+		const size_t firstBucketIndex = static_cast<size_t>(outL.IncrementalFramesAppended / 2);
+		const i64 framesToAppend = outL.GetIncrementalFramesToAppend(frameCount);
+		ReduceStereoFramePairsToBuckets(interleavedSamples, static_cast<size_t>(framesToAppend), &outL.AllMips[0].Buckets[firstBucketIndex], &outR.AllMips[0].Buckets[firstBucketIndex], path);
+
+		outL.IncrementalFramesAppended += frameCount;
+		outR.IncrementalFramesAppended += frameCount;
+	}
+
+	void WaveformMipChain::EndIncrementalStereoGeneration(WaveformMipChain& outL, WaveformMipChain& outR, MixKernelPath path)
+	{
+		// NOTE: Each mip depends on the one before it so the only thing left to parallelize are the two independent channels
+		std::thread channelRThread([&] { outR.GenerateRemainingMips(path, outR.GetIncrementalBaseMipBucketsFilled()); });
+		outL.GenerateRemainingMips(path, outL.GetIncrementalBaseMipBucketsFilled());
+		channelRThread.join();
+	}
+
+	b8 WaveformMipChain::RestoreIncrementalGeneration(i64 totalFrameCount, u32 sampleRate, const WaveformBucket* buckets, size_t bucketCount)
+	{
+		if (totalFrameCount <= 0 || sampleRate == 0)
+			return false;
+
+		BeginIncrementalGeneration(totalFrameCount, sampleRate);
+		if (bucketCount != BucketArenaCount)
+		{
+			*this = {};
+			return false;
+		}
+
+		memcpy(BucketArena.get(), buckets, bucketCount * sizeof(WaveformBucket));
+		IncrementalFramesAppended = totalFrameCount;
+		return true;
+	}
+
+	void WaveformMipChain::ClearAndSetupAllMips(i64 frameCount, u32 sampleRate, b8 includeFullSizeMip)
+	{
+		Duration = FramesToTime(frameCount, sampleRate);
+		for (auto& mip : AllMips)
+			mip.Clear();
+
+		WaveformMip& baseMip = AllMips[0];
+		baseMip.PowerOfTwoSampleCount = RoundUpToPowerOfTwo(static_cast<u32>(frameCount));
+		baseMip.TimePerSample = Time::FromSec(1.0 / static_cast<f64>(sampleRate));
+		baseMip.SamplesPerSecond = static_cast<f64>(sampleRate);
+		baseMip.BucketCount = static_cast<size_t>(frameCount);
+
+		if (!includeFullSizeMip)
+		{
+			baseMip.PowerOfTwoSampleCount /= 2;
+			baseMip.TimePerSample = baseMip.TimePerSample * 2.0;
+			baseMip.SamplesPerSecond = baseMip.SamplesPerSecond / 2.0;
+			baseMip.BucketCount = ClampTop((baseMip.BucketCount + 1) / 2, baseMip.PowerOfTwoSampleCount);
+		}
+
+		// NOTE: Only storing the buckets that actually cover the source instead of padding each mip up to its power of two size
+		for (size_t i = 1; i < MaxMipLevels; i++)
+		{
+			const WaveformMip& parentMip = AllMips[i - 1];
+			if (parentMip.PowerOfTwoSampleCount <= MinMipSampleCount)
+				break;
+
+			WaveformMip& newMip = AllMips[i];
+			newMip.PowerOfTwoSampleCount = (parentMip.PowerOfTwoSampleCount / 2);
+			newMip.TimePerSample = (parentMip.TimePerSample * 2.0);
+			newMip.SamplesPerSecond = (parentMip.SamplesPerSecond / 2.0);
+			newMip.BucketCount = ((parentMip.BucketCount + 1) / 2);
+		}
+
+		size_t totalBucketCountAcrossAllMips = 0;
+		for (const WaveformMip& mip : AllMips)
+			totalBucketCountAcrossAllMips += mip.BucketCount;
+
+		// NOTE: Intentionally left uninitialized as every bucket gets written to exactly once
+		if (totalBucketCountAcrossAllMips != BucketArenaCount || BucketArena == nullptr)
+			BucketArena = std::unique_ptr<WaveformBucket[]>(new WaveformBucket[totalBucketCountAcrossAllMips]);
+		BucketArenaCount = totalBucketCountAcrossAllMips;
+
+		WaveformBucket* nextMipBuckets = BucketArena.get();
+		for (WaveformMip& mip : AllMips)
+		{
+			mip.Buckets = (mip.BucketCount > 0) ? nextMipBuckets : nullptr;
+			nextMipBuckets += mip.BucketCount;
+		}
+	}
+
+	i64 WaveformMipChain::GetIncrementalFramesToAppend(i64 frameCount) const
+	{
+		const i64 remainingFrameCapacity = (static_cast<i64>(AllMips[0].BucketCount) * 2) - IncrementalFramesAppended;
+		return Clamp(frameCount, static_cast<i64>(0), ClampBot(remainingFrameCapacity, static_cast<i64>(0)));
+	}
+
+	size_t WaveformMipChain::GetIncrementalBaseMipBucketsFilled() const
+	{
+		return ClampTop(AllMips[0].BucketCount, static_cast<size_t>((IncrementalFramesAppended + 1) / 2));
+	}
+
+	void WaveformMipChain::GenerateRemainingMips(MixKernelPath path, size_t baseMipBucketsFilled)
+	{
+		// NOTE: In case the source turned out to be shorter than expected
+		WaveformMip& baseMip = AllMips[0];
+		if (baseMipBucketsFilled < baseMip.BucketCount)
+			::memset(&baseMip.Buckets[baseMipBucketsFilled], 0, (baseMip.BucketCount - baseMipBucketsFilled) * sizeof(WaveformBucket));
+
+		for (size_t i = 1; i < MaxMipLevels; i++)
+		{
+			const WaveformMip& parentMip = AllMips[i - 1];
+			WaveformMip& thisMip = AllMips[i];
+			if (thisMip.BucketCount == 0)
+				break;
+
+			assert(thisMip.BucketCount == ((parentMip.BucketCount + 1) / 2));
+			ReduceBucketPairs(parentMip.Buckets, parentMip.BucketCount, thisMip.Buckets, path);
+		}
+	}
+}
@@ -1,57 +1,63 @@
 #pragma once
 #include "core_types.h"
 #include "audio_common.h"
+#include "audio_mix_kernels.h"
 
 // TODO: Texture cache (create interface for uploading texture pixels to have a clean separation from the actual rendering?)
 
 namespace Audio
 {
-	constexpr i16 AverageTwoI16SamplesTogether(i16 a, i16 b) { return static_cast<i16>((static_cast<i32>(a) + static_cast<i32>(b)) / 2); };
+	// NOTE: Absolute peak and root mean square of all source samples covered by a single mip bucket, both in the range [0, 32768]
+	struct WaveformBucket
+	{
+		u16 Peak;
+		u16 RMS;
+	};
+
+	// NOTE: Normalized to [0.0f, 1.0f]
+	struct WaveformAmplitude
+	{
+		f32 Peak;
+		f32 RMS;
+	};
 
 	struct WaveformMip
 	{
 		size_t PowerOfTwoSampleCount = {};
 		Time TimePerSample = {};
 		f64 SamplesPerSecond = {};
-		std::vector<i16> AbsoluteSamples {};
+		// NOTE: View into the bucket arena of the owning WaveformMipChain
+		WaveformBucket* Buckets = nullptr;
+		size_t BucketCount = 0;
 
 		inline Time GetDuration() const
 		{
-			return Time::FromSec(static_cast<f64>(AbsoluteSamples.size()) / SamplesPerSecond);
+			return Time::FromSec(static_cast<f64>(BucketCount) / SamplesPerSecond);
 		}
 
-		inline i16 SampleAtIndexOrZero(size_t sampleIndex) const
+		inline WaveformBucket BucketAtIndexOrZero(i64 bucketIndex) const
 		{
-			return (sampleIndex < AbsoluteSamples.size()) ? AbsoluteSamples[sampleIndex] : static_cast<i16>(0);
+			return (bucketIndex >= 0 && static_cast<size_t>(bucketIndex) < BucketCount) ? Buckets[bucketIndex] : WaveformBucket {};
 		}
 
-		inline i16 LinearSampleAtTimeOrZero(Time time) const
+		inline WaveformAmplitude NormalizedAmplitudeInTimeRange(Time startTime, Time endTime) const
 		{
-			const f32 sampleIndexF32 = static_cast<f32>(time.Seconds * SamplesPerSecond);
-			const f32 sampleIndexFraction = sampleIndexF32 - static_cast<i32>(sampleIndexF32);
-
-			const size_t sampleIndexLo = (sampleIndexF32 <= 0.0f) ? 0 : static_cast<size_t>(sampleIndexF32);
-			const size_t sampleIndexHi = (sampleIndexLo + 1);
-
-			const i16 sampleLo = SampleAtIndexOrZero(sampleIndexLo);
-			const i16 sampleHi = SampleAtIndexOrZero(sampleIndexHi);
+			if (TimePerSample.Seconds <= 0.0) { assert(false); return {}; }
 
-			const f32 normalizedSampleLo = static_cast<f32>(sampleLo / static_cast<f32>(I16Max));
-			const f32 normalizedSampleHi = static_cast<f32>(sampleHi / static_cast<f32>(I16Max));
-			const f32 normalizedSample = Lerp(normalizedSampleLo, normalizedSampleHi, sampleIndexFraction);
+			// NOTE: The closest mip is picked to have at most two buckets per pixel, so this only ever combines a handful of them independent of the zoom level
+			const i64 firstBucketIndex = static_cast<i64>(Floor(startTime.Seconds * SamplesPerSecond));
+			const i64 lastBucketIndex = Max(firstBucketIndex, static_cast<i64>(Ceil(endTime.Seconds * SamplesPerSecond)) - 1);
 
-			return static_cast<i16>(normalizedSample * static_cast<f32>(I16Max));
-		}
-
-		f32 AverageNormalizedSampleInTimeRange(Time startTime, Time endTime) const
-		{
-			if (TimePerSample.Seconds <= 0.0) { assert(false); return 0.0f; }
-
-			i32 sampleSum = 0, sampleCount = 0;
-			for (Time timeIt = startTime; timeIt < endTime; timeIt += TimePerSample) { sampleSum += LinearSampleAtTimeOrZero(timeIt); sampleCount++; }
+			u16 peak = 0, rms = 0;
+			for (i64 bucketIndex = firstBucketIndex; bucketIndex <= lastBucketIndex; bucketIndex++)
+			{
+				const WaveformBucket bucket = BucketAtIndexOrZero(bucketIndex);
+				peak = Max(peak, bucket.Peak);
+				rms = Max(rms, bucket.RMS);
+			}
 
-			const i32 sampleAverage = (sampleSum / Max(sampleCount, 1));
-			return sampleAverage / static_cast<f32>(I16Max);
+			static constexpr f32 normalizationFactor = (1.0f / 32768.0f);
+			return WaveformAmplitude { static_cast<f32>(peak) * normalizationFactor, static_cast<f32>(rms) * normalizationFactor };
 		}
 
 		void Clear()
@@ -59,7 +65,8 @@ namespace Audio
 			PowerOfTwoSampleCount = {};
 			TimePerSample = {};
 			SamplesPerSecond = {};
-			AbsoluteSamples.clear();
+			Buckets = nullptr;
+			BucketCount = 0;
 		}
 	};
 
@@ -86,95 +93,58 @@ namespace Audio
 			return static_cast<i32>(MaxMipLevels);
 		}
 
+		// NOTE: The coarsest mip that still has at least one bucket per pixel, so that no peaks get skipped over
 		inline const WaveformMip& FindClosestMip(Time timePerPixel) const
 		{
 			const WaveformMip* closestMip = &AllMips[0];
 			for (size_t i = 1; i < MaxMipLevels; i++)
 			{
-				if (AllMips[i].PowerOfTwoSampleCount == 0)
+				if (AllMips[i].PowerOfTwoSampleCount == 0 || AllMips[i].TimePerSample > timePerPixel)
 					break;
-				if (Absolute((AllMips[i].TimePerSample - timePerPixel).Seconds < Absolute((closestMip->TimePerSample - timePerPixel).Seconds)))
-					closestMip = &AllMips[i];
+				closestMip = &AllMips[i];
 			}
 			return *closestMip;
 		}
 
-		inline f32 GetAmplitudeAt(const WaveformMip& mip, Time time, Time timePerPixel) const
+		inline WaveformAmplitude GetAmplitudeAt(const WaveformMip& mip, Time time, Time timePerPixel) const
 		{
-			return mip.AverageNormalizedSampleInTimeRange(time, time + timePerPixel);
+			return mip.NormalizedAmplitudeInTimeRange(time, time + timePerPixel);
 		}
 
-		inline void GenerateEntireMipChainFromSampleBuffer(const PCMSampleBuffer& inSampleBuffer, u32 channelIndex, b8 includeFullSizeMip = false)
+		inline size_t GetBucketArenaByteSize() const
 		{
-			assert(inSampleBuffer.InterleavedSamples != nullptr && channelIndex < inSampleBuffer.ChannelCount);
+			return BucketArenaCount * sizeof(WaveformBucket);
+		}
 
-			Duration = FramesToTime(inSampleBuffer.FrameCount, inSampleBuffer.SampleRate);
-			if (AllMips[0].PowerOfTwoSampleCount != 0)
-				for (auto& mip : AllMips) mip.Clear();
+		void GenerateEntireMipChainFromSampleBuffer(const PCMSampleBuffer& inSampleBuffer, u32 channelIndex, b8 includeFullSizeMip = false, MixKernelPath path = MixKernelPath::Default);
 
-			WaveformMip& baseMip = AllMips[0];
-			baseMip.PowerOfTwoSampleCount = RoundUpToPowerOfTwo(static_cast<u32>(inSampleBuffer.FrameCount));
-			baseMip.TimePerSample = Time::FromSec(1.0 / static_cast<f64>(inSampleBuffer.SampleRate));
-			baseMip.SamplesPerSecond = static_cast<f64>(inSampleBuffer.SampleRate);
+		// NOTE: Reads the interleaved samples only once to reduce both channels to their base mips together, and then generates the remaining mips of each channel on its own thread
+		static void GenerateStereoMipChainsFromSampleBuffer(const PCMSampleBuffer& inSampleBuffer, WaveformMipChain& outL, WaveformMipChain& outR, MixKernelPath path = MixKernelPath::Default);
 
-			if (includeFullSizeMip)
-			{
-				baseMip.AbsoluteSamples.resize(inSampleBuffer.FrameCount);
-				for (size_t frameIndex = 0; frameIndex < static_cast<size_t>(inSampleBuffer.FrameCount); frameIndex++)
-					baseMip.AbsoluteSamples[frameIndex] = Absolute(inSampleBuffer.InterleavedSamples[(frameIndex * inSampleBuffer.ChannelCount) + channelIndex]);
-			}
-			else // NOTE: No need to waste memory storing the full size mip if it won't even get sampled AND is already duplicated inside the source buffer
-			{
-				baseMip.PowerOfTwoSampleCount /= 2;
-				baseMip.TimePerSample = baseMip.TimePerSample * 2.0;
-				baseMip.SamplesPerSecond = baseMip.SamplesPerSecond / 2.0;
-				baseMip.AbsoluteSamples.resize(baseMip.PowerOfTwoSampleCount);
-				const size_t samplesToFill = ClampTop(baseMip.AbsoluteSamples.size(), static_cast<size_t>(inSampleBuffer.FrameCount / 2));
-				for (size_t frameIndex = 0; frameIndex < samplesToFill; frameIndex++)
-				{
-					baseMip.AbsoluteSamples[frameIndex] = AverageTwoI16SamplesTogether(
-						Absolute(inSampleBuffer.InterleavedSamples[(((frameIndex * 2 + 0) * inSampleBuffer.ChannelCount) + channelIndex)]),
-						Absolute(inSampleBuffer.InterleavedSamples[(((frameIndex * 2 + 1) * inSampleBuffer.ChannelCount) + channelIndex)]));
-				}
-			}
+		// NOTE: For generating the mip chain from sequentially decoded chunks, without the entire sample buffer ever having to exist in memory.
+		//		 All chunks except for the last one must contain an even number of frames (as every two frames are reduced into a single base mip bucket)
+		void BeginIncrementalGeneration(i64 totalFrameCount, u32 sampleRate);
+		void AppendIncrementalFrames(const i16* interleavedSamples, i64 frameCount, u32 channelCount, u32 channelIndex, MixKernelPath path = MixKernelPath::Default);
+		void EndIncrementalGeneration(MixKernelPath path = MixKernelPath::Default);
 
-			// NOTE: First loop (separated) to compute sample counts
-			for (size_t i = 1; i < MaxMipLevels; i++)
-			{
-				const WaveformMip& parentMip = AllMips[i - 1];
-				if (parentMip.PowerOfTwoSampleCount <= MinMipSampleCount)
-					break;
+		// NOTE: Same as the above for both channels of a stereo source, with the chunks being deinterleaved in the same pass as reducing them
+		static void AppendIncrementalStereoFrames(WaveformMipChain& outL, WaveformMipChain& outR, const i16* interleavedSamples, i64 frameCount, MixKernelPath path = MixKernelPath::Default);
+		static void EndIncrementalStereoGeneration(WaveformMipChain& outL, WaveformMipChain& outR, MixKernelPath path = MixKernelPath::Default);
 
-				WaveformMip& newMip = AllMips[i];
-				newMip.PowerOfTwoSampleCount = (parentMip.PowerOfTwoSampleCount / 2);
-				newMip.TimePerSample = (parentMip.TimePerSample * 2.0);
-				newMip.SamplesPerSecond = (parentMip.SamplesPerSecond / 2.0);
-			}
+		// NOTE: For storing a chain generated incrementally and restoring it later on, as the layout of all mips is fully determined by the frame count and sample rate of the source
+		inline const WaveformBucket* GetBucketArena() const { return BucketArena.get(); }
+		inline size_t GetBucketArenaCount() const { return BucketArenaCount; }
+		b8 RestoreIncrementalGeneration(i64 totalFrameCount, u32 sampleRate, const WaveformBucket* buckets, size_t bucketCount);
 
-			// TODO: Consider having single continuous sample buffer and store view pointer (or start index) inside each WaveformMip
-			[[maybe_unused]] size_t totalSampleCountAcrossAllMips = 0;
-			for (const WaveformMip& mip : AllMips)
-				totalSampleCountAcrossAllMips += (&mip == &baseMip) ? baseMip.AbsoluteSamples.size() : mip.PowerOfTwoSampleCount;
+	private:
+		// NOTE: Single allocation for the buckets of all mips, with each of them only storing a view into it
+		std::unique_ptr<WaveformBucket[]> BucketArena;
+		size_t BucketArenaCount = 0;
+		i64 IncrementalFramesAppended = 0;
 
-			// NOTE: Second loop to then generate the actual mip sample buffers
-			for (size_t i = 1; i < MaxMipLevels; i++)
-			{
-				const WaveformMip& parentMip = AllMips[i - 1];
-				if (parentMip.PowerOfTwoSampleCount == 0)
-					break;
-				const size_t parentSampleCount = parentMip.AbsoluteSamples.size();
-				const i16* parentSamples = parentMip.AbsoluteSamples.data();
-
-				WaveformMip& thisMip = AllMips[i];
-				thisMip.AbsoluteSamples.resize(thisMip.PowerOfTwoSampleCount);
-				const size_t samplesToFill = ClampTop(thisMip.AbsoluteSamples.size(), (parentSampleCount / 2));
-				for (size_t sampleIndex = 0; sampleIndex < samplesToFill; sampleIndex++)
-				{
-					// ... assert(parentSamples >= &parentMip.AbsoluteSamples.front() && parentSamples <= &parentMip.AbsoluteSamples.back());
-					thisMip.AbsoluteSamples[sampleIndex] = AverageTwoI16SamplesTogether(parentSamples[0], parentSamples[1]);
-					parentSamples += 2;
-				}
-			}
-		}
+		void ClearAndSetupAllMips(i64 frameCount, u32 sampleRate, b8 includeFullSizeMip);
+		i64 GetIncrementalFramesToAppend(i64 frameCount) const;
+		size_t GetIncrementalBaseMipBucketsFilled() const;
+		void GenerateRemainingMips(MixKernelPath path, size_t baseMipBucketsFilled);
 	};
 }
@@ -1,11 +1,46 @@
 #include "core_beat.h"
 #include <algorithm>
 
+i32 TempoMapAccelerationStructure::FindSegmentIndexContainingTick(i32 tick) const
+{
+	const i32 segmentCount = static_cast<i32>(Segments.size());
+	const i32 lastSegmentIndex = (segmentCount - 1);
+	const auto isInside = [&](i32 index) { return (Segments[index].StartTick <= tick) && (index == lastSegmentIndex || tick < Segments[index + 1].StartTick); };
+
+	// NOTE: Try the last used segment and its successor first as lookups are typically done in (roughly) ascending order
+	const i32 hint = ClampTop(SegmentCursorHint, lastSegmentIndex);
+	if (isInside(hint))
+		return hint;
+	if (hint < lastSegmentIndex && isInside(hint + 1))
+		return (SegmentCursorHint = hint + 1);
+
+	const auto it = std::upper_bound(Segments.begin(), Segments.end(), tick, [](i32 t, const Segment& segment) { return t < segment.StartTick; });
+	return (SegmentCursorHint = ClampBot(static_cast<i32>(std::distance(Segments.begin(), it)) - 1, 0));
+}
+
+i32 TempoMapAccelerationStructure::FindSegmentIndexContainingTime(f64 time) const
+{
+	const i32 segmentCount = static_cast<i32>(Segments.size());
+	const i32 lastSegmentIndex = (segmentCount - 1);
+	const auto isInside = [&](i32 index) { return (Segments[index].StartTime <= time) && (index == lastSegmentIndex || time < Segments[index + 1].StartTime); };
+
+	const i32 hint = ClampTop(SegmentCursorHint, lastSegmentIndex);
+	if (isInside(hint))
+		return hint;
+	if (hint < lastSegmentIndex && isInside(hint + 1))
+		return (SegmentCursorHint = hint + 1);
+
+	const auto it = std::upper_bound(Segments.begin(), Segments.end(), time, [](f64 t, const Segment& segment) { return t < segment.StartTime; });
+	return (SegmentCursorHint = ClampBot(static_cast<i32>(std::distance(Segments.begin(), it)) - 1, 0));
+}
+
 Time TempoMapAccelerationStructure::ConvertBeatToTimeUsingLookupTableIndexing(Beat beat) const
 {
-	const i32 beatTickToTimesCount = static_cast<i32>(BeatTickToTimes.size());
 	const i32 totalBeatTicks = beat.Ticks;
 
+	if (Segments.empty())
+		return Time::Zero();
+
 	if (totalBeatTicks < 0) // NOTE: Negative tick (tempo changes are assumed to only be positive)
 	{
 		// NOTE: Calculate the duration of a Beat at the first tempo
@@ -14,21 +49,10 @@ Time TempoMapAccelerationStructure::ConvertBeatToTimeUsingLookupTableIndexing(Be
 		// NOTE: Then scale by the negative tick
 		return firstTickDuration * totalBeatTicks;
 	}
-	else if (totalBeatTicks >= beatTickToTimesCount) // NOTE: Tick is outside the defined tempo map
-	{
-		// NOTE: Take the last calculated time
-		const Time lastTime = GetLastCalculatedTime();
-
-		// NOTE: Calculate the duration of a Beat at the last used tempo
-		const Time lastTickDuration = Time::FromSec((60.0 / abs(LastTempoBPM)) / Beat::TicksPerBeat);
-
-		// NOTE: Then scale by the remaining ticks
-		const i32 remainingTicks = (totalBeatTicks - beatTickToTimesCount) + 1;
-		return lastTime + (lastTickDuration * remainingTicks);
-	}
-	else // NOTE: Use the pre calculated lookup table directly
+	else // NOTE: Find the containing segment (which for the last one extends past the defined tempo map) and scale by the ticks within it
 	{
-		return BeatTickToTimes.at(totalBeatTicks);
+		const Segment& segment = Segments[FindSegmentIndexContainingTick(totalBeatTicks)];
+		return Time::FromSec((segment.TickDuration * (totalBeatTicks - segment.StartTick)) + segment.StartTime);
 	}
 }
 
@@ -39,7 +63,9 @@ Beat TempoMapAccelerationStructure::ConvertTimeToBeatUsingLookupTableBinarySearc
 
 Beat TempoMapAccelerationStructure::ConvertTimeToBeatUsingLookupTableBinarySearch(Time time, bool truncTo0) const
 {
-	const i32 beatTickToTimesCount = static_cast<i32>(BeatTickToTimes.size());
+	if (Segments.empty())
+		return Beat::Zero();
+
 	const Time lastTime = GetLastCalculatedTime();
 
 	if (time < Time::FromSec(0.0)) // NOTE: Negative time
@@ -61,27 +87,31 @@ Beat TempoMapAccelerationStructure::ConvertTimeToBeatUsingLookupTableBinarySearc
 		const f64 ticks = (timePastLast / lastTickDuration);
 
 		// NOTE: And add it to the last tick
-		return Beat(static_cast<i32>(beatTickToTimesCount + ticks - 1));
+		return Beat(static_cast<i32>(Segments.back().StartTick + ticks));
 	}
-	else // NOTE: Perform a binary search
+	else // NOTE: Find the containing segment, then the two ticks surrounding the time within it
 	{
-		i32 left = 0, right = beatTickToTimesCount - 1;
-
-		while (left <= right)
-		{
-			const i32 mid = (left + right) / 2;
-
-			if (time < BeatTickToTimes[mid])
-				right = mid - 1;
-			else if (time > BeatTickToTimes[mid])
-				left = mid + 1;
-			else
-				return Beat::FromTicks(mid);
-		}
-
-		// left > right
-		return Beat::FromTicks((truncTo0) ? right
-			: (BeatTickToTimes[left] - time) < (time - BeatTickToTimes[right]) ? left : right);
+		const i32 segmentIndex = FindSegmentIndexContainingTime(time.Seconds);
+		const Segment& segment = Segments[segmentIndex];
+		const Segment& nextSegment = Segments[segmentIndex + 1];
+
+		const i32 segmentTickCount = (nextSegment.StartTick - segment.StartTick);
+		const auto tickTimeWithinSegment = [&](i32 ticks) { return (ticks < segmentTickCount) ? ((segment.TickDuration * ticks) + segment.StartTime) : nextSegment.StartTime; };
+
+		// NOTE: Estimate directly then correct for floating point error so that the result is always bracketed by the exact same tick times BeatToTime would return
+		i32 ticksIntoSegment = Clamp(static_cast<i32>(Floor((time.Seconds - segment.StartTime) / segment.TickDuration)), 0, segmentTickCount - 1);
+		while (ticksIntoSegment > 0 && time.Seconds < tickTimeWithinSegment(ticksIntoSegment))
+			ticksIntoSegment--;
+		while (ticksIntoSegment + 1 < segmentTickCount && time.Seconds >= tickTimeWithinSegment(ticksIntoSegment + 1))
+			ticksIntoSegment++;
+
+		const i32 tickLeft = (segment.StartTick + ticksIntoSegment);
+		const f64 timeLeft = tickTimeWithinSegment(ticksIntoSegment);
+		const f64 timeRight = tickTimeWithinSegment(ticksIntoSegment + 1);
+
+		// NOTE: Round to the closer tick, preferring the earlier one if equally distant
+		return Beat::FromTicks((truncTo0) ? tickLeft
+			: (timeRight - time.Seconds) < (time.Seconds - timeLeft) ? (tickLeft + 1) : tickLeft);
 	}
 }
 
@@ -89,9 +119,11 @@ Beat TempoMapAccelerationStructure::ConvertTimeToBeatUsingLookupTableBinarySearc
 // allow over-extrapolating for reproducing TaikoJiro "time offset over tempo change" behavior
 f64 TempoMapAccelerationStructure::ConvertBeatAndTimeToHBScrollBeatTickUsingLookupTableIndexing(Beat beat, Time time) const
 {
-	const i32 beatTickToTimesCount = static_cast<i32>(BeatTickToTimes.size());
 	const i32 totalBeatTicks = beat.Ticks;
 
+	if (Segments.empty())
+		return 0.0;
+
 	if (totalBeatTicks < 0) // NOTE: Negative tick (tempo changes are assumed to only be positive)
 	{
 		// NOTE: Calculate the duration of a Beat at the first tempo
@@ -100,45 +132,29 @@ f64 TempoMapAccelerationStructure::ConvertBeatAndTimeToHBScrollBeatTickUsingLook
 		// NOTE: Then the time by the negative tick, this is assuming all tempo changes happen on positive ticks
 		return time / firstTickDuration;
 	}
-	else if (totalBeatTicks + 1 >= beatTickToTimesCount) // NOTE: Next tick is outside the defined tempo map
+	else // NOTE: Segments are linear in both time and HBScroll beat ticks so the segment of `beat` can be used directly for interpolating or extrapolating to `time`
 	{
-		const f64 lastHBScrollBeatTick = GetLastCalculatedHBScrollBeatTick();
-		const Time lastTime = GetLastCalculatedTime();
-		const Time timePastLast = (time - lastTime);
-
-		// NOTE: Each tick past the end has a duration of this value
-		const Time lastTickDuration = Time::FromSec((60.0 / LastTempoBPM) / Beat::TicksPerBeat);
-
-		// NOTE: So we just have to divide the remaining ticks by the duration
-		const f64 ticks = (timePastLast / lastTickDuration);
-
-		// NOTE: And add it to the last tick
-		return (lastHBScrollBeatTick + ticks);
-	}
-	else // NOTE: Use the pre calculated lookup table directly
-	{
-		// find the integer HBScroll beat tick using `beat`, and then interpolate by `time`
-		const i32 totalBeatTicks = beat.Ticks;
-		const f64 timeLeft = BeatTickToTimes.at(totalBeatTicks).Seconds;
-		const f64 timeRight = BeatTickToTimes.at(totalBeatTicks + 1).Seconds;
-		const f64 ticksLeft = BeatTickToHBScrollBeatTicks.at(totalBeatTicks);
-		const f64 ticksRight = BeatTickToHBScrollBeatTicks.at(totalBeatTicks + 1);
-
-		return ConvertRange(timeLeft, timeRight, ticksLeft, ticksRight, time.Seconds);
+		const Segment& segment = Segments[FindSegmentIndexContainingTick(totalBeatTicks)];
+		return segment.StartHBScrollBeatTick + (segment.TickSign * (time.Seconds - segment.StartTime) / segment.TickDuration);
 	}
 }
 
 Time TempoMapAccelerationStructure::GetLastCalculatedTime() const
 {
-	return BeatTickToTimes.empty() ? Time::Zero() : BeatTickToTimes.back();
+	return Segments.empty() ? Time::Zero() : Time::FromSec(Segments.back().StartTime);
 }
 
 f64 TempoMapAccelerationStructure::GetLastCalculatedHBScrollBeatTick() const
 {
-	return BeatTickToHBScrollBeatTicks.empty() ? 0.0 : BeatTickToHBScrollBeatTicks.back();
+	return Segments.empty() ? 0.0 : Segments.back().StartHBScrollBeatTick;
 }
 
 void TempoMapAccelerationStructure::Rebuild(const TempoChange* inTempoChanges, size_t inTempoCount)
+{
+	Rebuild(inTempoChanges, inTempoCount, Beat::Zero());
+}
+
+void TempoMapAccelerationStructure::Rebuild(const TempoChange* inTempoChanges, size_t inTempoCount, Beat firstChangedBeat)
 {
 	const TempoChange* tempoChanges = inTempoChanges;
 	size_t tempoCount = inTempoCount;
@@ -154,13 +170,19 @@ void TempoMapAccelerationStructure::Rebuild(const TempoChange* inTempoChanges, s
 		tempoCount = TempoBuffer.size();
 	}
 
-	size_t nTickValues = (tempoCount > 0) ? tempoChanges[tempoCount - 1].Beat.Ticks + 1 : 0;
-	BeatTickToTimes.resize(nTickValues);
-	BeatTickToHBScrollBeatTicks.resize(nTickValues);
+	// NOTE: Segments starting before the first changed beat remain valid as they only depend on the tempo changes preceding them,
+	//		 so only the remaining ones have to be recalculated (with the segment at tick 0 always being part of the changed range for (firstChangedBeat <= 0))
+	const auto firstSegmentToDiscard = std::lower_bound(Segments.begin(), Segments.end(), firstChangedBeat.Ticks, [](const Segment& segment, i32 t) { return segment.StartTick < t; });
+	const auto firstTempoChangeToRecalculate = std::lower_bound(tempoChanges, tempoChanges + tempoCount, firstChangedBeat, [](const TempoChange& tempo, Beat b) { return tempo.Beat < b; });
+	const size_t startTempoChangeIndex = (firstSegmentToDiscard == Segments.begin()) ? 0 : static_cast<size_t>(firstTempoChangeToRecalculate - tempoChanges);
+
+	Segments.erase(firstSegmentToDiscard, Segments.end());
+	Segments.reserve(tempoCount);
+	SegmentCursorHint = 0;
 
 	f64 lastEndTime = 0.0;
 	i32 lastEndHBScrollBeatTick = 0;
-	for (size_t tempoChangeIndex = 0; tempoChangeIndex < tempoCount; tempoChangeIndex++)
+	for (size_t tempoChangeIndex = startTempoChangeIndex; tempoChangeIndex < tempoCount; tempoChangeIndex++)
 	{
 		const TempoChange& tempoChange = tempoChanges[tempoChangeIndex];
 
@@ -169,25 +191,30 @@ void TempoMapAccelerationStructure::Rebuild(const TempoChange* inTempoChanges, s
 		const f64 tickDuration = abs(beatDuration / Beat::TicksPerBeat);
 		const f64 tickSign = Sign(beatDuration);
 
-		const b8 isSingleOrLastTempo = (tempoCount == 1) || (tempoChangeIndex == (tempoCount - 1));
-		const size_t timesCount = isSingleOrLastTempo ? BeatTickToTimes.size() : (tempoChanges[tempoChangeIndex + 1].Beat.Ticks);
-
-		for (size_t i = 0, t = tempoChange.Beat.Ticks; t < timesCount; i++, t++)
+		// NOTE: Advance to the start of this segment using the previous one's tempo
+		if (!Segments.empty())
 		{
-			BeatTickToTimes[t] = Time::FromSec((tickDuration * i) + lastEndTime);
-			BeatTickToHBScrollBeatTicks[t] = ((tickSign * i) + lastEndHBScrollBeatTick);
+			const Segment& lastSegment = Segments.back();
+			const i32 lastSegmentTickCount = (tempoChange.Beat.Ticks - lastSegment.StartTick);
+			lastEndTime = ((lastSegment.TickDuration * (lastSegmentTickCount - 1)) + lastSegment.StartTime) + lastSegment.TickDuration;
+			lastEndHBScrollBeatTick = lastSegment.StartHBScrollBeatTick + static_cast<i32>(lastSegment.TickSign * lastSegmentTickCount);
+
+			// NOTE: Zero length segments would never be looked up so just let the later tempo change take their place
+			if (lastSegmentTickCount <= 0)
+			{
+				lastEndTime = lastSegment.StartTime;
+				lastEndHBScrollBeatTick = lastSegment.StartHBScrollBeatTick;
+				Segments.pop_back();
+			}
 		}
 
-		if (tempoCount > 1)
-		{
-			lastEndTime = BeatTickToTimes[timesCount - 1].ToSec() + tickDuration;
-			lastEndHBScrollBeatTick = BeatTickToHBScrollBeatTicks[timesCount - 1] + tickSign;
-		}
+		Segments.push_back(Segment { tempoChange.Beat.Ticks, lastEndHBScrollBeatTick, lastEndTime, tickDuration, tickSign });
 
 		FirstTempoBPM = (tempoChangeIndex == 0) ? bpm : FirstTempoBPM;
-		LastTempoBPM = bpm;
 	}
 
+	LastTempoBPM = SafetyCheckTempo(tempoChanges[tempoCount - 1].Tempo).BPM;
+
 	if (!TempoBuffer.empty())
 		TempoBuffer.clear();
 }
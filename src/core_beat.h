@@ -21,7 +21,7 @@ struct Beat
 	static constexpr Beat FromTicks(i32 ticks) { return Beat(ticks); }
 	static constexpr Beat FromBeats(i32 beats) { return Beat(TicksPerBeat * beats); }
 	static constexpr Beat FromBars(i32 bars, i32 beatsPerBar = 4) { return FromBeats(bars * beatsPerBar); }
-	static constexpr Beat FromBeatsFraction(f64 fraction) { return FromTicks(static_cast<i32>(Round(fraction * static_cast<f64>(TicksPerBeat)))); }
+	static inline Beat FromBeatsFraction(f64 fraction) { return FromTicks(static_cast<i32>(Round(fraction * static_cast<f64>(TicksPerBeat)))); }
 
 	constexpr b8 operator==(const Beat& other) const { return Ticks == other.Ticks; }
 	constexpr b8 operator!=(const Beat& other) const { return Ticks != other.Ticks; }
@@ -145,19 +145,19 @@ namespace PeepoDrumKit {
 	struct TempoChange
 	{
 		constexpr TempoChange() = default;
-		constexpr TempoChange(Beat beat, Tempo tempo) : Beat(beat), Tempo(tempo) {}
+		constexpr TempoChange(::Beat beat, ::Tempo tempo) : Beat(beat), Tempo(tempo) {}
 
-		Beat Beat = {};
-		Tempo Tempo = {};
+		::Beat Beat = {};
+		::Tempo Tempo = {};
 		b8 IsSelected = false;
 	};
 
 	struct TimeSignatureChange
 	{
 		constexpr TimeSignatureChange() = default;
-		constexpr TimeSignatureChange(Beat beat, TimeSignature signature) : Beat(beat), Signature(signature) {}
+		constexpr TimeSignatureChange(::Beat beat, TimeSignature signature) : Beat(beat), Signature(signature) {}
 
-		Beat Beat = {};
+		::Beat Beat = {};
 		TimeSignature Signature = {};
 		b8 IsSelected = false;
 	};
@@ -195,6 +195,11 @@ struct BeatSortedList
 	T* TryFindOverlappingBeatUntrusted(Beat beatStart, Beat beatEnd, b8 inclusiveBeatCheck = true);
 	const T* TryFindOverlappingBeatUntrusted(Beat beatStart, Beat beatEnd, b8 inclusiveBeatCheck = true) const;
 
+	// NOTE: Binary searched for culling (such as only drawing the items within the visible range). Items with a duration (or any other extent) starting before minBeat
+	//		 are not included, so the caller has to lower minBeat by the longest such extent
+	// return { the index of the first item starting at or after minBeat, the index past the last item starting at or before maxBeat }
+	std::pair<size_t, size_t> GetIndexRangeStartingWithin(Beat minBeat, Beat maxBeat) const;
+
 	// return the to-insert index
 	template <typename Func> size_t InsertOrFunc(const T& valueToInsert, Func funcExist);
 	// return { the to-insert index, is inserted }
@@ -202,6 +207,14 @@ struct BeatSortedList
 	// return the insertion or update index
 	size_t InsertOrUpdate(const T& valueToInsertOrUpdate);
 
+	// NOTE: Same result as calling InsertOrFunc() / InsertOrUpdate() for each value in order but in O(n log n) instead of O(n^2),
+	//		 by stable sorting the values (only keeping the last one of each beat) and then merging them with the existing items in a single pass.
+	//		 Unlike calling InsertOrFunc() one at a time, funcExist is only ever called for existing items and never between two of the new values
+	template <typename Func> void BulkInsertOrFunc(std::vector<T> valuesToInsert, Func funcExist);
+	void BulkInsertOrUpdate(std::vector<T> valuesToInsertOrUpdate);
+	// NOTE: Replaces all existing items, same as clearing the list followed by BulkInsertOrUpdate()
+	void Assign(std::vector<T> unsortedValues);
+
 	void RemoveAtBeat(Beat beatToFindAndRemove);
 	void RemoveAtIndex(size_t indexToRemove);
 
@@ -226,12 +239,24 @@ struct BeatSortedList
 
 struct TempoMapAccelerationStructure
 {
-	// NOTE: Pre calculated beat times up to the last tempo change
-	std::vector<Time> BeatTickToTimes;
-	std::vector<i32> BeatTickToHBScrollBeatTicks;
+	// NOTE: Piecewise linear segment starting at a tempo change and spanning up until the next one (or infinitely for the last one)
+	struct Segment
+	{
+		i32 StartTick;
+		i32 StartHBScrollBeatTick;
+		f64 StartTime;
+		f64 TickDuration;
+		f64 TickSign;
+	};
+
+	// NOTE: Pre calculated segments, one per tempo change so that both memory and rebuild cost scale with the tempo change count instead of the chart length
+	std::vector<Segment> Segments;
 	std::vector<TempoChange> TempoBuffer;
 	f64 FirstTempoBPM = 0.0, LastTempoBPM = 0.0;
 
+	// NOTE: Index of the last looked up segment, checked first so that (mostly) sequential lookups don't even have to binary search
+	mutable i32 SegmentCursorHint = 0;
+
 	Time ConvertBeatToTimeUsingLookupTableIndexing(Beat beat) const;
 	Beat ConvertTimeToBeatUsingLookupTableBinarySearch(Time time) const;
 	Beat ConvertTimeToBeatUsingLookupTableBinarySearch(Time time, bool truncTo0) const;
@@ -240,6 +265,11 @@ struct TempoMapAccelerationStructure
 	Time GetLastCalculatedTime() const;
 	f64 GetLastCalculatedHBScrollBeatTick() const;
 	void Rebuild(const TempoChange* inTempoChanges, size_t inTempoCount);
+	void Rebuild(const TempoChange* inTempoChanges, size_t inTempoCount, Beat firstChangedBeat);
+
+private:
+	i32 FindSegmentIndexContainingTick(i32 tick) const;
+	i32 FindSegmentIndexContainingTime(f64 time) const;
 };
 
 // NOTE: Used when no other tempo / time signature change is defined (empty list or pre-first beat)
@@ -261,12 +291,14 @@ struct SortedTempoMap
 
 	// NOTE: Must manually be called every time a TempoChange has been edited otherwise Beat <-> Time conversions will be incorrect
 	inline void RebuildAccelerationStructure() { AccelerationStructure.Rebuild(Tempo.data(), Tempo.size()); }
+	// NOTE: Same as above but only recalculates from the first (in either the old or the new state) edited TempoChange onwards
+	inline void RebuildAccelerationStructure(Beat firstChangedBeat) { AccelerationStructure.Rebuild(Tempo.data(), Tempo.size(), firstChangedBeat); }
 	inline Time BeatToTime(Beat beat) const { return AccelerationStructure.ConvertBeatToTimeUsingLookupTableIndexing(beat); }
 	inline Beat TimeToBeat(Time time) const { return TimeToBeat(time, false); }
 	inline Beat TimeToBeat(Time time, bool truncTo0) const { return AccelerationStructure.ConvertTimeToBeatUsingLookupTableBinarySearch(time, truncTo0); }
 	inline f64 BeatAndTimeToHBScrollBeatTick(Beat beat, Time time) const { return AccelerationStructure.ConvertBeatAndTimeToHBScrollBeatTickUsingLookupTableIndexing(beat, time); }
 
-	struct ForEachBeatBarData { TimeSignature Signature; Beat Beat; i32 BarIndex; b8 IsBar; };
+	struct ForEachBeatBarData { TimeSignature Signature; ::Beat Beat; i32 BarIndex; b8 IsBar; };
 	template <typename Func>
 	inline void ForEachBeatBar(Func perBeatBarFunc) const
 	{
@@ -462,6 +494,96 @@ size_t BeatSortedList<T>::InsertOrUpdate(const T& valueToInsertOrUpdate)
 	return InsertOrFunc(valueToInsertOrUpdate, [&](T& existing, ...) { existing = valueToInsertOrUpdate; });
 }
 
+template <typename T>
+inline void StableSortByBeatAndKeepLastOfEachBeat(std::vector<T>& inOutValues)
+{
+	const auto isBeatLess = [](const T& a, const T& b) { return GetBeat(a) < GetBeat(b); };
+	if (!std::is_sorted(inOutValues.begin(), inOutValues.end(), isBeatLess))
+		std::stable_sort(inOutValues.begin(), inOutValues.end(), isBeatLess);
+
+	size_t writeIndex = 0;
+	for (size_t readIndex = 0; readIndex < inOutValues.size(); readIndex++)
+	{
+		if ((readIndex + 1) < inOutValues.size() && GetBeat(inOutValues[readIndex + 1]) == GetBeat(inOutValues[readIndex]))
+			continue;
+		if (writeIndex != readIndex)
+			inOutValues[writeIndex] = std::move(inOutValues[readIndex]);
+		writeIndex++;
+	}
+	inOutValues.erase(inOutValues.begin() + writeIndex, inOutValues.end());
+}
+
+template <typename T> template <typename Func>
+void BeatSortedList<T>::BulkInsertOrFunc(std::vector<T> valuesToInsert, Func funcExist)
+{
+	StableSortByBeatAndKeepLastOfEachBeat(valuesToInsert);
+	if (valuesToInsert.empty())
+		return;
+
+	// NOTE: Common case of only appending after the last existing item (such as when building up a list from scratch)
+	if (Sorted.empty() || GetBeat(Sorted.back()) < GetBeat(valuesToInsert.front()))
+	{
+		if (Sorted.empty())
+			Sorted = std::move(valuesToInsert);
+		else
+			Sorted.insert(Sorted.end(), std::make_move_iterator(valuesToInsert.begin()), std::make_move_iterator(valuesToInsert.end()));
+	}
+	else
+	{
+		std::vector<T> merged;
+		merged.reserve(Sorted.size() + valuesToInsert.size());
+
+		size_t existingIndex = 0, newIndex = 0;
+		while (existingIndex < Sorted.size() && newIndex < valuesToInsert.size())
+		{
+			T& existing = Sorted[existingIndex];
+			T& newValue = valuesToInsert[newIndex];
+			if (GetBeat(existing) < GetBeat(newValue))
+			{
+				merged.push_back(std::move(existing)); existingIndex++;
+			}
+			else if (GetBeat(newValue) < GetBeat(existing))
+			{
+				merged.push_back(std::move(newValue)); newIndex++;
+			}
+			else
+			{
+				funcExist(existing, newValue);
+				merged.push_back(std::move(existing)); existingIndex++; newIndex++;
+			}
+		}
+		for (; existingIndex < Sorted.size(); existingIndex++) merged.push_back(std::move(Sorted[existingIndex]));
+		for (; newIndex < valuesToInsert.size(); newIndex++) merged.push_back(std::move(valuesToInsert[newIndex]));
+		Sorted = std::move(merged);
+	}
+
+#if PEEPO_DEBUG
+	assert(Sorted.empty() || GetBeat(Sorted.front()).Ticks >= 0);
+	assert(ValidateIsSortedByBeat(*this));
+#endif
+}
+
+template <typename T>
+void BeatSortedList<T>::BulkInsertOrUpdate(std::vector<T> valuesToInsertOrUpdate)
+{
+	BulkInsertOrFunc(std::move(valuesToInsertOrUpdate), [](T& existing, const T& newValue) { existing = newValue; });
+}
+
+template <typename T>
+void BeatSortedList<T>::Assign(std::vector<T> unsortedValues)
+{
+	StableSortByBeatAndKeepLastOfEachBeat(unsortedValues);
+	Sorted = std::move(unsortedValues);
+}
+
+template <typename T>
+std::pair<size_t, size_t> BeatSortedList<T>::GetIndexRangeStartingWithin(Beat minBeat, Beat maxBeat) const
+{
+	const auto first = std::lower_bound(Sorted.begin(), Sorted.end(), minBeat, [](const T& v, Beat beat) { return GetBeat(v) < beat; });
+	const auto last = (minBeat <= maxBeat) ? std::upper_bound(first, Sorted.end(), maxBeat, [](Beat beat, const T& v) { return beat < GetBeat(v); }) : first;
+	return { static_cast<size_t>(std::distance(Sorted.begin(), first)), static_cast<size_t>(std::distance(Sorted.begin(), last)) };
+}
+
 template <typename T>
 void BeatSortedList<T>::RemoveAtBeat(Beat beatToFindAndRemove)
 {
@@ -2,11 +2,22 @@
 #include "core_string.h"
 #include <vector>
 #include <algorithm>
+
+#if PEEPO_WIN32
 #include <shlwapi.h>
 #include <shobjidl.h>
 #include <Windows.h>
 #include <wrl.h>
 using Microsoft::WRL::ComPtr;
+#else
+// NOTE: Only the file system parts are implemented outside of Windows (for the command line batch tool), with the Shell functions reduced to stubs
+#include <filesystem>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace Path
 {
@@ -64,6 +75,7 @@ namespace Path
 		return fileName.empty() ? filePath : filePath.substr(0, filePath.size() - fileName.size() - 1);
 	}
 
+#if PEEPO_WIN32
 	b8 IsRelative(std::string_view filePath)
 	{
 		return ::PathIsRelativeW(UTF8::WideArg(filePath).c_str());
@@ -73,6 +85,18 @@ namespace Path
 	{
 		return ::PathIsDirectoryW(UTF8::WideArg(filePath).c_str());
 	}
+#else
+	b8 IsRelative(std::string_view filePath)
+	{
+		return !ASCII::StartsWith(filePath, DirectorySeparator);
+	}
+
+	b8 IsDirectory(std::string_view filePath)
+	{
+		struct stat fileStatus;
+		return (::stat(std::string(filePath).c_str(), &fileStatus) == 0) && S_ISDIR(fileStatus.st_mode);
+	}
+#endif
 
 	std::string TryMakeAbsolute(std::string_view relativePath, std::string_view baseFileOrDirectory)
 	{
@@ -84,6 +108,7 @@ namespace Path
 		return baseDirectory.append("/").append(relativePath);
 	}
 
+#if PEEPO_WIN32
 	std::string TryMakeRelative(std::string_view absolutePath, std::string_view baseFileOrDirectory)
 	{
 		auto basePathU16 = UTF8::WideArg(CopyAndNormalizeWin32(baseFileOrDirectory));
@@ -96,6 +121,13 @@ namespace Path
 
 		return success ? std::string { ASCII::TrimPrefix(UTF8::Narrow(FixedBufferWStringView(outRelative)), Win32CurrentDirectoryPrefix) } : "";
 	}
+#else
+	std::string TryMakeRelative(std::string_view absolutePath, std::string_view baseFileOrDirectory)
+	{
+		const std::string_view baseDirectory = IsDirectory(baseFileOrDirectory) ? baseFileOrDirectory : GetDirectoryName(baseFileOrDirectory);
+		return std::filesystem::path(absolutePath).lexically_relative(baseDirectory).generic_string();
+	}
+#endif
 
 	std::string CopyAndNormalize(std::string_view filePath)
 	{
@@ -126,6 +158,7 @@ namespace Path
 
 namespace File
 {
+#if PEEPO_WIN32
 	UniqueFileContent ReadAllBytes(std::string_view filePath)
 	{
 		if (filePath.empty())
@@ -176,6 +209,62 @@ namespace File
 
 		return true;
 	}
+#else
+	UniqueFileContent ReadAllBytes(std::string_view filePath)
+	{
+		if (filePath.empty())
+			return UniqueFileContent {};
+
+		const int fileDescriptor = ::open(std::string(filePath).c_str(), O_RDONLY);
+		if (fileDescriptor < 0)
+			return UniqueFileContent {};
+
+		defer { ::close(fileDescriptor); };
+
+		struct stat fileStatus;
+		if (::fstat(fileDescriptor, &fileStatus) != 0)
+			return UniqueFileContent {};
+
+		const size_t fileSize = static_cast<size_t>(fileStatus.st_size);
+		auto fileContent = std::unique_ptr<u8[]>(new u8[fileSize + 1]);
+
+		for (size_t totalBytesRead = 0; totalBytesRead < fileSize;)
+		{
+			const ssize_t bytesRead = ::read(fileDescriptor, fileContent.get() + totalBytesRead, fileSize - totalBytesRead);
+			if (bytesRead <= 0)
+				return UniqueFileContent {};
+			totalBytesRead += static_cast<size_t>(bytesRead);
+		}
+
+		fileContent[fileSize] = '\0';
+		return UniqueFileContent { std::move(fileContent), fileSize };
+	}
+
+	static b8 PosixWriteAll(int fileDescriptor, const void* fileContent, size_t fileSize)
+	{
+		for (size_t totalBytesWritten = 0; totalBytesWritten < fileSize;)
+		{
+			const ssize_t bytesWritten = ::write(fileDescriptor, static_cast<const u8*>(fileContent) + totalBytesWritten, fileSize - totalBytesWritten);
+			if (bytesWritten <= 0)
+				return false;
+			totalBytesWritten += static_cast<size_t>(bytesWritten);
+		}
+		return true;
+	}
+
+	b8 WriteAllBytes(std::string_view filePath, const void* fileContent, size_t fileSize)
+	{
+		if (filePath.empty() || fileContent == nullptr)
+			return false;
+
+		const int fileDescriptor = ::open(std::string(filePath).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if (fileDescriptor < 0)
+			return false;
+
+		defer { ::close(fileDescriptor); };
+		return PosixWriteAll(fileDescriptor, fileContent, fileSize);
+	}
+#endif
 
 	b8 WriteAllBytes(std::string_view filePath, const UniqueFileContent& uniqueFileContent)
 	{
@@ -187,6 +276,213 @@ namespace File
 		return WriteAllBytes(filePath, textFileContent.data(), textFileContent.size());
 	}
 
+#if PEEPO_WIN32
+	b8 WriteAllBytesAtomic(std::string_view filePath, const void* fileContent, size_t fileSize)
+	{
+		if (filePath.empty() || fileContent == nullptr)
+			return false;
+
+		const std::string tempFilePath = std::string(filePath).append(".tmp");
+		const HANDLE fileHandle = ::CreateFileW(UTF8::WideArg(tempFilePath).c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+			return false;
+
+		// HACK: Assume the entire file fits inside a single DWORD for now
+		DWORD bytesWritten = 0;
+		const b8 writeSucceeded = (::WriteFile(fileHandle, fileContent, static_cast<DWORD>(fileSize), &bytesWritten, nullptr) != FALSE) && (bytesWritten == fileSize);
+
+		// NOTE: Make sure the content has actually reached the disk before the rename can make it visible under the target name
+		const b8 flushSucceeded = writeSucceeded && (::FlushFileBuffers(fileHandle) != FALSE);
+		::CloseHandle(fileHandle);
+
+		if (!flushSucceeded)
+		{
+			::DeleteFileW(UTF8::WideArg(tempFilePath).c_str());
+			return false;
+		}
+
+		if (::MoveFileExW(UTF8::WideArg(tempFilePath).c_str(), UTF8::WideArg(filePath).c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == FALSE)
+		{
+			::DeleteFileW(UTF8::WideArg(tempFilePath).c_str());
+			return false;
+		}
+
+		return true;
+	}
+#else
+	b8 WriteAllBytesAtomic(std::string_view filePath, const void* fileContent, size_t fileSize)
+	{
+		if (filePath.empty() || fileContent == nullptr)
+			return false;
+
+		const std::string tempFilePath = std::string(filePath).append(".tmp");
+		const int fileDescriptor = ::open(tempFilePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if (fileDescriptor < 0)
+			return false;
+
+		// NOTE: Make sure the content has actually reached the disk before the rename can make it visible under the target name
+		const b8 flushSucceeded = PosixWriteAll(fileDescriptor, fileContent, fileSize) && (::fsync(fileDescriptor) == 0);
+		::close(fileDescriptor);
+
+		if (!flushSucceeded || ::rename(tempFilePath.c_str(), std::string(filePath).c_str()) != 0)
+		{
+			::unlink(tempFilePath.c_str());
+			return false;
+		}
+
+		return true;
+	}
+#endif
+
+	b8 WriteAllBytesAtomic(std::string_view filePath, const std::string_view textFileContent)
+	{
+		return WriteAllBytesAtomic(filePath, textFileContent.data(), textFileContent.size());
+	}
+
+	MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
+		: Content(other.Content), Size(other.Size), FileHandle(other.FileHandle), MappingHandle(other.MappingHandle)
+	{
+		other.Content = nullptr; other.Size = 0; other.FileHandle = nullptr; other.MappingHandle = nullptr;
+	}
+
+	MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Close();
+			Content = other.Content; Size = other.Size; FileHandle = other.FileHandle; MappingHandle = other.MappingHandle;
+			other.Content = nullptr; other.Size = 0; other.FileHandle = nullptr; other.MappingHandle = nullptr;
+		}
+		return *this;
+	}
+
+	MemoryMappedFile::~MemoryMappedFile()
+	{
+		Close();
+	}
+
+#if PEEPO_WIN32
+	void MemoryMappedFile::Close()
+	{
+		if (Content != nullptr)
+			::UnmapViewOfFile(Content);
+		if (MappingHandle != nullptr)
+			::CloseHandle(static_cast<HANDLE>(MappingHandle));
+		if (FileHandle != nullptr)
+			::CloseHandle(static_cast<HANDLE>(FileHandle));
+		Content = nullptr; Size = 0; FileHandle = nullptr; MappingHandle = nullptr;
+	}
+
+	MemoryMappedFile MapReadOnly(std::string_view filePath)
+	{
+		MemoryMappedFile result = {};
+		if (filePath.empty())
+			return result;
+
+		const HANDLE fileHandle = ::CreateFileW(UTF8::WideArg(filePath).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+			return result;
+		result.FileHandle = fileHandle;
+
+		LARGE_INTEGER largeIntegerFileSize = {};
+		if (::GetFileSizeEx(fileHandle, &largeIntegerFileSize) == 0 || largeIntegerFileSize.QuadPart <= 0)
+		{
+			result.Close();
+			return result;
+		}
+
+		result.MappingHandle = ::CreateFileMappingW(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (result.MappingHandle == nullptr)
+		{
+			result.Close();
+			return result;
+		}
+
+		result.Content = static_cast<const u8*>(::MapViewOfFile(static_cast<HANDLE>(result.MappingHandle), FILE_MAP_READ, 0, 0, 0));
+		if (result.Content == nullptr)
+		{
+			result.Close();
+			return result;
+		}
+
+		result.Size = static_cast<size_t>(largeIntegerFileSize.QuadPart);
+		return result;
+	}
+#else
+	// NOTE: The mapping stays valid after closing the file descriptor, so neither of the handles are needed here
+	void MemoryMappedFile::Close()
+	{
+		if (Content != nullptr)
+			::munmap(const_cast<u8*>(Content), Size);
+		Content = nullptr; Size = 0; FileHandle = nullptr; MappingHandle = nullptr;
+	}
+
+	MemoryMappedFile MapReadOnly(std::string_view filePath)
+	{
+		MemoryMappedFile result = {};
+		if (filePath.empty())
+			return result;
+
+		const int fileDescriptor = ::open(std::string(filePath).c_str(), O_RDONLY);
+		if (fileDescriptor < 0)
+			return result;
+
+		defer { ::close(fileDescriptor); };
+
+		struct stat fileStatus;
+		if (::fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size <= 0)
+			return result;
+
+		void* const mappedContent = ::mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (mappedContent == MAP_FAILED)
+			return result;
+
+		result.Content = static_cast<const u8*>(mappedContent);
+		result.Size = static_cast<size_t>(fileStatus.st_size);
+		return result;
+	}
+#endif
+
+	u64 HashContent(const void* fileContent, size_t fileSize)
+	{
+		static constexpr u64 multiplierA = 0x9E3779B97F4A7C15, multiplierB = 0xC2B2AE3D27D4EB4F;
+		auto rotateLeft = [](u64 value, i32 shift) { return (value << shift) | (value >> (64 - shift)); };
+		auto mixWord = [&](u64 hash, u64 word) { return rotateLeft(hash ^ (word * multiplierB), 31) * multiplierA; };
+
+		// NOTE: Four independent lanes of 8 bytes each so that the multiplications don't all have to wait on one another
+		const u8* it = static_cast<const u8*>(fileContent);
+		const u8* const end = it + fileSize;
+		u64 lanes[4] = { multiplierA, multiplierB, ~multiplierA, ~multiplierB };
+		for (; (end - it) >= 32; it += 32)
+		{
+			for (size_t lane = 0; lane < ArrayCount(lanes); lane++)
+			{
+				u64 word; ::memcpy(&word, it + (lane * sizeof(u64)), sizeof(word));
+				lanes[lane] = mixWord(lanes[lane], word);
+			}
+		}
+
+		u64 hash = static_cast<u64>(fileSize);
+		for (const u64 lane : lanes)
+			hash = mixWord(hash, lane);
+		for (; (end - it) >= 8; it += 8)
+		{
+			u64 word; ::memcpy(&word, it, sizeof(word));
+			hash = mixWord(hash, word);
+		}
+		if (it < end)
+		{
+			u64 word = 0; ::memcpy(&word, it, static_cast<size_t>(end - it));
+			hash = mixWord(hash, word);
+		}
+
+		hash ^= (hash >> 33); hash *= multiplierB;
+		hash ^= (hash >> 29); hash *= multiplierA;
+		hash ^= (hash >> 32);
+		return hash;
+	}
+
+#if PEEPO_WIN32
 	b8 Exists(std::string_view filePath)
 	{
 		const DWORD attributes = ::GetFileAttributesW(UTF8::WideArg(filePath).c_str());
@@ -197,8 +493,23 @@ namespace File
 	{
 		return ::CopyFileW(UTF8::WideArg(source).c_str(), UTF8::WideArg(destination).c_str(), !overwriteExisting);
 	}
+#else
+	b8 Exists(std::string_view filePath)
+	{
+		struct stat fileStatus;
+		return (::stat(std::string(filePath).c_str(), &fileStatus) == 0) && !S_ISDIR(fileStatus.st_mode);
+	}
+
+	b8 Copy(std::string_view source, std::string_view destination, b8 overwriteExisting)
+	{
+		std::error_code errorCode;
+		const auto copyOptions = overwriteExisting ? std::filesystem::copy_options::overwrite_existing : std::filesystem::copy_options::none;
+		return std::filesystem::copy_file(std::filesystem::path(source), std::filesystem::path(destination), copyOptions, errorCode);
+	}
+#endif
 }
 
+#if PEEPO_WIN32
 namespace CommandLine
 {
 	CommandLineArrayView GetCommandLineUTF8()
@@ -273,6 +584,76 @@ namespace Directory
 	}
 }
 
+#else
+namespace CommandLine
+{
+	CommandLineArrayView GetCommandLineUTF8()
+	{
+		static b8 initialized = false;
+		static std::vector<std::string> argvString;
+		static std::vector<std::string_view> argvStringViews;
+
+		if (initialized)
+			return CommandLineArrayView { argvStringViews.size(), argvStringViews.data() };
+
+		// NOTE: Null separated list of all arguments, which are already expected to be UTF-8. Read until EOF as procfs files always report a size of zero
+		std::ifstream commandLineStream("/proc/self/cmdline", std::ios::binary);
+		const std::string commandLine { std::istreambuf_iterator<char>(commandLineStream), std::istreambuf_iterator<char>() };
+		ASCII::ForEachInCharSeparatedList(commandLine, '\0', [&](std::string_view argument) { argvString.emplace_back(argument); });
+
+		argvStringViews.reserve(argvString.size());
+		for (const std::string& argument : argvString)
+			argvStringViews.emplace_back(argument.c_str());
+
+		initialized = true;
+		return CommandLineArrayView { argvStringViews.size(), argvStringViews.data() };
+	}
+}
+
+namespace Directory
+{
+	b8 Create(std::string_view directoryPath)
+	{
+		if (directoryPath.empty())
+			return false;
+
+		return (::mkdir(std::string(directoryPath).c_str(), 0777) == 0);
+	}
+
+	b8 Exists(std::string_view directoryPath)
+	{
+		if (directoryPath.empty())
+			return false;
+
+		return Path::IsDirectory(directoryPath);
+	}
+
+	std::string GetExecutablePath()
+	{
+		std::error_code errorCode;
+		return std::filesystem::read_symlink("/proc/self/exe", errorCode).generic_string();
+	}
+
+	std::string GetExecutableDirectory()
+	{
+		return std::string { Path::GetDirectoryName(GetExecutablePath()) };
+	}
+
+	std::string GetWorkingDirectory()
+	{
+		std::error_code errorCode;
+		return std::filesystem::current_path(errorCode).generic_string();
+	}
+
+	void SetWorkingDirectory(std::string_view directoryPath)
+	{
+		::chdir(std::string(directoryPath).c_str());
+	}
+}
+
+#endif
+
+#if PEEPO_WIN32
 namespace Shell
 {
 	void OpenInExplorer(std::string_view filePath)
@@ -577,3 +958,21 @@ namespace Shell
 	FileDialogResult FileDialog::OpenSave() { return CreateAndShowFileDialog(*this, DialogType::Save, DialogPickType::File); }
 	FileDialogResult FileDialog::OpenSelectFolder() { return CreateAndShowFileDialog(*this, DialogType::Open, DialogPickType::Folder); }
 }
+#else
+namespace Shell
+{
+	void OpenInExplorer(std::string_view filePath)
+	{
+	}
+
+	MessageBoxResult ShowMessageBox(std::string_view message, std::string_view title, MessageBoxButtons buttons, MessageBoxIcon icon, void* parentWindowHandle)
+	{
+		fprintf(stderr, StrViewFmtString ": " StrViewFmtString "\n", FmtStrViewArgs(title), FmtStrViewArgs(message));
+		return MessageBoxResult::None;
+	}
+
+	FileDialogResult FileDialog::OpenRead() { return FileDialogResult::Error; }
+	FileDialogResult FileDialog::OpenSave() { return FileDialogResult::Error; }
+	FileDialogResult FileDialog::OpenSelectFolder() { return FileDialogResult::Error; }
+}
+#endif
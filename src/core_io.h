@@ -54,6 +54,34 @@ namespace File
 	b8 WriteAllBytes(std::string_view filePath, const void* fileContent, size_t fileSize);
 	b8 WriteAllBytes(std::string_view filePath, const UniqueFileContent& uniqueFileContent);
 	b8 WriteAllBytes(std::string_view filePath, const std::string_view textFileContent);
+	// NOTE: Writes to a temporary file next to the target first and then renames it on top, so that the target is never left partially written
+	b8 WriteAllBytesAtomic(std::string_view filePath, const void* fileContent, size_t fileSize);
+	b8 WriteAllBytesAtomic(std::string_view filePath, const std::string_view textFileContent);
+
+	// NOTE: Read-only view of an entire file mapped into memory, for parsing (binary) files in place without first copying them into a buffer of their own
+	struct MemoryMappedFile
+	{
+		const u8* Content = nullptr;
+		size_t Size = 0;
+		void* FileHandle = nullptr;
+		void* MappingHandle = nullptr;
+
+		MemoryMappedFile() = default;
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+		MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+		MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+		MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
+		~MemoryMappedFile();
+
+		void Close();
+		inline std::string_view AsString() const { return std::string_view(reinterpret_cast<const char*>(Content), Size); }
+	};
+
+	// NOTE: Empty files can't be mapped and are treated the same as a failure to open, with the returned Content being null
+	MemoryMappedFile MapReadOnly(std::string_view filePath);
+
+	// NOTE: Fast non-cryptographic 64-bit hash of the entire content, only meant for detecting whether a file has changed
+	u64 HashContent(const void* fileContent, size_t fileSize);
 
 	b8 Exists(std::string_view filePath);
 	b8 Copy(std::string_view source, std::string_view destination, b8 overwriteExisting = false);
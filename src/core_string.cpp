@@ -1,5 +1,7 @@
 #include "core_string.h"
 #include <charconv>
+
+#if PEEPO_WIN32
 #include <Windows.h>
 
 static std::string Win32NarrowStdStringWithCodePage(std::wstring_view input, UINT win32CodePage)
@@ -42,12 +44,6 @@ namespace UTF8
 		return Win32WidenStdStringWithCodePage(utf8Input, CP_UTF8);
 	}
 
-	std::string FromShiftJIS(std::string_view shiftJISInput)
-	{
-		// HACK: Quite inefficient of course but should work just fine for converting small amounts of text here and there
-		return UTF8::Narrow(ShiftJIS::Widen(shiftJISInput));
-	}
-
 	WideArg::WideArg(std::string_view utf8Input)
 	{
 		// NOTE: Length **without** null terminator
@@ -93,13 +89,119 @@ namespace ShiftJIS
 	{
 		return Win32WidenStdStringWithCodePage(utf8Input, CP_SHIFT_JIS);
 	}
+}
+#else
+// NOTE: wchar_t is 32-bit outside of Windows, so the "wide" strings there hold UTF-32 code points instead of UTF-16 code units
+namespace UTF8
+{
+	std::string Narrow(std::wstring_view utf32Input)
+	{
+		std::string output;
+		output.reserve(utf32Input.size());
+
+		for (const wchar_t c : utf32Input)
+		{
+			const u32 codePoint = ((static_cast<u32>(c) >= 0xD800 && static_cast<u32>(c) <= 0xDFFF) || static_cast<u32>(c) > 0x10FFFF) ? 0xFFFD : static_cast<u32>(c);
+			if (codePoint < 0x80)
+			{
+				output += static_cast<char>(codePoint);
+			}
+			else if (codePoint < 0x800)
+			{
+				output += static_cast<char>(0xC0 | (codePoint >> 6));
+				output += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else if (codePoint < 0x10000)
+			{
+				output += static_cast<char>(0xE0 | (codePoint >> 12));
+				output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				output += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else
+			{
+				output += static_cast<char>(0xF0 | (codePoint >> 18));
+				output += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+				output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				output += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+		}
+
+		return output;
+	}
+
+	std::wstring Widen(std::string_view utf8Input)
+	{
+		std::wstring output;
+		output.reserve(utf8Input.size());
+
+		const u8* in = reinterpret_cast<const u8*>(utf8Input.data());
+		const u8* const inEnd = (in + utf8Input.size());
+		while (in < inEnd)
+		{
+			// NOTE: Invalid and overlong sequences are replaced one byte at a time, same as MultiByteToWideChar()
+			const size_t remaining = static_cast<size_t>(inEnd - in);
+			const auto isContinuation = [&](size_t i) { return (i < remaining) && ((in[i] & 0xC0) == 0x80); };
+			u32 codePoint = 0xFFFD; size_t sequenceLength = 1;
+			if (in[0] < 0x80)
+			{
+				codePoint = in[0];
+			}
+			else if (in[0] >= 0xC2 && in[0] <= 0xDF && isContinuation(1))
+			{
+				codePoint = ((in[0] & 0x1F) << 6) | (in[1] & 0x3F);
+				sequenceLength = 2;
+			}
+			else if (in[0] >= 0xE0 && in[0] <= 0xEF && isContinuation(1) && isContinuation(2))
+			{
+				const u32 decoded = ((in[0] & 0x0F) << 12) | ((in[1] & 0x3F) << 6) | (in[2] & 0x3F);
+				if (decoded >= 0x800 && (decoded < 0xD800 || decoded > 0xDFFF)) { codePoint = decoded; sequenceLength = 3; }
+			}
+			else if (in[0] >= 0xF0 && in[0] <= 0xF4 && isContinuation(1) && isContinuation(2) && isContinuation(3))
+			{
+				const u32 decoded = ((in[0] & 0x07) << 18) | ((in[1] & 0x3F) << 12) | ((in[2] & 0x3F) << 6) | (in[3] & 0x3F);
+				if (decoded >= 0x10000 && decoded <= 0x10FFFF) { codePoint = decoded; sequenceLength = 4; }
+			}
+
+			output += static_cast<wchar_t>(codePoint);
+			in += sequenceLength;
+		}
+
+		return output;
+	}
+
+	WideArg::WideArg(std::string_view utf8Input)
+	{
+		const std::wstring wideString = Widen(utf8Input);
+		convertedLength = static_cast<int>(wideString.size());
+
+		if (convertedLength >= ArrayCount(stackBuffer))
+			heapBuffer = std::unique_ptr<wchar_t[]>(new wchar_t[convertedLength + 1]);
+
+		wchar_t* const outBuffer = (convertedLength < ArrayCount(stackBuffer)) ? stackBuffer : heapBuffer.get();
+		::memcpy(outBuffer, wideString.data(), convertedLength * sizeof(wchar_t));
+		outBuffer[convertedLength] = L'\0';
+	}
+
+	const wchar_t* WideArg::c_str() const
+	{
+		return (convertedLength < ArrayCount(stackBuffer)) ? stackBuffer : heapBuffer.get();
+	}
+}
+
+namespace ShiftJIS
+{
+	// NOTE: Without the Win32 code page functions the direct Shift-JIS <-> UTF-8 conversions (see core_string_shift_jis.cpp) are used instead
+	std::string Narrow(std::wstring_view utf32Input)
+	{
+		return ShiftJIS::FromUTF8(UTF8::Narrow(utf32Input));
+	}
 
-	std::string FromUTF8(std::string_view utf8Input)
+	std::wstring Widen(std::string_view shiftJISInput)
 	{
-		// HACK: Same problem as UTF8::FromShiftJIS() ...
-		return ShiftJIS::Narrow(UTF8::WideArg(utf8Input).c_str());
+		return UTF8::Widen(UTF8::FromShiftJIS(shiftJISInput));
 	}
 }
+#endif
 
 namespace ASCII
 {
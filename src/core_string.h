@@ -65,6 +65,7 @@ namespace UTF8
 		int convertedLength;
 	};
 
+	// NOTE: Convert Shift-JIS (CP932) to UTF-8 in a single pass through a lookup table (see core_string_shift_jis.cpp)
 	std::string FromShiftJIS(std::string_view shiftJISInput);
 }
 
@@ -76,6 +77,7 @@ namespace ShiftJIS
 	// NOTE: Convert SHIFT-JIS to UTF-16
 	std::wstring Widen(std::string_view shiftJISInput);
 
+	// NOTE: Convert UTF-8 to Shift-JIS (CP932) in a single pass, with characters that can't be represented replaced by '?'
 	std::string FromUTF8(std::string_view utf8Input);
 }
 
@@ -0,0 +1,237 @@
+#include "core_string.h"
+#include "core_string_shift_jis_table.h"
+#include <array>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define PEEPO_SHIFT_JIS_SSE2 1
+#include <emmintrin.h>
+#else
+#define PEEPO_SHIFT_JIS_SSE2 0
+#endif
+
+// NOTE: Self-contained CP932 conversions that go straight between Shift-JIS and UTF-8 in a single pass
+//		 instead of round tripping through UTF-16 via the Win32 code page functions (which are still used by ShiftJIS::Narrow() / ShiftJIS::Widen())
+namespace ShiftJIS
+{
+	// NOTE: The "default characters" of the code page, used in place of anything that has no mapping
+	constexpr u16 UnmappedUTF16 = 0x30FB;
+	constexpr char UnmappedShiftJIS = '?';
+
+	constexpr b8 IsLeadByte(u8 byte) { return (byte >= 0x81 && byte <= 0x9F) || (byte >= 0xE0 && byte <= 0xFC); }
+	constexpr b8 IsTrailByte(u8 byte) { return (byte >= 0x40 && byte <= 0xFC) && (byte != 0x7F); }
+	constexpr i32 LeadByteToTableIndex(u8 lead) { return (lead <= 0x9F) ? (lead - 0x81) : (lead - 0xE0 + (0x9F - 0x81 + 1)); }
+	constexpr u8 TableIndexToLeadByte(i32 index) { return static_cast<u8>((index <= (0x9F - 0x81)) ? (index + 0x81) : (index - (0x9F - 0x81 + 1) + 0xE0)); }
+	static_assert(LeadByteToTableIndex(0xFC) == (DoubleByteLeadCount - 1) && TableIndexToLeadByte(DoubleByteLeadCount - 1) == 0xFC);
+	static_assert(DoubleByteTrailCount == (0xFC - 0x40 + 1));
+
+	constexpr u16 SingleByteToUTF16(u8 byte)
+	{
+		if (byte < 0x80) return byte;
+		if (byte >= 0xA1 && byte <= 0xDF) return static_cast<u16>(0xFF61 + (byte - 0xA1)); // NOTE: Half-width katakana
+		if (byte == 0x80) return 0x0080;
+		if (byte == 0xA0) return 0xF8F0;
+		return static_cast<u16>(0xF8F1 + (byte - 0xFD));
+	}
+
+	// NOTE: Reverse of the decode tables for the entire BMP, with single byte values stored as is and double byte values as (lead << 8 | trail).
+	//		 Some characters are reachable from more than one double byte code (NEC row 13, NEC selected IBM extensions and IBM extensions),
+	//		 in which case the first one in code order is chosen, skipping the NEC selected IBM extensions (0xED / 0xEE) entirely, same as Windows
+	struct UTF16ToShiftJISTable
+	{
+		std::array<u16, 0x10000> Values;
+
+		static const UTF16ToShiftJISTable& Get()
+		{
+			// NOTE: Heap allocated as it's a bit too large to comfortably build on the stack
+			static const std::unique_ptr<UTF16ToShiftJISTable> table = []()
+			{
+				auto result = std::make_unique<UTF16ToShiftJISTable>();
+				result->Values.fill(0);
+
+				for (i32 byte = 0x80; byte <= 0xFF; byte++)
+				{
+					if (!IsLeadByte(static_cast<u8>(byte)))
+						result->Values[SingleByteToUTF16(static_cast<u8>(byte))] = static_cast<u16>(byte);
+				}
+
+				for (i32 leadIndex = 0; leadIndex < DoubleByteLeadCount; leadIndex++)
+				{
+					const u8 lead = TableIndexToLeadByte(leadIndex);
+					if (lead == 0xED || lead == 0xEE)
+						continue;
+
+					for (i32 trailIndex = 0; trailIndex < DoubleByteTrailCount; trailIndex++)
+					{
+						const u16 utf16 = DoubleByteToUTF16Table[leadIndex][trailIndex];
+						if (utf16 != 0 && result->Values[utf16] == 0)
+							result->Values[utf16] = static_cast<u16>((lead << 8) | (trailIndex + 0x40));
+					}
+				}
+
+				return result;
+			}();
+			return *table;
+		}
+	};
+
+	// NOTE: Number of leading bytes (up to maxCount) that are all ASCII, checked a whole block at a time
+	static inline size_t CountLeadingASCIIBlockBytes(const u8* bytes, size_t maxCount)
+	{
+		size_t count = 0;
+#if PEEPO_SHIFT_JIS_SSE2
+		while ((maxCount - count) >= 16)
+		{
+			if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + count))) != 0)
+				break;
+			count += 16;
+		}
+#else
+		while ((maxCount - count) >= 8)
+		{
+			u64 block; ::memcpy(&block, bytes + count, sizeof(block));
+			if ((block & 0x8080808080808080ull) != 0)
+				break;
+			count += 8;
+		}
+#endif
+		return count;
+	}
+
+	static inline char* WriteUTF8(char* out, u16 utf16)
+	{
+		if (utf16 < 0x80)
+		{
+			out[0] = static_cast<char>(utf16);
+			return out + 1;
+		}
+		else if (utf16 < 0x800)
+		{
+			out[0] = static_cast<char>(0xC0 | (utf16 >> 6));
+			out[1] = static_cast<char>(0x80 | (utf16 & 0x3F));
+			return out + 2;
+		}
+		else
+		{
+			out[0] = static_cast<char>(0xE0 | (utf16 >> 12));
+			out[1] = static_cast<char>(0x80 | ((utf16 >> 6) & 0x3F));
+			out[2] = static_cast<char>(0x80 | (utf16 & 0x3F));
+			return out + 3;
+		}
+	}
+
+	std::string FromUTF8(std::string_view utf8Input)
+	{
+		const UTF16ToShiftJISTable& table = UTF16ToShiftJISTable::Get();
+
+		// NOTE: No character takes up more bytes in Shift-JIS than in UTF-8, so the output is sized for the worst case once and then trimmed
+		std::string output;
+		output.resize(utf8Input.size());
+
+		const u8* in = reinterpret_cast<const u8*>(utf8Input.data());
+		const u8* const inEnd = (in + utf8Input.size());
+		char* out = output.data();
+
+		while (in < inEnd)
+		{
+			if (in[0] < 0x80)
+			{
+				const size_t blockCount = CountLeadingASCIIBlockBytes(in, static_cast<size_t>(inEnd - in));
+				::memcpy(out, in, blockCount);
+				in += blockCount; out += blockCount;
+
+				while (in < inEnd && in[0] < 0x80)
+					*out++ = static_cast<char>(*in++);
+				continue;
+			}
+
+			// NOTE: Anything outside the BMP can't be represented either way, while invalid bytes are skipped one at a time
+			const size_t remaining = static_cast<size_t>(inEnd - in);
+			const auto isContinuation = [&](size_t i) { return (i < remaining) && ((in[i] & 0xC0) == 0x80); };
+			u32 codePoint = 0; size_t sequenceLength = 1;
+			if (in[0] >= 0xC2 && in[0] <= 0xDF && isContinuation(1))
+			{
+				codePoint = ((in[0] & 0x1F) << 6) | (in[1] & 0x3F);
+				sequenceLength = 2;
+			}
+			else if (in[0] >= 0xE0 && in[0] <= 0xEF && isContinuation(1) && isContinuation(2))
+			{
+				codePoint = ((in[0] & 0x0F) << 12) | ((in[1] & 0x3F) << 6) | (in[2] & 0x3F);
+				sequenceLength = (codePoint >= 0x800) ? 3 : 1;
+				codePoint = (sequenceLength == 3) ? codePoint : 0;
+			}
+			else if (in[0] >= 0xF0 && in[0] <= 0xF4 && isContinuation(1) && isContinuation(2) && isContinuation(3))
+			{
+				sequenceLength = 4;
+			}
+			in += sequenceLength;
+
+			const u16 shiftJIS = (codePoint > 0 && codePoint < 0x10000) ? table.Values[codePoint] : 0;
+			if (shiftJIS == 0)
+				*out++ = UnmappedShiftJIS;
+			else if (shiftJIS <= 0xFF)
+				*out++ = static_cast<char>(shiftJIS);
+			else
+			{
+				out[0] = static_cast<char>(shiftJIS >> 8);
+				out[1] = static_cast<char>(shiftJIS & 0xFF);
+				out += 2;
+			}
+		}
+
+		output.resize(static_cast<size_t>(out - output.data()));
+		return output;
+	}
+}
+
+namespace UTF8
+{
+	std::string FromShiftJIS(std::string_view shiftJISInput)
+	{
+		using namespace ShiftJIS;
+
+		// NOTE: Every input byte turns into at most 3 output bytes (for single byte half-width katakana), so the output is sized for the worst case once and then trimmed
+		std::string output;
+		output.resize(shiftJISInput.size() * 3);
+
+		const u8* in = reinterpret_cast<const u8*>(shiftJISInput.data());
+		const u8* const inEnd = (in + shiftJISInput.size());
+		char* out = output.data();
+
+		while (in < inEnd)
+		{
+			// NOTE: ASCII bytes can never be lead bytes, so whole runs of them (the vast majority of any TJA file) are copied as is
+			if (in[0] < 0x80)
+			{
+				const size_t blockCount = CountLeadingASCIIBlockBytes(in, static_cast<size_t>(inEnd - in));
+				::memcpy(out, in, blockCount);
+				in += blockCount; out += blockCount;
+
+				while (in < inEnd && in[0] < 0x80)
+					*out++ = static_cast<char>(*in++);
+				continue;
+			}
+
+			const u8 lead = in[0];
+			if (!IsLeadByte(lead))
+			{
+				out = WriteUTF8(out, SingleByteToUTF16(lead));
+				in += 1;
+			}
+			else if ((in + 1) < inEnd && IsTrailByte(in[1]))
+			{
+				const u16 utf16 = DoubleByteToUTF16Table[LeadByteToTableIndex(lead)][in[1] - 0x40];
+				out = WriteUTF8(out, (utf16 != 0) ? utf16 : UnmappedUTF16);
+				in += 2;
+			}
+			else
+			{
+				// NOTE: Only skip the lead byte itself so that a truncated character can't swallow a following line break
+				out = WriteUTF8(out, UnmappedUTF16);
+				in += 1;
+			}
+		}
+
+		output.resize(static_cast<size_t>(out - output.data()));
+		return output;
+	}
+}
@@ -10,6 +10,19 @@ static_assert((sizeof(u64) * BitsPerByte) == 64 && (sizeof(i64) * BitsPerByte) =
 static_assert((sizeof(f32) * BitsPerByte) == 32 && (sizeof(f64) * BitsPerByte) == 64);
 static_assert((sizeof(b8) * BitsPerByte) == 8);
 
+// NOTE: Integer conversions only, for which sscanf_s doesn't expect any additional buffer size arguments (unlike for "%s" / "%c" / "%[")
+//		 and can therefore be swapped for the standard sscanf on compilers without it
+template <typename... IntegerTypes>
+static i32 ScanIntegers(cstr inBuffer, cstr format, IntegerTypes*... outIntegers)
+{
+	static_assert((std::is_integral_v<IntegerTypes> && ...), "Only integer conversions are supported");
+#if defined(_MSC_VER)
+	return ::sscanf_s(inBuffer, format, outIntegers...);
+#else
+	return ::sscanf(inBuffer, format, outIntegers...);
+#endif
+}
+
 Rect FitInsideFixedAspectRatio(Rect rectToFitInside, f32 targetAspectRatio)
 {
 	static constexpr f32 roundingAdd = 0.0f; // 0.5f;
@@ -53,7 +66,7 @@ i32 Time::ToString(char* outBuffer, size_t bufferSize) const
 	static constexpr const char invalidFormatString[] = "--:--.---";
 
 	const f64 msRoundSeconds = RoundToMilliseconds(Time::FromSec(Absolute(Seconds))).Seconds;
-	if (::isnan(msRoundSeconds) || ::isinf(msRoundSeconds))
+	if (std::isnan(msRoundSeconds) || std::isinf(msRoundSeconds))
 	{
 		// NOTE: Array count of a string literal char array already accounts for the null terminator
 		memcpy(outBuffer, invalidFormatString, ArrayCount(invalidFormatString));
@@ -66,7 +79,7 @@ i32 Time::ToString(char* outBuffer, size_t bufferSize) const
 	const f64 ms = (sec - Floor(sec)) * 1000.0;
 
 	const char signPrefix[2] = { (Seconds < 0.0) ? '-' : '\0', '\0' };
-	return sprintf_s(outBuffer, bufferSize, "%s%02d:%02d.%03d", signPrefix, static_cast<i32>(min), static_cast<i32>(sec), static_cast<i32>(ms));
+	return snprintf(outBuffer, bufferSize, "%s%02d:%02d.%03d", signPrefix, static_cast<i32>(min), static_cast<i32>(sec), static_cast<i32>(ms));
 }
 
 Time::FormatBuffer Time::ToString() const
@@ -86,7 +99,7 @@ Time Time::FromString(cstr inBuffer)
 	else if (inBuffer[0] == '+') { isNegative = false; inBuffer++; }
 
 	i32 min = 0, sec = 0, ms = 0;
-	sscanf_s(inBuffer, "%02d:%02d.%03d", &min, &sec, &ms);
+	ScanIntegers(inBuffer, "%02d:%02d.%03d", &min, &sec, &ms);
 
 	min = Clamp(min, 0, 59);
 	sec = Clamp(sec, 0, 59);
@@ -99,9 +112,14 @@ Time Time::FromString(cstr inBuffer)
 Date Date::GetToday()
 {
 	const time_t inTimeNow = ::time(nullptr); tm outDateNow;
+#if PEEPO_WIN32
 	const errno_t timeToDateError = ::localtime_s(&outDateNow, &inTimeNow);
 	if (timeToDateError != 0)
 		return Date::Zero();
+#else
+	if (::localtime_r(&inTimeNow, &outDateNow) == nullptr)
+		return Date::Zero();
+#endif
 
 	Date result = {};
 	result.Year = static_cast<i16>(outDateNow.tm_year + 1900);
@@ -118,7 +136,7 @@ i32 Date::ToString(char* outBuffer, size_t bufferSize, char separator) const
 	const u32 yyyy = Clamp<u32>(Year, 0, 9999);
 	const u32 mm = Clamp<u32>(Month, 0, 12);
 	const u32 dd = Clamp<u32>(Day, 0, 31);
-	return sprintf_s(outBuffer, bufferSize, "%04u%c%02u%c%02u", yyyy, separator, mm, separator, dd);
+	return snprintf(outBuffer, bufferSize, "%04u%c%02u%c%02u", yyyy, separator, mm, separator, dd);
 }
 
 Date::FormatBuffer Date::ToString(char separator) const
@@ -136,7 +154,7 @@ Date Date::FromString(cstr inBuffer, char separator)
 	formatString[9] = separator;
 
 	u32 yyyy = 0, mm = 0, dd = 0;
-	sscanf_s(inBuffer, formatString, &yyyy, &mm, &dd);
+	ScanIntegers(inBuffer, formatString, &yyyy, &mm, &dd);
 
 	Date result = {};
 	result.Year = static_cast<i16>(Clamp<u32>(yyyy, 0, 9999));
@@ -145,40 +163,54 @@ Date Date::FromString(cstr inBuffer, char separator)
 	return result;
 }
 
+#if PEEPO_WIN32
 #include <Windows.h>
 
-static i64 Win32GetPerformanceCounterTicksPerSecond()
+static i64 GetPerformanceCounterTicksPerSecond()
 {
 	::LARGE_INTEGER frequency = {};
 	::QueryPerformanceFrequency(&frequency);
 	return frequency.QuadPart;
 }
 
-static i64 Win32GetPerformanceCounterTicksNow()
+static i64 GetPerformanceCounterTicksNow()
 {
 	::LARGE_INTEGER timeNow = {};
 	::QueryPerformanceCounter(&timeNow);
 	return timeNow.QuadPart;
 }
+#else
+#include <chrono>
+
+static i64 GetPerformanceCounterTicksPerSecond()
+{
+	return static_cast<i64>(std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num);
+}
+
+static i64 GetPerformanceCounterTicksNow()
+{
+	return static_cast<i64>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+#endif
 
-static struct Win32PerformanceCounterData
+static struct PerformanceCounterData
 {
-	i64 TicksPerSecond = Win32GetPerformanceCounterTicksPerSecond();
-	i64 TicksOnProgramStartup = Win32GetPerformanceCounterTicksNow();
-} Win32GlobalPerformanceCounter = {};
+	i64 TicksPerSecond = GetPerformanceCounterTicksPerSecond();
+	i64 TicksOnProgramStartup = GetPerformanceCounterTicksNow();
+} GlobalPerformanceCounter = {};
 
 CPUTime CPUTime::GetNow()
 {
-	return CPUTime { Win32GetPerformanceCounterTicksNow() - Win32GlobalPerformanceCounter.TicksOnProgramStartup };
+	return CPUTime { GetPerformanceCounterTicksNow() - GlobalPerformanceCounter.TicksOnProgramStartup };
 }
 
 CPUTime CPUTime::GetNowAbsolute()
 {
-	return CPUTime { Win32GetPerformanceCounterTicksNow() };
+	return CPUTime { GetPerformanceCounterTicksNow() };
 }
 
 Time CPUTime::DeltaTime(const CPUTime& startTime, const CPUTime& endTime)
 {
 	const i64 deltaTicks = (endTime.Ticks - startTime.Ticks);
-	return Time::FromSec(static_cast<f64>(deltaTicks) / static_cast<f64>(Win32GlobalPerformanceCounter.TicksPerSecond));
+	return Time::FromSec(static_cast<f64>(deltaTicks) / static_cast<f64>(GlobalPerformanceCounter.TicksPerSecond));
 }
@@ -2,15 +2,27 @@
 #include <memory>
 #include <stdint.h>
 #include <limits>
+#include <climits>
 #include <cfloat>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <algorithm>
+#include <array>
+#include <utility>
+#include <string>
+#include <string_view>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <complex>
 #include <regex>
 
+// NOTE: MSVC specific, so that the core headers can also be compiled by GCC / Clang (for the command line batch tool)
+#if !defined(_MSC_VER) && !defined(__forceinline)
+#define __forceinline inline __attribute__((always_inline))
+#endif
+
 using i8 = int8_t;
 using u8 = uint8_t;
 
@@ -103,6 +115,10 @@ constexpr auto ConstevalStrJoinedArr = StrJoinImpl<Strs...>();
 template <const auto&... Strs>
 constexpr std::string_view ConstevalStrJoined = {ConstevalStrJoinedArr<Strs...>.data(), ForceConsteval<ConstevalStrJoinedArr<Strs...>.size()>};
 
+// NOTE: Example: else static_assert(always_false_v<Value>, "..."); for the last branch of an if constexpr chain, as a non-dependent static_assert(false) is ill-formed before C++23
+template <auto...>
+constexpr b8 always_false_v = false;
+
 // NOTE: Example: if constexpr (expect_type_v<TTested, TExpected>); to be used where TTested is a template type declaring forwarding-reference parameters
 template <typename TTested, typename TExpected>
 constexpr b8 expect_type_v = std::is_same_v<TExpected, std::remove_cv_t<std::remove_reference_t<TTested>>>;
@@ -370,7 +386,7 @@ struct Complex {
 	explicit constexpr Complex(f32 scalar) : cpx(scalar) {}
 	constexpr Complex(f32 x, f32 y) : cpx(x, y) {}
 	constexpr Complex(std::complex<f32> cpx) : cpx(cpx) {}
-	constexpr Complex(const Complex& other) : cpx(other.cpx) {}
+	constexpr Complex(const Complex& other) = default;
 	Complex(const std::string& s) { std::istringstream iss(s); iss >> *this; }
 	std::string toString() const {
 		std::ostringstream oss;
@@ -396,20 +412,21 @@ struct Complex {
 	constexpr b8 operator==(const Complex& other) const { return cpx == other.cpx; }
 	constexpr b8 operator!=(const Complex& other) const { return !(*this == other); }
 
-	constexpr Complex operator+(const Complex& other) const { return { (cpx + other.cpx) }; }
-	constexpr Complex operator-(const Complex& other) const { return { (cpx - other.cpx) }; }
-	constexpr Complex operator*(const Complex& other) const { return { (cpx * other.cpx) }; }
-	constexpr Complex operator/(const Complex& other) const { return { (cpx / other.cpx) }; }
-	constexpr Complex operator*(const f32 scalar) const { return { (cpx * scalar) }; }
-	constexpr Complex operator/(const f32 scalar) const { return { (cpx / scalar) }; }
-
-	constexpr Complex& operator+=(const Complex& other) { *this = (*this + other); return *this; }
-	constexpr Complex& operator-=(const Complex& other) { *this = (*this - other); return *this; }
-	constexpr Complex& operator*=(const Complex& other) { *this = (*this * other); return *this; }
-	constexpr Complex& operator/=(const Complex& other) { *this = (*this / other); return *this; }
-	constexpr Complex& operator*=(const f32 scalar) { *this = (*this * scalar); return *this; }
-	constexpr Complex& operator/=(const f32 scalar) { *this = (*this / scalar); return *this; }
-	constexpr Complex operator-() const { return { -cpx }; }
+	// NOTE: Not constexpr as the std::complex arithmetic operators only are since C++20
+	inline Complex operator+(const Complex& other) const { return { (cpx + other.cpx) }; }
+	inline Complex operator-(const Complex& other) const { return { (cpx - other.cpx) }; }
+	inline Complex operator*(const Complex& other) const { return { (cpx * other.cpx) }; }
+	inline Complex operator/(const Complex& other) const { return { (cpx / other.cpx) }; }
+	inline Complex operator*(const f32 scalar) const { return { (cpx * scalar) }; }
+	inline Complex operator/(const f32 scalar) const { return { (cpx / scalar) }; }
+
+	inline Complex& operator+=(const Complex& other) { *this = (*this + other); return *this; }
+	inline Complex& operator-=(const Complex& other) { *this = (*this - other); return *this; }
+	inline Complex& operator*=(const Complex& other) { *this = (*this * other); return *this; }
+	inline Complex& operator/=(const Complex& other) { *this = (*this / other); return *this; }
+	inline Complex& operator*=(const f32 scalar) { *this = (*this * scalar); return *this; }
+	inline Complex& operator/=(const f32 scalar) { *this = (*this / scalar); return *this; }
+	inline Complex operator-() const { return { -cpx }; }
 
 #define PAT_APLUSB_RE "[+-]?(?:\\d+(?:\\.\\d*)?|\\.\\d+)(?:[eE][+-]?\\d+)?(?![iI.\\d])"
 #define PAT_APLUSB_IM "[+-]?(?:\\d+(?:\\.\\d*)?|\\.\\d+)(?:[eE][+-]?\\d+)?[iI]"
@@ -598,7 +615,7 @@ constexpr void AnimateExponentialVec2(vec2* inOutCurrent, vec2 target, f32 anima
 constexpr f32 Dot(vec2 a, vec2 b) { return (a.x * b.x) + (a.y * b.y); }
 constexpr f32 LengthSqr(vec2 value) { return Dot(value, value); }
 inline f32 Length(vec2 value) { return std::sqrt(LengthSqr(value)); }
-inline vec2 Normalize(vec2 value) { value / Length(value); }
+inline vec2 Normalize(vec2 value) { return value / Length(value); }
 inline f32 Distance(f32 a, f32 b) { return Absolute(a - b); }
 inline f32 Distance(vec2 a, vec2 b) { return Length(a - b); }
 inline vec2 LookAtDirection(vec2 from, vec2 target) { return Normalize(target - from); }
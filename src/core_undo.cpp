@@ -42,6 +42,7 @@ namespace Undo
 
 		HasPendingChanges = true;
 		NumberOfChangesMade++;
+		EditGeneration++;
 
 		if (!RedoStack.empty())
 			RedoStack.clear();
@@ -88,6 +89,7 @@ namespace Undo
 				break;
 
 			HasPendingChanges = true;
+			EditGeneration++;
 			RedoStack.emplace_back(VectorPop(UndoStack))->Undo();
 		}
 	}
@@ -100,6 +102,7 @@ namespace Undo
 				break;
 
 			HasPendingChanges = true;
+			EditGeneration++;
 			UndoStack.emplace_back(VectorPop(RedoStack))->Redo();
 		}
 	}
@@ -107,6 +110,7 @@ namespace Undo
 	void UndoHistory::ClearAll()
 	{
 		ClearChangesWereMade();
+		EditGeneration++;
 		if (!CommandsToExecutedAtEndOfFrame.empty()) CommandsToExecutedAtEndOfFrame.clear();
 		if (!UndoStack.empty()) UndoStack.clear();
 		if (!RedoStack.empty()) RedoStack.clear();
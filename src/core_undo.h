@@ -52,6 +52,8 @@ namespace Undo
 		std::vector<std::unique_ptr<Command>> CommandsToExecutedAtEndOfFrame;
 		b8 HasPendingChanges = false;
 		i32 NumberOfChangesMade = 0;
+		// NOTE: Incremented by every change, undo and redo alike and never reset (unlike NumberOfChangesMade), to detect whether the document differs from an earlier point in time
+		u64 EditGeneration = 0;
 
 		i32 NumberOfCommandsToDisallowMergesFor = 0;
 		Time CommandMergeTimeThreshold = Time::FromSec(2.0);
@@ -82,7 +84,7 @@ namespace Undo
 
 		inline b8 CanUndo() const { return !UndoStack.empty(); }
 		inline b8 CanRedo() const { return !RedoStack.empty(); }
-		inline void NotifyChangesWereMade() { HasPendingChanges = true; NumberOfChangesMade++; }
+		inline void NotifyChangesWereMade() { HasPendingChanges = true; NumberOfChangesMade++; EditGeneration++; }
 		inline void ClearChangesWereMade() { HasPendingChanges = false; NumberOfChangesMade = 0; }
 
 		inline void DisallowMergeForLastCommand() { NumberOfCommandsToDisallowMergesFor = 1; }
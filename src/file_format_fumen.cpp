@@ -1,3 +1,135 @@
 #include "file_format_fumen.h"
 
-// TODO: ...
+namespace Fumen
+{
+	b8 Read(const void* fileContent, size_t fileSize, ChartView& out)
+	{
+		const u8* const begin = static_cast<const u8*>(fileContent);
+		const u8* const end = begin + fileSize;
+		if (fileContent == nullptr || fileSize < sizeof(FileHeader))
+			return false;
+
+		FileHeader header; ::memcpy(&header, begin, sizeof(header));
+
+		// NOTE: Every measure takes up at least its own record plus the (empty) branch records, which also rules out absurd counts before reserving for them
+		const size_t minBytesPerMeasure = sizeof(MeasureRecord) + (sizeof(BranchRecord) * BranchCount);
+		if (header.MeasureCount > ((fileSize - sizeof(FileHeader)) / minBytesPerMeasure))
+			return false;
+
+		std::vector<MeasureView> measures;
+		measures.reserve(header.MeasureCount);
+
+		const u8* it = begin + sizeof(FileHeader);
+		for (u32 measureIndex = 0; measureIndex < header.MeasureCount; measureIndex++)
+		{
+			if (static_cast<size_t>(end - it) < sizeof(MeasureRecord))
+				return false;
+
+			MeasureView& measure = measures.emplace_back();
+			::memcpy(&measure.Record, it, sizeof(MeasureRecord));
+			it += sizeof(MeasureRecord);
+			if (!std::isfinite(measure.Record.BPM) || !std::isfinite(measure.Record.OffsetMS))
+				return false;
+
+			for (BranchView& branch : measure.Branches)
+			{
+				if (static_cast<size_t>(end - it) < sizeof(BranchRecord))
+					return false;
+
+				::memcpy(&branch.Record, it, sizeof(BranchRecord));
+				it += sizeof(BranchRecord);
+				branch.NoteData = it;
+				if (!std::isfinite(branch.Record.ScrollSpeed))
+					return false;
+
+				// NOTE: The type of each note is needed to know where the next one begins, with its times being checked along the way
+				for (size_t noteIndex = 0; noteIndex < branch.Record.NoteCount; noteIndex++)
+				{
+					if (static_cast<size_t>(end - it) < sizeof(NoteRecord))
+						return false;
+
+					NoteRecord note; ::memcpy(&note, it, sizeof(note));
+					if (!std::isfinite(note.PositionMS) || !std::isfinite(note.DurationMS))
+						return false;
+
+					const size_t noteSize = sizeof(NoteRecord) + (HasTrailingDrumrollBytes(note.Type) ? TrailingDrumrollByteCount : 0);
+					if (static_cast<size_t>(end - it) < noteSize)
+						return false;
+					it += noteSize;
+				}
+			}
+		}
+
+		out.Header = header;
+		out.Measures = std::move(measures);
+		return true;
+	}
+
+	FileHeader CreateDefaultHeader(b8 easierDifficulty, i32 hitNoteCount)
+	{
+		FileHeader header = {};
+		for (auto& timings : header.JudgeTimings)
+		{
+			timings[0] = easierDifficulty ? 41.7083358764648f : 25.0250015258789f;
+			timings[1] = easierDifficulty ? 108.441665649414f : 75.0750045776367f;
+			timings[2] = easierDifficulty ? 125.125000000000f : 108.441665649414f;
+		}
+
+		header.HPMax = 10000;
+		header.HPClear = easierDifficulty ? 6000 : 8000;
+		header.HPGainGood = (hitNoteCount > 0) ? ClampBot((header.HPMax + hitNoteCount - 1) / hitNoteCount, 1) : header.HPMax;
+		header.HPGainOk = ClampBot(header.HPGainGood / 2, 1);
+		header.HPLossBad = -(header.HPGainGood * 2);
+		for (i32& points : header.BranchPoints)
+			points = 20;
+		return header;
+	}
+
+	template <typename T>
+	static inline void AppendRecord(std::vector<u8>& out, const T& record)
+	{
+		const size_t offset = out.size();
+		out.resize(offset + sizeof(T));
+		::memcpy(out.data() + offset, &record, sizeof(T));
+	}
+
+	void Writer::BeginFile(const FileHeader& header)
+	{
+		HeaderOffset = Out.size();
+		BranchOffset = 0;
+		MeasureCount = 0;
+		AppendRecord(Out, header);
+	}
+
+	void Writer::AddMeasure(const MeasureRecord& measure)
+	{
+		AppendRecord(Out, measure);
+		MeasureCount++;
+	}
+
+	void Writer::BeginBranch(f32 scrollSpeed)
+	{
+		BranchOffset = Out.size();
+		AppendRecord(Out, BranchRecord { 0, 0, scrollSpeed });
+	}
+
+	b8 Writer::AddNote(const NoteRecord& note)
+	{
+		u16 noteCount; ::memcpy(&noteCount, Out.data() + BranchOffset + offsetof(BranchRecord, NoteCount), sizeof(noteCount));
+		if (noteCount >= U16Max)
+			return false;
+
+		AppendRecord(Out, note);
+		if (HasTrailingDrumrollBytes(note.Type))
+			Out.resize(Out.size() + TrailingDrumrollByteCount, 0x00);
+
+		noteCount++;
+		::memcpy(Out.data() + BranchOffset + offsetof(BranchRecord, NoteCount), &noteCount, sizeof(noteCount));
+		return true;
+	}
+
+	void Writer::EndFile()
+	{
+		::memcpy(Out.data() + HeaderOffset + offsetof(FileHeader, MeasureCount), &MeasureCount, sizeof(MeasureCount));
+	}
+}
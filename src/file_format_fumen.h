@@ -1,3 +1,157 @@
 #pragma once
+#include "core_types.h"
+#include <string_view>
+#include <vector>
 
-// TODO: ...
+// NOTE: The binary "fumen" chart format as used by the games themselves, with each file storing a single course as a fixed size header
+//		 followed by a list of measures that each contain three branches (normal, expert, master) of note records.
+//		 All values are little-endian and all times are in (single precision) milliseconds.
+//
+//		 Measures have no notion of beats or time signatures, instead each one stores its own tempo and start time
+//		 (offset by the duration of a 4/4 bar at that tempo, being the time it takes to scroll in from the right edge of the lane)
+//		 with the notes inside positioned relative to the start of the measure.
+//
+//		 "Reading" doesn't copy any of the measure or note data and only builds up an index of where each measure and branch begins inside the input buffer,
+//		 which is expected to outlive the resulting ChartView (and can just as well be a file mapped directly into memory).
+namespace Fumen
+{
+	static constexpr std::string_view Extension = ".bin";
+	static constexpr std::string_view FilterName = "Fumen Taiko Chart";
+	static constexpr std::string_view FilterSpec = "*.bin";
+
+	constexpr i32 BranchCount = 3;
+
+	enum class NoteType : u32
+	{
+		None = 0x0,
+		Don = 0x1,
+		Do = 0x2,
+		Ko = 0x3,
+		Ka = 0x4,
+		Katsu = 0x5,
+		Drumroll = 0x6,
+		DonBig = 0x7,
+		KaBig = 0x8,
+		DrumrollBig = 0x9,
+		Balloon = 0xA,
+		DonBigHand = 0xB,
+		Kusudama = 0xC,
+		KaBigHand = 0xD,
+		DrumrollAlt = 0x62,
+	};
+
+	// NOTE: Drumroll notes are followed by 8 additional (unused) bytes, making the note records variable in size
+	constexpr b8 HasTrailingDrumrollBytes(NoteType v) { return (v == NoteType::Drumroll) || (v == NoteType::DrumrollBig) || (v == NoteType::DrumrollAlt); }
+	constexpr size_t TrailingDrumrollByteCount = 8;
+
+	struct FileHeader
+	{
+		// NOTE: Hit timing windows (good, ok, bad) repeated for every entry
+		f32 JudgeTimings[36][3];
+		i32 HasBranches;
+		i32 HPMax;
+		i32 HPClear;
+		i32 HPGainGood;
+		i32 HPGainOk;
+		i32 HPLossBad;
+		i32 BranchPoints[12];
+		i32 Reserved0[2];
+		u32 MeasureCount;
+		u32 Reserved1;
+	};
+
+	struct MeasureRecord
+	{
+		f32 BPM;
+		f32 OffsetMS;
+		u8 GoGo;
+		u8 BarLine;
+		u16 Reserved0;
+		// NOTE: Expert and master requirements for each of the three branch condition types, -1 meaning none
+		i32 BranchConditions[6];
+		i32 Reserved1;
+	};
+
+	struct BranchRecord
+	{
+		u16 NoteCount;
+		u16 Reserved;
+		f32 ScrollSpeed;
+	};
+
+	struct NoteRecord
+	{
+		NoteType Type;
+		f32 PositionMS;
+		u32 Item;
+		f32 Reserved;
+		// NOTE: Number of hits required to pop balloon notes instead of the score
+		u16 ScoreInitOrBalloonHits;
+		u16 ScoreDiff;
+		f32 DurationMS;
+	};
+
+	static_assert(sizeof(FileHeader) == 0x208 && sizeof(MeasureRecord) == 0x28 && sizeof(BranchRecord) == 0x8 && sizeof(NoteRecord) == 0x18);
+
+	// NOTE: The measure offset is stored one 4/4 bar earlier than where the measure actually starts
+	constexpr f64 GetMeasureLeadInMS(f32 bpm) { return (bpm == 0.0f) ? 0.0 : (240000.0 / static_cast<f64>(bpm)); }
+	constexpr f32 MeasureStartToOffsetMS(f64 startMS, f32 bpm) { return static_cast<f32>(startMS - GetMeasureLeadInMS(bpm)); }
+
+	struct BranchView
+	{
+		BranchRecord Record;
+		// NOTE: Points into the buffer that was read from, with the records not necessarily being aligned
+		const u8* NoteData;
+
+		template <typename Func>
+		inline void ForEachNote(Func perNoteFunc) const
+		{
+			const u8* it = NoteData;
+			for (size_t i = 0; i < Record.NoteCount; i++)
+			{
+				NoteRecord note; ::memcpy(&note, it, sizeof(note));
+				it += sizeof(NoteRecord) + (HasTrailingDrumrollBytes(note.Type) ? TrailingDrumrollByteCount : 0);
+				perNoteFunc(note);
+			}
+		}
+	};
+
+	struct MeasureView
+	{
+		MeasureRecord Record;
+		BranchView Branches[BranchCount];
+
+		inline f64 GetStartMS() const { return static_cast<f64>(Record.OffsetMS) + GetMeasureLeadInMS(Record.BPM); }
+	};
+
+	struct ChartView
+	{
+		FileHeader Header;
+		std::vector<MeasureView> Measures;
+	};
+
+	// NOTE: Fails (without touching the output) for anything too short to hold all of the records it claims to contain
+	//		 or with any tempo, time or scroll speed that isn't a finite number
+	b8 Read(const void* fileContent, size_t fileSize, ChartView& out);
+
+	// NOTE: Timing windows and soul gauge values derived from the number of hittable notes,
+	//		 with the easier difficulties having more lenient timing windows and a lower clear threshold
+	FileHeader CreateDefaultHeader(b8 easierDifficulty, i32 hitNoteCount);
+
+	// NOTE: Appends records to the output one after another, patching in the note and measure counts once they are known.
+	//		 Usage: BeginFile(), then for each measure AddMeasure() followed by BranchCount times BeginBranch() and AddNote() for each of its notes, then EndFile()
+	struct Writer
+	{
+		std::vector<u8>& Out;
+		size_t HeaderOffset = 0;
+		size_t BranchOffset = 0;
+		u32 MeasureCount = 0;
+
+		void BeginFile(const FileHeader& header);
+		void AddMeasure(const MeasureRecord& measure);
+		void BeginBranch(f32 scrollSpeed);
+		// NOTE: Fails (without adding the note) once the branch already holds as many notes as its record is able to count
+		b8 AddNote(const NoteRecord& note);
+		void EndFile();
+	};
+}
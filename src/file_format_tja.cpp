@@ -1,6 +1,8 @@
 #include "file_format_tja.h"
 #include <algorithm>
 #include <array>
+#include <charconv>
+#include <cmath>
 #include <numeric>
 
 namespace TJA
@@ -92,49 +94,140 @@ namespace TJA
 
 	static_assert(ArrayCount(KeyStrings) == EnumCount<Key>);
 
-	static const std::regex PatTJAHeader = std::regex("^\\.?[A-Z][A-Z0-9_]*$");
-	static const std::regex PatTJACommand = std::regex("^[A-Z]+$");
+	// NOTE: Same as matching "^\.?[A-Z][A-Z0-9_]*$"
+	static constexpr b8 IsValidHeaderKeyString(std::string_view str)
+	{
+		if (!str.empty() && str[0] == '.')
+			str.remove_prefix(1);
+		if (str.empty() || !ASCII::IsUpperCase(str[0]))
+			return false;
+		for (size_t i = 1; i < str.size(); i++)
+		{
+			if (!ASCII::IsUpperCase(str[i]) && !(str[i] >= '0' && str[i] <= '9') && str[i] != '_')
+				return false;
+		}
+		return true;
+	}
 
-	static bool MatchKeyString(Key key, std::string_view str)
+	// NOTE: Same as matching "^[A-Z]+$"
+	static constexpr b8 IsValidCommandKeyString(std::string_view str)
 	{
-		switch (key) {
-		case Key::Main_Invalid:
-		case Key::Course_Invalid:
-			return !std::regex_match(begin(str), end(str), PatTJAHeader);
-		case Key::Chart_Invalid:
-			return !std::regex_match(begin(str), end(str), PatTJACommand);
-
-		case Key::Main_TITLE_localized:
-		case Key::Main_SUBTITLE_localized:
-		case Key::Course_NOTESDESIGNERs:
-		case Key::Course_EXAMs:
-			return ASCII::StartsWith(str, KeyStrings[EnumToIndex(key)]);
-
-		case Key::Unknown:
-		case Key::Course_Unknown: // ambiguous between Main and Course scope, reassigned later
-		case Key::Chart_Unknown:
-			return true;
+		if (str.empty())
+			return false;
+		for (const char c : str)
+		{
+			if (!ASCII::IsUpperCase(c))
+				return false;
+		}
+		return true;
+	}
 
-		case Key::Main_Unknown:
-			return false; // ambiguous between Main and Course scope, assigned separately
+	// NOTE: Localized and numbered keys (such as "TITLEJA", "NOTESDESIGNER2" or "EXAM1") only ever match by prefix,
+	//		 and only once none of the exact keys did (in the order they are declared in)
+	static constexpr Key PrefixMatchedKeys[] = { Key::Main_TITLE_localized, Key::Main_SUBTITLE_localized, Key::Course_NOTESDESIGNERs, Key::Course_EXAMs };
 
-		default:
-			return (str == KeyStrings[EnumToIndex(key)]);
+	static constexpr b8 IsPrefixMatchedKey(Key key)
+	{
+		for (const Key prefixKey : PrefixMatchedKeys) { if (key == prefixKey) return true; }
+		return false;
+	}
+
+	static constexpr b8 NoExactKeyIsShadowedByAnEarlierPrefixKey()
+	{
+		for (const Key prefixKey : PrefixMatchedKeys)
+		{
+			for (Key key = prefixKey; key < Key::Count; IncrementEnum(key))
+			{
+				if (!IsPrefixMatchedKey(key) && !KeyStrings[EnumToIndex(key)].empty() && ASCII::StartsWith(KeyStrings[EnumToIndex(key)], KeyStrings[EnumToIndex(prefixKey)]))
+					return false;
+			}
 		}
+		return true;
+	}
+
+	static_assert(NoExactKeyIsShadowedByAnEarlierPrefixKey(), "Exact keys are looked up before any prefix keys");
+
+	static constexpr u32 HashKeyString(std::string_view str, u32 seed)
+	{
+		u32 hash = seed;
+		for (const char c : str) { hash ^= static_cast<u8>(c); hash *= 0x01000193; }
+		return hash ^ (hash >> 16);
 	}
 
+	// NOTE: Perfect hash table over all exact key strings within a key range, with its seed being searched for at compile time
+	//		 so that every key ends up in a slot of its own. A lookup then only has to hash the input once and compare it against a single key string
+	struct PerfectHashKeyTable
+	{
+		static constexpr u32 SlotCount = 256;
+		u32 Seed;
+		Key Slots[SlotCount];
+
+		constexpr Key Find(std::string_view str) const
+		{
+			const Key key = Slots[HashKeyString(str, Seed) & (SlotCount - 1)];
+			return (key != Key::Unknown && KeyStrings[EnumToIndex(key)] == str) ? key : Key::Unknown;
+		}
+	};
+
+	static constexpr PerfectHashKeyTable BuildPerfectHashKeyTable(Key first, Key last)
+	{
+		for (u32 seed = 0x811C9DC5;; seed++)
+		{
+			PerfectHashKeyTable table = {};
+			table.Seed = seed;
+			for (Key& slot : table.Slots)
+				slot = Key::Unknown;
+
+			b8 anyCollision = false;
+			for (Key key = first; key <= last && !anyCollision; IncrementEnum(key))
+			{
+				if (KeyStrings[EnumToIndex(key)].empty() || IsPrefixMatchedKey(key))
+					continue;
+
+				Key& slot = table.Slots[HashKeyString(KeyStrings[EnumToIndex(key)], seed) & (PerfectHashKeyTable::SlotCount - 1)];
+				anyCollision = (slot != Key::Unknown);
+				slot = key;
+			}
+
+			if (!anyCollision)
+				return table;
+		}
+	}
+
+	static constexpr PerfectHashKeyTable KeyColonValueKeyTable = BuildPerfectHashKeyTable(Key::KeyColonValue_First, Key::KeyColonValue_Last);
+	static constexpr PerfectHashKeyTable HashCommandKeyTable = BuildPerfectHashKeyTable(Key::HashCommand_First, Key::HashCommand_Last);
+
 	Key GetKeyColonValueTokenKey(std::string_view str)
 	{
-		for (Key i = Key::KeyColonValue_First; i <= Key::KeyColonValue_Last; IncrementEnum(i))
-			if (MatchKeyString(i, str)) { return i; }
-		return Key::Course_Unknown; // already matched; should never be reached
+		if (!IsValidHeaderKeyString(str))
+			return Key::Main_Invalid;
+
+		if (const Key exactKey = KeyColonValueKeyTable.Find(str); exactKey != Key::Unknown)
+			return exactKey;
+
+		for (const Key prefixKey : PrefixMatchedKeys)
+		{
+			if (ASCII::StartsWith(str, KeyStrings[EnumToIndex(prefixKey)]))
+				return prefixKey;
+		}
+
+		return Key::Course_Unknown; // ambiguous between Main and Course scope, reassigned later
 	}
 
 	Key GetHashCommandTokenKey(std::string_view str)
 	{
-		for (Key i = Key::HashCommand_First; i <= Key::HashCommand_Last; IncrementEnum(i))
-			if (MatchKeyString(i, str)) { return i; }
-		return Key::Chart_Unknown; // already matched; should never be reached
+		if (!IsValidCommandKeyString(str))
+			return Key::Chart_Invalid;
+
+		if (const Key exactKey = HashCommandKeyTable.Find(str); exactKey != Key::Unknown)
+			return exactKey;
+
+		return Key::Chart_Unknown;
+	}
+
+	std::string_view GetKeyString(Key key)
+	{
+		return KeyStrings[EnumToIndex(key)];
 	}
 
 	struct LinePrefixCommentSuffixSplit { std::string_view LinePrefix, CommentSuffix; };
@@ -165,95 +258,104 @@ namespace TJA
 		return outLines;
 	}
 
-	std::vector<Token> TokenizeLines(const std::vector<std::string_view>& lines)
+	// NOTE: Outputs up to two tokens for a single line, being either an empty line or the line content (if any) followed by a comment token (if any)
+	static i32 TokenizeLine(std::string_view lineFull, size_t lineIndex, TokenStream::TokenizerState& state, Token outTokens[2])
 	{
-		std::vector<Token> outTokens;
-		outTokens.reserve(lines.size());
+		i32 outTokenCount = 0;
+		std::string_view lineTrimmed = ASCII::Trim(lineFull);
 
-		b8 currentlyBetweenChartStartAndEnd = false;
-		b8 currentlyAfterFirstCourse = false;
-
-		for (size_t lineIndex = 0; lineIndex < lines.size(); lineIndex++)
+		if (lineTrimmed.empty() || ASCII::IsAllWhitespace(lineTrimmed))
 		{
-			const std::string_view lineFull = lines[lineIndex];
-			std::string_view lineTrimmed = ASCII::Trim(lineFull);
+			Token& newToken = (outTokens[outTokenCount++] = {});
+			newToken.Type = TokenType::EmptyLine;
+			newToken.LineIndex = static_cast<i16>(lineIndex);
+			newToken.Line = lineTrimmed;
+		}
+		else
+		{
+			const LinePrefixCommentSuffixSplit lineCommentSplit = SplitLineIntoPrefixAndCommentSuffix(lineTrimmed);
+			if (!lineCommentSplit.CommentSuffix.empty())
+				lineTrimmed = ASCII::Trim(lineCommentSplit.LinePrefix);
 
-			if (lineTrimmed.empty() || ASCII::IsAllWhitespace(lineTrimmed))
+			if (!lineTrimmed.empty())
 			{
-				Token& newToken = outTokens.emplace_back();
-				newToken.Type = TokenType::EmptyLine;
+				Token& newToken = (outTokens[outTokenCount++] = {});
+				newToken.Type = TokenType::Unknown;
 				newToken.LineIndex = static_cast<i16>(lineIndex);
 				newToken.Line = lineTrimmed;
-			}
-			else
-			{
-				const LinePrefixCommentSuffixSplit lineCommentSplit = SplitLineIntoPrefixAndCommentSuffix(lineTrimmed);
-				if (!lineCommentSplit.CommentSuffix.empty())
-					lineTrimmed = ASCII::Trim(lineCommentSplit.LinePrefix);
 
-				if (!lineTrimmed.empty())
+				if (lineTrimmed[0] == '#')
 				{
-					Token& newToken = outTokens.emplace_back();
-					newToken.Type = TokenType::Unknown;
-					newToken.LineIndex = static_cast<i16>(lineIndex);
-					newToken.Line = lineTrimmed;
-
-					if (lineTrimmed[0] == '#')
-					{
-						newToken.Type = TokenType::HashChartCommand;
-						if (const size_t spaceSeparator = lineTrimmed.find_first_of(' '); spaceSeparator != std::string_view::npos)
-						{
-							newToken.KeyString = lineTrimmed.substr(sizeof('#'), spaceSeparator - sizeof('#'));
-							newToken.ValueString = lineTrimmed.substr(spaceSeparator + sizeof(' '));
-						}
-						else
-						{
-							newToken.KeyString = lineTrimmed.substr(sizeof('#'), lineTrimmed.size() - sizeof('#'));
-							newToken.ValueString = {};
-						}
-
-						newToken.Key = GetHashCommandTokenKey(newToken.KeyString);
-						if (newToken.Key == Key::Chart_START)
-							currentlyBetweenChartStartAndEnd = true;
-						else if (newToken.Key == Key::Chart_END)
-							currentlyBetweenChartStartAndEnd = false;
-					}
-					else if (const size_t colonSeparator = lineTrimmed.find_first_of(':'); colonSeparator != std::string_view::npos)
+					newToken.Type = TokenType::HashChartCommand;
+					if (const size_t spaceSeparator = lineTrimmed.find_first_of(' '); spaceSeparator != std::string_view::npos)
 					{
-						newToken.Type = TokenType::KeyColonValue;
-						newToken.KeyString = lineTrimmed.substr(0, colonSeparator);
-						newToken.ValueString = lineTrimmed.substr(colonSeparator + sizeof(':'));
-
-						newToken.Key = GetKeyColonValueTokenKey(newToken.KeyString);
-						if (newToken.Key == Key::Course_COURSE) {
-							currentlyAfterFirstCourse = true;
-						} else if (currentlyAfterFirstCourse) {
-							// treat unknown headers after first COURSE: as course-scope header
-							if (newToken.Key == Key::Main_Invalid)
-								newToken.Key = Key::Course_Invalid;
-						} else {
-							// treat unknown headers before first COURSE: as file-scope header
-							if (newToken.Key == Key::Course_Unknown)
-								newToken.Key = Key::Main_Unknown;
-						}
+						newToken.KeyString = lineTrimmed.substr(sizeof('#'), spaceSeparator - sizeof('#'));
+						newToken.ValueString = lineTrimmed.substr(spaceSeparator + sizeof(' '));
 					}
 					else
 					{
-						newToken.Type = currentlyBetweenChartStartAndEnd ? TokenType::ChartData : TokenType::Unknown;
-						newToken.KeyString = {};
-						newToken.ValueString = lineTrimmed;
+						newToken.KeyString = lineTrimmed.substr(sizeof('#'), lineTrimmed.size() - sizeof('#'));
+						newToken.ValueString = {};
 					}
-				}
 
-				if (!lineCommentSplit.CommentSuffix.empty())
+					newToken.Key = GetHashCommandTokenKey(newToken.KeyString);
+					if (newToken.Key == Key::Chart_START)
+						state.CurrentlyBetweenChartStartAndEnd = true;
+					else if (newToken.Key == Key::Chart_END)
+						state.CurrentlyBetweenChartStartAndEnd = false;
+				}
+				else if (const size_t colonSeparator = lineTrimmed.find_first_of(':'); colonSeparator != std::string_view::npos)
+				{
+					newToken.Type = TokenType::KeyColonValue;
+					newToken.KeyString = lineTrimmed.substr(0, colonSeparator);
+					newToken.ValueString = lineTrimmed.substr(colonSeparator + sizeof(':'));
+
+					newToken.Key = GetKeyColonValueTokenKey(newToken.KeyString);
+					if (newToken.Key == Key::Course_COURSE) {
+						state.CurrentlyAfterFirstCourse = true;
+					} else if (state.CurrentlyAfterFirstCourse) {
+						// treat unknown headers after first COURSE: as course-scope header
+						if (newToken.Key == Key::Main_Invalid)
+							newToken.Key = Key::Course_Invalid;
+					} else {
+						// treat unknown headers before first COURSE: as file-scope header
+						if (newToken.Key == Key::Course_Unknown)
+							newToken.Key = Key::Main_Unknown;
+					}
+				}
+				else
 				{
-					Token& newCommentToken = outTokens.emplace_back();
-					newCommentToken.Type = TokenType::Comment;
-					newCommentToken.LineIndex = static_cast<i16>(lineIndex);
-					newCommentToken.Line = lineTrimmed;
-					newCommentToken.ValueString = ASCII::Trim(lineCommentSplit.CommentSuffix.substr(sizeof('/') * 2));
+					newToken.Type = state.CurrentlyBetweenChartStartAndEnd ? TokenType::ChartData : TokenType::Unknown;
+					newToken.KeyString = {};
+					newToken.ValueString = lineTrimmed;
 				}
 			}
+
+			if (!lineCommentSplit.CommentSuffix.empty())
+			{
+				Token& newCommentToken = (outTokens[outTokenCount++] = {});
+				newCommentToken.Type = TokenType::Comment;
+				newCommentToken.LineIndex = static_cast<i16>(lineIndex);
+				newCommentToken.Line = lineTrimmed;
+				newCommentToken.ValueString = ASCII::Trim(lineCommentSplit.CommentSuffix.substr(sizeof('/') * 2));
+			}
+		}
+
+		return outTokenCount;
+	}
+
+	std::vector<Token> TokenizeLines(const std::vector<std::string_view>& lines)
+	{
+		std::vector<Token> outTokens;
+		outTokens.reserve(lines.size());
+
+		TokenStream::TokenizerState state = {};
+		for (size_t lineIndex = 0; lineIndex < lines.size(); lineIndex++)
+		{
+			Token lineTokens[2];
+			const i32 lineTokenCount = TokenizeLine(lines[lineIndex], lineIndex, state, lineTokens);
+			for (i32 i = 0; i < lineTokenCount; i++)
+				outTokens.push_back(lineTokens[i]);
 		}
 
 		// end-of-file token as implicit `#END`
@@ -263,7 +365,59 @@ namespace TJA
 		return outTokens;
 	}
 
-	ParsedTJA ParseTokens(const std::vector<Token>& tokens, ErrorList& outErrors)
+	b8 TokenStream::Next(Token& outToken)
+	{
+		if (HasPendingToken)
+		{
+			outToken = PendingToken;
+			HasPendingToken = false;
+			return true;
+		}
+
+		while (NextLineStart < FileContent.size())
+		{
+			// NOTE: Same line splitting as ASCII::ForEachLineInMultiLineString(), including its quirk of not trimming the line break of a trailing final line
+			const size_t lineBreak = FileContent.find('\n', NextLineStart);
+			std::string_view line;
+			if (lineBreak == std::string_view::npos || (lineBreak + 1) == FileContent.size())
+			{
+				line = FileContent.substr(NextLineStart);
+				NextLineStart = FileContent.size();
+			}
+			else
+			{
+				const size_t lineEnd = (lineBreak > NextLineStart && FileContent[lineBreak - 1] == '\r') ? (lineBreak - 1) : lineBreak;
+				line = FileContent.substr(NextLineStart, lineEnd - NextLineStart);
+				NextLineStart = (lineBreak + 1);
+			}
+
+			Token lineTokens[2];
+			const i32 lineTokenCount = TokenizeLine(line, static_cast<size_t>(NextLineIndex++), State, lineTokens);
+			if (lineTokenCount > 0)
+			{
+				outToken = lineTokens[0];
+				if (lineTokenCount > 1) { PendingToken = lineTokens[1]; HasPendingToken = true; }
+				return true;
+			}
+		}
+
+		// end-of-file token as implicit `#END`
+		if (!HasReachedEndOfFile)
+		{
+			HasReachedEndOfFile = true;
+			if (NextLineIndex > 0)
+			{
+				outToken = Token { TokenType::HashChartCommand, Key::Chart_END, static_cast<i16>(NextLineIndex - 1) };
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// NOTE: Pulls tokens from nextTokenFunc until it returns null. The measure note arena is reserved upfront so that it (ideally) never has to grow
+	template <typename NextTokenFunc>
+	static ParsedTJA ParseTokensFrom(NextTokenFunc nextTokenFunc, size_t measureNoteArenaCapacity, ErrorList& outErrors)
 	{
 		static constexpr auto tryParseDefaultForEmpty = [](std::string_view in, auto* out, auto dflt) -> b8 { if (in.empty()) { *out = dflt; return true; } else { return ASCII::TryParse(in, *out); } };
 		static constexpr auto tryParseCommaSeparatedValues = [](std::string_view in, auto* out) -> b8
@@ -447,6 +601,7 @@ namespace TJA
 		};
 
 		ParsedTJA outTJA = {};
+		outTJA.MeasureNoteArena.reserve(measureNoteArenaCapacity);
 
 		i32 currentMeasureNoteCount = 0;
 		b8 currentlyBetweenFirstCommandAndEnd = false;
@@ -492,8 +647,9 @@ namespace TJA
 			return newCommand;
 		};
 
-		for (const Token& token : tokens)
+		while (const Token* nextToken = nextTokenFunc())
 		{
+			const Token& token = *nextToken;
 			const i16 lineIndex = token.LineIndex;
 			switch (token.Type)
 			{
@@ -995,7 +1151,8 @@ namespace TJA
 					currentlyInBetweenMeasure = true;
 
 					ParsedChartCommand& newCommand = pushChartCommand(ParsedChartCommandType::MeasureNotes);
-					newCommand.Param.MeasureNotes.Notes.reserve(token.ValueString.size());
+					newCommand.Param.MeasureNotes.NoteStart = static_cast<u32>(outTJA.MeasureNoteArena.size());
+					newCommand.Param.MeasureNotes.NoteCount = 0;
 					for (const char& c : token.ValueString)
 					{
 						if (c == ',')
@@ -1021,7 +1178,8 @@ namespace TJA
 							if (!tryParseNoteTypeChar(c, &parsedNoteTypeOrNone))
 								outErrors.Push(lineIndex, "Unknown note type '%c'", c);
 
-							newCommand.Param.MeasureNotes.Notes.push_back(parsedNoteTypeOrNone);
+							outTJA.MeasureNoteArena.push_back(parsedNoteTypeOrNone);
+							newCommand.Param.MeasureNotes.NoteCount++;
 							currentMeasureNoteCount++;
 						}
 					}
@@ -1047,30 +1205,115 @@ namespace TJA
 		return outTJA;
 	}
 
+	ParsedTJA ParseTokens(const std::vector<Token>& tokens, ErrorList& outErrors)
+	{
+		size_t measureNoteArenaCapacity = 0;
+		for (const Token& token : tokens)
+			measureNoteArenaCapacity += (token.Type == TokenType::ChartData) ? token.ValueString.size() : 0;
+
+		size_t nextTokenIndex = 0;
+		return ParseTokensFrom([&]() { return (nextTokenIndex < tokens.size()) ? &tokens[nextTokenIndex++] : nullptr; }, measureNoteArenaCapacity, outErrors);
+	}
+
+	ParsedTJA ParseFileContent(std::string_view fileContent, ErrorList& outErrors)
+	{
+		// NOTE: Every note takes up (at least) one character so the file size is an upper bound for the note count
+		TokenStream tokenStream = TokenStream(fileContent);
+		Token token = {};
+		return ParseTokensFrom([&]() { return tokenStream.Next(token) ? &token : nullptr; }, fileContent.size(), outErrors);
+	}
+
 	static const ParsedMainMetadata DefaultMainMetadata = {};
 	static const ParsedCourseMetadata DefaultCourseMetadata = {};
 
+	// NOTE: Writes straight into the output string without going through any temporary strings, formatting all numbers in place via std::to_chars.
+	//		 Floating point values use the general format with a precision of 6 which is defined to produce the exact same output as printf's "%g"
+	struct TJATextWriter
+	{
+		std::string& Out;
+
+		inline void Char(char c) { Out += c; }
+		inline void String(std::string_view value) { Out += value; }
+		inline void NewLine() { Out += '\n'; }
+
+		inline void I32(i32 value)
+		{
+			char buffer[16];
+			Out.append(buffer, static_cast<size_t>(std::to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer));
+		}
+
+		inline void F64(f64 value, std::chars_format format = std::chars_format::general, i32 precision = 6)
+		{
+			char buffer[512];
+			const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value, format, precision);
+			assert(result.ec == std::errc {});
+			Out.append(buffer, static_cast<size_t>(result.ptr - buffer));
+		}
+
+		// NOTE: Same output as Complex::toStringCompat(), with the imaginary part always having an explicit sign like std::showpos
+		inline void ComplexCompat(const Complex& value)
+		{
+			F64(value.GetRealPart());
+			if (value.GetImaginaryPart() != 0)
+			{
+				if (!std::signbit(value.GetImaginaryPart()))
+					Char('+');
+				F64(value.GetImaginaryPart());
+				Char('i');
+			}
+		}
+
+		inline void KeyString(TJA::Key key) { Out += KeyStrings[EnumToIndex(key)]; }
+		inline void PropertyStart(TJA::Key key) { KeyString(key); Char(':'); }
+		inline void SuffixedPropertyStart(TJA::Key key, std::string_view suffix) { KeyString(key); String(suffix); Char(':'); }
+		inline void CommandStart(TJA::Key key) { Char('#'); KeyString(key); Char(' '); }
+
+		inline void PropertyLine(TJA::Key key, std::string_view value) { PropertyStart(key); String(value); NewLine(); }
+		inline void SuffixedPropertyLine(TJA::Key key, std::string_view suffix, std::string_view value) { SuffixedPropertyStart(key, suffix); String(value); NewLine(); }
+		inline void CommandLine(TJA::Key key) { Char('#'); KeyString(key); NewLine(); }
+		inline void CommandLine(TJA::Key key, std::string_view value) { if (value.empty()) { CommandLine(key); } else { CommandStart(key); String(value); NewLine(); } }
+
+		inline void BalloonPropertyLine(TJA::Key key, const std::vector<i32>& popCounts)
+		{
+			PropertyStart(key);
+			for (size_t i = 0; i < popCounts.size(); i++) { if (i != 0) { Char(','); } I32(popCounts[i]); }
+			NewLine();
+		}
+	};
+
+	// NOTE: Rough upper estimate so that the output only has to be allocated once, with the bulk of any TJA being made up of one char per note
+	//		 and short command lines in between. Should it ever fall short the output simply grows as usual
+	static size_t EstimateConvertedTextSize(const ParsedTJA& inContent)
+	{
+		const auto mapSize = [](const auto& map) { size_t size = 0; for (const auto& [key, value] : map) { size += key.size() + value.size() + 16; } return size; };
+
+		const ParsedMainMetadata& metadata = inContent.Metadata;
+		size_t size = 0x400 + metadata.TITLE.size() + metadata.SUBTITLE.size() + metadata.WAVE.size() + metadata.PREIMAGE.size() + metadata.BGIMAGE.size()
+			+ metadata.BGMOVIE.size() + metadata.LYRICS.size() + metadata.MAKER.size() + metadata.GENRE.size()
+			+ mapSize(metadata.TITLE_localized) + mapSize(metadata.SUBTITLE_localized) + mapSize(metadata.Others);
+
+		size += inContent.MeasureNoteArena.size();
+		for (const ParsedCourse& course : inContent.Courses)
+		{
+			size += 0x200 + course.Metadata.NOTESDESIGNER.size() + mapSize(course.Metadata.Others);
+			size += (course.Metadata.BALLOON.size() + course.Metadata.BALLOON_Normal.size() + course.Metadata.BALLOON_Expert.size() + course.Metadata.BALLOON_Master.size()) * 4;
+			size += course.ChartCommands.size() * 24;
+			for (const ParsedChartCommand& command : course.ChartCommands)
+			{
+				if (command.Type == ParsedChartCommandType::SetLyricLine)
+					size += command.Param.SetLyricLine.Value.size();
+			}
+		}
+		return size;
+	}
+
 	void ConvertParsedToText(const ParsedTJA& inContent, std::string& out, Encoding encoding)
 	{
-		// TODO: ... or maybe tokenize first instead of going right to text..?
-		out.reserve(out.size() + 0x4000);
+		out.reserve(out.size() + EstimateConvertedTextSize(inContent));
 		if (encoding == Encoding::UTF8)
 			out += std::string_view(UTF8::BOM_UTF8, sizeof(UTF8::BOM_UTF8));
 
-		static constexpr auto appendLine = [](std::string& out, std::string_view line) { out += line; out += '\n'; };
-		static constexpr auto appendProperyLine = [](std::string& out, Key key, std::string_view value) { out += KeyStrings[EnumToIndex(key)]; out += ':'; out += value; out += '\n'; };
-		static constexpr auto appendSuffixedPropertyLine = [](std::string& out, Key key, std::string_view suffix, std::string_view value)
-		{ out += KeyStrings[EnumToIndex(key)]; out += suffix; out += ':'; out += value; out += '\n'; };
-		static constexpr auto appendCommandLine = [](std::string& out, Key key, std::string_view value) { out += '#'; out += KeyStrings[EnumToIndex(key)]; if (!value.empty()) { out += ' '; out += value; }out += '\n'; };
-		static constexpr auto appendBalloonProperyLine = [](std::string& out, Key key, const std::vector<i32>& popCounts)
-		{
-			out += KeyStrings[EnumToIndex(key)];
-			out += ':';
-			char buffer[16];
-			for (size_t i = 0; i < popCounts.size(); i++) { if (i != 0) { out += ','; } out += std::string_view(buffer, sprintf_s(buffer, "%d", popCounts[i])); }
-			out += '\n';
-		};
-		char buffer[512];
+		TJATextWriter writer = { out };
 
 		static constexpr auto noteTypeToChar = [](NoteType in) -> char
 		{
@@ -1109,15 +1352,6 @@ namespace TJA
 			default: return "";
 			}
 		};
-		static auto styleModeToString = [&](i32 in) -> std::string
-		{
-			switch (in)
-			{
-			case 1: return "Single";
-			case 2: return "Double";
-			default: return std::to_string(in);
-			}
-		};
 		static constexpr auto sideToString = [](SongSelectSide in) -> cstr
 		{
 			switch (in)
@@ -1129,95 +1363,62 @@ namespace TJA
 			}
 		};
 
-		// ヘッダー部分の云々かんぬん
-		if (inContent.HasPeepoDrumKitComment)
-		{
-			/*
-			out += "// ";
-			out += PeepoDrumKitCommentMarkerPrefix;
-			if (inContent.PeepoDrumKitCommentDate != Date::Zero())
-			{
-				out += " ";
-				out += inContent.PeepoDrumKitCommentDate.ToString().Data;
-			}
-			out += '\n';
-			*/
-		}
-
-		DifficultyType currentCourseScope = DifficultyType::Count; // default course scope
-
 		auto shouldEmitMainMetadata = [&, &inContent = inContent](auto ParsedMainMetadata::*... membs) // MSVC++ bug?: cannot implicitly capture variables when used in folder expression
 		{
 			return (... || (inContent.Metadata.*membs != DefaultMainMetadata.*membs));
 		};
 
-		appendProperyLine(out, Key::Main_TITLE, inContent.Metadata.TITLE); // Required for TaikoJiro
+		writer.PropertyLine(Key::Main_TITLE, inContent.Metadata.TITLE); // Required for TaikoJiro
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::TITLE_localized)) {
 			for (const auto& [locale, val] : inContent.Metadata.TITLE_localized)
-				appendSuffixedPropertyLine(out, Key::Main_TITLE_localized, locale, val);
+				writer.SuffixedPropertyLine(Key::Main_TITLE_localized, locale, val);
 		}
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::SUBTITLE, &ParsedMainMetadata::SUBTITLE_localized))
-			appendProperyLine(out, Key::Main_SUBTITLE, inContent.Metadata.SUBTITLE); // Better to be explicit if localized
+			writer.PropertyLine(Key::Main_SUBTITLE, inContent.Metadata.SUBTITLE); // Better to be explicit if localized
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::SUBTITLE_localized)) {
 			for (const auto& [locale, val] : inContent.Metadata.SUBTITLE_localized)
-				appendSuffixedPropertyLine(out, Key::Main_SUBTITLE_localized, locale, val);
+				writer.SuffixedPropertyLine(Key::Main_SUBTITLE_localized, locale, val);
 		}
-		appendProperyLine(out, Key::Main_BPM, std::string_view(buffer, sprintf_s(buffer, "%g", inContent.Metadata.BPM.BPM))); // Better to be explicit
+		{ writer.PropertyStart(Key::Main_BPM); writer.F64(inContent.Metadata.BPM.BPM); writer.NewLine(); } // Better to be explicit
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::WAVE))
-			appendProperyLine(out, Key::Main_WAVE, inContent.Metadata.WAVE);
+			writer.PropertyLine(Key::Main_WAVE, inContent.Metadata.WAVE);
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::PREIMAGE))
-			appendProperyLine(out, Key::Main_PREIMAGE, inContent.Metadata.PREIMAGE);
+			writer.PropertyLine(Key::Main_PREIMAGE, inContent.Metadata.PREIMAGE);
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::WAVE, &ParsedMainMetadata::OFFSET)) // Better to be explicit if `WAVE:` is given
-			appendProperyLine(out, Key::Main_OFFSET, std::string_view(buffer, sprintf_s(buffer, "%g", inContent.Metadata.OFFSET.Seconds)));
+			{ writer.PropertyStart(Key::Main_OFFSET); writer.F64(inContent.Metadata.OFFSET.Seconds); writer.NewLine(); }
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::DEMOSTART))
-			appendProperyLine(out, Key::Main_DEMOSTART, std::string_view(buffer, sprintf_s(buffer, "%g", inContent.Metadata.DEMOSTART.Seconds)));
+			{ writer.PropertyStart(Key::Main_DEMOSTART); writer.F64(inContent.Metadata.DEMOSTART.Seconds); writer.NewLine(); }
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::GENRE))
-			appendProperyLine(out, Key::Main_GENRE, inContent.Metadata.GENRE);
+			writer.PropertyLine(Key::Main_GENRE, inContent.Metadata.GENRE);
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::SCOREMODE))
-			appendProperyLine(out, Key::Main_SCOREMODE, std::string_view(buffer, sprintf_s(buffer, "%d", static_cast<i32>(inContent.Metadata.SCOREMODE))));
+			{ writer.PropertyStart(Key::Main_SCOREMODE); writer.I32(static_cast<i32>(inContent.Metadata.SCOREMODE)); writer.NewLine(); }
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::MAKER))
-			appendProperyLine(out, Key::Main_MAKER, inContent.Metadata.MAKER);
+			writer.PropertyLine(Key::Main_MAKER, inContent.Metadata.MAKER);
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::LYRICS))
-			appendProperyLine(out, Key::Main_LYRICS, inContent.Metadata.LYRICS);
+			writer.PropertyLine(Key::Main_LYRICS, inContent.Metadata.LYRICS);
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::SONGVOL))
-			appendProperyLine(out, Key::Main_SONGVOL, std::string_view(buffer, sprintf_s(buffer, "%g", ToPercent(inContent.Metadata.SONGVOL))));
+			{ writer.PropertyStart(Key::Main_SONGVOL); writer.F64(ToPercent(inContent.Metadata.SONGVOL)); writer.NewLine(); }
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::SEVOL))
-			appendProperyLine(out, Key::Main_SEVOL, std::string_view(buffer, sprintf_s(buffer, "%g", ToPercent(inContent.Metadata.SEVOL))));
+			{ writer.PropertyStart(Key::Main_SEVOL); writer.F64(ToPercent(inContent.Metadata.SEVOL)); writer.NewLine(); }
 		// TODO: Key::Main_SIDE;
 		// TODO: Key::Main_GAME;
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::HEADSCROLL))
-			appendProperyLine(out, Key::Main_HEADSCROLL, std::string_view(buffer, sprintf_s(buffer, "%g", inContent.Metadata.HEADSCROLL)));
+			{ writer.PropertyStart(Key::Main_HEADSCROLL); writer.F64(inContent.Metadata.HEADSCROLL); writer.NewLine(); }
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::BGIMAGE))
-			appendProperyLine(out, Key::Main_BGIMAGE, inContent.Metadata.BGIMAGE);
+			writer.PropertyLine(Key::Main_BGIMAGE, inContent.Metadata.BGIMAGE);
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::BGMOVIE))
-			appendProperyLine(out, Key::Main_BGMOVIE, inContent.Metadata.BGMOVIE);
+			writer.PropertyLine(Key::Main_BGMOVIE, inContent.Metadata.BGMOVIE);
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::BGIMAGE, &ParsedMainMetadata::BGMOVIE, &ParsedMainMetadata::MOVIEOFFSET)) // Better to be explicit if bg is given
-			appendProperyLine(out, Key::Main_MOVIEOFFSET, std::string_view(buffer, sprintf_s(buffer, "%g", inContent.Metadata.MOVIEOFFSET.Seconds)));
+			{ writer.PropertyStart(Key::Main_MOVIEOFFSET); writer.F64(inContent.Metadata.MOVIEOFFSET.Seconds); writer.NewLine(); }
 
 		if (shouldEmitMainMetadata(&ParsedMainMetadata::Others)) {
 			for (const auto& [header, val] : inContent.Metadata.Others)
-				appendSuffixedPropertyLine(out, Key::Main_Unknown, header, val);
+				writer.SuffixedPropertyLine(Key::Main_Unknown, header, val);
 		}
 
-		appendLine(out, "");
+		writer.NewLine();
 
-		// group difficulties by course scope
 		using CourseIter = decltype(inContent.Courses)::const_iterator;
-		std::vector<std::pair<CourseIter, CourseIter>> courseScopes = {};
-
-		for (auto it = begin(inContent.Courses); it != end(inContent.Courses); ++it) {
-			const auto& course = *it;
-			if (course.Metadata.COURSE == currentCourseScope)
-				continue;
-			// change course scope
-			if (!courseScopes.empty())
-				courseScopes.back().second = it;
-			courseScopes.emplace_back(it, end(inContent.Courses));
-			currentCourseScope = course.Metadata.COURSE;
-		}
-		// revert course scope
-		currentCourseScope = DifficultyType::Count;
-
 		static constexpr auto courseMetadataDifferWithin = [](CourseIter it, CourseIter itBeg, CourseIter itEnd, auto ParsedCourseMetadata::*... membs)
 		{
 			for (CourseIter itI = itBeg; itI != itEnd; ++itI) {
@@ -1240,53 +1441,62 @@ namespace TJA
 
 			const ParsedCourse& course = *it;
 			if (&course != &inContent.Courses[0])
-				appendLine(out, "");
+				writer.NewLine();
 
 			b8 firstInGroup = (it == itBeg);
-			if (firstInGroup) { // change course scope
-				appendProperyLine(out, Key::Course_COURSE, difficultyTypeToString(course.Metadata.COURSE));
-				currentCourseScope = course.Metadata.COURSE;
-			}
+			if (firstInGroup) // change course scope
+				writer.PropertyLine(Key::Course_COURSE, difficultyTypeToString(course.Metadata.COURSE));
 
 			// scope-like, omit mid-group when possible
 			if (firstInGroup ? shouldEmitCourseMetadata(&ParsedCourseMetadata::STYLE) : course.Metadata.STYLE != (it - 1)->Metadata.STYLE) {
 				if (firstInGroup)
-					appendLine(out, "");
-				appendProperyLine(out, Key::Course_STYLE, styleModeToString(course.Metadata.STYLE));
-				appendLine(out, "");
+					writer.NewLine();
+				writer.PropertyStart(Key::Course_STYLE);
+				switch (course.Metadata.STYLE)
+				{
+				case 1: { writer.String("Single"); } break;
+				case 2: { writer.String("Double"); } break;
+				default: { writer.I32(course.Metadata.STYLE); } break;
+				}
+				writer.NewLine();
+				writer.NewLine();
 			}
 
 			// Unspecified default value
 			if (firstInGroup || shouldEmitCourseMetadata(&ParsedCourseMetadata::LEVEL, &ParsedCourseMetadata::LEVEL_DECIMALTAG)) {
+				writer.PropertyStart(Key::Course_LEVEL);
 				if (course.Metadata.LEVEL_DECIMALTAG == -1)
-					appendProperyLine(out, Key::Course_LEVEL, std::string_view(buffer, sprintf_s(buffer, "%d", course.Metadata.LEVEL)));
+					writer.I32(course.Metadata.LEVEL);
 				else
-					appendProperyLine(out, Key::Course_LEVEL, std::string_view(buffer, sprintf_s(buffer, "%.1f", course.Metadata.LEVEL + static_cast<float>(course.Metadata.LEVEL_DECIMALTAG) / 10.)));
+					writer.F64(course.Metadata.LEVEL + static_cast<float>(course.Metadata.LEVEL_DECIMALTAG) / 10., std::chars_format::fixed, 1);
+				writer.NewLine();
 			}
 
 			// Better to be explicit
 			if (course.Metadata.COURSE == DifficultyType::Tower) {
-				appendProperyLine(out, Key::Course_LIFE, std::string_view(buffer, sprintf_s(buffer, "%d", course.Metadata.LIFE)));
-				appendProperyLine(out, Key::Course_SIDE, sideToString(course.Metadata.SIDE));
+				writer.PropertyStart(Key::Course_LIFE); writer.I32(course.Metadata.LIFE); writer.NewLine();
+				writer.PropertyLine(Key::Course_SIDE, sideToString(course.Metadata.SIDE));
 			}
 
 			// Better to be explicit
 			if (!course.Metadata.BALLOON.empty() || !course.Metadata.BALLOON_Normal.empty() || !course.Metadata.BALLOON_Expert.empty() || !course.Metadata.BALLOON_Master.empty())
-				appendBalloonProperyLine(out, Key::Course_BALLOON, course.Metadata.BALLOON); // necessary for branched charts as branched BALLOON headers are not handled consistently across all simulators
+				writer.BalloonPropertyLine(Key::Course_BALLOON, course.Metadata.BALLOON); // necessary for branched charts as branched BALLOON headers are not handled consistently across all simulators
 			if (!course.Metadata.BALLOON_Normal.empty() || !course.Metadata.BALLOON_Expert.empty() || !course.Metadata.BALLOON_Master.empty())
 			{
-				appendBalloonProperyLine(out, Key::Course_BALLOONNOR, course.Metadata.BALLOON_Normal);
-				appendBalloonProperyLine(out, Key::Course_BALLOONEXP, course.Metadata.BALLOON_Expert);
-				appendBalloonProperyLine(out, Key::Course_BALLOONMAS, course.Metadata.BALLOON_Master);
+				writer.BalloonPropertyLine(Key::Course_BALLOONNOR, course.Metadata.BALLOON_Normal);
+				writer.BalloonPropertyLine(Key::Course_BALLOONEXP, course.Metadata.BALLOON_Expert);
+				writer.BalloonPropertyLine(Key::Course_BALLOONMAS, course.Metadata.BALLOON_Master);
 			}
 
 			if (shouldEmitCourseMetadata(&ParsedCourseMetadata::SCOREINIT, &ParsedCourseMetadata::SCOREDIFF)) {
-				appendProperyLine(out, Key::Course_SCOREINIT, (course.Metadata.SCOREINIT == 0) ? "" : std::string_view(buffer, sprintf_s(buffer, "%d", course.Metadata.SCOREINIT)));
-				appendProperyLine(out, Key::Course_SCOREDIFF, (course.Metadata.SCOREDIFF == 0) ? "" : std::string_view(buffer, sprintf_s(buffer, "%d", course.Metadata.SCOREDIFF)));
+				writer.PropertyStart(Key::Course_SCOREINIT); if (course.Metadata.SCOREINIT != 0) { writer.I32(course.Metadata.SCOREINIT); } writer.NewLine();
+				writer.PropertyStart(Key::Course_SCOREDIFF); if (course.Metadata.SCOREDIFF != 0) { writer.I32(course.Metadata.SCOREDIFF); } writer.NewLine();
 			}
 
-			if (shouldEmitCourseMetadata(&ParsedCourseMetadata::NOTESDESIGNER))
-				appendSuffixedPropertyLine(out, Key::Course_NOTESDESIGNERs, std::to_string(EnumToIndex(course.Metadata.COURSE)), course.Metadata.NOTESDESIGNER);
+			if (shouldEmitCourseMetadata(&ParsedCourseMetadata::NOTESDESIGNER)) {
+				writer.KeyString(Key::Course_NOTESDESIGNERs); writer.I32(static_cast<i32>(EnumToIndex(course.Metadata.COURSE))); writer.Char(':');
+				writer.String(course.Metadata.NOTESDESIGNER); writer.NewLine();
+			}
 
 			// TODO: Key::Course_EXAM1;
 			// TODO: Key::Course_EXAM2;
@@ -1297,15 +1507,15 @@ namespace TJA
 
 			if (shouldEmitCourseMetadata(&ParsedCourseMetadata::Others)) {
 				for (const auto& [header, val] : course.Metadata.Others)
-					appendSuffixedPropertyLine(out, Key::Course_Unknown, header, val);
+					writer.SuffixedPropertyLine(Key::Course_Unknown, header, val);
 			}
 
-			appendLine(out, "");
+			writer.NewLine();
 
 			if (course.Metadata.STYLE <= 1)
-				appendCommandLine(out, Key::Chart_START, "");
+				writer.CommandLine(Key::Chart_START);
 			else
-				appendCommandLine(out, Key::Chart_START, "P" + std::to_string(course.Metadata.START_PLAYERSIDE));
+				{ writer.CommandStart(Key::Chart_START); writer.Char('P'); writer.I32(course.Metadata.START_PLAYERSIDE); writer.NewLine(); }
 
 			for (const ParsedChartCommand& command : course.ChartCommands)
 			{
@@ -1313,63 +1523,74 @@ namespace TJA
 				{
 				case ParsedChartCommandType::MeasureNotes:
 				{
-					for (const NoteType note : command.Param.MeasureNotes.Notes)
-						out += noteTypeToChar(note);
+					// NOTE: Resized once and then filled in place rather than appending one char at a time
+					const ParsedTJA::MeasureNotesView notes = inContent.GetMeasureNotes(command);
+					const size_t notesStart = out.size();
+					out.resize(notesStart + notes.Count);
+					char* notesOut = out.data() + notesStart;
+					for (const NoteType note : notes)
+						*notesOut++ = noteTypeToChar(note);
 
 					if (ArrayItToIndex(&command, &course.ChartCommands[0]) + 1 < course.ChartCommands.size())
 					{
 						if ((&command + 1)->Type != ParsedChartCommandType::MeasureEnd)
-							appendLine(out, "");
+							writer.NewLine();
 					}
 				} break;
-				case ParsedChartCommandType::MeasureEnd: { appendLine(out, ","); } break;
+				case ParsedChartCommandType::MeasureEnd: { writer.Char(','); writer.NewLine(); } break;
 				case ParsedChartCommandType::ChangeTimeSignature:
 				{
-					appendCommandLine(out, Key::Chart_MEASURE, std::string_view(buffer, sprintf_s(buffer, "%d/%d", command.Param.ChangeTimeSignature.Value.Numerator, command.Param.ChangeTimeSignature.Value.Denominator)));
+					writer.CommandStart(Key::Chart_MEASURE);
+					writer.I32(command.Param.ChangeTimeSignature.Value.Numerator); writer.Char('/'); writer.I32(command.Param.ChangeTimeSignature.Value.Denominator);
+					writer.NewLine();
 				} break;
 				case ParsedChartCommandType::ChangeTempo:
 				{
-					appendCommandLine(out, Key::Chart_BPMCHANGE, std::string_view(buffer, sprintf_s(buffer, "%g", command.Param.ChangeTempo.Value.BPM)));
+					writer.CommandStart(Key::Chart_BPMCHANGE); writer.F64(command.Param.ChangeTempo.Value.BPM); writer.NewLine();
 				} break;
 				case ParsedChartCommandType::ChangeDelay:
 				{
-					appendCommandLine(out, Key::Chart_DELAY, std::string_view(buffer, sprintf_s(buffer, "%g", command.Param.ChangeDelay.Value.ToSec())));
+					writer.CommandStart(Key::Chart_DELAY); writer.F64(command.Param.ChangeDelay.Value.ToSec()); writer.NewLine();
 				} break;
 				case ParsedChartCommandType::ChangeScrollSpeed:
 				{
-					appendCommandLine(out, Key::Chart_SCROLL, std::string_view(buffer, sprintf_s(buffer, "%s", command.Param.ChangeScrollSpeed.Value.toStringCompat().c_str())));
+					writer.CommandStart(Key::Chart_SCROLL); writer.ComplexCompat(command.Param.ChangeScrollSpeed.Value); writer.NewLine();
 				} break;
 				case ParsedChartCommandType::ChangeBarLine:
 				{
-					appendCommandLine(out, command.Param.ChangeBarLine.Visible ? Key::Chart_BARLINEON : Key::Chart_BARLINEOFF, "");
+					writer.CommandLine(command.Param.ChangeBarLine.Visible ? Key::Chart_BARLINEON : Key::Chart_BARLINEOFF);
 				} break;
 				case ParsedChartCommandType::GoGoStart:
 				{
-					appendCommandLine(out, Key::Chart_GOGOSTART, "");
+					writer.CommandLine(Key::Chart_GOGOSTART);
 				} break;
 				case ParsedChartCommandType::GoGoEnd:
 				{
-					appendCommandLine(out, Key::Chart_GOGOEND, "");
+					writer.CommandLine(Key::Chart_GOGOEND);
 				} break;
 				case ParsedChartCommandType::BranchStart:
 				{
-					appendCommandLine(out, Key::Chart_BRANCHSTART, std::string_view(buffer, sprintf_s(buffer, "%c,%d,%d", BranchConditionToChar(command.Param.BranchStart.Condition), command.Param.BranchStart.RequirementExpert, command.Param.BranchStart.RequirementMaster)));
+					writer.CommandStart(Key::Chart_BRANCHSTART);
+					writer.Char(BranchConditionToChar(command.Param.BranchStart.Condition)); writer.Char(',');
+					writer.I32(command.Param.BranchStart.RequirementExpert); writer.Char(',');
+					writer.I32(command.Param.BranchStart.RequirementMaster);
+					writer.NewLine();
 				} break;
 				case ParsedChartCommandType::BranchNormal:
 				{
-					appendCommandLine(out, Key::Chart_N, "");
+					writer.CommandLine(Key::Chart_N);
 				} break;
 				case ParsedChartCommandType::BranchExpert:
 				{
-					appendCommandLine(out, Key::Chart_E, "");
+					writer.CommandLine(Key::Chart_E);
 				} break;
 				case ParsedChartCommandType::BranchMaster:
 				{
-					appendCommandLine(out, Key::Chart_M, "");
+					writer.CommandLine(Key::Chart_M);
 				} break;
 				case ParsedChartCommandType::BranchEnd:
 				{
-					appendCommandLine(out, Key::Chart_BRANCHEND, "");
+					writer.CommandLine(Key::Chart_BRANCHEND);
 				} break;
 				case ParsedChartCommandType::BranchLevelHold:
 				{
@@ -1382,19 +1603,19 @@ namespace TJA
 				case ParsedChartCommandType::SetLyricLine:
 				{
 					// TODO: Handle escape characters, most importantly "\n"
-					appendCommandLine(out, Key::Chart_LYRIC, command.Param.SetLyricLine.Value);
+					writer.CommandLine(Key::Chart_LYRIC, command.Param.SetLyricLine.Value);
 				} break;
 				case ParsedChartCommandType::NMScroll:
 				{
-					appendCommandLine(out, Key::Chart_NMSCROLL, "");
+					writer.CommandLine(Key::Chart_NMSCROLL);
 				} break;
 				case ParsedChartCommandType::BMScroll:
 				{
-					appendCommandLine(out, Key::Chart_BMSCROLL, "");
+					writer.CommandLine(Key::Chart_BMSCROLL);
 				} break;
 				case ParsedChartCommandType::HBScroll:
 				{
-					appendCommandLine(out, Key::Chart_HBSCROLL, "");
+					writer.CommandLine(Key::Chart_HBSCROLL);
 				} break;
 				case ParsedChartCommandType::SENoteChange:
 				{
@@ -1410,27 +1631,39 @@ namespace TJA
 				} break;
 				case ParsedChartCommandType::SetSudden:
 				{
-					appendCommandLine(out, Key::Chart_SUDDEN, std::string_view(buffer, sprintf_s(buffer, "%g %g", command.Param.SetSudden.AppearanceOffset.ToSec(), command.Param.SetSudden.MovementWaitDelay.ToSec())));
+					writer.CommandStart(Key::Chart_SUDDEN);
+					writer.F64(command.Param.SetSudden.AppearanceOffset.ToSec()); writer.Char(' '); writer.F64(command.Param.SetSudden.MovementWaitDelay.ToSec());
+					writer.NewLine();
 				} break;
 				case ParsedChartCommandType::SetJPOSScroll:
 				{
-					appendCommandLine(out, Key::Chart_JPOSSCROLL, std::string_view(buffer, sprintf_s(buffer, "%g %s 1", command.Param.ChangeJPOSScroll.Duration.ToSec(), command.Param.ChangeJPOSScroll.Move.toStringCompat().c_str())));
+					writer.CommandStart(Key::Chart_JPOSSCROLL);
+					writer.F64(command.Param.ChangeJPOSScroll.Duration.ToSec()); writer.Char(' '); writer.ComplexCompat(command.Param.ChangeJPOSScroll.Move); writer.String(" 1");
+					writer.NewLine();
 				} break;
 				default: { assert(!"Unhandled ParsedChartCommandType switch case"); } break;
 				}
 			}
-			appendCommandLine(out, Key::Chart_END, "");
+			writer.CommandLine(Key::Chart_END);
 		};
 
-		for (const auto& [itBeg, itEnd] : courseScopes) {
+		// NOTE: Group difficulties by course scope, each group being a consecutive run of courses of the same difficulty
+		for (CourseIter itBeg = begin(inContent.Courses); itBeg != end(inContent.Courses);)
+		{
+			CourseIter itEnd = itBeg + 1;
+			while (itEnd != end(inContent.Courses) && itEnd->Metadata.COURSE == itBeg->Metadata.COURSE)
+				++itEnd;
+
 			for (CourseIter it = itBeg; it != itEnd; ++it)
 				convertCourse(it, itBeg, itEnd);
+			itBeg = itEnd;
 		}
 	}
 
-	void ConvertConvertedMeasuresToParsedCommands(const std::vector<ConvertedMeasure>& inMeasures, std::vector<ParsedChartCommand>& outCommands)
+	void ConvertConvertedMeasuresToParsedCommands(const std::vector<ConvertedMeasure>& inMeasures, std::vector<ParsedChartCommand>& outCommands, std::vector<NoteType>& outMeasureNoteArena)
 	{
-		struct TempCommand { Beat TimeWithinMeasure; ParsedChartCommand ParsedCommand; };
+		// NOTE: Each temp MeasureNotes command holds a single note which is only written to the arena once adjacent ones have been merged
+		struct TempCommand { Beat TimeWithinMeasure; ParsedChartCommand ParsedCommand; NoteType Note; };
 		std::vector<TempCommand> tempBuffer;
 		tempBuffer.reserve(64);
 
@@ -1512,9 +1745,8 @@ namespace TJA
 			i32 actualNotesInThisMeasure = 0;
 			for (const ConvertedNote& note : inMeasure.Notes)
 			{
-				ParsedChartCommand& tempCommand = tempBuffer.emplace_back(TempCommand { note.TimeWithinMeasure }).ParsedCommand;
+				ParsedChartCommand& tempCommand = tempBuffer.emplace_back(TempCommand { note.TimeWithinMeasure, {}, note.Type }).ParsedCommand;
 				tempCommand.Type = ParsedChartCommandType::MeasureNotes;
-				tempCommand.Param.MeasureNotes.Notes.push_back(note.Type);
 				actualNotesInThisMeasure++;
 			}
 			size_t noteCommandEnd = tempBuffer.size();
@@ -1561,9 +1793,8 @@ namespace TJA
 
 						if (!noteAlreadyExists)
 						{
-							ParsedChartCommand& tempCommand = tempBuffer.emplace_back(TempCommand { noteBeat }).ParsedCommand;
+							ParsedChartCommand& tempCommand = tempBuffer.emplace_back(TempCommand { noteBeat, {}, NoteType::None }).ParsedCommand;
 							tempCommand.Type = ParsedChartCommandType::MeasureNotes;
-							tempCommand.Param.MeasureNotes.Notes.push_back(NoteType::None);
 						}
 					}
 
@@ -1587,10 +1818,17 @@ namespace TJA
 					// NOTE: Merge adjacent single-note MeasureNotes commands
 					if (lastNoteCommand != nullptr && (thisCommand.ParsedCommand.Type == ParsedChartCommandType::MeasureNotes))
 					{
-						for (NoteType note : thisCommand.ParsedCommand.Param.MeasureNotes.Notes)
-							lastNoteCommand->Param.MeasureNotes.Notes.push_back(note);
+						outMeasureNoteArena.push_back(thisCommand.Note);
+						lastNoteCommand->Param.MeasureNotes.NoteCount++;
 					}
 					else {
+						if (thisCommand.ParsedCommand.Type == ParsedChartCommandType::MeasureNotes)
+						{
+							thisCommand.ParsedCommand.Param.MeasureNotes.NoteStart = static_cast<u32>(outMeasureNoteArena.size());
+							thisCommand.ParsedCommand.Param.MeasureNotes.NoteCount = 1;
+							outMeasureNoteArena.push_back(thisCommand.Note);
+						}
+
 						// Push first, modify later
 						outCommands.push_back(std::move(thisCommand.ParsedCommand));
 						lastNoteCommand = (outCommands.back().Type == ParsedChartCommandType::MeasureNotes) ?
@@ -1625,7 +1863,7 @@ namespace TJA
 			{
 				if (command.Type == ParsedChartCommandType::MeasureNotes)
 				{
-					for (const NoteType note : command.Param.MeasureNotes.Notes)
+					for (const NoteType note : inContent.GetMeasureNotes(command))
 						currentMeasure->Notes.push_back(ConvertedNote { Beat::Zero(), note });
 				}
 				else if (command.Type == ParsedChartCommandType::MeasureEnd)
@@ -1664,7 +1902,7 @@ namespace TJA
 			{
 				if (command.Type == ParsedChartCommandType::MeasureNotes)
 				{
-					currentNotesInMeasure += static_cast<i32>(command.Param.MeasureNotes.Notes.size());
+					currentNotesInMeasure += static_cast<i32>(command.Param.MeasureNotes.NoteCount);
 
 					if (!currentMeasure->Notes.empty() && currentNotesInMeasure > 0)
 						currentTimeWithinMeasure = currentMeasure->Notes[currentNotesInMeasure - 1].TimeWithinMeasure +
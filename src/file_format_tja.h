@@ -141,11 +141,12 @@ namespace TJA
 
 	Key GetKeyColonValueTokenKey(std::string_view str);
 	Key GetHashCommandTokenKey(std::string_view str);
+	std::string_view GetKeyString(Key key);
 
 	struct Token
 	{
 		TokenType Type;
-		Key Key;
+		TJA::Key Key;
 		i16 LineIndex;
 		std::string_view Line;
 		std::string_view KeyString;
@@ -380,11 +381,11 @@ namespace TJA
 
 	struct ParsedChartCommand
 	{
-		// TODO: Maybe store notes as index + count into single vector (?)
 		ParsedChartCommandType Type;
 		struct ParamData
 		{
-			struct { std::vector<NoteType> Notes; } MeasureNotes;
+			// NOTE: Range within the MeasureNoteArena of the owning ParsedTJA
+			struct { u32 NoteStart, NoteCount; } MeasureNotes;
 			struct { TimeSignature Value; } ChangeTimeSignature;
 			struct { Tempo Value; } ChangeTempo;
 			struct { Time Value; } ChangeDelay;
@@ -418,6 +419,26 @@ namespace TJA
 		//		 are assumed to only make use of known and supported features that can be safely converted without having to worry about potential data loss
 		b8 HasPeepoDrumKitComment = false;
 		Date PeepoDrumKitCommentDate = {};
+
+		// NOTE: The notes of all MeasureNotes commands of all courses, stored back to back so that they can be allocated and freed in one go
+		//		 instead of each measure owning a tiny allocation of its own
+		std::vector<NoteType> MeasureNoteArena;
+
+		struct MeasureNotesView
+		{
+			const NoteType* Data; size_t Count;
+			inline const NoteType* begin() const { return Data; }
+			inline const NoteType* end() const { return Data + Count; }
+			inline size_t size() const { return Count; }
+			inline b8 empty() const { return (Count == 0); }
+			inline const NoteType& back() const { return Data[Count - 1]; }
+		};
+
+		inline MeasureNotesView GetMeasureNotes(const ParsedChartCommand& command) const
+		{
+			assert(command.Type == ParsedChartCommandType::MeasureNotes && (command.Param.MeasureNotes.NoteStart + command.Param.MeasureNotes.NoteCount) <= MeasureNoteArena.size());
+			return MeasureNotesView { MeasureNoteArena.data() + command.Param.MeasureNotes.NoteStart, command.Param.MeasureNotes.NoteCount };
+		}
 	};
 
 	std::vector<std::string_view> SplitLines(std::string_view fileContent);
@@ -425,6 +446,26 @@ namespace TJA
 	// NOTE: Designed to never fail, invalid input data just means a different arrangements of (unknown / bad) tokens
 	std::vector<Token> TokenizeLines(const std::vector<std::string_view>& lines);
 
+	// NOTE: Splits and tokenizes the file content lazily one line at a time, yielding the exact same tokens as TokenizeLines(SplitLines(fileContent))
+	//		 without ever building either of the two intermediate vectors
+	struct TokenStream
+	{
+		struct TokenizerState { b8 CurrentlyBetweenChartStartAndEnd, CurrentlyAfterFirstCourse; };
+
+		std::string_view FileContent;
+		size_t NextLineStart = 0;
+		i32 NextLineIndex = 0;
+		TokenizerState State = {};
+		b8 HasPendingToken = false;
+		b8 HasReachedEndOfFile = false;
+		Token PendingToken = {};
+
+		TokenStream(std::string_view fileContent) : FileContent(fileContent) {}
+
+		// NOTE: Returns false once all tokens (including the implicit end-of-file #END) have been read
+		b8 Next(Token& outToken);
+	};
+
 	struct ErrorList
 	{
 		// TODO: Have error enum type instead + std::string_view of the offending data (?)
@@ -436,7 +477,8 @@ namespace TJA
 			char buffer[0xFF];
 			va_list args;
 			va_start(args, fmt);
-			Errors.push_back(ErrorLine { lineIndex, std::string(buffer, vsprintf_s(buffer, fmt, args)) });
+			const i32 length = vsnprintf(buffer, ArrayCount(buffer), fmt, args);
+			Errors.push_back(ErrorLine { lineIndex, std::string(buffer, Clamp<i32>(length, 0, ArrayCountI32(buffer) - 1)) });
 			va_end(args);
 		}
 		inline void Clear() { Errors.clear(); }
@@ -444,6 +486,9 @@ namespace TJA
 
 	ParsedTJA ParseTokens(const std::vector<Token>& tokens, ErrorList& outErrors);
 
+	// NOTE: Same result as ParseTokens(TokenizeLines(SplitLines(fileContent))) but pulling the tokens from a TokenStream instead
+	ParsedTJA ParseFileContent(std::string_view fileContent, ErrorList& outErrors);
+
 	void ConvertParsedToText(const ParsedTJA& inContent, std::string& out, Encoding encoding);
 
 	struct ConvertedNote
@@ -457,7 +502,7 @@ namespace TJA
 	struct ConvertedTempoChange
 	{
 		Beat TimeWithinMeasure;
-		Tempo Tempo;
+		::Tempo Tempo;
 	};
 
 	struct ConvertedDelayChange
@@ -506,7 +551,7 @@ namespace TJA
 	struct ConvertedMeasure
 	{
 		Beat StartTime;
-		TimeSignature TimeSignature;
+		::TimeSignature TimeSignature;
 		std::vector<ConvertedNote> Notes;
 		std::vector<ConvertedTempoChange> TempoChanges;
 		std::vector<ConvertedDelayChange> DelayChanges;
@@ -538,7 +583,7 @@ namespace TJA
 		std::vector<ConvertedGoGoRange> GoGoRanges;
 	};
 
-	void ConvertConvertedMeasuresToParsedCommands(const std::vector<TJA::ConvertedMeasure>& inMeasures, std::vector<TJA::ParsedChartCommand>& outCommands);
+	void ConvertConvertedMeasuresToParsedCommands(const std::vector<TJA::ConvertedMeasure>& inMeasures, std::vector<TJA::ParsedChartCommand>& outCommands, std::vector<TJA::NoteType>& outMeasureNoteArena);
 
 	ConvertedCourse ConvertParsedToConvertedCourse(const ParsedTJA& inContent, const ParsedCourse& inCourse);
 }
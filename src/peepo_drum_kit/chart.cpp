@@ -1,9 +1,178 @@
 #include "chart.h"
 #include "core_build_info.h"
 #include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <thread>
 
 namespace PeepoDrumKit
 {
+	void ChartCourse::UpdateNoteCullingExtentsIfOutdated(BranchType branch) const
+	{
+		if (AreNoteCullingExtentsUpToDate[EnumToIndex(branch)])
+			return;
+
+		Beat maxBeatDuration = Beat::Zero();
+		Time maxAbsTimeOffset = Time::Zero();
+		for (const Note& note : GetNotes(branch))
+		{
+			maxBeatDuration = Max(maxBeatDuration, note.BeatDuration);
+			maxAbsTimeOffset = Max(maxAbsTimeOffset, Time::FromSec(Absolute(note.TimeOffset.Seconds)));
+		}
+		MaxNoteBeatDuration[EnumToIndex(branch)] = maxBeatDuration;
+		MaxAbsNoteTimeOffset[EnumToIndex(branch)] = maxAbsTimeOffset;
+		AreNoteCullingExtentsUpToDate[EnumToIndex(branch)] = true;
+	}
+
+	void ChartCourse::RecalculateSENotes(BranchType branch, Beat firstChangedBeat) const
+	{
+		NoteLaneFirstChangedBeat[EnumToIndex(branch)] = std::min(NoteLaneFirstChangedBeat[EnumToIndex(branch)], firstChangedBeat);
+		AreNoteCullingExtentsUpToDate[EnumToIndex(branch)] = false;
+
+		enum class SEFormType { Long, Short, Alternate, Final };
+
+		// prev, curr, next, n(ext)2nd
+		ForEachNoteLaneData noteDataRingBuffer[4] = {};
+		i32 noteDataRingOffset = 0;
+		auto getNoteData = [&](i32 idx) -> decltype(auto) { return noteDataRingBuffer[(noteDataRingOffset + idx) & 3]; };
+
+		// distance when curr is on the judgement mark
+		// other is NMScroll: visual beat distance = sec_time * visual_beat_per_second_other
+		// other is HBScroll: visual beat distance = scroll_other * beat_distance
+		auto getVisualBeat = [&](const auto& curr, const auto& other, f32 scrollOther, f32 vbpsOther, Time timeDistance)
+		{
+			return (other.OriginalNote == nullptr) ? F32Max
+				: (other.ScrollType == ScrollMethod::NMSCROLL) ? vbpsOther * timeDistance.Seconds
+				: (other.ScrollType == ScrollMethod::HBSCROLL) ? scrollOther * abs(curr.Beat - other.Beat).Ticks / Beat::TicksPerBeat
+				: /* (prev.ScrollType == ScrollMethod::BMSCROLL) ? */ abs(curr.Beat - other.Beat).Ticks / Beat::TicksPerBeat;
+		};
+
+		auto getNoteDistance = [&]()
+		{
+			const auto& prev = getNoteData(0);
+			const auto& curr = getNoteData(1);
+			const auto& next = getNoteData(2);
+			const auto& n2nd = getNoteData(3);
+			const f32 scrollPrev = abs(prev.ScrollSpeed.cpx);
+			const f32 scrollNextCapped = std::min(1.0f, abs(next.ScrollSpeed.cpx));
+			// visual beat per second
+			const f32 vbpsPrev = scrollPrev * prev.Tempo.BPM / 60;
+			const f32 vbpsNextCapped = scrollNextCapped * next.Tempo.BPM / 60;
+			// time distance
+			const Time tdToPrev = (prev.OriginalNote == nullptr) ? Time::FromSec(F32Max) : (curr.Time - prev.Time);
+			const Time tdToNext = (next.OriginalNote == nullptr) ? Time::FromSec(F32Max) : (next.Time - curr.Time);
+			const Time tdToN2nd = (n2nd.OriginalNote == nullptr) ? Time::FromSec(F32Max) : (n2nd.Time - next.Time);
+			const f32 vbdToPrev = getVisualBeat(curr, prev, scrollPrev, vbpsPrev, tdToPrev);
+			const f32 vbdToNextCapped = getVisualBeat(curr, next, scrollNextCapped, vbpsNextCapped, tdToNext);
+			return std::tuple{ tdToPrev, vbdToPrev, tdToNext, vbdToNextCapped, tdToN2nd };
+		};
+
+		const SortedNotesList& notes = GetNotes(branch);
+		std::vector<const Note*> alterChain;
+		b8 isAlterChain = true;
+		Time timeIntervalAlter = Time::Zero();
+		Time timeStartAlter = Time::Zero();
+
+		// NOTE: The SE type of a note depends on the (unchanged) previous and the next two notes as well as the alternating chain state, which however is fully reset
+		//		 whenever the note density changes. So resume right after the last such reset point not affected by the edit instead of always starting from the very beginning
+		std::vector<SENoteResyncPoint>& resyncPoints = SENoteResyncPoints[EnumToIndex(branch)];
+		const Note* resyncNote = nullptr;
+		size_t startNoteIndex = 0;
+		{
+			const auto findFirstNoteIndexAtOrAfter = [&](Beat beat) { return static_cast<size_t>(std::distance(notes.begin(), std::lower_bound(notes.begin(), notes.end(), beat, [](const Note& note, Beat b) { return note.BeatTime < b; }))); };
+			const size_t firstChangedNoteIndex = findFirstNoteIndexAtOrAfter(firstChangedBeat);
+			const Beat lastUnaffectedBeat = (firstChangedBeat > Beat::Zero() && firstChangedNoteIndex >= 3) ? notes[firstChangedNoteIndex - 3].BeatTime : Beat::FromTicks(-1);
+			const auto firstInvalidResyncPoint = std::upper_bound(resyncPoints.begin(), resyncPoints.end(), lastUnaffectedBeat, [](Beat beat, const SENoteResyncPoint& point) { return beat < point.Beat; });
+			resyncPoints.erase(firstInvalidResyncPoint, resyncPoints.end());
+
+			if (!resyncPoints.empty())
+			{
+				startNoteIndex = findFirstNoteIndexAtOrAfter(resyncPoints.back().Beat);
+				if (startNoteIndex < notes.size() && notes[startNoteIndex].BeatTime == resyncPoints.back().Beat)
+				{
+					resyncNote = &notes[startNoteIndex];
+					isAlterChain = resyncPoints.back().IsAlterChain;
+				}
+				else // NOTE: Should never happen unless the notes have been edited without recalculating afterwards
+				{
+					startNoteIndex = 0;
+					resyncPoints.clear();
+				}
+			}
+		}
+
+		auto assignSingleNote = [&]()
+		{
+			auto& curr = getNoteData(1);
+			const Note& it = *getNoteData(1).OriginalNote;
+			auto [tdToPrev, vbdToPrev, tdToNext, vbdToNextCapped, tdToN2nd] = getNoteDistance();
+			const Time timeEpsilon = Time::FromMS(1e-3);
+			const b8 denseToSparse = (tdToNext >= tdToPrev + timeEpsilon);
+			const b8 sparseToDense = (tdToN2nd <= tdToNext - timeEpsilon);
+			const f32 beatsEpsilon = 4 / 192.0;
+			const b8 isLongAvoided = (vbdToPrev <= 4 / 16.0 - beatsEpsilon
+				|| vbdToNextCapped <= 4 / 12.0 - beatsEpsilon); // avoid text from overlapping or extending under next note
+			const b8 isPrePause = (vbdToNextCapped >= 4 / 8.0 + beatsEpsilon);
+			auto se = (!isLongAvoided && (denseToSparse || sparseToDense || isPrePause)) ? SEFormType::Long : SEFormType::Short;
+			if (isAlterChain) {
+				if (it.Type == NoteType::Don && alterChain.empty()) {
+					timeIntervalAlter = tdToNext;
+					timeStartAlter = curr.Time;
+					alterChain.push_back(&it);
+				} else if (it.Type == NoteType::Don && abs(tdToPrev - timeIntervalAlter) < timeEpsilon && abs(timeStartAlter - curr.Time) < Time::FromSec(0.5) + timeEpsilon) {
+					alterChain.push_back(&it);
+				} else {
+					isAlterChain = false;
+					alterChain.clear();
+				}
+			}
+			if (denseToSparse || sparseToDense) {
+				if (denseToSparse && isAlterChain && !isLongAvoided && size(alterChain) % 2 != 0 && abs(timeStartAlter - curr.Time) < Time::FromSec(0.5) + timeEpsilon) {
+					for (i32 ia = 0; ia < size(alterChain); ++ia) {
+						if (ia % 2 == 1)
+							alterChain[ia]->TempSEType = NoteSEType::Ko;
+					}
+				}
+				alterChain.clear();
+				isAlterChain = sparseToDense;
+				resyncPoints.push_back(SENoteResyncPoint { it.BeatTime, isAlterChain });
+			}
+
+			switch (it.Type)
+			{
+			case NoteType::Don: { it.TempSEType = (se == SEFormType::Long) ? NoteSEType::Don : NoteSEType::Do; } break;
+			case NoteType::DonBig: { it.TempSEType = NoteSEType::DonBig; } break;
+			case NoteType::DonBigHand: { it.TempSEType = NoteSEType::DonHand; } break;
+			case NoteType::Ka: { it.TempSEType = (se == SEFormType::Long) ? NoteSEType::Katsu : NoteSEType::Ka; } break;
+			case NoteType::KaBig: { it.TempSEType = NoteSEType::KatsuBig; } break;
+			case NoteType::KaBigHand: { it.TempSEType = NoteSEType::KatsuHand; } break;
+			case NoteType::Drumroll: { it.TempSEType = NoteSEType::Drumroll; } break;
+			case NoteType::DrumrollBig: { it.TempSEType = NoteSEType::DrumrollBig; } break;
+			case NoteType::Balloon: { it.TempSEType = NoteSEType::Balloon; } break;
+			case NoteType::BalloonSpecial: { it.TempSEType = NoteSEType::BalloonSpecial; } break;
+			default: { it.TempSEType = NoteSEType::Count; } break;
+			}
+		};
+
+		// fetch 2nd next note, update current note
+		// NOTE: The resync note itself is only fed in to act as the previous note of the next one
+		i32 lastFilled = 0;
+		ForEachNoteOnNoteLane(*this, branch, startNoteIndex, [&](const ForEachNoteLaneData& dataIt)
+		{
+			if (getNoteData(1).OriginalNote != nullptr && getNoteData(1).OriginalNote != resyncNote)
+				assignSingleNote();
+			noteDataRingOffset = (noteDataRingOffset + 1) & 3;
+			getNoteData(3) = dataIt;
+			lastFilled = 3;
+		});
+		for (; lastFilled >= 1; --lastFilled) {
+			if (getNoteData(1).OriginalNote != nullptr && getNoteData(1).OriginalNote != resyncNote)
+				assignSingleNote();
+			noteDataRingOffset = (noteDataRingOffset + 1) & 3;
+			getNoteData(3).OriginalNote = nullptr;
+		}
+	}
+
 	void DebugCompareCharts(const ChartProject& chartA, const ChartProject& chartB, DebugCompareChartsOnMessageFunc onMessageFunc, void* userData)
 	{
 		auto logf = [onMessageFunc, userData](cstr fmt, ...)
@@ -11,7 +180,8 @@ namespace PeepoDrumKit
 			char buffer[512];
 			va_list args;
 			va_start(args, fmt);
-			onMessageFunc(std::string_view(buffer, _vsnprintf_s(buffer, ArrayCount(buffer), fmt, args)), userData);
+			const i32 length = vsnprintf(buffer, ArrayCount(buffer), fmt, args);
+			onMessageFunc(std::string_view(buffer, Clamp<i32>(length, 0, ArrayCountI32(buffer) - 1)), userData);
 			va_end(args);
 		};
 
@@ -65,7 +235,7 @@ namespace PeepoDrumKit
 		}
 	}
 
-	struct TempTimedDelayCommand { Beat Beat; Time Delay; };
+	struct TempTimedDelayCommand { ::Beat Beat; Time Delay; };
 
 	template <>
 	struct IsNonListChartEventTrait<TempTimedDelayCommand> : std::true_type { };
@@ -122,6 +292,33 @@ namespace PeepoDrumKit
 		}
 	}
 
+	void CopyChartProject(const ChartProject& in, ChartProject& out)
+	{
+		out.Courses.clear();
+		out.Courses.reserve(in.Courses.size());
+		for (const std::unique_ptr<ChartCourse>& course : in.Courses)
+			out.Courses.push_back(std::make_unique<ChartCourse>(*course));
+
+		out.ChartDuration = in.ChartDuration;
+		out.ChartTitle = in.ChartTitle;
+		out.ChartTitleLocalized = in.ChartTitleLocalized;
+		out.ChartSubtitle = in.ChartSubtitle;
+		out.ChartSubtitleLocalized = in.ChartSubtitleLocalized;
+		out.ChartCreator = in.ChartCreator;
+		out.ChartGenre = in.ChartGenre;
+		out.ChartLyricsFileName = in.ChartLyricsFileName;
+		out.SongOffset = in.SongOffset;
+		out.SongDemoStartTime = in.SongDemoStartTime;
+		out.SongFileName = in.SongFileName;
+		out.SongJacket = in.SongJacket;
+		out.SongVolume = in.SongVolume;
+		out.SoundEffectVolume = in.SoundEffectVolume;
+		out.BackgroundImageFileName = in.BackgroundImageFileName;
+		out.BackgroundMovieFileName = in.BackgroundMovieFileName;
+		out.MovieOffset = in.MovieOffset;
+		out.OtherMetadata = in.OtherMetadata;
+	}
+
 	Beat FindCourseMaxUsedBeat(const ChartCourse& course)
 	{
 		// NOTE: Technically only need to look at the last item of each sorted list **but just to be sure**, in case there is something wonky going on with out-of-order durations or something
@@ -137,136 +334,177 @@ namespace PeepoDrumKit
 		return maxBeat;
 	}
 
-	b8 CreateChartProjectFromTJA(const TJA::ParsedTJA& inTJA, ChartProject& out)
+	// NOTE: Only depends on the main metadata and the parsed course itself, returning the time of its last measure
+	static Time ConvertTJACourseToChartCourse(const TJA::ParsedTJA& inTJA, const TJA::ParsedCourse& inParsedCourse, ChartCourse& outCourse)
 	{
-		out.ChartDuration = Time::Zero();
-		out.ChartTitle = inTJA.Metadata.TITLE;
-		out.ChartTitleLocalized = inTJA.Metadata.TITLE_localized;
-		out.ChartSubtitle = inTJA.Metadata.SUBTITLE;
-		out.ChartSubtitleLocalized = inTJA.Metadata.SUBTITLE_localized;
-		out.ChartCreator = inTJA.Metadata.MAKER;
-		out.ChartGenre = inTJA.Metadata.GENRE;
-		out.ChartLyricsFileName = inTJA.Metadata.LYRICS;
-		out.SongOffset = inTJA.Metadata.OFFSET;
-		out.SongDemoStartTime = inTJA.Metadata.DEMOSTART;
-		out.SongFileName = inTJA.Metadata.WAVE;
-		out.SongJacket = inTJA.Metadata.PREIMAGE;
-		out.SongVolume = inTJA.Metadata.SONGVOL;
-		out.SoundEffectVolume = inTJA.Metadata.SEVOL;
-		out.BackgroundImageFileName = inTJA.Metadata.BGIMAGE;
-		out.BackgroundMovieFileName = inTJA.Metadata.BGMOVIE;
-		out.MovieOffset = inTJA.Metadata.MOVIEOFFSET;
-		out.OtherMetadata = inTJA.Metadata.Others;
-		for (size_t i = 0; i < inTJA.Courses.size(); i++)
-		{
-			if (!inTJA.Courses[i].HasChart) // metadata-only TJA section
-				continue;
+		const TJA::ConvertedCourse& inCourse = TJA::ConvertParsedToConvertedCourse(inTJA, inParsedCourse);
 
-			const TJA::ConvertedCourse& inCourse = TJA::ConvertParsedToConvertedCourse(inTJA, inTJA.Courses[i]);
-			ChartCourse& outCourse = *out.Courses.emplace_back(std::make_unique<ChartCourse>());
+		// HACK: Write proper enum conversion functions
+		outCourse.Type = Clamp(static_cast<DifficultyType>(inCourse.CourseMetadata.COURSE), DifficultyType {}, DifficultyType::Count);
+		outCourse.Level = Clamp(static_cast<DifficultyLevel>(inCourse.CourseMetadata.LEVEL), DifficultyLevel::Min, DifficultyLevel::Max);
+		outCourse.Decimal = Clamp(static_cast<DifficultyLevelDecimal>(inCourse.CourseMetadata.LEVEL_DECIMALTAG), DifficultyLevelDecimal::None, DifficultyLevelDecimal::Max);
+		outCourse.Style = std::max(inCourse.CourseMetadata.STYLE, 1);
+		outCourse.PlayerSide = std::clamp(inCourse.CourseMetadata.START_PLAYERSIDE, 1, outCourse.Style);
 
-			// HACK: Write proper enum conversion functions
-			outCourse.Type = Clamp(static_cast<DifficultyType>(inCourse.CourseMetadata.COURSE), DifficultyType {}, DifficultyType::Count);
-			outCourse.Level = Clamp(static_cast<DifficultyLevel>(inCourse.CourseMetadata.LEVEL), DifficultyLevel::Min, DifficultyLevel::Max);
-			outCourse.Decimal = Clamp(static_cast<DifficultyLevelDecimal>(inCourse.CourseMetadata.LEVEL_DECIMALTAG), DifficultyLevelDecimal::None, DifficultyLevelDecimal::Max);
-			outCourse.Style = std::max(inCourse.CourseMetadata.STYLE, 1);
-			outCourse.PlayerSide = std::clamp(inCourse.CourseMetadata.START_PLAYERSIDE, 1, outCourse.Style);
+		outCourse.CourseCreator = inCourse.CourseMetadata.NOTESDESIGNER;
 
-			outCourse.CourseCreator = inCourse.CourseMetadata.NOTESDESIGNER;
+		outCourse.Life = Clamp(static_cast<TowerLives>(inCourse.CourseMetadata.LIFE), TowerLives::Min, TowerLives::Max);
+		outCourse.Side = Clamp(static_cast<Side>(inCourse.CourseMetadata.SIDE), Side{}, Side::Count);
 
-			outCourse.Life = Clamp(static_cast<TowerLives>(inCourse.CourseMetadata.LIFE), TowerLives::Min, TowerLives::Max);
-			outCourse.Side = Clamp(static_cast<Side>(inCourse.CourseMetadata.SIDE), Side{}, Side::Count);
+		// NOTE: Collected in TJA order first and then sorted all at once, with later changes at the same beat replacing earlier ones
+		std::vector<TempoChange> tempTempoChanges = { TempoChange(Beat::Zero(), inTJA.Metadata.BPM) };
+		std::vector<TimeSignatureChange> tempSignatureChanges = { TimeSignatureChange(Beat::Zero(), TimeSignature(4, 4)) };
+		TimeSignature lastSignature = TimeSignature(4, 4);
 
-			outCourse.TempoMap.Tempo.Sorted = { TempoChange(Beat::Zero(), inTJA.Metadata.BPM) };
-			outCourse.TempoMap.Signature.Sorted = { TimeSignatureChange(Beat::Zero(), TimeSignature(4, 4)) };
-			TimeSignature lastSignature = TimeSignature(4, 4);
+		i32 currentBalloonIndex = 0;
 
-			i32 currentBalloonIndex = 0;
+		std::vector<TempTimedDelayCommand> tempDelayCommands;
+		for (const TJA::ConvertedMeasure& inMeasure : inCourse.Measures)
+		{
+			for (const TJA::ConvertedDelayChange& inDelayChange : inMeasure.DelayChanges)
+				tempDelayCommands.push_back(TempTimedDelayCommand { inMeasure.StartTime + inDelayChange.TimeWithinMeasure, inDelayChange.Delay });
+		}
 
-			BeatSortedList<TempTimedDelayCommand> tempSortedDelayCommands;
-			BeatSortedForwardIterator<TempTimedDelayCommand> tempDelayCommandsIt;
-			for (const TJA::ConvertedMeasure& inMeasure : inCourse.Measures)
-			{
-				for (const TJA::ConvertedDelayChange& inDelayChange : inMeasure.DelayChanges)
-					tempSortedDelayCommands.InsertOrUpdate(TempTimedDelayCommand { inMeasure.StartTime + inDelayChange.TimeWithinMeasure, inDelayChange.Delay });
-			}
+		BeatSortedList<TempTimedDelayCommand> tempSortedDelayCommands;
+		tempSortedDelayCommands.Assign(std::move(tempDelayCommands));
+		BeatSortedForwardIterator<TempTimedDelayCommand> tempDelayCommandsIt;
 
-			for (const TJA::ConvertedMeasure& inMeasure : inCourse.Measures)
+		for (const TJA::ConvertedMeasure& inMeasure : inCourse.Measures)
+		{
+			for (const TJA::ConvertedNote& inNote : inMeasure.Notes)
 			{
-				for (const TJA::ConvertedNote& inNote : inMeasure.Notes)
+				if (inNote.Type == TJA::NoteType::End_BalloonOrDrumroll)
 				{
-					if (inNote.Type == TJA::NoteType::End_BalloonOrDrumroll)
-					{
-						// TODO: Proper handling
-						if (!outCourse.Notes_Normal.Sorted.empty())
-							outCourse.Notes_Normal.Sorted.back().BeatDuration = (inMeasure.StartTime + inNote.TimeWithinMeasure) - outCourse.Notes_Normal.Sorted.back().BeatTime;
-						continue;
-					}
-
-					const NoteType outNoteType = ConvertTJANoteType(inNote.Type);
-					if (outNoteType == NoteType::Count)
-						continue;
+					// TODO: Proper handling
+					if (!outCourse.Notes_Normal.Sorted.empty())
+						outCourse.Notes_Normal.Sorted.back().BeatDuration = (inMeasure.StartTime + inNote.TimeWithinMeasure) - outCourse.Notes_Normal.Sorted.back().BeatTime;
+					continue;
+				}
 
-					Note& outNote = outCourse.Notes_Normal.Sorted.emplace_back();
-					outNote.BeatTime = (inMeasure.StartTime + inNote.TimeWithinMeasure);
-					outNote.Type = outNoteType;
+				const NoteType outNoteType = ConvertTJANoteType(inNote.Type);
+				if (outNoteType == NoteType::Count)
+					continue;
 
-					const TempTimedDelayCommand* delayCommandForThisNote = tempDelayCommandsIt.Next(tempSortedDelayCommands.Sorted, outNote.BeatTime);
-					outNote.TimeOffset = (delayCommandForThisNote != nullptr) ? delayCommandForThisNote->Delay : Time::Zero();
+				Note& outNote = outCourse.Notes_Normal.Sorted.emplace_back();
+				outNote.BeatTime = (inMeasure.StartTime + inNote.TimeWithinMeasure);
+				outNote.Type = outNoteType;
 
-					if (inNote.Type == TJA::NoteType::Start_Balloon || inNote.Type == TJA::NoteType::Start_BaloonSpecial || inNote.Type == TJA::NoteType::Fuse)
-					{
-						// TODO: Implement properly with correct branch handling
-						if (InBounds(currentBalloonIndex, inCourse.CourseMetadata.BALLOON))
-							outNote.BalloonPopCount = inCourse.CourseMetadata.BALLOON[currentBalloonIndex];
-						currentBalloonIndex++;
-					}
-				}
+				const TempTimedDelayCommand* delayCommandForThisNote = tempDelayCommandsIt.Next(tempSortedDelayCommands.Sorted, outNote.BeatTime);
+				outNote.TimeOffset = (delayCommandForThisNote != nullptr) ? delayCommandForThisNote->Delay : Time::Zero();
 
-				if (inMeasure.TimeSignature != lastSignature)
+				if (inNote.Type == TJA::NoteType::Start_Balloon || inNote.Type == TJA::NoteType::Start_BaloonSpecial || inNote.Type == TJA::NoteType::Fuse)
 				{
-					outCourse.TempoMap.Signature.InsertOrUpdate(TimeSignatureChange(inMeasure.StartTime, inMeasure.TimeSignature));
-					lastSignature = inMeasure.TimeSignature;
+					// TODO: Implement properly with correct branch handling
+					if (InBounds(currentBalloonIndex, inCourse.CourseMetadata.BALLOON))
+						outNote.BalloonPopCount = inCourse.CourseMetadata.BALLOON[currentBalloonIndex];
+					currentBalloonIndex++;
 				}
+			}
 
-				for (const TJA::ConvertedTempoChange& inTempoChange : inMeasure.TempoChanges)
-					outCourse.TempoMap.Tempo.InsertOrUpdate(TempoChange(inMeasure.StartTime + inTempoChange.TimeWithinMeasure, inTempoChange.Tempo));
+			if (inMeasure.TimeSignature != lastSignature)
+			{
+				tempSignatureChanges.push_back(TimeSignatureChange(inMeasure.StartTime, inMeasure.TimeSignature));
+				lastSignature = inMeasure.TimeSignature;
+			}
 
-				for (const TJA::ConvertedScrollChange& inScrollChange : inMeasure.ScrollChanges)
-					outCourse.ScrollChanges.Sorted.push_back(ScrollChange { (inMeasure.StartTime + inScrollChange.TimeWithinMeasure), inScrollChange.ScrollSpeed });
+			for (const TJA::ConvertedTempoChange& inTempoChange : inMeasure.TempoChanges)
+				tempTempoChanges.push_back(TempoChange(inMeasure.StartTime + inTempoChange.TimeWithinMeasure, inTempoChange.Tempo));
 
-				for (const TJA::ConvertedScrollType& inScrollType : inMeasure.ScrollTypes)
-					outCourse.ScrollTypes.Sorted.push_back(ScrollType{ (inMeasure.StartTime + inScrollType.TimeWithinMeasure),  static_cast<ScrollMethod>(inScrollType.Method) });
+			for (const TJA::ConvertedScrollChange& inScrollChange : inMeasure.ScrollChanges)
+				outCourse.ScrollChanges.Sorted.push_back(ScrollChange { (inMeasure.StartTime + inScrollChange.TimeWithinMeasure), inScrollChange.ScrollSpeed });
 
-				for (const TJA::ConvertedJPOSScroll& inJPOSScrollChange : inMeasure.JPOSScrollChanges)
-					outCourse.JPOSScrollChanges.Sorted.push_back(JPOSScrollChange{ (inMeasure.StartTime + inJPOSScrollChange.TimeWithinMeasure), inJPOSScrollChange.Move, inJPOSScrollChange.Duration });
+			for (const TJA::ConvertedScrollType& inScrollType : inMeasure.ScrollTypes)
+				outCourse.ScrollTypes.Sorted.push_back(ScrollType{ (inMeasure.StartTime + inScrollType.TimeWithinMeasure),  static_cast<ScrollMethod>(inScrollType.Method) });
 
+			for (const TJA::ConvertedJPOSScroll& inJPOSScrollChange : inMeasure.JPOSScrollChanges)
+				outCourse.JPOSScrollChanges.Sorted.push_back(JPOSScrollChange{ (inMeasure.StartTime + inJPOSScrollChange.TimeWithinMeasure), inJPOSScrollChange.Move, inJPOSScrollChange.Duration });
 
-				for (const TJA::ConvertedBarLineChange& barLineChange : inMeasure.BarLineChanges)
-					outCourse.BarLineChanges.Sorted.push_back(BarLineChange { (inMeasure.StartTime + barLineChange.TimeWithinMeasure), barLineChange.Visibile });
 
-				for (const TJA::ConvertedLyricChange& lyricChange : inMeasure.LyricChanges)
-					outCourse.Lyrics.Sorted.push_back(LyricChange { (inMeasure.StartTime + lyricChange.TimeWithinMeasure), lyricChange.Lyric });
-			}
+			for (const TJA::ConvertedBarLineChange& barLineChange : inMeasure.BarLineChanges)
+				outCourse.BarLineChanges.Sorted.push_back(BarLineChange { (inMeasure.StartTime + barLineChange.TimeWithinMeasure), barLineChange.Visibile });
 
-			for (const TJA::ConvertedGoGoRange& inGoGoRange : inCourse.GoGoRanges)
-				outCourse.GoGoRanges.Sorted.push_back(GoGoRange { inGoGoRange.StartTime, (inGoGoRange.EndTime - inGoGoRange.StartTime) });
+			for (const TJA::ConvertedLyricChange& lyricChange : inMeasure.LyricChanges)
+				outCourse.Lyrics.Sorted.push_back(LyricChange { (inMeasure.StartTime + lyricChange.TimeWithinMeasure), lyricChange.Lyric });
+		}
 
-			//outCourse.TempoMap.SetTempoChange(TempoChange());
-			//outCourse.TempoMap = inCourse.GoGoRanges;
+		for (const TJA::ConvertedGoGoRange& inGoGoRange : inCourse.GoGoRanges)
+			outCourse.GoGoRanges.Sorted.push_back(GoGoRange { inGoGoRange.StartTime, (inGoGoRange.EndTime - inGoGoRange.StartTime) });
 
-			outCourse.ScoreInit = inCourse.CourseMetadata.SCOREINIT;
-			outCourse.ScoreDiff = inCourse.CourseMetadata.SCOREDIFF;
+		outCourse.TempoMap.Tempo.Assign(std::move(tempTempoChanges));
+		outCourse.TempoMap.Signature.Assign(std::move(tempSignatureChanges));
 
-			outCourse.OtherMetadata = inCourse.CourseMetadata.Others;
+		//outCourse.TempoMap.SetTempoChange(TempoChange());
+		//outCourse.TempoMap = inCourse.GoGoRanges;
 
-			outCourse.TempoMap.RebuildAccelerationStructure();
-			outCourse.RecalculateSENotes();
+		outCourse.ScoreInit = inCourse.CourseMetadata.SCOREINIT;
+		outCourse.ScoreDiff = inCourse.CourseMetadata.SCOREDIFF;
 
-			if (!inCourse.Measures.empty())
-				out.ChartDuration = Max(out.ChartDuration, outCourse.TempoMap.BeatToTime(inCourse.Measures.back().StartTime /*+ inCourse.Measures.back().TimeSignature.GetDurationPerBar()*/));
+		outCourse.OtherMetadata = inCourse.CourseMetadata.Others;
+
+		outCourse.TempoMap.RebuildAccelerationStructure();
+		outCourse.RecalculateSENotes();
+
+		return inCourse.Measures.empty() ? Time::Zero() : outCourse.TempoMap.BeatToTime(inCourse.Measures.back().StartTime /*+ inCourse.Measures.back().TimeSignature.GetDurationPerBar()*/);
+	}
+
+	b8 CreateChartProjectFromTJA(const TJA::ParsedTJA& inTJA, ChartProject& out, b8 convertCoursesInParallel)
+	{
+		out.ChartDuration = Time::Zero();
+		out.ChartTitle = inTJA.Metadata.TITLE;
+		out.ChartTitleLocalized = inTJA.Metadata.TITLE_localized;
+		out.ChartSubtitle = inTJA.Metadata.SUBTITLE;
+		out.ChartSubtitleLocalized = inTJA.Metadata.SUBTITLE_localized;
+		out.ChartCreator = inTJA.Metadata.MAKER;
+		out.ChartGenre = inTJA.Metadata.GENRE;
+		out.ChartLyricsFileName = inTJA.Metadata.LYRICS;
+		out.SongOffset = inTJA.Metadata.OFFSET;
+		out.SongDemoStartTime = inTJA.Metadata.DEMOSTART;
+		out.SongFileName = inTJA.Metadata.WAVE;
+		out.SongJacket = inTJA.Metadata.PREIMAGE;
+		out.SongVolume = inTJA.Metadata.SONGVOL;
+		out.SoundEffectVolume = inTJA.Metadata.SEVOL;
+		out.BackgroundImageFileName = inTJA.Metadata.BGIMAGE;
+		out.BackgroundMovieFileName = inTJA.Metadata.BGMOVIE;
+		out.MovieOffset = inTJA.Metadata.MOVIEOFFSET;
+		out.OtherMetadata = inTJA.Metadata.Others;
+
+		std::vector<const TJA::ParsedCourse*> inCoursesWithChart;
+		inCoursesWithChart.reserve(inTJA.Courses.size());
+		for (const TJA::ParsedCourse& inCourse : inTJA.Courses)
+		{
+			if (inCourse.HasChart) // skip metadata-only TJA section
+				inCoursesWithChart.push_back(&inCourse);
 		}
 
+		const size_t firstOutCourseIndex = out.Courses.size();
+		out.Courses.reserve(firstOutCourseIndex + inCoursesWithChart.size());
+		for (size_t i = 0; i < inCoursesWithChart.size(); i++)
+			out.Courses.push_back(std::make_unique<ChartCourse>());
+
+		// NOTE: Every course is independent of all others once parsed, so they are handed out to a small pool of worker threads (including this one).
+		//		 The output courses are allocated upfront to keep their TJA order and the chart duration is only combined after all of them have finished,
+		//		 which makes the result the same as converting them one after another
+		std::vector<Time> courseDurations(inCoursesWithChart.size(), Time::Zero());
+		std::atomic<size_t> nextCourseIndex = 0;
+		auto convertRemainingCourses = [&]()
+		{
+			for (size_t i = nextCourseIndex++; i < inCoursesWithChart.size(); i = nextCourseIndex++)
+				courseDurations[i] = ConvertTJACourseToChartCourse(inTJA, *inCoursesWithChart[i], *out.Courses[firstOutCourseIndex + i]);
+		};
+
+		const size_t hardwareThreadCount = ClampBot<size_t>(std::thread::hardware_concurrency(), 1);
+		const size_t workerThreadCount = (convertCoursesInParallel && !inCoursesWithChart.empty()) ? (Min(inCoursesWithChart.size(), hardwareThreadCount) - 1) : 0;
+		std::vector<std::thread> workerThreads;
+		workerThreads.reserve(workerThreadCount);
+		for (size_t i = 0; i < workerThreadCount; i++)
+			workerThreads.emplace_back(convertRemainingCourses);
+		convertRemainingCourses();
+		for (std::thread& thread : workerThreads)
+			thread.join();
+
+		for (const Time courseDuration : courseDurations)
+			out.ChartDuration = Max(out.ChartDuration, courseDuration);
+
 		return true;
 	}
 
@@ -444,9 +682,375 @@ namespace PeepoDrumKit
 					outConvertedMeasureEnd->GoGoChanges.push_back(TJA::ConvertedGoGoChange{ (endTime - outConvertedMeasureEnd->StartTime), false });
 			}
 
-			TJA::ConvertConvertedMeasuresToParsedCommands(outConvertedMeasures, outCourse.ChartCommands);
+			TJA::ConvertConvertedMeasuresToParsedCommands(outConvertedMeasures, outCourse.ChartCommands, out.MeasureNoteArena);
+		}
+
+		return true;
+	}
+
+	static constexpr NoteType ConvertFumenNoteType(Fumen::NoteType fumenNoteType)
+	{
+		switch (fumenNoteType)
+		{
+		case Fumen::NoteType::Don: return NoteType::Don;
+		case Fumen::NoteType::Do: return NoteType::Don;
+		case Fumen::NoteType::Ko: return NoteType::Don;
+		case Fumen::NoteType::Ka: return NoteType::Ka;
+		case Fumen::NoteType::Katsu: return NoteType::Ka;
+		case Fumen::NoteType::Drumroll: return NoteType::Drumroll;
+		case Fumen::NoteType::DrumrollAlt: return NoteType::Drumroll;
+		case Fumen::NoteType::DonBig: return NoteType::DonBig;
+		case Fumen::NoteType::KaBig: return NoteType::KaBig;
+		case Fumen::NoteType::DrumrollBig: return NoteType::DrumrollBig;
+		case Fumen::NoteType::Balloon: return NoteType::Balloon;
+		case Fumen::NoteType::DonBigHand: return NoteType::DonBigHand;
+		case Fumen::NoteType::Kusudama: return NoteType::BalloonSpecial;
+		case Fumen::NoteType::KaBigHand: return NoteType::KaBigHand;
+		default: return NoteType::Count;
+		}
+	}
+
+	// NOTE: Small notes are written using their (already calculated) sound effect variant, as is the case for the games' own charts
+	static constexpr Fumen::NoteType ConvertFumenNoteType(const Note& note)
+	{
+		switch (note.Type)
+		{
+		case NoteType::Don: return (note.TempSEType == NoteSEType::Do) ? Fumen::NoteType::Do : (note.TempSEType == NoteSEType::Ko) ? Fumen::NoteType::Ko : Fumen::NoteType::Don;
+		case NoteType::Ka: return (note.TempSEType == NoteSEType::Katsu) ? Fumen::NoteType::Katsu : Fumen::NoteType::Ka;
+		case NoteType::DonBig: return Fumen::NoteType::DonBig;
+		case NoteType::KaBig: return Fumen::NoteType::KaBig;
+		case NoteType::Drumroll: return Fumen::NoteType::Drumroll;
+		case NoteType::DrumrollBig: return Fumen::NoteType::DrumrollBig;
+		case NoteType::Balloon: return Fumen::NoteType::Balloon;
+		case NoteType::BalloonSpecial: return Fumen::NoteType::Kusudama;
+		case NoteType::DonBigHand: return Fumen::NoteType::DonBigHand;
+		case NoteType::KaBigHand: return Fumen::NoteType::KaBigHand;
+		default: return Fumen::NoteType::None;
+		}
+	}
+
+	// NOTE: Measure lengths and note positions only exist as (single precision) milliseconds, so they are snapped back onto the closest
+	//		 bar division (including tuplets) when within a fraction of a millisecond of it, falling back to the closest tick otherwise.
+	//		 Fails for any resulting beat outside of half the tick range, so that the distance between any two converted beats can't overflow either
+	static constexpr i32 MaxAbsFumenBeatTicks = (I32Max / 2);
+	static b8 TryFumenDurationToBeat(Beat baseBeat, f64 durationMS, f32 bpm, Beat& outBeat)
+	{
+		static constexpr f64 snapToleranceMS = 0.1;
+		const f64 ticksPerMS = (static_cast<f64>(bpm) / 60000.0) * static_cast<f64>(Beat::TicksPerBeat);
+		const f64 ticks = durationMS * ticksPerMS;
+		const f64 toleranceTicks = snapToleranceMS * ::fabs(ticksPerMS);
+
+		f64 snappedTicks = Round(ticks);
+		for (const i32 barDivision : { 192, 160, 224, 288 })
+		{
+			const f64 gridTicks = static_cast<f64>(GetGridBeatSnap(barDivision).Ticks);
+			if (const f64 gridSnappedTicks = Round(ticks / gridTicks) * gridTicks; ::fabs(gridSnappedTicks - ticks) <= toleranceTicks)
+			{
+				snappedTicks = gridSnappedTicks;
+				break;
+			}
+		}
+
+		// NOTE: Written as a negated comparison so that NaN fails as well
+		const f64 absoluteTicks = static_cast<f64>(baseBeat.Ticks) + snappedTicks;
+		if (!(::fabs(absoluteTicks) <= static_cast<f64>(MaxAbsFumenBeatTicks)))
+			return false;
+
+		outBeat = Beat::FromTicks(static_cast<i32>(absoluteTicks));
+		return true;
+	}
+
+	static TimeSignature FumenMeasureLengthToTimeSignature(Beat measureLength)
+	{
+		const i32 barTicks = Beat::FromBars(1).Ticks;
+		const i32 divisor = std::gcd(measureLength.Ticks, barTicks);
+		TimeSignature signature = TimeSignature(measureLength.Ticks / divisor, barTicks / divisor);
+		while (signature.Denominator < 4) { signature.Numerator *= 2; signature.Denominator *= 2; }
+		return signature;
+	}
+
+	b8 CreateChartCourseFromFumen(const Fumen::ChartView& inFumen, ChartCourse& outCourse, Time& outSongOffset, Time& outDuration)
+	{
+		const std::vector<Fumen::MeasureView>& inMeasures = inFumen.Measures;
+		outCourse.TempoMap.Tempo.Sorted = { TempoChange(Beat::Zero(), FallbackTempo) };
+		outCourse.TempoMap.Signature.Sorted = { TimeSignatureChange(Beat::Zero(), TimeSignature(4, 4)) };
+		outSongOffset = Time::Zero();
+		outDuration = Time::Zero();
+
+		if (inMeasures.empty())
+		{
+			outCourse.TempoMap.RebuildAccelerationStructure();
+			return true;
+		}
+
+		// NOTE: Each measure lasts until the next one begins (with the last one assumed to be as long as the one before it)
+		std::vector<Beat> measureBeats(inMeasures.size() + 1, Beat::Zero());
+		std::vector<f32> measureBPMs(inMeasures.size());
+		Beat lastMeasureLength = Beat::FromBars(1);
+		for (size_t i = 0; i < inMeasures.size(); i++)
+		{
+			measureBPMs[i] = SafetyCheckTempo(Tempo(inMeasures[i].Record.BPM)).BPM;
+			Beat measureLength = lastMeasureLength;
+			if ((i + 1) < inMeasures.size() && !TryFumenDurationToBeat(Beat::Zero(), inMeasures[i + 1].GetStartMS() - inMeasures[i].GetStartMS(), measureBPMs[i], measureLength))
+				return false;
+
+			lastMeasureLength = Max(measureLength, Beat::Zero());
+			if (lastMeasureLength.Ticks > (MaxAbsFumenBeatTicks - measureBeats[i].Ticks))
+				return false;
+			measureBeats[i + 1] = measureBeats[i] + lastMeasureLength;
+		}
+
+		auto tryAbsoluteTimeToBeat = [&](size_t measureIndex, f64 absoluteMS, Beat& outBeat)
+		{
+			while ((measureIndex + 1) < inMeasures.size() && inMeasures[measureIndex + 1].GetStartMS() <= absoluteMS)
+				measureIndex++;
+			return TryFumenDurationToBeat(measureBeats[measureIndex], absoluteMS - inMeasures[measureIndex].GetStartMS(), measureBPMs[measureIndex], outBeat);
+		};
+
+		const i32 branchCount = (inFumen.Header.HasBranches != 0) ? Fumen::BranchCount : 1;
+		TimeSignature lastSignature = TimeSignature(4, 4);
+		b8 lastBarLineVisible = true, isInsideGoGo = false, hasScore = false, allNotesInRange = true;
+		f32 lastScrollSpeed = 1.0f;
+		Beat goGoStartBeat = Beat::Zero();
+
+		// NOTE: Measures are visited in order so changes can simply be appended, only replacing the previous one if it is at the same beat (after a zero length measure)
+		static constexpr auto appendOrReplaceLast = [](auto& sortedList, auto&& value)
+		{
+			if (!sortedList.Sorted.empty() && GetBeat(sortedList.Sorted.back()) == GetBeat(value))
+				sortedList.Sorted.back() = value;
+			else
+				sortedList.Sorted.push_back(value);
+		};
+
+		for (size_t i = 0; i < inMeasures.size(); i++)
+		{
+			const Fumen::MeasureView& inMeasure = inMeasures[i];
+			const Beat measureBeat = measureBeats[i], measureLength = (measureBeats[i + 1] - measureBeats[i]);
+			const f32 bpm = measureBPMs[i];
+			const f64 measureStartMS = inMeasure.GetStartMS();
+
+			if (i == 0)
+				outCourse.TempoMap.Tempo.Sorted[0].Tempo = Tempo(bpm);
+			else if (bpm != measureBPMs[i - 1])
+				appendOrReplaceLast(outCourse.TempoMap.Tempo, TempoChange(measureBeat, Tempo(bpm)));
+
+			if (measureLength > Beat::Zero())
+			{
+				const TimeSignature signature = FumenMeasureLengthToTimeSignature(measureLength);
+				if (signature != lastSignature)
+					appendOrReplaceLast(outCourse.TempoMap.Signature, TimeSignatureChange(measureBeat, signature));
+				lastSignature = signature;
+			}
+
+			if (const b8 barLineVisible = (inMeasure.Record.BarLine != 0); barLineVisible != lastBarLineVisible)
+			{
+				appendOrReplaceLast(outCourse.BarLineChanges, BarLineChange { measureBeat, barLineVisible });
+				lastBarLineVisible = barLineVisible;
+			}
+
+			if (const b8 isGoGo = (inMeasure.Record.GoGo != 0); isGoGo != isInsideGoGo)
+			{
+				if (isGoGo)
+					goGoStartBeat = measureBeat;
+				else
+					outCourse.GoGoRanges.Sorted.push_back(GoGoRange { goGoStartBeat, (measureBeat - goGoStartBeat) });
+				isInsideGoGo = isGoGo;
+			}
+
+			// TODO: Have per-branch scroll speed changes (?)
+			if (const f32 scrollSpeed = inMeasure.Branches[0].Record.ScrollSpeed; scrollSpeed != lastScrollSpeed)
+			{
+				appendOrReplaceLast(outCourse.ScrollChanges, ScrollChange { measureBeat, Complex(scrollSpeed, 0.0f) });
+				lastScrollSpeed = scrollSpeed;
+			}
+
+			for (i32 branchIndex = 0; branchIndex < branchCount; branchIndex++)
+			{
+				SortedNotesList& outNotes = outCourse.GetNotes(static_cast<BranchType>(branchIndex));
+				inMeasure.Branches[branchIndex].ForEachNote([&](const Fumen::NoteRecord& inNote)
+				{
+					const NoteType outNoteType = ConvertFumenNoteType(inNote.Type);
+					if (outNoteType == NoteType::Count)
+						return;
+
+					Beat noteBeat = Beat::Zero(), noteEndBeat = Beat::Zero();
+					if (!TryFumenDurationToBeat(measureBeat, inNote.PositionMS, bpm, noteBeat) ||
+						(IsLongNote(outNoteType) && !tryAbsoluteTimeToBeat(i, measureStartMS + inNote.PositionMS + inNote.DurationMS, noteEndBeat)))
+					{
+						allNotesInRange = false;
+						return;
+					}
+
+					Note& outNote = outNotes.Sorted.emplace_back();
+					outNote.BeatTime = noteBeat;
+					outNote.Type = outNoteType;
+
+					if (IsLongNote(outNoteType))
+						outNote.BeatDuration = Max(Beat::Zero(), noteEndBeat - outNote.BeatTime);
+
+					if (IsBalloonNote(outNoteType))
+						outNote.BalloonPopCount = static_cast<i16>(Min<i32>(inNote.ScoreInitOrBalloonHits, I16Max));
+					else if (!hasScore)
+					{
+						outCourse.ScoreInit = inNote.ScoreInitOrBalloonHits;
+						outCourse.ScoreDiff = inNote.ScoreDiff;
+						hasScore = true;
+					}
+				});
+			}
+		}
+
+		if (!allNotesInRange)
+			return false;
+
+		if (isInsideGoGo)
+			outCourse.GoGoRanges.Sorted.push_back(GoGoRange { goGoStartBeat, (measureBeats.back() - goGoStartBeat) });
+
+		for (SortedNotesList* notes : { &outCourse.Notes_Normal, &outCourse.Notes_Expert, &outCourse.Notes_Master })
+		{
+			static constexpr auto isLessBeat = [](const Note& a, const Note& b) { return a.BeatTime < b.BeatTime; };
+			if (!std::is_sorted(notes->Sorted.begin(), notes->Sorted.end(), isLessBeat))
+				std::stable_sort(notes->Sorted.begin(), notes->Sorted.end(), isLessBeat);
+		}
+
+		outCourse.TempoMap.RebuildAccelerationStructure();
+		outCourse.RecalculateSENotes();
+
+		outSongOffset = Time::FromMS(-inMeasures[0].GetStartMS());
+		outDuration = outCourse.TempoMap.BeatToTime(measureBeats.back());
+		return true;
+	}
+
+	b8 CreateChartProjectFromFumen(const Fumen::ChartView& inFumen, ChartProject& out, DifficultyType difficulty)
+	{
+		ChartCourse& outCourse = *out.Courses.emplace_back(std::make_unique<ChartCourse>());
+		outCourse.Type = difficulty;
+
+		Time songOffset, duration;
+		if (!CreateChartCourseFromFumen(inFumen, outCourse, songOffset, duration))
+		{
+			out.Courses.pop_back();
+			return false;
+		}
+
+		out.SongOffset = songOffset;
+		out.ChartDuration = Max(out.ChartDuration, duration);
+		return true;
+	}
+
+	b8 ConvertChartCourseToFumen(const ChartProject& inChart, const ChartCourse& inCourse, std::vector<u8>& out)
+	{
+		inCourse.RecalculateSENotes();
+
+		// NOTE: Covers the same bars as ConvertChartProjectToTJA() does, each of which is then further split up at every tempo change,
+		//		 scroll speed change and go-go time boundary within it as those can only change from one measure to the next
+		struct MeasureSplit { ::Beat Beat; b8 IsBar; };
+		std::vector<MeasureSplit> splits;
+		Beat endBeat = Beat::Zero();
+
+		const Beat inChartMaxUsedBeat = FindCourseMaxUsedBeat(inCourse);
+		const Beat inChartBeatDuration = inCourse.TempoMap.TimeToBeat(inChart.GetDurationOrDefault());
+		inCourse.TempoMap.ForEachBeatBar([&](const SortedTempoMap::ForEachBeatBarData& it)
+		{
+			if (inChartBeatDuration > inChartMaxUsedBeat && (it.Beat >= inChartBeatDuration))
+				return ControlFlow::Break;
+			if (it.IsBar)
+			{
+				splits.push_back(MeasureSplit { it.Beat, true });
+				endBeat = it.Beat + abs(it.Signature.GetDurationPerBar());
+			}
+			return (it.Beat >= Max(inChartBeatDuration, inChartMaxUsedBeat)) ? ControlFlow::Break : ControlFlow::Fallthrough;
+		});
+
+		if (splits.empty())
+		{
+			splits.push_back(MeasureSplit { Beat::Zero(), true });
+			endBeat = Beat::FromBars(1);
+		}
+
+		auto addSplit = [&](Beat beat) { if (beat > Beat::Zero() && beat < endBeat) { splits.push_back(MeasureSplit { beat, false }); } };
+		for (const TempoChange& tempoChange : inCourse.TempoMap.Tempo) addSplit(tempoChange.Beat);
+		for (const ScrollChange& scrollChange : inCourse.ScrollChanges) addSplit(scrollChange.BeatTime);
+		for (const GoGoRange& goGo : inCourse.GoGoRanges) { addSplit(goGo.GetStart()); addSplit(goGo.GetEnd()); }
+
+		std::stable_sort(splits.begin(), splits.end(), [](const MeasureSplit& a, const MeasureSplit& b) { return (a.Beat < b.Beat) || (a.Beat == b.Beat && a.IsBar && !b.IsBar); });
+		splits.erase(std::unique(splits.begin(), splits.end(), [](const MeasureSplit& a, const MeasureSplit& b) { return a.Beat == b.Beat; }), splits.end());
+
+		const b8 hasBranches = !inCourse.Notes_Expert.empty() || !inCourse.Notes_Master.empty();
+		size_t totalNoteCount = 0; i32 hitNoteCount = 0;
+		for (const Note& note : inCourse.Notes_Normal) { if (IsRegularNote(note.Type) && ConvertFumenNoteType(note) != Fumen::NoteType::None) hitNoteCount++; }
+		for (size_t i = 0; i < EnumCount<BranchType>; i++) { totalNoteCount += inCourse.GetNotes(static_cast<BranchType>(i)).size(); }
+
+		Fumen::FileHeader header = Fumen::CreateDefaultHeader(inCourse.Type <= DifficultyType::Normal, hitNoteCount);
+		header.HasBranches = hasBranches;
+
+		out.reserve(out.size() + sizeof(Fumen::FileHeader) + (splits.size() * (sizeof(Fumen::MeasureRecord) + sizeof(Fumen::BranchRecord) * Fumen::BranchCount))
+			+ (totalNoteCount * (sizeof(Fumen::NoteRecord) + Fumen::TrailingDrumrollByteCount)));
+
+		Fumen::Writer writer = { out };
+		writer.BeginFile(header);
+
+		const u16 scoreInit = static_cast<u16>(Clamp<i32>(inCourse.ScoreInit, 0, U16Max));
+		const u16 scoreDiff = static_cast<u16>(Clamp<i32>(inCourse.ScoreDiff, 0, U16Max));
+		size_t noteIndices[EnumCount<BranchType>] = {};
+		size_t goGoIndex = 0;
+		BeatSortedForwardIterator<TempoChange> tempoChangeIt {};
+		BeatSortedForwardIterator<ScrollChange> scrollChangeIt {};
+		BeatSortedForwardIterator<BarLineChange> barLineChangeIt {};
+
+		for (size_t splitIndex = 0; splitIndex < splits.size(); splitIndex++)
+		{
+			const b8 isLastSplit = ((splitIndex + 1) == splits.size());
+			const Beat splitBeat = splits[splitIndex].Beat;
+			const Beat nextSplitBeat = isLastSplit ? endBeat : splits[splitIndex + 1].Beat;
+			const Time splitTime = inCourse.TempoMap.BeatToTime(splitBeat);
+			const f32 bpm = TempoOrDefault(tempoChangeIt.Next(inCourse.TempoMap.Tempo.Sorted, splitBeat)).BPM;
+
+			while (goGoIndex < inCourse.GoGoRanges.size() && inCourse.GoGoRanges[goGoIndex].GetEnd() <= splitBeat)
+				goGoIndex++;
+
+			Fumen::MeasureRecord outMeasure = {};
+			outMeasure.BPM = bpm;
+			outMeasure.OffsetMS = Fumen::MeasureStartToOffsetMS(ChartToSongTimeSpace(splitTime, inChart.SongOffset).ToMS(), bpm);
+			outMeasure.GoGo = (goGoIndex < inCourse.GoGoRanges.size() && inCourse.GoGoRanges[goGoIndex].GetStart() <= splitBeat);
+			outMeasure.BarLine = splits[splitIndex].IsBar && VisibleOrDefault(barLineChangeIt.Next(inCourse.BarLineChanges.Sorted, splitBeat));
+			for (i32& condition : outMeasure.BranchConditions)
+				condition = -1;
+			writer.AddMeasure(outMeasure);
+
+			const f32 scrollSpeed = ScrollOrDefault(scrollChangeIt.Next(inCourse.ScrollChanges.Sorted, splitBeat)).GetRealPart();
+			for (size_t branchIndex = 0; branchIndex < EnumCount<BranchType>; branchIndex++)
+			{
+				writer.BeginBranch(scrollSpeed);
+
+				const SortedNotesList& inNotes = inCourse.GetNotes(static_cast<BranchType>(branchIndex));
+				for (size_t& noteIndex = noteIndices[branchIndex]; noteIndex < inNotes.size() && (isLastSplit || inNotes[noteIndex].BeatTime < nextSplitBeat); noteIndex++)
+				{
+					const Note& inNote = inNotes[noteIndex];
+					const Fumen::NoteType outNoteType = ConvertFumenNoteType(inNote);
+					if (outNoteType == Fumen::NoteType::None)
+						continue;
+
+					const Time noteTime = inCourse.TempoMap.BeatToTime(inNote.BeatTime);
+					Fumen::NoteRecord outNote = {};
+					outNote.Type = outNoteType;
+					outNote.PositionMS = (noteTime - splitTime).ToMS_F32();
+					if (IsLongNote(inNote.Type))
+						outNote.DurationMS = (inCourse.TempoMap.BeatToTime(inNote.GetEnd()) - noteTime).ToMS_F32();
+					if (IsBalloonNote(inNote.Type))
+						outNote.ScoreInitOrBalloonHits = static_cast<u16>(ClampBot<i16>(inNote.BalloonPopCount, 0));
+					else
+					{
+						outNote.ScoreInitOrBalloonHits = scoreInit;
+						outNote.ScoreDiff = scoreDiff;
+					}
+					if (!writer.AddNote(outNote))
+						return false;
+				}
+			}
 		}
 
+		writer.EndFile();
 		return true;
 	}
 }
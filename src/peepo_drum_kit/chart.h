@@ -3,8 +3,8 @@
 #include "core_string.h"
 #include "core_beat.h"
 #include "file_format_tja.h"
+#include "file_format_fumen.h"
 #include <unordered_map>
-#include "chart_editor_i18n.h"
 
 namespace PeepoDrumKit
 {
@@ -161,18 +161,6 @@ namespace PeepoDrumKit
 		"DIFFICULTY_TYPE_DAN",
 	};
 
-	static inline std::string GetStyleName(i32 style, i32 playerSide)
-	{
-		if (style == 1)
-			return UI_Str("PLAYER_SIDE_STYLE_SINGLE");
-		char buf[32];
-		std::string res = (style == 2) ? UI_Str("PLAYER_SIDE_STYLE_DOUBLE")
-			: std::string(buf, sprintf_s(buf, UI_Str("PLAYER_SIDE_STYLE_FMT_%d_STYLE"), style));
-		std::string_view strPlaySide (buf, sprintf_s(buf, UI_Str("PLAYER_SIDE_PLAYER_FMT_%d_PLAYER"), playerSide));
-		res += " ("; res += strPlaySide; res += ")";
-		return res;
-	}
-
 	constexpr cstr TowerSideNames[EnumCount<Side>] =
 	{
 		"TOWER_SIDE_NORMAL",
@@ -219,7 +207,7 @@ namespace PeepoDrumKit
 	constexpr std::string_view PluralSuffixDefault = "s"; // unfortunately cannot just pass the string literal for now
 
 	template <typename TEvent>
-	constexpr std::string_view DisplayNameOfChartEvent = std::declval<std::string_view>(); // Forbid usage unless specialized
+	extern const std::string_view DisplayNameOfChartEvent; // Forbid usage unless specialized
 	template <typename TEvent>
 	constexpr std::string_view DisplayNameOfLongChartEvent = DisplayNameOfChartEvent<TEvent>;
 	template <typename TEvent>
@@ -391,7 +379,7 @@ namespace PeepoDrumKit
 
 		// Tower specific
 		TowerLives Life = TowerLives{ 5 };
-		Side Side = Side::Normal;
+		PeepoDrumKit::Side Side = PeepoDrumKit::Side::Normal;
 
 		std::map<std::string, std::string> OtherMetadata;
 
@@ -404,10 +392,37 @@ namespace PeepoDrumKit
 				RecalculateSENotes(branch);
 		}
 
-		void RecalculateSENotes(BranchType branch) const; // implemented in chart_editor_widgets_game.cpp
+		// NOTE: Only recalculates the notes that could have been affected by an edit (to either the notes or the tempo map) starting at the specified beat
+		void RecalculateSENotes(Beat firstChangedBeat) const
+		{
+			for (BranchType branch = BranchType::Normal; branch < BranchType::Count; IncrementEnum(branch))
+				RecalculateSENotes(branch, firstChangedBeat);
+		}
+
+		void RecalculateSENotes(BranchType branch, Beat firstChangedBeat = Beat::Zero()) const;
+
+		// NOTE: Notes after which the SE note calculation state has been fully reset, recorded by RecalculateSENotes() to resume from
+		struct SENoteResyncPoint { ::Beat Beat; b8 IsAlterChain; };
+		mutable std::vector<SENoteResyncPoint> SENoteResyncPoints[EnumCount<BranchType>];
+
+		// NOTE: Earliest beat from which the note lane data cached by the game preview (see NoteLaneVisibilityIndex) is outdated, lowered by RecalculateSENotes()
+		//		 as every edit affecting the SE notes (the notes themselves, the tempo map or the scroll changes) affects the note lane positions too.
+		//		 Starts out at zero so that a newly created course is always indexed from scratch
+		mutable Beat NoteLaneFirstChangedBeat[EnumCount<BranchType>] = {};
+
+		// NOTE: Longest duration and largest absolute time offset (#DELAY) of the notes of each branch, by which the timeline extends the beat range of its binary searched culling.
+		//		 Only flagged as outdated by RecalculateSENotes() (which every note edit already has to go through) and then lazily recalculated by the next query,
+		//		 so that any number of edits in between only has to walk all notes of the branch once
+		Beat GetMaxNoteBeatDuration(BranchType branch) const { UpdateNoteCullingExtentsIfOutdated(branch); return MaxNoteBeatDuration[EnumToIndex(branch)]; }
+		Time GetMaxAbsNoteTimeOffset(BranchType branch) const { UpdateNoteCullingExtentsIfOutdated(branch); return MaxAbsNoteTimeOffset[EnumToIndex(branch)]; }
+
+		void UpdateNoteCullingExtentsIfOutdated(BranchType branch) const;
+		mutable b8 AreNoteCullingExtentsUpToDate[EnumCount<BranchType>] = {};
+		mutable Beat MaxNoteBeatDuration[EnumCount<BranchType>] = {};
+		mutable Time MaxAbsNoteTimeOffset[EnumCount<BranchType>] = {};
 	};
 
-	// NOTE: Internal representation of a chart. Can then be imported / exported as .tja (and maybe as the native fumen binary format too eventually?)
+	// NOTE: Internal representation of a chart. Can then be imported / exported as .tja or (one course at a time) as the native fumen binary format
 	struct ChartProject
 	{
 		std::vector<std::unique_ptr<ChartCourse>> Courses;
@@ -440,7 +455,7 @@ namespace PeepoDrumKit
 	};
 
 	template <auto ChartProject::* Attr>
-	extern constexpr std::string_view DisplayNameOfChartProjectAttr; // defined later
+	extern const std::string_view DisplayNameOfChartProjectAttr; // defined later
 
 	template <> constexpr std::string_view DisplayNameOfChartProjectAttr<&ChartProject::ChartDuration> = "Chart Duration";
 	template <> constexpr std::string_view DisplayNameOfChartProjectAttr<&ChartProject::ChartTitle> = "Chart Title";
@@ -468,12 +483,79 @@ namespace PeepoDrumKit
 	constexpr Time ConvertTimeSpace(Time v, TimeSpace in, TimeSpace out, Time songOffset) { v = (in == out) ? v : (in == TimeSpace::Chart) ? (v - songOffset) : (v + songOffset); return (v == Time { -0.0 }) ? Time {} : v; }
 	constexpr Time ConvertTimeSpace(Time v, TimeSpace in, TimeSpace out, const ChartProject& chart) { return ConvertTimeSpace(v, in, out, chart.SongOffset); }
 
+	// NOTE: Shared by the SE note calculation (see ChartCourse::RecalculateSENotes()) and the game preview, with the scroll state of each note head and tail resolved
+	struct ForEachNoteLaneData
+	{
+		const Note* OriginalNote;
+		::Beat Beat;
+		::Time Time;
+		::Tempo Tempo;
+		Complex ScrollSpeed;
+		ScrollMethod ScrollType;
+		struct {
+			struct Beat Beat;
+			struct Time Time;
+			struct Tempo Tempo;
+			Complex ScrollSpeed;
+			ScrollMethod ScrollType;
+		} Tail;
+	};
+
+	template <typename Func>
+	void ForEachNoteOnNoteLane(const ChartCourse& course, BranchType branch, size_t startNoteIndex, Func perNoteFunc)
+	{
+		BeatSortedForwardIterator<TempoChange> tempoChangeIt {};
+		BeatSortedForwardIterator<ScrollChange> scrollChangeIt {};
+		BeatSortedForwardIterator<ScrollType> scrollTypeIt {};
+		BeatSortedForwardIterator<JPOSScrollChange> JPOSscrollChangeIt {};
+
+		const SortedNotesList& notes = course.GetNotes(branch);
+		for (size_t noteIndex = startNoteIndex; noteIndex < notes.size(); noteIndex++)
+		{
+			const Note& note = notes[noteIndex];
+			const Beat beat = note.BeatTime;
+			const Time head = (course.TempoMap.BeatToTime(beat) + note.TimeOffset);
+			const Beat beatTail = (note.BeatDuration > Beat::Zero()) ? (beat + note.BeatDuration) : beat;
+			const Time tail = (note.BeatDuration > Beat::Zero()) ? (course.TempoMap.BeatToTime(beatTail) + note.TimeOffset) : head;
+			perNoteFunc(ForEachNoteLaneData { &note, beat, head,
+				TempoOrDefault(tempoChangeIt.Next(course.TempoMap.Tempo.Sorted, beat)),
+				ScrollOrDefault(scrollChangeIt.Next(course.ScrollChanges.Sorted, beat)),
+				ScrollTypeOrDefault(scrollTypeIt.Next(course.ScrollTypes.Sorted, beat)),
+				{
+					beatTail, tail,
+					TempoOrDefault(tempoChangeIt.Next(course.TempoMap.Tempo.Sorted, beatTail)),
+					ScrollOrDefault(scrollChangeIt.Next(course.ScrollChanges.Sorted, beatTail)),
+					ScrollTypeOrDefault(scrollTypeIt.Next(course.ScrollTypes.Sorted, beatTail)),
+				},
+			});
+		}
+	}
+
+	template <typename Func>
+	void ForEachNoteOnNoteLane(const ChartCourse& course, BranchType branch, Func perNoteFunc)
+	{
+		ForEachNoteOnNoteLane(course, branch, 0, perNoteFunc);
+	}
+
 	using DebugCompareChartsOnMessageFunc = void(*)(std::string_view message, void* userData);
 	void DebugCompareCharts(const ChartProject& chartA, const ChartProject& chartB, DebugCompareChartsOnMessageFunc onMessageFunc, void* userData = nullptr);
 
+	// NOTE: Deep copy including all courses, for handing an independent snapshot of the chart off to a background thread
+	void CopyChartProject(const ChartProject& in, ChartProject& out);
+
 	Beat FindCourseMaxUsedBeat(const ChartCourse& course);
-	b8 CreateChartProjectFromTJA(const TJA::ParsedTJA& inTJA, ChartProject& out);
+	// NOTE: Courses are converted on multiple threads unless requested otherwise, which only exists for comparing against the serial result
+	b8 CreateChartProjectFromTJA(const TJA::ParsedTJA& inTJA, ChartProject& out, b8 convertCoursesInParallel = true);
 	b8 ConvertChartProjectToTJA(const ChartProject& in, TJA::ParsedTJA& out, b8 includePeepoDrumKitComment = true);
+
+	// NOTE: Fumen files only contain a single course without any of the chart metadata, with the start of the first measure marking the song offset.
+	//		 Time signatures aren't stored either and instead come back from the length of each measure, so bars that had to be split up
+	//		 at a tempo, scroll speed or go-go time change are read back as separate shorter bars (with a hidden bar line).
+	//		 Only the real part of scroll speeds and none of delays, lyrics, JPOS scrolls, scroll types, branch conditions or OpenTaiko note types are written.
+	//		 Reading fails for any measure or note too far away to be represented as a beat, writing for any measure with more notes than a branch is able to count
+	b8 CreateChartCourseFromFumen(const Fumen::ChartView& inFumen, ChartCourse& outCourse, Time& outSongOffset, Time& outDuration);
+	b8 CreateChartProjectFromFumen(const Fumen::ChartView& inFumen, ChartProject& out, DifficultyType difficulty = DifficultyType::Oni);
+	b8 ConvertChartCourseToFumen(const ChartProject& inChart, const ChartCourse& inCourse, std::vector<u8>& out);
 }
 
 namespace PeepoDrumKit
@@ -543,7 +625,7 @@ namespace PeepoDrumKit
 
 	// Member availability queries
 	template <typename T, GenericMember Member>
-	extern constexpr b8 IsMemberAvailable; // defined later
+	extern const b8 IsMemberAvailable; // defined later
 
 	template <typename T, GenericMember... Members>
 	constexpr GenericMemberFlags GetAvailableMemberFlags(enum_sequence<GenericMember, Members...>) {
@@ -558,11 +640,11 @@ namespace PeepoDrumKit
 		b8 B8;
 		i16 I16;
 		f32 F32;
-		Beat Beat;
-		Time Time;
-		NoteType NoteType;
-		Tempo Tempo;
-		TimeSignature TimeSignature;
+		::Beat Beat;
+		::Time Time;
+		PeepoDrumKit::NoteType NoteType;
+		::Tempo Tempo;
+		::TimeSignature TimeSignature;
 		cstr CStr;
 		Complex CPX;
 
@@ -594,7 +676,7 @@ namespace PeepoDrumKit
 		else if constexpr (Member == GenericMember::I8_ScrollType) return (std::forward<GenericMemberUnionT>(values).I16);
 		else if constexpr (Member == GenericMember::F32_JPOSScroll) return (std::forward<GenericMemberUnionT>(values).CPX);
 		else if constexpr (Member == GenericMember::F32_JPOSScrollDuration) return (std::forward<GenericMemberUnionT>(values).F32);
-		else static_assert(false, "unhandled or invalid GenericMember value");
+		else static_assert(always_false_v<Member>, "unhandled or invalid GenericMember value");
 	}
 
 	template <GenericMember Member>
@@ -825,7 +907,7 @@ namespace PeepoDrumKit
 	}
 
 	// need to be lambdas to be used as arguments with to-be-deduced parameter types (not needed since C++20)
-	constexpr auto GetGeneric = [&](auto&& typedMember, auto& typedOutValue)
+	constexpr auto GetGeneric = [](auto&& typedMember, auto& typedOutValue)
 	{
 		if constexpr (expect_type_v<decltype(typedMember), std::string> && !expect_type_v<decltype(typedOutValue), std::string>) // for GenericMember::CStr_Lyric
 			typedOutValue = typedMember.data();
@@ -833,7 +915,7 @@ namespace PeepoDrumKit
 			typedOutValue = static_cast<std::remove_reference_t<decltype(typedOutValue)>>(typedMember);
 	};
 
-	constexpr auto SetGeneric = [&](auto& typedMember, auto&& typedInValue)
+	constexpr auto SetGeneric = [](auto& typedMember, auto&& typedInValue)
 	{
 		typedMember = static_cast<std::remove_reference_t<decltype(typedMember)>>(typedInValue);
 	};
@@ -887,11 +969,11 @@ namespace PeepoDrumKit
 		{
 			TempoChange Tempo;
 			TimeSignatureChange Signature;
-			Note Note;
+			PeepoDrumKit::Note Note;
 			ScrollChange Scroll;
 			BarLineChange BarLine;
 			GoGoRange GoGo;
-			ScrollType ScrollType;
+			PeepoDrumKit::ScrollType ScrollType;
 			JPOSScrollChange JPOSScroll;
 
 			inline PODData() { ::memset(this, 0, sizeof(*this)); }
@@ -955,7 +1037,7 @@ namespace PeepoDrumKit
 		else if constexpr (List == GenericList::Lyrics) return (std::forward<ChartCourseT>(course).Lyrics);
 		else if constexpr (List == GenericList::ScrollType) return (std::forward<ChartCourseT>(course).ScrollTypes);
 		else if constexpr (List == GenericList::JPOSScroll) return (std::forward<ChartCourseT>(course).JPOSScrollChanges);
-		else static_assert(false, "unhandled or invalid GenericList value");
+		else static_assert(always_false_v<List>, "unhandled or invalid GenericList value");
 	}
 
 	template <GenericList List>
@@ -975,7 +1057,7 @@ namespace PeepoDrumKit
 		else if constexpr (List == GenericList::Lyrics) return (std::forward<GenericListStructT>(inValue).NonTrivial.Lyric);
 		else if constexpr (List == GenericList::ScrollType) return (std::forward<GenericListStructT>(inValue).POD.ScrollType);
 		else if constexpr (List == GenericList::JPOSScroll) return (std::forward<GenericListStructT>(inValue).POD.JPOSScroll);
-		else static_assert(false, "unhandled or invalid GenericList value");
+		else static_assert(always_false_v<List>, "unhandled or invalid GenericList value");
 	}
 
 	// Access functions for concrete GenericListStruct types
@@ -1088,6 +1170,7 @@ namespace PeepoDrumKit
 
 	// course list attribute query functions
 	constexpr b8 IsNotesList(GenericList list) { return (list == GenericList::Notes_Normal) || (list == GenericList::Notes_Expert) || (list == GenericList::Notes_Master); }
+	constexpr b8 ListAffectsSENotes(GenericList list) { return IsNotesList(list) || (list == GenericList::ScrollChanges) || (list == GenericList::ScrollType); }
 	constexpr b8 ListHasDurations(GenericList list) { return IsNotesList(list) || (list == GenericList::GoGoRanges); }
 	constexpr b8 ListUsesInclusiveBeatCheck(GenericList list) { return IsNotesList(list) || (list != GenericList::GoGoRanges && list != GenericList::Lyrics); }
 	constexpr b8 ListIsItemEndBounded(GenericList list) { return IsNotesList(list) || (list == GenericList::GoGoRanges) || (list == GenericList::JPOSScroll); }
@@ -1175,6 +1258,27 @@ namespace PeepoDrumKit
 			course, std::move(inValue)); // `std::move` makes no differences on POD
 	}
 
+	// NOTE: BeatSortedList::BulkInsertOrFunc() counterpart of TryAddOrFuncGenericStruct(), with all of the values expected to belong to the same list
+	template <typename Func>
+	b8 TryBulkAddOrFuncGenericStructs(ChartCourse& course, GenericList list, const std::vector<GenericListStructWithType>& inValues, Func funcExist)
+	{
+		return ApplySingleGenericList(list,
+			[&](auto&& typedList)
+			{
+				using TEvent = typename std::remove_reference_t<decltype(typedList)>::value_type;
+				std::vector<TEvent> typedValues;
+				typedValues.reserve(inValues.size());
+				for (const GenericListStructWithType& inValue : inValues)
+				{
+					assert(inValue.List == list);
+					typedValues.push_back(get<TEvent>(inValue.Value));
+				}
+				typedList.BulkInsertOrFunc(std::move(typedValues), funcExist);
+				return true;
+			}, false,
+			course);
+	}
+
 	inline b8 TryAddOrReplaceGenericStruct(ChartCourse& course, GenericList list, GenericListStruct inValue)
 	{
 		return ApplySingleGenericList(list,
@@ -0,0 +1,422 @@
+#include "chart_cache.h"
+
+namespace PeepoDrumKit::ChartCache
+{
+	static constexpr char FileMagic[8] = { 'P', 'D', 'K', 'C', 'A', 'C', 'H', 'E' };
+
+	struct FileHeader
+	{
+		char Magic[8];
+		u32 Version;
+		u32 ConverterVersion;
+		u64 ChartContentHash;
+		u64 ChartPartOffset;
+		u64 ChartPartSize;
+		u64 SongContentHash;
+		u64 WaveformPartOffset;
+		u64 WaveformPartSize;
+	};
+
+	enum class SectionType : u32
+	{
+		ProjectProperties,
+		CourseProperties,
+		TempoChanges,
+		SignatureChanges,
+		TempoSegments,
+		NotesNormal,
+		NotesExpert,
+		NotesMaster,
+		ScrollChanges,
+		BarLineChanges,
+		GoGoRanges,
+		ScrollTypes,
+		JPOSScrollChanges,
+		Lyrics,
+		Count
+	};
+
+	struct ChartPartHeader
+	{
+		u32 SectionCount;
+		u32 CourseCount;
+		u32 HasPeepoDrumKitComment;
+		u32 Reserved;
+	};
+
+	// NOTE: Offset relative to the start of the chart part, with the item count being the byte size for the variable size property sections
+	struct SectionHeader
+	{
+		SectionType Type;
+		u32 CourseIndex;
+		u64 Offset;
+		u64 ItemCount;
+	};
+
+	struct WaveformPartHeader
+	{
+		i64 FrameCount;
+		u32 SampleRate;
+		u32 Reserved;
+		u64 BucketCountL;
+		u64 BucketCountR;
+	};
+
+	static_assert(sizeof(FileHeader) % 8 == 0 && sizeof(ChartPartHeader) % 8 == 0 && sizeof(SectionHeader) % 8 == 0 && sizeof(WaveformPartHeader) % 8 == 0);
+
+	template <typename T>
+	static inline void AppendBytes(std::vector<u8>& out, const T* items, size_t itemCount)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		if (itemCount == 0)
+			return;
+		const size_t offset = out.size();
+		out.resize(offset + (itemCount * sizeof(T)));
+		::memcpy(out.data() + offset, items, itemCount * sizeof(T));
+	}
+
+	static inline void AlignTo8(std::vector<u8>& out) { out.resize((out.size() + 7) & ~static_cast<size_t>(7), 0x00); }
+
+	// NOTE: The handful of strings and scalar values of the chart and each course are stored sequentially, everything else as flat arrays
+	struct PropertyWriter
+	{
+		std::vector<u8>& Out;
+
+		template <typename T>
+		inline void Value(const T& value) { AppendBytes(Out, &value, 1); }
+		inline void String(std::string_view value) { Value(static_cast<u32>(value.size())); AppendBytes(Out, value.data(), value.size()); }
+		inline void StringMap(const std::map<std::string, std::string>& value) { Value(static_cast<u32>(value.size())); for (const auto&[k, v] : value) { String(k); String(v); } }
+	};
+
+	struct PropertyReader
+	{
+		const u8* It;
+		const u8* End;
+		b8 Failed = false;
+
+		inline b8 CanRead(size_t byteSize) { Failed |= (static_cast<size_t>(End - It) < byteSize); return !Failed; }
+
+		template <typename T>
+		inline void Value(T& out) { if (CanRead(sizeof(T))) { ::memcpy(&out, It, sizeof(T)); It += sizeof(T); } }
+		inline void String(std::string& out) { u32 size = 0; Value(size); if (CanRead(size)) { out.assign(reinterpret_cast<const char*>(It), size); It += size; } }
+		inline void StringMap(std::map<std::string, std::string>& out)
+		{
+			u32 count = 0; Value(count);
+			for (u32 i = 0; i < count && !Failed; i++) { std::string k, v; String(k); String(v); out.emplace(std::move(k), std::move(v)); }
+		}
+	};
+
+	struct ChartPartWriter
+	{
+		std::vector<SectionHeader> Sections;
+		std::vector<u8> Data;
+
+		template <typename T>
+		inline void Array(SectionType type, u32 courseIndex, const std::vector<T>& items)
+		{
+			Sections.push_back(SectionHeader { type, courseIndex, Data.size(), items.size() });
+			AppendBytes(Data, items.data(), items.size());
+			AlignTo8(Data);
+		}
+
+		template <typename Func>
+		inline void Properties(SectionType type, u32 courseIndex, Func writeFunc)
+		{
+			const size_t offset = Data.size();
+			writeFunc(PropertyWriter { Data });
+			Sections.push_back(SectionHeader { type, courseIndex, offset, (Data.size() - offset) });
+			AlignTo8(Data);
+		}
+	};
+
+	static void WriteProjectProperties(PropertyWriter out, const ChartProject& in)
+	{
+		out.Value(in.ChartDuration);
+		out.String(in.ChartTitle);
+		out.StringMap(in.ChartTitleLocalized);
+		out.String(in.ChartSubtitle);
+		out.StringMap(in.ChartSubtitleLocalized);
+		out.String(in.ChartCreator);
+		out.String(in.ChartGenre);
+		out.String(in.ChartLyricsFileName);
+		out.Value(in.SongOffset);
+		out.Value(in.SongDemoStartTime);
+		out.String(in.SongFileName);
+		out.String(in.SongJacket);
+		out.Value(in.SongVolume);
+		out.Value(in.SoundEffectVolume);
+		out.String(in.BackgroundImageFileName);
+		out.String(in.BackgroundMovieFileName);
+		out.Value(in.MovieOffset);
+		out.StringMap(in.OtherMetadata);
+	}
+
+	static void ReadProjectProperties(PropertyReader& in, ChartProject& out)
+	{
+		in.Value(out.ChartDuration);
+		in.String(out.ChartTitle);
+		in.StringMap(out.ChartTitleLocalized);
+		in.String(out.ChartSubtitle);
+		in.StringMap(out.ChartSubtitleLocalized);
+		in.String(out.ChartCreator);
+		in.String(out.ChartGenre);
+		in.String(out.ChartLyricsFileName);
+		in.Value(out.SongOffset);
+		in.Value(out.SongDemoStartTime);
+		in.String(out.SongFileName);
+		in.String(out.SongJacket);
+		in.Value(out.SongVolume);
+		in.Value(out.SoundEffectVolume);
+		in.String(out.BackgroundImageFileName);
+		in.String(out.BackgroundMovieFileName);
+		in.Value(out.MovieOffset);
+		in.StringMap(out.OtherMetadata);
+	}
+
+	static void WriteCourseProperties(PropertyWriter out, const ChartCourse& in)
+	{
+		out.Value(in.Type);
+		out.Value(in.Level);
+		out.Value(in.Decimal);
+		out.Value(in.Style);
+		out.Value(in.PlayerSide);
+		out.String(in.CourseCreator);
+		out.Value(in.ScoreInit);
+		out.Value(in.ScoreDiff);
+		out.Value(in.Life);
+		out.Value(in.Side);
+		out.StringMap(in.OtherMetadata);
+		out.Value(in.TempoMap.AccelerationStructure.FirstTempoBPM);
+		out.Value(in.TempoMap.AccelerationStructure.LastTempoBPM);
+	}
+
+	static void ReadCourseProperties(PropertyReader& in, ChartCourse& out)
+	{
+		in.Value(out.Type);
+		in.Value(out.Level);
+		in.Value(out.Decimal);
+		in.Value(out.Style);
+		in.Value(out.PlayerSide);
+		in.String(out.CourseCreator);
+		in.Value(out.ScoreInit);
+		in.Value(out.ScoreDiff);
+		in.Value(out.Life);
+		in.Value(out.Side);
+		in.StringMap(out.OtherMetadata);
+		in.Value(out.TempoMap.AccelerationStructure.FirstTempoBPM);
+		in.Value(out.TempoMap.AccelerationStructure.LastTempoBPM);
+	}
+
+	void CreateChartPart(const ChartProject& chart, u64 chartContentHash, b8 hasPeepoDrumKitComment, ChartPartData& outChartPart)
+	{
+		ChartPartWriter writer;
+		writer.Properties(SectionType::ProjectProperties, 0, [&](PropertyWriter out) { WriteProjectProperties(out, chart); });
+
+		for (size_t i = 0; i < chart.Courses.size(); i++)
+		{
+			const ChartCourse& course = *chart.Courses[i];
+			const u32 courseIndex = static_cast<u32>(i);
+			writer.Properties(SectionType::CourseProperties, courseIndex, [&](PropertyWriter out) { WriteCourseProperties(out, course); });
+			writer.Array(SectionType::TempoChanges, courseIndex, course.TempoMap.Tempo.Sorted);
+			writer.Array(SectionType::SignatureChanges, courseIndex, course.TempoMap.Signature.Sorted);
+			writer.Array(SectionType::TempoSegments, courseIndex, course.TempoMap.AccelerationStructure.Segments);
+			writer.Array(SectionType::NotesNormal, courseIndex, course.Notes_Normal.Sorted);
+			writer.Array(SectionType::NotesExpert, courseIndex, course.Notes_Expert.Sorted);
+			writer.Array(SectionType::NotesMaster, courseIndex, course.Notes_Master.Sorted);
+			writer.Array(SectionType::ScrollChanges, courseIndex, course.ScrollChanges.Sorted);
+			writer.Array(SectionType::BarLineChanges, courseIndex, course.BarLineChanges.Sorted);
+			writer.Array(SectionType::GoGoRanges, courseIndex, course.GoGoRanges.Sorted);
+			writer.Array(SectionType::ScrollTypes, courseIndex, course.ScrollTypes.Sorted);
+			writer.Array(SectionType::JPOSScrollChanges, courseIndex, course.JPOSScrollChanges.Sorted);
+			writer.Properties(SectionType::Lyrics, courseIndex, [&](PropertyWriter out)
+			{
+				out.Value(static_cast<u32>(course.Lyrics.size()));
+				for (const LyricChange& lyric : course.Lyrics) { out.Value(lyric.BeatTime); out.String(lyric.Lyric); }
+			});
+		}
+
+		const ChartPartHeader header = { static_cast<u32>(writer.Sections.size()), static_cast<u32>(chart.Courses.size()), hasPeepoDrumKitComment, 0 };
+		const size_t dataOffset = sizeof(ChartPartHeader) + (writer.Sections.size() * sizeof(SectionHeader));
+		for (SectionHeader& section : writer.Sections)
+			section.Offset += dataOffset;
+
+		outChartPart.ChartContentHash = chartContentHash;
+		outChartPart.HasPeepoDrumKitComment = hasPeepoDrumKitComment;
+		outChartPart.Blob.clear();
+		outChartPart.Blob.reserve(dataOffset + writer.Data.size());
+		AppendBytes(outChartPart.Blob, &header, 1);
+		AppendBytes(outChartPart.Blob, writer.Sections.data(), writer.Sections.size());
+		AppendBytes(outChartPart.Blob, writer.Data.data(), writer.Data.size());
+	}
+
+	static const FileHeader* TryGetValidFileHeader(const File::MemoryMappedFile& cacheFile)
+	{
+		if (cacheFile.Content == nullptr || cacheFile.Size < sizeof(FileHeader))
+			return nullptr;
+
+		const FileHeader* header = reinterpret_cast<const FileHeader*>(cacheFile.Content);
+		if (::memcmp(header->Magic, FileMagic, sizeof(FileMagic)) != 0 || header->Version != Version || header->ConverterVersion != ConverterVersion)
+			return nullptr;
+		if (header->ChartPartOffset > cacheFile.Size || header->ChartPartSize > (cacheFile.Size - header->ChartPartOffset))
+			return nullptr;
+		if (header->WaveformPartOffset > cacheFile.Size || header->WaveformPartSize > (cacheFile.Size - header->WaveformPartOffset))
+			return nullptr;
+		return header;
+	}
+
+	template <typename T>
+	static b8 TryReadArraySection(const u8* partBegin, size_t partSize, const SectionHeader& section, std::vector<T>& out)
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		if (section.Offset > partSize || section.ItemCount > ((partSize - section.Offset) / sizeof(T)))
+			return false;
+
+		out.resize(static_cast<size_t>(section.ItemCount));
+		if (!out.empty())
+			::memcpy(out.data(), partBegin + section.Offset, out.size() * sizeof(T));
+		return true;
+	}
+
+	b8 TryReadChart(const File::MemoryMappedFile& cacheFile, u64 chartContentHash, ChartProject& outChart, ChartPartData& outChartPart)
+	{
+		const FileHeader* fileHeader = TryGetValidFileHeader(cacheFile);
+		if (fileHeader == nullptr || fileHeader->ChartContentHash != chartContentHash || fileHeader->ChartPartSize < sizeof(ChartPartHeader))
+			return false;
+
+		const u8* const partBegin = cacheFile.Content + fileHeader->ChartPartOffset;
+		const size_t partSize = static_cast<size_t>(fileHeader->ChartPartSize);
+		ChartPartHeader partHeader; ::memcpy(&partHeader, partBegin, sizeof(partHeader));
+		if (partHeader.SectionCount > ((partSize - sizeof(ChartPartHeader)) / sizeof(SectionHeader)))
+			return false;
+
+		ChartProject chart;
+		chart.Courses.reserve(partHeader.CourseCount);
+		for (u32 i = 0; i < partHeader.CourseCount; i++)
+			chart.Courses.push_back(std::make_unique<ChartCourse>());
+
+		for (u32 sectionIndex = 0; sectionIndex < partHeader.SectionCount; sectionIndex++)
+		{
+			SectionHeader section; ::memcpy(&section, partBegin + sizeof(ChartPartHeader) + (sectionIndex * sizeof(SectionHeader)), sizeof(section));
+			if (section.Type != SectionType::ProjectProperties && section.CourseIndex >= partHeader.CourseCount)
+				return false;
+
+			ChartCourse* course = (section.Type != SectionType::ProjectProperties) ? chart.Courses[section.CourseIndex].get() : nullptr;
+			b8 succeeded = true;
+			switch (section.Type)
+			{
+			case SectionType::TempoChanges: { succeeded = TryReadArraySection(partBegin, partSize, section, course->TempoMap.Tempo.Sorted); } break;
+			case SectionType::SignatureChanges: { succeeded = TryReadArraySection(partBegin, partSize, section, course->TempoMap.Signature.Sorted); } break;
+			case SectionType::TempoSegments: { succeeded = TryReadArraySection(partBegin, partSize, section, course->TempoMap.AccelerationStructure.Segments); } break;
+			case SectionType::NotesNormal: { succeeded = TryReadArraySection(partBegin, partSize, section, course->Notes_Normal.Sorted); } break;
+			case SectionType::NotesExpert: { succeeded = TryReadArraySection(partBegin, partSize, section, course->Notes_Expert.Sorted); } break;
+			case SectionType::NotesMaster: { succeeded = TryReadArraySection(partBegin, partSize, section, course->Notes_Master.Sorted); } break;
+			case SectionType::ScrollChanges: { succeeded = TryReadArraySection(partBegin, partSize, section, course->ScrollChanges.Sorted); } break;
+			case SectionType::BarLineChanges: { succeeded = TryReadArraySection(partBegin, partSize, section, course->BarLineChanges.Sorted); } break;
+			case SectionType::GoGoRanges: { succeeded = TryReadArraySection(partBegin, partSize, section, course->GoGoRanges.Sorted); } break;
+			case SectionType::ScrollTypes: { succeeded = TryReadArraySection(partBegin, partSize, section, course->ScrollTypes.Sorted); } break;
+			case SectionType::JPOSScrollChanges: { succeeded = TryReadArraySection(partBegin, partSize, section, course->JPOSScrollChanges.Sorted); } break;
+			case SectionType::ProjectProperties:
+			case SectionType::CourseProperties:
+			case SectionType::Lyrics:
+			{
+				if (section.Offset > partSize || section.ItemCount > (partSize - section.Offset))
+					return false;
+
+				PropertyReader reader = { partBegin + section.Offset, partBegin + section.Offset + section.ItemCount };
+				if (section.Type == SectionType::ProjectProperties)
+					ReadProjectProperties(reader, chart);
+				else if (section.Type == SectionType::CourseProperties)
+					ReadCourseProperties(reader, *course);
+				else
+				{
+					u32 lyricCount = 0; reader.Value(lyricCount);
+					for (u32 i = 0; i < lyricCount && !reader.Failed; i++)
+					{
+						LyricChange& lyric = course->Lyrics.Sorted.emplace_back();
+						reader.Value(lyric.BeatTime);
+						reader.String(lyric.Lyric);
+					}
+				}
+				succeeded = !reader.Failed;
+			} break;
+			default: { succeeded = false; } break;
+			}
+
+			if (!succeeded)
+				return false;
+		}
+
+		// NOTE: Only the derived temporary state is recalculated, which is trivial compared to parsing and converting
+		for (const auto& course : chart.Courses)
+		{
+			course->TempoMap.AccelerationStructure.SegmentCursorHint = 0;
+			course->RecalculateSENotes();
+		}
+
+		outChart = std::move(chart);
+		outChartPart.ChartContentHash = chartContentHash;
+		outChartPart.HasPeepoDrumKitComment = (partHeader.HasPeepoDrumKitComment != 0);
+		outChartPart.Blob.assign(partBegin, partBegin + partSize);
+		return true;
+	}
+
+	b8 TryReadWaveform(const File::MemoryMappedFile& cacheFile, u64 songContentHash, Audio::WaveformMipChain& outWaveformL, Audio::WaveformMipChain& outWaveformR)
+	{
+		const FileHeader* fileHeader = TryGetValidFileHeader(cacheFile);
+		if (fileHeader == nullptr || songContentHash == 0 || fileHeader->SongContentHash != songContentHash || fileHeader->WaveformPartSize < sizeof(WaveformPartHeader))
+			return false;
+
+		const u8* const partBegin = cacheFile.Content + fileHeader->WaveformPartOffset;
+		WaveformPartHeader partHeader; ::memcpy(&partHeader, partBegin, sizeof(partHeader));
+		const u64 maxBucketCount = ((fileHeader->WaveformPartSize - sizeof(WaveformPartHeader)) / sizeof(Audio::WaveformBucket));
+		if (partHeader.BucketCountL > maxBucketCount || partHeader.BucketCountR > (maxBucketCount - partHeader.BucketCountL))
+			return false;
+
+		const Audio::WaveformBucket* bucketsL = reinterpret_cast<const Audio::WaveformBucket*>(partBegin + sizeof(WaveformPartHeader));
+		const Audio::WaveformBucket* bucketsR = bucketsL + partHeader.BucketCountL;
+
+		Audio::WaveformMipChain waveformL, waveformR;
+		if (!waveformL.RestoreIncrementalGeneration(partHeader.FrameCount, partHeader.SampleRate, bucketsL, static_cast<size_t>(partHeader.BucketCountL)))
+			return false;
+		if (partHeader.BucketCountR > 0 && !waveformR.RestoreIncrementalGeneration(partHeader.FrameCount, partHeader.SampleRate, bucketsR, static_cast<size_t>(partHeader.BucketCountR)))
+			return false;
+
+		outWaveformL = std::move(waveformL);
+		outWaveformR = std::move(waveformR);
+		return true;
+	}
+
+	b8 WriteCacheFile(std::string_view cacheFilePath, const ChartPartData& chartPart, u64 songContentHash, i64 songFrameCount, u32 songSampleRate,
+		const Audio::WaveformMipChain& waveformL, const Audio::WaveformMipChain& waveformR)
+	{
+		const b8 includeWaveform = (songContentHash != 0 && !waveformL.IsEmpty());
+		const size_t bucketCountL = includeWaveform ? waveformL.GetBucketArenaCount() : 0;
+		const size_t bucketCountR = (includeWaveform && !waveformR.IsEmpty()) ? waveformR.GetBucketArenaCount() : 0;
+
+		FileHeader header = {};
+		::memcpy(header.Magic, FileMagic, sizeof(FileMagic));
+		header.Version = Version;
+		header.ConverterVersion = ConverterVersion;
+		header.ChartContentHash = chartPart.ChartContentHash;
+		header.ChartPartOffset = sizeof(FileHeader);
+		header.ChartPartSize = chartPart.Blob.size();
+		header.SongContentHash = includeWaveform ? songContentHash : 0;
+		header.WaveformPartOffset = (header.ChartPartOffset + ((header.ChartPartSize + 7) & ~static_cast<u64>(7)));
+		header.WaveformPartSize = includeWaveform ? (sizeof(WaveformPartHeader) + ((bucketCountL + bucketCountR) * sizeof(Audio::WaveformBucket))) : 0;
+
+		std::vector<u8> fileContent;
+		fileContent.reserve(static_cast<size_t>(header.WaveformPartOffset + header.WaveformPartSize));
+		AppendBytes(fileContent, &header, 1);
+		AppendBytes(fileContent, chartPart.Blob.data(), chartPart.Blob.size());
+		AlignTo8(fileContent);
+		if (includeWaveform)
+		{
+			const WaveformPartHeader partHeader = { songFrameCount, songSampleRate, 0, bucketCountL, bucketCountR };
+			AppendBytes(fileContent, &partHeader, 1);
+			AppendBytes(fileContent, waveformL.GetBucketArena(), bucketCountL);
+			AppendBytes(fileContent, waveformR.GetBucketArena(), bucketCountR);
+		}
+
+		return File::WriteAllBytesAtomic(cacheFilePath, fileContent.data(), fileContent.size());
+	}
+}
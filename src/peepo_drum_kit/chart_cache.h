@@ -0,0 +1,46 @@
+#pragma once
+#include "core_types.h"
+#include "core_io.h"
+#include "chart.h"
+#include "audio/audio_waveform.h"
+
+namespace PeepoDrumKit
+{
+	// NOTE: Optional sidecar file stored next to a chart for reopening it without having to decode, tokenize, parse and convert the .tja
+	//		 (nor decode the entire song again to generate its waveform) every single time.
+	//
+	//		 The file consists of two independent parts, each validated by the content hash of the file it was created from:
+	//		 The "chart part" holding the converted chart with all event lists of each course (and its tempo map segments) stored as flat arrays of trivially copyable items,
+	//		 and the "waveform part" holding the bucket arenas of both waveform mip chains of the song, with the layout of each mip being derived from the song frame count and sample rate.
+	//		 The chart part is kept around as an opaque blob after opening a chart so that the file can be rewritten as a whole once the waveform has been generated
+	namespace ChartCache
+	{
+		constexpr std::string_view Extension = ".pdkcache";
+
+		// NOTE: Must be incremented whenever the layout of the file or any of the types stored inside it change
+		constexpr u32 Version = 1;
+
+		// NOTE: Must be incremented whenever a change to the .tja import (or the waveform generation) changes its result even with the layout staying the same,
+		//		 as charts would otherwise keep being opened from caches created by an older build
+		constexpr u32 ConverterVersion = 1;
+
+		inline std::string GetCacheFilePath(std::string_view chartFilePath) { return std::string(chartFilePath).append(Extension); }
+
+		struct ChartPartData
+		{
+			u64 ChartContentHash;
+			b8 HasPeepoDrumKitComment;
+			std::vector<u8> Blob;
+		};
+
+		// NOTE: Both fail (without touching the outputs) if the cache file is of a different (converter) version or was created from a file with different content
+		b8 TryReadChart(const File::MemoryMappedFile& cacheFile, u64 chartContentHash, ChartProject& outChart, ChartPartData& outChartPart);
+		b8 TryReadWaveform(const File::MemoryMappedFile& cacheFile, u64 songContentHash, Audio::WaveformMipChain& outWaveformL, Audio::WaveformMipChain& outWaveformR);
+
+		void CreateChartPart(const ChartProject& chart, u64 chartContentHash, b8 hasPeepoDrumKitComment, ChartPartData& outChartPart);
+
+		// NOTE: The waveform part is left out if the song content hash is zero (for charts without a song)
+		b8 WriteCacheFile(std::string_view cacheFilePath, const ChartPartData& chartPart, u64 songContentHash, i64 songFrameCount, u32 songSampleRate,
+			const Audio::WaveformMipChain& waveformL, const Audio::WaveformMipChain& waveformR);
+	}
+}
@@ -86,6 +86,7 @@ namespace PeepoDrumKit
 
 	ChartEditor::~ChartEditor()
 	{
+		if (saveChartFuture.valid()) saveChartFuture.get();
 		context.SfxVoicePool.UnloadAllSourcesAndVoices();
 	}
 
@@ -138,6 +139,8 @@ namespace PeepoDrumKit
 				if (Gui::MenuItem(UI_Str("ACT_EDIT_SAVE"), ToShortcutString(*Settings.Input.Editor_ChartSave).Data)) { TrySaveChartOrOpenSaveAsDialog(context); }
 				if (Gui::MenuItem(UI_Str("ACT_FILE_SAVE_AS"), ToShortcutString(*Settings.Input.Editor_ChartSaveAs).Data)) { OpenChartSaveAsDialog(context); }
 				Gui::Separator();
+				if (Gui::MenuItem(UI_Str("ACT_FILE_EXPORT_PREVIEW_MIX"))) { OpenExportPreviewMixDialog(context); }
+				Gui::Separator();
 				if (Gui::MenuItem(UI_Str("ACT_FILE_EXIT"), ToShortcutString(InputBinding(ImGuiKey_F4, ImGuiMod_Alt)).Data))
 					tryToCloseApplicationOnNextFrame = true;
 				Gui::EndMenu();
@@ -830,6 +833,11 @@ namespace PeepoDrumKit
 						const Rect overlayTextRect = Rect::FromTLSize(plotLinesRect.GetCenter() - (overlayTextSize * 0.5f) - vec2(0.0f, plotLinesRect.GetHeight() / 4.0f), overlayTextSize);
 						Gui::GetWindowDrawList()->AddRectFilled(overlayTextRect.TL - vec2(2.0f), overlayTextRect.BR + vec2(2.0f), Gui::GetColorU32(ImGuiCol_WindowBg, 0.5f));
 						Gui::AddTextWithDropShadow(Gui::GetWindowDrawList(), overlayTextRect.TL, Gui::GetColorU32(ImGuiCol_Text), overlayText, 0xFF111111);
+
+						if (const auto& timing = performance.LastChartOpen; timing.HasValue)
+							Gui::TextDisabled("%s%.3f ms (%s)", UI_Str("INFO_OPEN_TIME_CHART"), timing.Duration.ToMS(), timing.FromCache ? UI_Str("INFO_OPEN_TIME_WARM") : UI_Str("INFO_OPEN_TIME_COLD"));
+						if (const auto& timing = performance.LastWaveformLoad; timing.HasValue)
+							Gui::TextDisabled("%s%.3f ms (%s)", UI_Str("INFO_OPEN_TIME_WAVEFORM"), timing.Duration.ToMS(), timing.FromCache ? UI_Str("INFO_OPEN_TIME_WARM") : UI_Str("INFO_OPEN_TIME_COLD"));
 					}
 					Gui::End();
 
@@ -844,13 +852,19 @@ namespace PeepoDrumKit
 	void ChartEditor::DrawGui()
 	{
 		InternalUpdateAsyncLoading();
+		UpdateAutosave();
 
 		if (tryToCloseApplicationOnNextFrame)
 		{
 			tryToCloseApplicationOnNextFrame = false;
 			CheckOpenSaveConfirmationPopupThenCall([&]
 			{
+				// NOTE: Don't exit without the changes that have just been "saved" if writing them out failed after all
+				if (!WaitForAsyncSavingChart())
+					return;
+
 				if (loadSongFuture.valid()) loadSongFuture.get();
+				if (loadSongWaveformFuture.valid()) loadSongWaveformFuture.get();
 				if (loadJacketFuture.valid()) loadJacketFuture.get();
 				if (importChartFuture.valid()) importChartFuture.get();
 				context.Undo.ClearAll();
@@ -1150,9 +1164,8 @@ namespace PeepoDrumKit
 						// DEBUG: TJA bug hunting
 						if (exportDebugViewData.RoundTripCheck)
 						{
-							std::vector<TJA::Token> tempTokens = TJA::TokenizeLines(TJA::SplitLines(exportDebugViewData.Text));
 							TJA::ErrorList tempErrors;
-							TJA::ParsedTJA tempTJA = TJA::ParseTokens(tempTokens, tempErrors);
+							TJA::ParsedTJA tempTJA = TJA::ParseFileContent(exportDebugViewData.Text, tempErrors);
 							exportDebugViewData.DebugChart = {}; CreateChartProjectFromTJA(tempTJA, exportDebugViewData.DebugChart); exportDebugViewData.DebugLog.clear();
 							DebugCompareCharts(context.Chart, exportDebugViewData.DebugChart, [](std::string_view message, void*) { exportDebugViewData.DebugLog += message; exportDebugViewData.DebugLog += '\n'; });
 						}
@@ -1342,11 +1355,14 @@ namespace PeepoDrumKit
 
 		if (context.Undo.HasPendingChanges)
 			ApplicationHost::GlobalState.SetWindowTitleNextFrame += "*";
+		if (saveChartFuture.valid())
+			ApplicationHost::GlobalState.SetWindowTitleNextFrame += " (Saving...)";
 	}
 
 	void ChartEditor::CreateNewChart(ChartContext& context)
 	{
 		if (loadSongFuture.valid()) loadSongFuture.get();
+		if (loadSongWaveformFuture.valid()) loadSongWaveformFuture.get();
 		if (!context.SongSourceFilePath.empty()) StartAsyncLoadingSongAudioFile("");
 		if (loadJacketFuture.valid()) loadJacketFuture.get();
 		if (!context.SongJacketFilePath.empty()) StartAsyncLoadingSongJacketFile("");
@@ -1354,6 +1370,8 @@ namespace PeepoDrumKit
 		InternalUpdateAsyncLoading();
 
 		createBackupOfOriginalTJABeforeOverwriteSave = false;
+		chartCachePart = nullptr;
+		isChartCachePartWritten = false;
 		context.Chart = {};
 		context.ChartFilePath.clear();
 		context.ResetChartsCompared();
@@ -1367,6 +1385,7 @@ namespace PeepoDrumKit
 		context.SetIsPlayback(false);
 		context.SetCursorBeat(Beat::Zero());
 		context.Undo.ClearAll();
+		autosave = {};
 
 		timeline.Camera.PositionTarget.x = TimelineCameraBaseScrollX;
 		timeline.Camera.ZoomTarget = vec2(1.0f);
@@ -1397,25 +1416,13 @@ namespace PeepoDrumKit
 		assert(!filePath.empty());
 		if (!filePath.empty())
 		{
-			TJA::ParsedTJA tja;
-			ConvertChartProjectToTJA(context.Chart, tja);
-			std::string tjaText;
-			TJA::ConvertParsedToText(tja, tjaText, TJA::Encoding::UTF8);
-
-			// TODO: Proper async file saving by copying in-memory
-			if (createBackupOfOriginalTJABeforeOverwriteSave)
-			{
-				static constexpr b8 overwriteExisting = false;
-				const std::string originalFileBackupPath { std::string(filePath).append(".bak") };
-
-				File::Copy(filePath, originalFileBackupPath, overwriteExisting);
-				createBackupOfOriginalTJABeforeOverwriteSave = false;
-			}
-
-			File::WriteAllBytes(filePath, tjaText);
+			StartAsyncSavingChart(context, filePath, false);
 
+			// NOTE: Already considered saved as of the snapshot, any edits made while the save is still in flight mark the chart as changed again as usual
 			context.ChartFilePath = filePath;
 			context.Undo.ClearChangesWereMade();
+			autosave.TimeSinceLastSave = {};
+			autosave.EditGenerationAtLastSave = context.Undo.EditGeneration;
 
 			PersistentApp.RecentFiles.Add(std::string { filePath });
 		}
@@ -1444,6 +1451,32 @@ namespace PeepoDrumKit
 		return true;
 	}
 
+	b8 ChartEditor::OpenExportPreviewMixDialog(ChartContext& context)
+	{
+		Shell::FileDialog fileDialog {};
+		fileDialog.InTitle = "Export Preview Mix";
+		fileDialog.InFileName = !context.ChartFilePath.empty() ? Path::GetFileName(context.ChartFilePath, false) : Path::TrimExtension(UntitledChartFileName);
+		fileDialog.InDefaultExtension = ".wav";
+		fileDialog.InFilters = { { "WAV Files", "*.wav" }, { Shell::AllFilesFilterName, Shell::AllFilesFilterSpec }, };
+		fileDialog.InParentWindowHandle = ApplicationHost::GlobalState.NativeWindowHandle;
+
+		if (fileDialog.OpenSave() != Shell::FileDialogResult::OK)
+			return false;
+
+		CPUStopwatch exportStopwatch = CPUStopwatch::StartNew();
+		const b8 exportSuccess = timeline.ExportPreviewMix(context, fileDialog.OutFilePath);
+		if (exportSuccess)
+		{
+			printf("Exported preview mix to '%.*s' in %.2f ms\n", FmtStrViewArgs(fileDialog.OutFilePath), exportStopwatch.Stop().ToMS());
+		}
+		else
+		{
+			const std::string message = std::string("Failed to export preview mix:\n").append(fileDialog.OutFilePath);
+			Shell::ShowMessageBox(message, "Peepo Drum Kit - Export Error", Shell::MessageBoxButtons::OK, Shell::MessageBoxIcon::Error, ApplicationHost::GlobalState.NativeWindowHandle);
+		}
+		return exportSuccess;
+	}
+
 	b8 ChartEditor::TrySaveChartOrOpenSaveAsDialog(ChartContext& context)
 	{
 		if (context.ChartFilePath.empty())
@@ -1453,16 +1486,110 @@ namespace PeepoDrumKit
 		return true;
 	}
 
+	void ChartEditor::StartAsyncSavingChart(ChartContext& context, std::string_view absoluteChartFilePath, b8 isAutosave)
+	{
+		// NOTE: Only ever have a single save in flight so that an older snapshot can never end up overwriting a newer one
+		WaitForAsyncSavingChart();
+
+		// NOTE: Copying the chart is cheap compared to converting and formatting it, which is all left to the background thread
+		auto chartSnapshot = std::make_shared<ChartProject>();
+		CopyChartProject(context.Chart, *chartSnapshot);
+
+		const b8 createBackupOfOriginal = (createBackupOfOriginalTJABeforeOverwriteSave && !isAutosave);
+		if (createBackupOfOriginal)
+			createBackupOfOriginalTJABeforeOverwriteSave = false;
+
+		saveChartFuture = std::async(std::launch::async, [chartSnapshot, tempPathCopy = std::string(absoluteChartFilePath), isAutosave, createBackupOfOriginal]() mutable->AsyncSaveChartResult
+		{
+			AsyncSaveChartResult result {};
+			result.ChartFilePath = std::move(tempPathCopy);
+			result.IsAutosave = isAutosave;
+
+			TJA::ParsedTJA tja;
+			ConvertChartProjectToTJA(*chartSnapshot, tja);
+			std::string tjaText;
+			TJA::ConvertParsedToText(tja, tjaText, TJA::Encoding::UTF8);
+
+			if (createBackupOfOriginal)
+			{
+				static constexpr b8 overwriteExisting = false;
+				const std::string originalFileBackupPath { std::string(result.ChartFilePath).append(".bak") };
+
+				File::Copy(result.ChartFilePath, originalFileBackupPath, overwriteExisting);
+			}
+
+			result.Succeeded = File::WriteAllBytesAtomic(result.ChartFilePath, tjaText);
+			return result;
+		});
+	}
+
+	b8 ChartEditor::WaitForAsyncSavingChart()
+	{
+		if (!saveChartFuture.valid())
+			return true;
+
+		const AsyncSaveChartResult saveResult = saveChartFuture.get();
+		OnAsyncSavingChartFinished(saveResult);
+		return (saveResult.Succeeded || saveResult.IsAutosave);
+	}
+
+	void ChartEditor::OnAsyncSavingChartFinished(const AsyncSaveChartResult& saveResult)
+	{
+		if (saveResult.Succeeded)
+			return;
+
+		// NOTE: Try again next interval instead of waiting for yet another change to be made
+		if (saveResult.IsAutosave)
+		{
+			autosave.EditGenerationAtLastSave.reset();
+			return;
+		}
+
+		// NOTE: The changes were marked as saved as soon as the snapshot was taken, so they have to be marked as unsaved again
+		if (saveResult.ChartFilePath == context.ChartFilePath)
+			context.Undo.NotifyChangesWereMade();
+
+		const std::string message = std::string("Failed to save chart file:\n").append(saveResult.ChartFilePath);
+		Shell::ShowMessageBox(message, "Peepo Drum Kit - Save Error", Shell::MessageBoxButtons::OK, Shell::MessageBoxIcon::Error, ApplicationHost::GlobalState.NativeWindowHandle);
+	}
+
+	void ChartEditor::UpdateAutosave()
+	{
+		autosave.TimeSinceLastSave += Time::FromSec(Gui::GetIO().DeltaTime);
+
+		const i32 intervalMinutes = *Settings.General.AutosaveIntervalMinutes;
+		if (intervalMinutes <= 0 || autosave.TimeSinceLastSave < Time::FromMin(static_cast<f64>(intervalMinutes)))
+			return;
+
+		// NOTE: Never block a frame waiting for a previous save, simply check again next frame instead
+		if (saveChartFuture.valid())
+			return;
+
+		autosave.TimeSinceLastSave = {};
+		if (!context.Undo.HasPendingChanges || context.Undo.EditGeneration == autosave.EditGenerationAtLastSave)
+			return;
+
+		// NOTE: Written next to the chart (or the executable for charts that haven't been saved yet) and never on top of the chart file itself
+		const std::string autosaveFilePath = !context.ChartFilePath.empty() ?
+			std::string(context.ChartFilePath).append(".autosave") :
+			Directory::GetExecutableDirectory().append("/").append(UntitledChartFileName).append(".autosave");
+
+		autosave.EditGenerationAtLastSave = context.Undo.EditGeneration;
+		StartAsyncSavingChart(context, autosaveFilePath, true);
+	}
+
 	void ChartEditor::StartAsyncImportingChartFile(std::string_view absoluteChartFilePath)
 	{
+		WaitForAsyncSavingChart();
 		if (importChartFuture.valid())
 			importChartFuture.get();
 
 		PersistentApp.RecentFiles.Add(std::string { absoluteChartFilePath });
-		importChartFuture = std::async(std::launch::async, [tempPathCopy = std::string(absoluteChartFilePath)]() mutable->AsyncImportChartResult
+		importChartFuture = std::async(std::launch::async, [tempPathCopy = std::string(absoluteChartFilePath), useChartCache = *Settings.General.UseChartCache]() mutable->AsyncImportChartResult
 		{
 			AsyncImportChartResult result {};
 			result.ChartFilePath = std::move(tempPathCopy);
+			CPUStopwatch stopwatch = CPUStopwatch::StartNew();
 
 			auto[fileContent, fileSize] = File::ReadAllBytes(result.ChartFilePath);
 			if (fileContent == nullptr || fileSize == 0)
@@ -1473,15 +1600,27 @@ namespace PeepoDrumKit
 
 			assert(Path::HasExtension(result.ChartFilePath, TJA::Extension));
 
+			const u64 contentHash = useChartCache ? File::HashContent(fileContent.get(), fileSize) : 0;
+			const std::string cacheFilePath = ChartCache::GetCacheFilePath(result.ChartFilePath);
+			if (useChartCache)
+			{
+				const File::MemoryMappedFile cacheFile = File::MapReadOnly(cacheFilePath);
+				if (ChartCache::TryReadChart(cacheFile, contentHash, result.Chart, result.CachePart))
+				{
+					result.HasPeepoDrumKitComment = result.CachePart.HasPeepoDrumKitComment;
+					result.LoadedFromCache = true;
+					result.LoadDuration = stopwatch.Stop();
+					return result;
+				}
+			}
+
 			const std::string_view fileContentView = std::string_view(reinterpret_cast<const char*>(fileContent.get()), fileSize);
 			if (UTF8::HasBOM(fileContentView))
 				result.TJA.FileContentUTF8 = UTF8::TrimBOM(fileContentView);
 			else
 				result.TJA.FileContentUTF8 = UTF8::FromShiftJIS(fileContentView);
 
-			result.TJA.Lines = TJA::SplitLines(result.TJA.FileContentUTF8);
-			result.TJA.Tokens = TJA::TokenizeLines(result.TJA.Lines);
-			result.TJA.Parsed = ParseTokens(result.TJA.Tokens, result.TJA.ParseErrors);
+			result.TJA.Parsed = TJA::ParseFileContent(result.TJA.FileContentUTF8, result.TJA.ParseErrors);
 
 			if (!CreateChartProjectFromTJA(result.TJA.Parsed, result.Chart))
 			{
@@ -1489,6 +1628,18 @@ namespace PeepoDrumKit
 				return result;
 			}
 
+			result.HasPeepoDrumKitComment = result.TJA.Parsed.HasPeepoDrumKitComment;
+			result.LoadDuration = stopwatch.Stop();
+
+			if (useChartCache)
+			{
+				ChartCache::CreateChartPart(result.Chart, contentHash, result.HasPeepoDrumKitComment, result.CachePart);
+
+				// NOTE: Otherwise only written once the song waveform has finished loading, which never happens for charts without a song
+				if (result.Chart.SongFileName.empty())
+					ChartCache::WriteCacheFile(cacheFilePath, result.CachePart, 0, 0, 0, Audio::WaveformMipChain {}, Audio::WaveformMipChain {});
+			}
+
 			return result;
 		});
 	}
@@ -1521,7 +1672,7 @@ namespace PeepoDrumKit
 
 		context.SongWaveformFadeAnimationTarget = 0.0f;
 		loadSongStopwatch.Restart();
-		loadSongFuture = std::async(std::launch::async, [tempPathCopy = std::string(absoluteAudioFilePath)]()->AsyncLoadSongResult
+		loadSongFuture = std::async(std::launch::async, [tempPathCopy = std::string(absoluteAudioFilePath), useChartCache = *Settings.General.UseChartCache]()->AsyncLoadSongResult
 		{
 			AsyncLoadSongResult result {};
 			result.SongFilePath = std::move(tempPathCopy);
@@ -1537,20 +1688,88 @@ namespace PeepoDrumKit
 				return result;
 			}
 
-			if (Audio::DecodeEntireFile(result.SongFilePath, fileContent.get(), fileSize, result.SampleBuffer) != Audio::DecodeFileResult::FeelsGoodMan)
+			// NOTE: Only opening the file to validate it and read its format, the actual decoding happens on demand while streaming
+			Audio::StreamingDecoder decoder;
+			if (decoder.OpenMemory(result.SongFilePath, fileContent.get(), fileSize) != Audio::DecodeFileResult::FeelsGoodMan)
 			{
 				printf("Failed to decode audio file '%.*s'\n", FmtStrViewArgs(result.SongFilePath));
 				return result;
 			}
 
-			// HACK: ...
-			if (result.SampleBuffer.SampleRate != Audio::Engine.OutputSampleRate)
-				Audio::LinearlyResampleBuffer<i16>(result.SampleBuffer.InterleavedSamples, result.SampleBuffer.FrameCount, result.SampleBuffer.SampleRate, result.SampleBuffer.ChannelCount, Audio::Engine.OutputSampleRate);
+			result.SampleRate = decoder.GetSampleRate();
+			result.FrameCount = decoder.GetFrameCount();
+			// NOTE: Only needed for validating the waveform part of the chart cache, with a hash of zero meaning none is read or written
+			result.ContentHash = useChartCache ? File::HashContent(fileContent.get(), fileSize) : 0;
 
-			if (result.SampleBuffer.ChannelCount > 0) result.WaveformL.GenerateEntireMipChainFromSampleBuffer(result.SampleBuffer, 0);
-#if !PEEPO_DEBUG // NOTE: Always ignore the second channel in debug builds for performance reasons!
-			if (result.SampleBuffer.ChannelCount > 1) result.WaveformR.GenerateEntireMipChainFromSampleBuffer(result.SampleBuffer, 1);
-#endif
+			result.FileContent = std::move(fileContent);
+			result.FileSize = fileSize;
+			return result;
+		});
+	}
+
+	static b8 GenerateSongWaveform(AsyncLoadSongWaveformResult& out, const void* fileContent, size_t fileSize)
+	{
+		// NOTE: Decoding separately from the one being streamed from so that only a single chunk is ever decoded at a time
+		Audio::StreamingDecoder decoder;
+		if (decoder.OpenMemory(out.SongFilePath, fileContent, fileSize) != Audio::DecodeFileResult::FeelsGoodMan)
+			return false;
+
+		const u32 channelCount = decoder.GetChannelCount();
+		const b8 generateWaveformR = (channelCount > 1);
+
+		out.WaveformL.BeginIncrementalGeneration(decoder.GetFrameCount(), decoder.GetSampleRate());
+		if (generateWaveformR) out.WaveformR.BeginIncrementalGeneration(decoder.GetFrameCount(), decoder.GetSampleRate());
+
+		static constexpr i64 chunkFrameCount = 16384;
+		static_assert(chunkFrameCount % 2 == 0);
+		auto chunkSamples = std::make_unique<i16[]>(chunkFrameCount * channelCount);
+		for (i64 framesRead; (framesRead = decoder.ReadFrames(chunkSamples.get(), chunkFrameCount)) > 0;)
+		{
+			if (channelCount == 2)
+			{
+				Audio::WaveformMipChain::AppendIncrementalStereoFrames(out.WaveformL, out.WaveformR, chunkSamples.get(), framesRead);
+			}
+			else
+			{
+				out.WaveformL.AppendIncrementalFrames(chunkSamples.get(), framesRead, channelCount, 0);
+				if (generateWaveformR) out.WaveformR.AppendIncrementalFrames(chunkSamples.get(), framesRead, channelCount, 1);
+			}
+		}
+
+		if (generateWaveformR)
+			Audio::WaveformMipChain::EndIncrementalStereoGeneration(out.WaveformL, out.WaveformR);
+		else
+			out.WaveformL.EndIncrementalGeneration();
+		return true;
+	}
+
+	void ChartEditor::StartAsyncLoadingSongWaveform(const AsyncLoadSongResult& loadResult)
+	{
+		if (loadSongWaveformFuture.valid())
+			loadSongWaveformFuture.get();
+
+		const b8 useChartCache = (*Settings.General.UseChartCache && chartCachePart != nullptr && !context.ChartFilePath.empty());
+		loadSongWaveformFuture = std::async(std::launch::async, [songFilePath = loadResult.SongFilePath, fileContent = loadResult.FileContent, fileSize = loadResult.FileSize,
+			songContentHash = loadResult.ContentHash, songFrameCount = loadResult.FrameCount, songSampleRate = loadResult.SampleRate,
+			useChartCache, cacheFilePath = useChartCache ? ChartCache::GetCacheFilePath(context.ChartFilePath) : std::string {}, chartPart = chartCachePart, isChartPartWritten = isChartCachePartWritten]()->AsyncLoadSongWaveformResult
+		{
+			AsyncLoadSongWaveformResult result {};
+			result.SongFilePath = songFilePath;
+			CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+
+			if (useChartCache)
+			{
+				const File::MemoryMappedFile cacheFile = File::MapReadOnly(cacheFilePath);
+				result.LoadedFromCache = ChartCache::TryReadWaveform(cacheFile, songContentHash, result.WaveformL, result.WaveformR);
+			}
+
+			if (!result.LoadedFromCache && !GenerateSongWaveform(result, fileContent.get(), fileSize))
+				return result;
+			result.LoadDuration = stopwatch.Stop();
+
+			// NOTE: Rewriting the whole file (with the chart part from when the chart was opened) if either part is missing or outdated
+			if (useChartCache && (!result.LoadedFromCache || !isChartPartWritten) && !result.WaveformL.IsEmpty())
+				result.WroteCacheFile = ChartCache::WriteCacheFile(cacheFilePath, *chartPart, songContentHash, songFrameCount, songSampleRate, result.WaveformL, result.WaveformR);
 
 			return result;
 		});
@@ -1658,6 +1877,9 @@ namespace PeepoDrumKit
 		context.Gfx.UpdateAsyncLoading();
 		context.SfxVoicePool.UpdateAsyncLoading();
 
+		if (saveChartFuture.valid() && saveChartFuture._Is_ready())
+			OnAsyncSavingChartFinished(saveChartFuture.get());
+
 		if (importChartFuture.valid() && importChartFuture._Is_ready())
 		{
 			const Time previousChartSongOffset = context.Chart.SongOffset;
@@ -1665,7 +1887,12 @@ namespace PeepoDrumKit
 			AsyncImportChartResult loadResult = importChartFuture.get();
 
 			// TODO: Maybe also do date version check (?)
-			createBackupOfOriginalTJABeforeOverwriteSave = !loadResult.TJA.Parsed.HasPeepoDrumKitComment;
+			createBackupOfOriginalTJABeforeOverwriteSave = !loadResult.HasPeepoDrumKitComment;
+
+			// NOTE: Must be set before starting to load the song so that its waveform can be written to the cache file together with the chart part
+			chartCachePart = loadResult.CachePart.Blob.empty() ? nullptr : std::make_shared<const ChartCache::ChartPartData>(std::move(loadResult.CachePart));
+			isChartCachePartWritten = (loadResult.LoadedFromCache || loadResult.Chart.SongFileName.empty());
+			performance.LastChartOpen = { true, loadResult.LoadedFromCache, loadResult.LoadDuration };
 
 			context.Chart = std::move(loadResult.Chart);
 			context.ChartFilePath = std::move(loadResult.ChartFilePath);
@@ -1683,6 +1910,7 @@ namespace PeepoDrumKit
 				context.SetCursorTime(context.GetCursorTime() + (previousChartSongOffset - context.Chart.SongOffset));
 
 			context.Undo.ClearAll();
+			autosave = {};
 		}
 
 		// NOTE: Just in case there is something wrong with the animation, that could otherwise prevent the song from finishing to load
@@ -1693,27 +1921,48 @@ namespace PeepoDrumKit
 		{
 			loadSongStopwatch.Stop();
 			AsyncLoadSongResult loadResult = loadSongFuture.get();
-			context.SongSourceFilePath = std::move(loadResult.SongFilePath);
-			context.SongWaveformL = std::move(loadResult.WaveformL);
-			context.SongWaveformR = std::move(loadResult.WaveformR);
-			context.SongWaveformFadeAnimationTarget = context.SongWaveformL.IsEmpty() ? 0.0f : 1.0f;
+			context.SongSourceFilePath = loadResult.SongFilePath;
+			context.SongWaveformL = {};
+			context.SongWaveformR = {};
+			context.SongWaveformFadeAnimationTarget = 0.0f;
 
 			// TODO: Maybe handle this differently...
 			if (context.Chart.ChartTitle.empty() && !context.SongSourceFilePath.empty())
 				context.Chart.ChartTitle = Path::GetFileName(context.SongSourceFilePath, false);
 
-			if (context.Chart.ChartDuration.Seconds <= 0.0 && loadResult.SampleBuffer.SampleRate > 0)
-				context.Chart.ChartDuration = Audio::FramesToTime(loadResult.SampleBuffer.FrameCount, loadResult.SampleBuffer.SampleRate);
+			if (context.Chart.ChartDuration.Seconds <= 0.0 && loadResult.SampleRate > 0)
+				context.Chart.ChartDuration = Audio::FramesToTime(loadResult.FrameCount, loadResult.SampleRate);
 
 			if (context.SongSource != Audio::SourceHandle::Invalid)
 				Audio::Engine.UnloadSource(context.SongSource);
 
-			context.SongSource = Audio::Engine.LoadSourceFromBufferMove(Path::GetFileName(context.SongSourceFilePath), std::move(loadResult.SampleBuffer));
+			context.SongSource = (loadResult.FileContent != nullptr) ? Audio::Engine.LoadStreamingSourceFromFileContent(Path::GetFileName(context.SongSourceFilePath), loadResult.FileContent, loadResult.FileSize) : Audio::SourceHandle::Invalid;
 			context.SongVoice.SetSource(context.SongSource);
 
+			if (loadResult.FileContent != nullptr)
+				StartAsyncLoadingSongWaveform(loadResult);
+
 			Audio::Engine.EnsureStreamRunning();
 		}
 
+		if (loadSongWaveformFuture.valid() && loadSongWaveformFuture._Is_ready())
+		{
+			AsyncLoadSongWaveformResult loadResult = loadSongWaveformFuture.get();
+
+			// NOTE: Another song might have been loaded in the meantime
+			if (loadResult.SongFilePath == context.SongSourceFilePath)
+			{
+				context.SongWaveformL = std::move(loadResult.WaveformL);
+				context.SongWaveformR = std::move(loadResult.WaveformR);
+				context.SongWaveformFadeAnimationTarget = context.SongWaveformL.IsEmpty() ? 0.0f : 1.0f;
+				if (!context.SongWaveformL.IsEmpty())
+					performance.LastWaveformLoad = { true, loadResult.LoadedFromCache, loadResult.LoadDuration };
+			}
+
+			if (loadResult.WroteCacheFile)
+				isChartCachePartWritten = true;
+		}
+
 		if (loadJacketFuture.valid() && loadJacketFuture._Is_ready())
 		{
 			AsyncLoadJacketResult loadResult = loadJacketFuture.get();
@@ -2,6 +2,7 @@
 #include "core_types.h"
 #include "core_string.h"
 #include "chart.h"
+#include "chart_cache.h"
 #include "chart_editor_context.h"
 #include "chart_editor_widgets.h"
 #include "chart_editor_settings_gui.h"
@@ -18,22 +19,39 @@ namespace PeepoDrumKit
 	{
 		std::string ChartFilePath;
 		ChartProject Chart;
+		b8 HasPeepoDrumKitComment;
+
+		// NOTE: Only filled in when the chart cache is enabled, with the chart having been either read from it or just converted to be written to it later on
+		ChartCache::ChartPartData CachePart;
+		b8 LoadedFromCache;
+		Time LoadDuration;
 
 		struct TJATempData
 		{
 			std::string FileContentUTF8;
-			std::vector<std::string_view> Lines;
-			std::vector<TJA::Token> Tokens;
 			TJA::ParsedTJA Parsed;
 			TJA::ErrorList ParseErrors;
 		} TJA;
 	};
 
+	// NOTE: Only the (still encoded) file content, which is then streamed from as soon as possible with the waveform being generated separately in the background
 	struct AsyncLoadSongResult
 	{
 		std::string SongFilePath;
-		Audio::PCMSampleBuffer SampleBuffer;
+		std::shared_ptr<const u8[]> FileContent;
+		size_t FileSize;
+		u64 ContentHash;
+		u32 SampleRate;
+		i64 FrameCount;
+	};
+
+	struct AsyncLoadSongWaveformResult
+	{
+		std::string SongFilePath;
 		Audio::WaveformMipChain WaveformL, WaveformR;
+		b8 LoadedFromCache;
+		b8 WroteCacheFile;
+		Time LoadDuration;
 	};
 
 	struct AsyncLoadJacketResult
@@ -41,6 +59,14 @@ namespace PeepoDrumKit
 		std::string JacketFilePath;
 	};
 
+	// NOTE: Converted, formatted and written on a background thread from a snapshot of the chart taken at the time of saving
+	struct AsyncSaveChartResult
+	{
+		std::string ChartFilePath;
+		b8 IsAutosave;
+		b8 Succeeded;
+	};
+
 	struct ChartEditor
 	{
 	public:
@@ -61,9 +87,15 @@ namespace PeepoDrumKit
 		void SaveChart(ChartContext& context, std::string_view filePath = "");
 		b8 OpenChartSaveAsDialog(ChartContext& context);
 		b8 TrySaveChartOrOpenSaveAsDialog(ChartContext& context);
+		b8 OpenExportPreviewMixDialog(ChartContext& context);
+		void StartAsyncSavingChart(ChartContext& context, std::string_view absoluteChartFilePath, b8 isAutosave);
+		b8 WaitForAsyncSavingChart();
+		void OnAsyncSavingChartFinished(const AsyncSaveChartResult& saveResult);
+		void UpdateAutosave();
 
 		void StartAsyncImportingChartFile(std::string_view absoluteChartFilePath);
 		void StartAsyncLoadingSongAudioFile(std::string_view absoluteAudioFilePath);
+		void StartAsyncLoadingSongWaveform(const AsyncLoadSongResult& loadResult);
 		void StartAsyncLoadingSongJacketFile(std::string_view absoluteJacketFilePath);
 		void SetAndStartLoadingChartSongFileName(std::string_view relativeOrAbsoluteAudioFilePath, Undo::UndoHistory& undo);
 		void SetAndStartLoadingSongJacketFileName(std::string_view relativeOrAbsoluteAudioFilePath, Undo::UndoHistory& undo);
@@ -82,8 +114,14 @@ namespace PeepoDrumKit
 
 		std::future<AsyncImportChartResult> importChartFuture {};
 		std::future<AsyncLoadSongResult> loadSongFuture {};
+		std::future<AsyncLoadSongWaveformResult> loadSongWaveformFuture {};
 		std::future<AsyncLoadJacketResult> loadJacketFuture {};
+		std::future<AsyncSaveChartResult> saveChartFuture {};
 		CPUStopwatch loadSongStopwatch = {};
+
+		// NOTE: Chart part of the cache of the currently opened chart, to be written together with the song waveform once it has finished loading
+		std::shared_ptr<const ChartCache::ChartPartData> chartCachePart = {};
+		b8 isChartCachePartWritten = false;
 		b8 createBackupOfOriginalTJABeforeOverwriteSave = false;
 		b8 wasAudioEngineRunningIdleOnFocusLost = false;
 		b8 tryToCloseApplicationOnNextFrame = false;
@@ -115,6 +153,12 @@ namespace PeepoDrumKit
 			inline void OnChange() { TimeSinceLastChange = {}; }
 		} zoomPopup = {};
 
+		struct AutosaveData
+		{
+			Time TimeSinceLastSave;
+			std::optional<u64> EditGenerationAtLastSave;
+		} autosave = {};
+
 		struct SaveConfirmationPopupData
 		{
 			b8 OpenOnNextFrame;
@@ -127,6 +171,10 @@ namespace PeepoDrumKit
 			f32 FrameTimesMS[256];
 			size_t FrameTimeIndex;
 			size_t FrameTimeCount;
+
+			struct LoadTiming { b8 HasValue; b8 FromCache; Time Duration; };
+			LoadTiming LastChartOpen;
+			LoadTiming LastWaveformLoad;
 		} performance = {};
 	};
 }
@@ -27,8 +27,6 @@ namespace PeepoDrumKit
 		b8 CompareMode = false;
 		std::unordered_map<const ChartCourse*, std::set<BranchType>> ChartsCompared; // should always include ChartSelected
 
-		// NOTE: Specifically for accurate playback preview sound future-offset calculations
-		Time CursorNonSmoothTimeThisFrame, CursorNonSmoothTimeLastFrame;
 		// NOTE: Store cursor time as Beat while paused to avoid any floating point precision issues and make sure "SetCursorBeat(x); assert(GetCursorBeat() == x)"
 		Beat CursorBeatWhilePaused = Beat::Zero();
 		// NOTE: Specifically to skip hit animations for notes before this time point
@@ -88,6 +86,7 @@ namespace PeepoDrumKit
 			if (SongVoice.GetIsPlaying() == newIsPlaying)
 				return;
 
+			SfxVoicePool.ClearScheduledSounds();
 			if (newIsPlaying)
 			{
 				CursorTimeOnPlaybackStart = (SongVoice.GetPosition() + Chart.SongOffset);
@@ -95,8 +94,10 @@ namespace PeepoDrumKit
 			}
 			else
 			{
-				SongVoice.SetIsPlaying(false);
-				CursorBeatWhilePaused = ChartSelectedCourse->TempoMap.TimeToBeat((SongVoice.GetPosition() + Chart.SongOffset));
+				// NOTE: Pinning the voice to the position read here as the render thread only pauses it once it gets around to it, possibly after having rendered another buffer
+				const Time pausePosition = SongVoice.GetPosition();
+				SongVoice.SetParams(Audio::VoiceParamBatch {}.SetIsPlaying(false).SetPosition(pausePosition));
+				CursorBeatWhilePaused = ChartSelectedCourse->TempoMap.TimeToBeat((pausePosition + Chart.SongOffset));
 				SfxVoicePool.PauseAllFutureVoices();
 			}
 		}
@@ -142,7 +143,7 @@ namespace PeepoDrumKit
 		inline void SetCursorTime(Time newTime)
 		{
 			SongVoice.SetPosition(newTime - Chart.SongOffset);
-			CursorNonSmoothTimeThisFrame = CursorNonSmoothTimeLastFrame = newTime;
+			SfxVoicePool.ClearScheduledSounds();
 			CursorBeatWhilePaused = ChartSelectedCourse->TempoMap.TimeToBeat(newTime);
 			CursorTimeOnPlaybackStart = newTime;
 		}
@@ -151,7 +152,7 @@ namespace PeepoDrumKit
 		{
 			const Time newTime = ChartSelectedCourse->TempoMap.BeatToTime(newBeat);
 			SongVoice.SetPosition(newTime - Chart.SongOffset);
-			CursorNonSmoothTimeThisFrame = CursorNonSmoothTimeLastFrame = newTime;
+			SfxVoicePool.ClearScheduledSounds();
 			CursorBeatWhilePaused = newBeat;
 			CursorTimeOnPlaybackStart = newTime;
 		}
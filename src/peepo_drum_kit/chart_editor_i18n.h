@@ -71,6 +71,7 @@ X("ACT_FILE_OPEN",									"Open...") \
 X("ACT_FILE_CLEAR_ITEMS",							"Clear Items") \
 X("ACT_FILE_OPEN_CHART_DIRECTORY",					"Open Chart Directory...") \
 X("ACT_FILE_SAVE_AS",								"Save As...") \
+X("ACT_FILE_EXPORT_PREVIEW_MIX",					"Export Preview Mix...") \
 /* selection menu */ \
 X("ACT_SELECTION_REFINE",							"Refine Selection") \
 X("ACT_SELECTION_SELECT_ALL",						"Select All") \
@@ -159,6 +160,10 @@ X("ACT_AUDIO_CLOSE_DEVICE",							"Close Audio Device") \
 X("INFO_LATENCY_AVERAGE",							"Average: ") \
 X("INFO_LATENCY_MIN",								"Min: ") \
 X("INFO_LATENCY_MAX",								"Max: ") \
+X("INFO_OPEN_TIME_CHART",							"Open Chart: ") \
+X("INFO_OPEN_TIME_WAVEFORM",						"Load Waveform: ") \
+X("INFO_OPEN_TIME_COLD",							"cold") \
+X("INFO_OPEN_TIME_WARM",							"warm, from cache") \
 /* audio menu (contd.) */ \
 X("ACT_AUDIO_USE_FMT_%s_DEVICE",					"Use %s") \
 /* unsaved message box */ \
@@ -470,6 +470,8 @@ namespace PeepoDrumKit
 			X(General.TransformScale_KeepTimePosition, "transform_scale_keep_time_position");
 			X(General.TransformScale_KeepTimeSignature, "transform_scale_keep_time_signature");
 			X(General.TransformScale_KeepItemDuration, "transform_scale_keep_item_duration");
+			X(General.AutosaveIntervalMinutes, "autosave_interval_minutes");
+			X(General.UseChartCache, "use_chart_cache");
 
 			SECTION("audio");
 			X(Audio.OpenDeviceOnStartup, "open_device_on_startup");
@@ -150,6 +150,8 @@ namespace PeepoDrumKit
 			WithDefault<b8> TransformScale_KeepTimePosition = false;
 			WithDefault<b8> TransformScale_KeepTimeSignature = false;
 			WithDefault<b8> TransformScale_KeepItemDuration = false;
+			WithDefault<i32> AutosaveIntervalMinutes = 0;
+			WithDefault<b8> UseChartCache = false;
 			// TODO: ...
 			static inline WithDefault<vec2> GameViewportAspectRatioMin = vec2(0.0f, 0.0f);
 			static inline WithDefault<vec2> GameViewportAspectRatioMax = vec2(0.0f, 0.0f);
@@ -710,6 +710,16 @@ namespace PeepoDrumKit
 							"Display time in either Chart Space (normalized starting at 00:00.000) or in Song Space (relative to song offset).",
 							SettingsGui::WidgetType::B8_ChartSongSpaceComboBox),
 
+						SettingsGui::SettingsEntry(
+							settings.General.AutosaveIntervalMinutes,
+							"General: Autosave Interval (Minutes)",
+							"Periodically save unsaved changes in the background to a separate \".autosave\" file next to the chart. Set to 0 to disable."),
+
+						SettingsGui::SettingsEntry(
+							settings.General.UseChartCache,
+							"General: Chart Cache",
+							"Store the imported chart and the song waveform in a separate \".pdkcache\" file next to the chart, so that reopening it doesn't have to parse the chart and decode the song again."),
+
 						SettingsGui::SettingsEntry(
 							settings.General.TimelineScrollInvertMouseWheel,
 							"Timeline: Invert Scroll Wheel Direction",
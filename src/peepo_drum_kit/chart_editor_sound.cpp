@@ -27,10 +27,6 @@ namespace PeepoDrumKit
 					printf("Failed to decode audio file '%.*s'\n", FmtStrViewArgs(inFilePath));
 					continue;
 				}
-
-				// HACK: ...
-				if (resultBuffer.SampleRate != Audio::Engine.OutputSampleRate)
-					Audio::LinearlyResampleBuffer<i16>(resultBuffer.InterleavedSamples, resultBuffer.FrameCount, resultBuffer.SampleRate, resultBuffer.ChannelCount, Audio::Engine.OutputSampleRate);
 			}
 			return result;
 		});
@@ -83,12 +79,13 @@ namespace PeepoDrumKit
 		if (audible)
 		{
 			Audio::Voice voice = VoicePool[VoicePoolRingIndex];
-			voice.SetSource(TryGetSourceForType(type));
-			voice.SetSoundGroup(EnumToIndex(soundGroup));
-			voice.SetPosition(startTime);
-			voice.SetVolume(1.0);
-			voice.SetPan(pan);
-			voice.SetIsPlaying(true);
+			voice.SetParams(Audio::VoiceParamBatch {}
+				.SetSource(TryGetSourceForType(type))
+				.SetSoundGroup(EnumToIndex(soundGroup))
+				.SetPosition(startTime)
+				.SetVolume(1.0f)
+				.SetPan(pan)
+				.SetIsPlaying(true));
 
 			VoicePoolRingIndex++;
 			if (VoicePoolRingIndex >= VoicePoolSize)
@@ -96,6 +93,34 @@ namespace PeepoDrumKit
 		}
 	}
 
+	void SoundEffectsVoicePool::ScheduleSound(SoundEffectType type, Time clockVoiceTime, f32 pan)
+	{
+		const b8 isMetronome = (type >= SoundEffectType::MetronomeBar);
+		const SoundGroup soundGroup = isMetronome ? SoundGroup::Metronome : SoundGroup::SoundEffects;
+		const b8 audible = (GetSoundGroupVolume(soundGroup) != 0) && (GetSoundGroupVolume(SoundGroup::Master) != 0);
+		if (audible)
+			SoundsToSchedule.push_back(Audio::ScheduledSound { clockVoiceTime, TryGetSourceForType(type), 1.0f, pan, EnumToIndex(soundGroup) });
+	}
+
+	void SoundEffectsVoicePool::SubmitScheduledSounds(Audio::Voice clockVoice, Time scheduledUntilTime)
+	{
+		if (!SoundsToSchedule.empty())
+		{
+			std::stable_sort(SoundsToSchedule.begin(), SoundsToSchedule.end(), [](const Audio::ScheduledSound& a, const Audio::ScheduledSound& b) { return a.ClockTime < b.ClockTime; });
+			Audio::Engine.ScheduleSounds(clockVoice, SoundsToSchedule.data(), SoundsToSchedule.size());
+			SoundsToSchedule.clear();
+		}
+		ScheduledUntilTime = scheduledUntilTime;
+	}
+
+	void SoundEffectsVoicePool::ClearScheduledSounds()
+	{
+		SoundsToSchedule.clear();
+		if (ScheduledUntilTime.has_value())
+			Audio::Engine.ClearScheduledSounds();
+		ScheduledUntilTime.reset();
+	}
+
 	void SoundEffectsVoicePool::PauseAllFutureVoices()
 	{
 		for (auto& voice : VoicePool)
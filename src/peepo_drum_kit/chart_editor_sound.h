@@ -48,6 +48,12 @@ namespace PeepoDrumKit
 		void PauseAllFutureVoices();
 		Audio::SourceHandle TryGetSourceForType(SoundEffectType type) const;
 
+		// NOTE: Started by the audio engine at the exact output frame the clock voice (the song) reaches their time, instead of whenever the next UI frame happens to notice.
+		//		 Collected by ScheduleSound() and then submitted all at once, with the schedule being topped up to ScheduledUntilTime each frame until it has been cleared
+		void ScheduleSound(SoundEffectType type, Time clockVoiceTime, f32 pan = 0);
+		void SubmitScheduledSounds(Audio::Voice clockVoice, Time scheduledUntilTime);
+		void ClearScheduledSounds();
+
 		inline void SetSoundGroupVolume(SoundGroup soundGroup, f32 value) { Audio::Engine.SetSoundGroupVolume(EnumToIndex(soundGroup), value); }
 		inline f32 GetSoundGroupVolume(SoundGroup soundGroup) { return Audio::Engine.GetSoundGroupVolume(EnumToIndex(soundGroup)); }
 
@@ -55,6 +61,9 @@ namespace PeepoDrumKit
 		static constexpr size_t VoicePoolSize = 32;
 		Audio::Voice VoicePool[VoicePoolSize] = {};
 
+		std::vector<Audio::ScheduledSound> SoundsToSchedule;
+		std::optional<Time> ScheduledUntilTime = {};
+
 		Audio::SourceHandle LoadedSources[EnumCount<SoundEffectType>] = {};
 		std::future<AsyncLoadSoundEffectsResult> LoadSoundEffectFuture = {};
 	};
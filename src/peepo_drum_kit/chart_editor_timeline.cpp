@@ -2,6 +2,7 @@
 #include "chart_editor_undo.h"
 #include "chart_editor_theme.h"
 #include "chart_editor_i18n.h"
+#include "audio/audio_backend.h"
 
 namespace PeepoDrumKit
 {
@@ -335,6 +336,14 @@ namespace PeepoDrumKit
 			context.SfxVoicePool.PlaySound(SoundEffectType::TaikoKa, startTime, externalClock, pan);
 	}
 
+	static void ScheduleSoundEffectTypeForNoteType(ChartContext& context, NoteType noteType, Time clockVoiceTime, f32 pan = 0)
+	{
+		if (!IsKaNote(noteType))
+			context.SfxVoicePool.ScheduleSound(SoundEffectType::TaikoDon, clockVoiceTime, pan);
+		if (IsKaNote(noteType) || IsKaDonNote(noteType))
+			context.SfxVoicePool.ScheduleSound(SoundEffectType::TaikoKa, clockVoiceTime, pan);
+	}
+
 	static b8 IsTimelineCursorVisibleOnScreen(const TimelineCamera& camera, const TimelineRegions& regions, const Time cursorTime, const f32 edgePixelThreshold = 0.0f)
 	{
 		assert(edgePixelThreshold >= 0.0f);
@@ -554,10 +563,11 @@ namespace PeepoDrumKit
 			if (waveform.IsEmpty())
 				continue;
 
+			// NOTE: Drawing the RMS on top of the peaks so that transients stand out while the overall loudness is still visible
 			const auto& waveformMip = waveform.FindClosestMip(waveformTimePerPixel);
 			for (i32 visiblePixel = 0; visiblePixel < contentRect.GetWidth(); /*visiblePixel++*/)
 			{
-				CustomDraw::WaveformChunk chunk;
+				CustomDraw::WaveformChunk peakChunk, rmsChunk;
 				const Rect chunkRect = Rect::FromTLSize(timeline.LocalToScreenSpace(vec2(static_cast<f32>(visiblePixel), 0.5f)), vec2(static_cast<f32>(CustomDraw::WaveformPixelsPerChunk), rowsHeight));
 
 				for (i32 chunkPixel = 0; chunkPixel < CustomDraw::WaveformPixelsPerChunk; chunkPixel++)
@@ -565,11 +575,14 @@ namespace PeepoDrumKit
 					const Time timeAtPixel = timeline.Camera.LocalSpaceXToTime(static_cast<f32>(visiblePixel)) - chartSongOffset;
 					const b8 outOfBounds = (timeAtPixel < Time::Zero() || (timeAtPixel > waveformDuration));
 
-					chunk.PerPixelAmplitude[chunkPixel] = outOfBounds ? 0.0f : (waveformAnimationScale * ClampBot(waveform.GetAmplitudeAt(waveformMip, timeAtPixel, waveformTimePerPixel), minAmplitude));
+					const Audio::WaveformAmplitude amplitude = outOfBounds ? Audio::WaveformAmplitude {} : waveform.GetAmplitudeAt(waveformMip, timeAtPixel, waveformTimePerPixel);
+					peakChunk.PerPixelAmplitude[chunkPixel] = outOfBounds ? 0.0f : (waveformAnimationScale * ClampBot(amplitude.Peak, minAmplitude));
+					rmsChunk.PerPixelAmplitude[chunkPixel] = outOfBounds ? 0.0f : (waveformAnimationScale * ClampBot(amplitude.RMS, minAmplitude));
 					visiblePixel++;
 				}
 
-				CustomDraw::DrawWaveformChunk(drawList, chunkRect, waveformColor, chunk);
+				CustomDraw::DrawWaveformChunk(drawList, chunkRect, waveformColor, peakChunk);
+				CustomDraw::DrawWaveformChunk(drawList, chunkRect, waveformColor, rmsChunk);
 			}
 		}
 	}
@@ -594,7 +607,8 @@ namespace PeepoDrumKit
 		const TimelineCamera& camera = timeline.Camera;
 		const ChartTimeline::MinMaxTime visibleTime = param.VisibleTime;
 
-		// TODO: Do culling by first determining min/max visible beat times then use those to continue / break inside loop (although problematic with TimeOffset?)
+		// NOTE: Only the items around the visible range are converted to time so that drawing a zoomed in timeline doesn't depend on the chart length
+		const auto[firstItemIndex, lastItemIndex] = GetTimelineItemIndexRangeWithinTime(*context.ChartSelectedCourse, list, visibleTime.Min, visibleTime.Max);
 		if constexpr (std::is_same_v<T, Note>)
 		{
 			// TODO: Draw unselected branch notes grayed and at a slightly smaller scale (also nicely animate between selecting different branched!)
@@ -602,8 +616,9 @@ namespace PeepoDrumKit
 			// TODO: It looks like there'll also have to be one scroll speed lane per branch type
 			//		 which means the scroll speed change line should probably extend all to the way down to its corresponding note lane (?)
 
-			for (const Note& it : list)
+			for (size_t i = firstItemIndex; i < lastItemIndex; i++)
 			{
+				const Note& it = list[i];
 				const Time startTime = context.BeatToTime(it.GetStart()) + it.TimeOffset;
 				const Time endTime = (it.BeatDuration > Beat::Zero()) ? context.BeatToTime(it.GetEnd()) + it.TimeOffset : startTime;
 				if (endTime < visibleTime.Min || startTime > visibleTime.Max)
@@ -688,8 +703,9 @@ namespace PeepoDrumKit
 		}
 		else if constexpr (std::is_same_v<T, GoGoRange>)
 		{
-			for (const GoGoRange& it : list)
+			for (size_t i = firstItemIndex; i < lastItemIndex; i++)
 			{
+				const GoGoRange& it = list[i];
 				const Time startTime = context.BeatToTime(it.GetStart());
 				const Time endTime = context.BeatToTime(it.GetEnd());
 				if (endTime < visibleTime.Min || startTime > visibleTime.Max)
@@ -706,7 +722,7 @@ namespace PeepoDrumKit
 			const Beat chartBeatDuration = context.TimeToBeat(context.Chart.GetDurationOrDefault());
 
 			Gui::PushFont(FontMain, GuiScaleI32_AtTarget(FontBaseSizes::Small));
-			for (size_t i = 0; i < list.size(); i++)
+			for (size_t i = firstItemIndex; i < lastItemIndex; i++)
 			{
 				const LyricChange* prevLyric = IndexOrNull(static_cast<i32>(i) - 1, list);
 				const LyricChange& thisLyric = list[i];
@@ -756,8 +772,9 @@ namespace PeepoDrumKit
 			const b8 useCompactFormat = (camera.ZoomTarget.x < compactFormatStringZoomLevelThreshold);
 			const f32 textHeight = Gui::GetFontSize();
 
-			for (const auto& it : list)
+			for (size_t i = firstItemIndex; i < lastItemIndex; i++)
 			{
+				const T& it = list[i];
 				const Time startTime = context.BeatToTime(GetBeat(it));
 				Time endTime = startTime;
 				if constexpr (std::is_same_v<T, JPOSScrollChange>) {
@@ -838,10 +855,11 @@ namespace PeepoDrumKit
 			if (waveform.IsEmpty())
 				continue;
 
+			// NOTE: Drawing the RMS on top of the peaks so that transients stand out while the overall loudness is still visible
 			const auto& waveformMip = waveform.FindClosestMip(waveformTimePerPixel);
 			for (i32 visiblePixel = 0; visiblePixel < scrollbarRect.GetWidth(); /*visiblePixel++*/)
 			{
-				CustomDraw::WaveformChunk chunk;
+				CustomDraw::WaveformChunk peakChunk, rmsChunk;
 				const Rect chunkRect = Rect::FromTLSize(timeline.LocalToScreenSpace_ScrollbarX(vec2(static_cast<f32>(visiblePixel), 0.5f)), vec2(static_cast<f32>(CustomDraw::WaveformPixelsPerChunk), scrollbarHeight));
 
 				for (i32 chunkPixel = 0; chunkPixel < CustomDraw::WaveformPixelsPerChunk; chunkPixel++)
@@ -849,11 +867,14 @@ namespace PeepoDrumKit
 					const Time timeAtPixel = (waveformTimePerPixel * static_cast<f64>(visiblePixel)) - chartSongOffset;
 					const b8 outOfBounds = (timeAtPixel < Time::Zero() || (timeAtPixel > waveformDuration));
 
-					chunk.PerPixelAmplitude[chunkPixel] = outOfBounds ? 0.0f : (waveformAnimationScale * ClampBot(waveform.GetAmplitudeAt(waveformMip, timeAtPixel, waveformTimePerPixel), minAmplitude));
+					const Audio::WaveformAmplitude amplitude = outOfBounds ? Audio::WaveformAmplitude {} : waveform.GetAmplitudeAt(waveformMip, timeAtPixel, waveformTimePerPixel);
+					peakChunk.PerPixelAmplitude[chunkPixel] = outOfBounds ? 0.0f : (waveformAnimationScale * ClampBot(amplitude.Peak, minAmplitude));
+					rmsChunk.PerPixelAmplitude[chunkPixel] = outOfBounds ? 0.0f : (waveformAnimationScale * ClampBot(amplitude.RMS, minAmplitude));
 					visiblePixel++;
 				}
 
-				CustomDraw::DrawWaveformChunk(drawList, chunkRect, waveformColor, chunk);
+				CustomDraw::DrawWaveformChunk(drawList, chunkRect, waveformColor, peakChunk);
+				CustomDraw::DrawWaveformChunk(drawList, chunkRect, waveformColor, rmsChunk);
 			}
 		}
 	}
@@ -880,37 +901,20 @@ namespace PeepoDrumKit
 		}
 	}
 
-	static void UpdateTimelinePlaybackAndMetronomneSounds(ChartContext& context, b8 playbackSoundsEnabled, ChartTimeline::MetronomeData& metronome)
-	{
-		static constexpr Time frameTimeThresholdAtWhichPlayingSoundsMakesNoSense = Time::FromMS(250.0);
-		static constexpr Time playbackSoundFutureOffset = Time::FromSec(1.0 / 25.0);
-
-		Time& nonSmoothCursorThisFrame = context.CursorNonSmoothTimeThisFrame;
-		Time& nonSmoothCursorLastFrame = context.CursorNonSmoothTimeLastFrame;
-
-		nonSmoothCursorLastFrame = nonSmoothCursorThisFrame;
-		nonSmoothCursorThisFrame = (context.SongVoice.GetPosition() + context.Chart.SongOffset);
+	// NOTE: Far enough ahead to make it through any UI frame hitches, while still being short enough for edits made during playback to be heard soon after
+	static constexpr Time PlaybackSoundScheduleAheadDuration = Time::FromMS(250.0);
 
-		const Time elapsedCursorTimeSinceLastUpdate = (nonSmoothCursorLastFrame - nonSmoothCursorThisFrame);
-		if (elapsedCursorTimeSinceLastUpdate >= frameTimeThresholdAtWhichPlayingSoundsMakesNoSense)
-			return;
-
-		const Time futureOffset = (playbackSoundFutureOffset * Min(context.SongVoice.GetPlaybackSpeed(), 1.0f));
+	static void ScheduleTimelinePlaybackAndMetronomeSoundsWithin(ChartContext& context, b8 playbackSoundsEnabled, b8 metronomeEnabled, Time chartScheduleStart, Time chartScheduleEnd)
+	{
+		const Time songOffset = context.Chart.SongOffset;
+		auto isWithinSchedule = [&](Time chartTime) { return (chartTime >= chartScheduleStart && chartTime < chartScheduleEnd); };
 
 		if (playbackSoundsEnabled)
 		{
-			auto checkAndPlayNoteSound = [&](Time noteTime, NoteType noteType, f32 pan)
+			auto scheduleNoteSound = [&](Time noteTime, NoteType noteType, f32 pan)
 			{
-				const Time offsetNoteTime = noteTime - futureOffset;
-				if (offsetNoteTime >= nonSmoothCursorLastFrame && offsetNoteTime < nonSmoothCursorThisFrame)
-				{
-					// NOTE: Don't wanna cause any audio cutoffs. If this happens the future threshold is either set too low for the current frame time
-					//		 or playback was started on top of an existing note
-					const Time startTime = Min((nonSmoothCursorThisFrame - noteTime), Time::Zero());
-					const Time externalClock = noteTime;
-
-					PlaySoundEffectTypeForNoteType(context, noteType, startTime, externalClock, pan);
-				}
+				if (isWithinSchedule(noteTime))
+					ScheduleSoundEffectTypeForNoteType(context, noteType, (noteTime - songOffset), pan);
 			};
 
 			auto handleNotePlayback = [&](const ChartCourse* course, BranchType branch, const Note& note, i32 nLanes, i32 iLane)
@@ -921,18 +925,18 @@ namespace PeepoDrumKit
 					if (IsBalloonNote(note.Type))
 					{
 						for (i32 iPop = 0; iPop < note.BalloonPopCount; ++iPop)
-							checkAndPlayNoteSound(course->TempoMap.BeatToTime(ConvertRange(0, i32{ note.BalloonPopCount }, note.BeatTime, note.GetEnd(), iPop)) + note.TimeOffset, note.Type, pan);
+							scheduleNoteSound(course->TempoMap.BeatToTime(ConvertRange(0, i32{ note.BalloonPopCount }, note.BeatTime, note.GetEnd(), iPop)) + note.TimeOffset, note.Type, pan);
 					}
 					else
 					{
 						const Beat drummrollBeatInterval = GetGridBeatSnap(*Settings.General.DrumrollAutoHitBarDivision);
 						for (Beat subBeat = Beat::Zero(); subBeat <= note.BeatDuration; subBeat += drummrollBeatInterval)
-							checkAndPlayNoteSound(course->TempoMap.BeatToTime(note.BeatTime + subBeat) + note.TimeOffset, note.Type, pan);
+							scheduleNoteSound(course->TempoMap.BeatToTime(note.BeatTime + subBeat) + note.TimeOffset, note.Type, pan);
 					}
 				}
 				else
 				{
-					checkAndPlayNoteSound(course->TempoMap.BeatToTime(note.BeatTime) + note.TimeOffset, note.Type, pan);
+					scheduleNoteSound(course->TempoMap.BeatToTime(note.BeatTime) + note.TimeOffset, note.Type, pan);
 				}
 			};
 
@@ -943,61 +947,65 @@ namespace PeepoDrumKit
 				auto branch = BranchType::Normal;
 				if (!context.IsChartCompared(course, branch))
 					continue;
-				const b8 isFocusedLane = (context.CompareMode && course == context.ChartSelectedCourse && branch == context.ChartSelectedBranch);
 				++iLane;
 
-				for (const Note& note : course->GetNotes(branch))
-					handleNotePlayback(course, branch, note, nLanes, iLane);
+				const BeatSortedList<Note>& notes = course->GetNotes(branch);
+				const auto[firstNoteIndex, lastNoteIndex] = GetTimelineItemIndexRangeWithinTime(*course, notes, chartScheduleStart, chartScheduleEnd);
+				for (size_t i = firstNoteIndex; i < lastNoteIndex; i++)
+					handleNotePlayback(course, branch, notes[i], nLanes, iLane);
 			}
 		}
 
-		if (metronome.IsEnabled)
+		if (metronomeEnabled)
 		{
-			if (nonSmoothCursorLastFrame != metronome.LastProvidedNonSmoothCursorTime)
-			{
-				metronome.LastPlayedBeatTime = Time::FromSec(F64Min);
-				metronome.HasOnPlaybackStartTimeBeenPlayed = false;
-			}
-			metronome.LastProvidedNonSmoothCursorTime = nonSmoothCursorThisFrame;
-
-			const Beat cursorBeatStart = context.TimeToBeat(nonSmoothCursorThisFrame);
-			const Beat cursorBeatEnd = cursorBeatStart + Beat::FromBars(1);
-			const Time cursorTimeOnPlaybackStart = context.CursorTimeOnPlaybackStart;
-
 			context.ChartSelectedCourse->TempoMap.ForEachBeatBar([&](const SortedTempoMap::ForEachBeatBarData& it)
 			{
-				if (it.Beat >= cursorBeatEnd)
-					return ControlFlow::Break;
-
 				const Time beatTime = context.BeatToTime(it.Beat);
-				const Time offsetBeatTime = (beatTime - futureOffset);
-
-				// BUG: This is definitely too lenient and easily falsely triggers 1/16th after a bar start
-				// HACK: Imperfect solution for making up for the future offset skipping past the first beat(s) if they are too close to the playback start time
-				if (!metronome.HasOnPlaybackStartTimeBeenPlayed && ApproxmiatelySame(beatTime.Seconds, cursorTimeOnPlaybackStart.Seconds, 0.01))
-				{
-					metronome.HasOnPlaybackStartTimeBeenPlayed = true;
-					metronome.LastPlayedBeatTime = beatTime;
-					context.SfxVoicePool.PlaySound(it.IsBar ? SoundEffectType::MetronomeBar : SoundEffectType::MetronomeBeat);
+				if (beatTime >= chartScheduleEnd)
 					return ControlFlow::Break;
-				}
-
-				if (offsetBeatTime >= nonSmoothCursorLastFrame && offsetBeatTime < nonSmoothCursorThisFrame)
-				{
-					if (metronome.LastPlayedBeatTime != beatTime)
-					{
-						metronome.LastPlayedBeatTime = beatTime;
-						const Time startTime = Min((nonSmoothCursorThisFrame - beatTime), Time::Zero());
-						context.SfxVoicePool.PlaySound(it.IsBar ? SoundEffectType::MetronomeBar : SoundEffectType::MetronomeBeat, startTime);
-					}
-					return ControlFlow::Break;
-				}
 
+				if (isWithinSchedule(beatTime))
+					context.SfxVoicePool.ScheduleSound(it.IsBar ? SoundEffectType::MetronomeBar : SoundEffectType::MetronomeBeat, (beatTime - songOffset));
 				return ControlFlow::Fallthrough;
 			});
 		}
 	}
 
+	static void UpdateTimelinePlaybackAndMetronomneSounds(ChartContext& context, b8 playbackSoundsEnabled, b8 metronomeEnabled, ChartTimeline::PlaybackSoundScheduleInputs& lastScheduleInputs)
+	{
+		// NOTE: The audio engine skips anything the song voice has already passed by (or has already started), so a new schedule can safely start slightly behind it
+		static constexpr Time scheduleBehindLeeway = Time::FromMS(1.0);
+
+		SoundEffectsVoicePool& sfx = context.SfxVoicePool;
+		const ChartTimeline::PlaybackSoundScheduleInputs scheduleInputs =
+		{
+			context.Undo.EditGeneration, context.Chart.SongOffset, context.ChartSelectedCourse, context.ChartSelectedBranch,
+			context.CompareMode, context.ChartsCompared.size(), *Settings.General.DrumrollAutoHitBarDivision, playbackSoundsEnabled, metronomeEnabled,
+		};
+
+		const ChartTimeline::PlaybackSoundScheduleInputs& a = scheduleInputs, &b = lastScheduleInputs;
+		if (a.EditGeneration != b.EditGeneration || a.SongOffset != b.SongOffset || a.SelectedCourse != b.SelectedCourse || a.SelectedBranch != b.SelectedBranch ||
+			a.CompareMode != b.CompareMode || a.ComparedCourseCount != b.ComparedCourseCount || a.DrumrollAutoHitBarDivision != b.DrumrollAutoHitBarDivision ||
+			a.PlaybackSoundsEnabled != b.PlaybackSoundsEnabled || a.MetronomeEnabled != b.MetronomeEnabled)
+		{
+			sfx.ClearScheduledSounds();
+		}
+		lastScheduleInputs = scheduleInputs;
+
+		// NOTE: Scheduled in song voice time, only adding whatever has come into range since the last frame
+		const Time songOffset = context.Chart.SongOffset;
+		const Time cursorVoiceTime = context.SongVoice.GetPosition();
+		const Time scheduleStart = sfx.ScheduledUntilTime.has_value() ? Max(*sfx.ScheduledUntilTime, cursorVoiceTime - scheduleBehindLeeway) : (cursorVoiceTime - scheduleBehindLeeway);
+		const Time scheduleEnd = cursorVoiceTime + (PlaybackSoundScheduleAheadDuration * context.SongVoice.GetPlaybackSpeed());
+		if (scheduleEnd <= scheduleStart)
+			return;
+
+		ScheduleTimelinePlaybackAndMetronomeSoundsWithin(context, playbackSoundsEnabled, metronomeEnabled, (scheduleStart + songOffset), (scheduleEnd + songOffset));
+		if (!sfx.SoundsToSchedule.empty())
+			Audio::Engine.EnsureStreamRunning();
+		sfx.SubmitScheduledSounds(context.SongVoice, scheduleEnd);
+	}
+
 	void ChartTimeline::DrawGui(ChartContext& context)
 	{
 		UpdateInputAtStartOfFrame(context);
@@ -1202,6 +1210,68 @@ namespace PeepoDrumKit
 		}
 	}
 
+	b8 ChartTimeline::ExportPreviewMix(ChartContext& context, std::string_view wavFilePath)
+	{
+		static constexpr u32 exportBufferFrameCount = 1024;
+		// NOTE: Long enough for the last sounds to ring out past the end of the song / chart
+		static constexpr Time exportEndTail = Time::FromSec(2.0);
+
+		const b8 wasPlaying = context.GetIsPlayback();
+		const Time cursorTimeBefore = context.GetCursorTime();
+		context.SetIsPlayback(false);
+		for (Audio::Voice& voice : context.SfxVoicePool.VoicePool)
+			voice.SetIsPlaying(false);
+
+		const b8 wasStreamRunning = Audio::Engine.GetIsStreamOpenRunning();
+		Audio::Engine.StopCloseStream();
+
+		// NOTE: Starting with whichever comes first out of the song and the chart and ending with whichever comes last, all in song voice time
+		const Time songOffset = context.Chart.SongOffset;
+		const f32 playbackSpeed = context.SongVoice.GetPlaybackSpeed();
+		const Time startVoiceTime = Min(Time::Zero(), -songOffset);
+		const Time endVoiceTime = Max(context.SongVoice.GetSourceDuration(), context.Chart.GetDurationOrDefault() - songOffset) + exportEndTail;
+		const i64 totalFrameCount = static_cast<i64>(((endVoiceTime - startVoiceTime).ToSec() / playbackSpeed) * static_cast<f64>(Audio::AudioEngine::OutputSampleRate));
+
+		Audio::FileSinkBackend fileSink(wavFilePath, Audio::NullBackendClock::Manual);
+		const Audio::BackendStreamParam streamParam = { Audio::AudioEngine::OutputSampleRate, Audio::AudioEngine::OutputChannelCount, exportBufferFrameCount, Audio::StreamShareMode::Shared };
+		const b8 openStreamSuccess = fileSink.OpenStartStream(streamParam, [](i16* outputBuffer, const u32 bufferFrameCount, const u32 bufferChannelCount)
+		{
+			Audio::Engine.RenderOffline(outputBuffer, bufferFrameCount);
+		});
+
+		if (openStreamSuccess)
+		{
+			SoundEffectsVoicePool& sfx = context.SfxVoicePool;
+			context.SongVoice.SetPosition(startVoiceTime);
+			context.SongVoice.SetIsPlaying(true);
+
+			while (fileSink.GetRenderedFrameCount() < totalFrameCount)
+			{
+				// NOTE: Topped up the same way as during playback, just with each rendered buffer standing in for a UI frame
+				const Time scheduleStart = sfx.ScheduledUntilTime.value_or(startVoiceTime);
+				const Time scheduleEnd = context.SongVoice.GetPosition() + (PlaybackSoundScheduleAheadDuration * playbackSpeed);
+				if (scheduleEnd > scheduleStart)
+				{
+					ScheduleTimelinePlaybackAndMetronomeSoundsWithin(context, PlaybackSoundsEnabled, Metronome.IsEnabled, (scheduleStart + songOffset), (scheduleEnd + songOffset));
+					sfx.SubmitScheduledSounds(context.SongVoice, scheduleEnd);
+				}
+				fileSink.RenderFrames(exportBufferFrameCount);
+			}
+
+			context.SongVoice.SetIsPlaying(false);
+			sfx.ClearScheduledSounds();
+			fileSink.StopCloseStream();
+		}
+
+		context.SetCursorTime(cursorTimeBefore);
+		if (wasStreamRunning)
+			Audio::Engine.OpenStartStream();
+		if (wasPlaying)
+			context.SetIsPlayback(true);
+
+		return openStreamSuccess && fileSink.GetLastFileWriteSucceeded();
+	}
+
 	void ChartTimeline::ExecuteClipboardAction(ChartContext& context, ClipboardAction action)
 	{
 		static constexpr cstr clipboardTextHeader = "// PeepoDrumKit Clipboard";
@@ -2331,6 +2401,7 @@ namespace PeepoDrumKit
 
 				if (selectedItemCount > 0 && IsContentWindowHovered && SelectedItemDrag.ActiveTarget == EDragTarget::None)
 				{
+					const MinMaxTime visibleTime = GetMinMaxVisibleTime(Camera.TimePerScreenPixel() * GuiScale(TimelineSelectedNoteHitBoxSizeBig));
 					ForEachTimelineRow(*this, [&](const ForEachRowData& rowIt)
 					{
 						const GenericList list = TimelineRowToGenericList(rowIt.RowType);
@@ -2339,7 +2410,9 @@ namespace PeepoDrumKit
 						const Rect screenRowRect = Rect(LocalToScreenSpace(vec2(0.0f, rowIt.LocalY)), LocalToScreenSpace(vec2(Regions.Content.GetWidth(), rowIt.LocalY + rowIt.LocalHeight)));
 						const vec2 screenRectCenter = screenRowRect.GetCenter();
 
-						for (size_t i = 0; i < GetGenericListCount(selectedCourse, list); i++)
+						// NOTE: Only the visible items can be hovered
+						const auto[firstItemIndex, lastItemIndex] = GetTimelineItemIndexRangeWithinTime(selectedCourse, list, visibleTime.Min, visibleTime.Max);
+						for (size_t i = firstItemIndex; i < lastItemIndex; i++)
 						{
 							b8 isSelected {};
 							if (TryGet<GenericMember::B8_IsSelected>(selectedCourse, list, i, isSelected) && isSelected)
@@ -3003,7 +3076,7 @@ namespace PeepoDrumKit
 
 		// NOTE: Playback preview sounds / metronome
 		if (context.GetIsPlayback() && (PlaybackSoundsEnabled || Metronome.IsEnabled))
-			UpdateTimelinePlaybackAndMetronomneSounds(context, PlaybackSoundsEnabled, Metronome);
+			UpdateTimelinePlaybackAndMetronomneSounds(context, PlaybackSoundsEnabled, Metronome.IsEnabled, LastPlaybackSoundScheduleInputs);
 
 		// NOTE: Mouse selection box
 		{
@@ -3059,7 +3132,17 @@ namespace PeepoDrumKit
 							const f32 screenMinY = (yIntersectionTest == YIntersectionTest::Center) ? screenRowRect.GetCenter().y : screenRowRect.TL.y;
 							const f32 screenMaxY = (yIntersectionTest == YIntersectionTest::Center) ? screenRowRect.GetCenter().y : screenRowRect.BR.y;
 
-							for (size_t i = 0; i < GetGenericListCount(*context.ChartSelectedCourse, list); i++)
+							// NOTE: Items outside of the index range can't possibly be inside the selection box so only need to be deselected when replacing the selection
+							const auto[firstItemIndex, lastItemIndex] = GetTimelineItemIndexRangeWithinTime(*context.ChartSelectedCourse, list, selectionTimeMin, selectionTimeMax);
+							if (BoxSelection.Action == BoxSelectionAction::Clear)
+							{
+								for (size_t i = 0; i < firstItemIndex; i++)
+									TrySet<GenericMember::B8_IsSelected>(*context.ChartSelectedCourse, list, i, false);
+								for (size_t i = lastItemIndex; i < GetGenericListCount(*context.ChartSelectedCourse, list); i++)
+									TrySet<GenericMember::B8_IsSelected>(*context.ChartSelectedCourse, list, i, false);
+							}
+
+							for (size_t i = firstItemIndex; i < lastItemIndex; i++)
 							{
 								Beat beatStart {}, beatDuration {};
 								f32 timeDuration {};
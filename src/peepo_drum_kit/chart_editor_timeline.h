@@ -146,6 +146,54 @@ namespace PeepoDrumKit
 			(rowType == TimelineRowType::Notes_Master) ? BranchType::Master : BranchType::Count;
 	}
 
+	// NOTE: Binary searched index range of the items of a timeline row that could be within the specified time range, instead of converting the beat of every single item to time.
+	//		 Items starting before the range are included for as long as their duration (or time offset) could still reach into it, with the per item checks still being up to the caller
+	template <typename T>
+	std::pair<size_t, size_t> GetTimelineItemIndexRangeWithinTime(const ChartCourse& course, const BeatSortedList<T>& list, Time minTime, Time maxTime)
+	{
+		Beat lookBackBeats = Beat::Zero();
+		Time lookBackTime = Time::Zero(), lookAheadTime = Time::Zero();
+		if constexpr (std::is_same_v<T, Note>)
+		{
+			for (BranchType branch = BranchType::Normal; branch < BranchType::Count; IncrementEnum(branch))
+			{
+				if (&course.GetNotes(branch) == &list)
+				{
+					lookBackBeats = course.GetMaxNoteBeatDuration(branch);
+					lookBackTime = lookAheadTime = course.GetMaxAbsNoteTimeOffset(branch);
+				}
+			}
+		}
+		else if constexpr (std::is_same_v<T, GoGoRange>)
+		{
+			// NOTE: Only ever a handful of these per chart, unlike notes
+			for (const GoGoRange& it : list)
+				lookBackBeats = Max(lookBackBeats, it.BeatDuration);
+		}
+		else if constexpr (std::is_same_v<T, JPOSScrollChange>)
+		{
+			for (const JPOSScrollChange& it : list)
+				lookBackTime = Max(lookBackTime, Time::FromSec(it.Duration));
+		}
+
+		// NOTE: Plus one tick of slack for the rounding of the time to beat conversion
+		const Beat minBeat = course.TempoMap.TimeToBeat(minTime - lookBackTime) - lookBackBeats - Beat::FromTicks(1);
+		const Beat maxBeat = course.TempoMap.TimeToBeat(maxTime + lookAheadTime) + Beat::FromTicks(1);
+		auto range = list.GetIndexRangeStartingWithin(minBeat, maxBeat);
+
+		// NOTE: Lyrics span up until the next one
+		if constexpr (std::is_same_v<T, LyricChange>)
+			range.first = (range.first > 0) ? (range.first - 1) : 0;
+		return range;
+	}
+
+	inline std::pair<size_t, size_t> GetTimelineItemIndexRangeWithinTime(const ChartCourse& course, GenericList list, Time minTime, Time maxTime)
+	{
+		return ApplySingleGenericList<std::pair<size_t, size_t>>(list,
+			[&](auto&& typedList) { return GetTimelineItemIndexRangeWithinTime(course, typedList, minTime, maxTime); }, std::pair<size_t, size_t> {},
+			course);
+	}
+
 	struct TimelineRegions
 	{
 		// NOTE: Includes the entire window
@@ -275,11 +323,21 @@ namespace PeepoDrumKit
 		struct MetronomeData
 		{
 			b8 IsEnabled = false;
-			b8 HasOnPlaybackStartTimeBeenPlayed = false;
-			Time LastProvidedNonSmoothCursorTime = {};
-			Time LastPlayedBeatTime = {};
 		} Metronome = {};
 
+		// NOTE: Everything the already scheduled playback sounds depend on, with any change to them requiring the schedule to be cleared and started anew
+		struct PlaybackSoundScheduleInputs
+		{
+			u64 EditGeneration;
+			Time SongOffset;
+			const ChartCourse* SelectedCourse;
+			BranchType SelectedBranch;
+			b8 CompareMode;
+			size_t ComparedCourseCount;
+			i32 DrumrollAutoHitBarDivision;
+			b8 PlaybackSoundsEnabled, MetronomeEnabled;
+		} LastPlaybackSoundScheduleInputs = {};
+
 		// TODO: Implement properly and make it so the draw order stays correct by binary searching through sorted list (?)
 		struct DeletedNoteAnimation { Note OriginalNote; BranchType Branch; f32 ElapsedTimeSec; };
 		std::vector<DeletedNoteAnimation> TempDeletedNoteAnimationsBuffer;
@@ -319,6 +377,10 @@ namespace PeepoDrumKit
 		void StartEndRangeSelectionAtCursor(ChartContext& context);
 		void PlayNoteSoundAndHitAnimationsAtBeat(ChartContext& context, Beat cursorBeat);
 
+		// NOTE: Renders the song together with the currently enabled playback sounds and metronome into a WAV file as fast as possible,
+		//		 using the same sound schedule as during playback. Blocks until done and stops the audio stream for the duration
+		b8 ExportPreviewMix(ChartContext& context, std::string_view wavFilePath);
+
 		void ExecuteClipboardAction(ChartContext& context, ClipboardAction action);
 		void ExecuteSelectionAction(ChartContext& context, SelectionAction action, const SelectionActionParam& param);
 		void ExecuteTransformAction(ChartContext& context, TransformAction action, const TransformActionParam& param);
@@ -80,11 +80,21 @@ namespace PeepoDrumKit
 		constexpr std::string_view ActionPrefixUpdate = "Update ";
 		constexpr std::string_view ActionPrefixUpdateAll = "Update All ";
 
+		// NOTE: Only the state from the first changed beat onwards is recalculated so that continuous edits (such as dragging a tempo slider) stay cheap
 		template <typename TEvent>
-		static void RefreshChart(ChartCourse* Course, ChartCourseListType<TEvent>* Map)
+		static void RefreshChart(ChartCourse* Course, ChartCourseListType<TEvent>* Map, Beat firstChangedBeat)
 		{
-			if constexpr (TempoMapMemberPointer<TEvent> != nullptr) { Map->RebuildAccelerationStructure(); Course->RecalculateSENotes(); }
-			else if constexpr (expect_type_v<TEvent, Note>) { Course->RecalculateSENotes(); }
+			if constexpr (TempoMapMemberPointer<TEvent> != nullptr) { Map->RebuildAccelerationStructure(firstChangedBeat); Course->RecalculateSENotes(firstChangedBeat); }
+			else if constexpr (expect_type_v<TEvent, Note> || expect_type_v<TEvent, ScrollChange> || expect_type_v<TEvent, ScrollType>) { Course->RecalculateSENotes(firstChangedBeat); }
+		}
+
+		template <typename TEvent>
+		static Beat GetFirstBeat(const std::vector<TEvent>& events)
+		{
+			Beat firstBeat = Beat::FromTicks(I32Max);
+			for (const TEvent& event : events)
+				firstBeat = std::min(firstBeat, GetBeat(event));
+			return firstBeat;
 		}
 
 		template <typename TEvent>
@@ -100,12 +110,12 @@ namespace PeepoDrumKit
 					GetEventList<EventList>(*Map).InsertOrUpdate(ReplacedValue.value());
 				else
 					GetEventList<EventList>(*Map).RemoveAtBeat(GetBeat(NewValue));
-				RefreshChart<TEvent>(Course, Map);
+				RefreshChart<TEvent>(Course, Map, GetBeat(NewValue));
 			}
 			void Redo() override
 			{
 				GetEventList<EventList>(*Map).InsertOrFunc(NewValue, [&](TEvent& v, ...) { ReplacedValue = std::move(v); v = NewValue; }); // safe replace
-				RefreshChart<TEvent>(Course, Map);
+				RefreshChart<TEvent>(Course, Map, GetBeat(NewValue));
 			}
 
 			Undo::MergeResult TryMerge(Command& commandToMerge) override { return Undo::MergeResult::Failed; }
@@ -126,24 +136,21 @@ namespace PeepoDrumKit
 			constexpr static auto EventList = TempoMapMemberPointer<TEvent>;
 			AddMultipleChartEventsBase(ChartCourse* course, ChartCourseListType* map, std::vector<TEvent> newValues) : Course(course), Map(map)
 			{
-				for (const auto& event : newValues)
-					NewEvents.InsertOrUpdate(event); // merge new events
+				NewEvents.Assign(std::move(newValues)); // merge new events
 			}
 
 			void Undo() override
 			{
 				for (const auto& event : NewEvents)
 					GetEventList<EventList>(*Map).RemoveAtBeat(GetBeat(event));
-				for (const auto& event : ReplacedEvents)
-					GetEventList<EventList>(*Map).InsertOrUpdate(event);
-				RefreshChart<TEvent>(Course, Map);
+				GetEventList<EventList>(*Map).BulkInsertOrUpdate(ReplacedEvents);
+				RefreshChart<TEvent>(Course, Map, GetFirstBeat(NewEvents.Sorted));
 			}
 			void Redo() override
 			{
 				ReplacedEvents.clear();
-				for (const auto& event : NewEvents)
-					GetEventList<EventList>(*Map).InsertOrFunc(event, [&](TEvent& v, ...) { ReplacedEvents.push_back(std::move(v)); v = event; }); // safe replace
-				RefreshChart<TEvent>(Course, Map);
+				GetEventList<EventList>(*Map).BulkInsertOrFunc(NewEvents.Sorted, [&](TEvent& v, const TEvent& vNew) { ReplacedEvents.push_back(std::move(v)); v = vNew; }); // safe replace
+				RefreshChart<TEvent>(Course, Map, GetFirstBeat(NewEvents.Sorted));
 			}
 
 			Undo::MergeResult TryMerge(Undo::Command& commandToMerge) override { return Undo::MergeResult::Failed; }
@@ -165,8 +172,8 @@ namespace PeepoDrumKit
 			RemoveSingleChartEventBase(ChartCourse* course, ChartCourseListType* map, TEvent oldValue) : Course(course), Map(map), OldValue(oldValue) { }
 			RemoveSingleChartEventBase(ChartCourse* course, ChartCourseListType* map, Beat beat) : Course(course), Map(map), OldValue(*GetEventList<EventList>(*Map).TryFindExactAtBeat(beat)) { assert(GetBeat(OldValue) == beat); }
 
-			void Undo() override { GetEventList<EventList>(*Map).InsertOrUpdate(OldValue); RefreshChart<TEvent>(Course, Map); }
-			void Redo() override { GetEventList<EventList>(*Map).RemoveAtBeat(GetBeat(OldValue)); RefreshChart<TEvent>(Course, Map); }
+			void Undo() override { GetEventList<EventList>(*Map).InsertOrUpdate(OldValue); RefreshChart<TEvent>(Course, Map, GetBeat(OldValue)); }
+			void Redo() override { GetEventList<EventList>(*Map).RemoveAtBeat(GetBeat(OldValue)); RefreshChart<TEvent>(Course, Map, GetBeat(OldValue)); }
 
 			Undo::MergeResult TryMerge(Command& commandToMerge) override { return Undo::MergeResult::Failed; }
 			Undo::CommandInfo GetInfo() const override { return { ConstevalStrJoined<ActionPrefixRemove, DisplayNameOfChartEvent<TEvent>> }; }
@@ -187,14 +194,13 @@ namespace PeepoDrumKit
 
 			void Undo() override
 			{
-				for (const auto& event : OldValues)
-					GetEventList<EventList>(*Map).InsertOrUpdate(event);
-				RefreshChart<TEvent>(Course, Map);
+				GetEventList<EventList>(*Map).BulkInsertOrUpdate(OldValues);
+				RefreshChart<TEvent>(Course, Map, GetFirstBeat(OldValues));
 			}
 			void Redo() override
 			{
 				for (const TEvent& event : OldValues) GetEventList<EventList>(*Map).RemoveAtBeat(GetBeat(event));
-				RefreshChart<TEvent>(Course, Map);
+				RefreshChart<TEvent>(Course, Map, GetFirstBeat(OldValues));
 			}
 
 			Undo::MergeResult TryMerge(Undo::Command& commandToMerge) override { return Undo::MergeResult::Failed; }
@@ -218,13 +224,13 @@ namespace PeepoDrumKit
 			{
 				GetEventList<EventList>(*Map).RemoveAtBeat(GetBeat(NewValue));
 				EventsToRemove.Undo();
-				RefreshChart<TEvent>(Course, Map);
+				RefreshChart<TEvent>(Course, Map, std::min(GetBeat(NewValue), GetFirstBeat(EventsToRemove.OldValues)));
 			}
 			void Redo() override
 			{
 				EventsToRemove.Redo();
 				GetEventList<EventList>(*Map).InsertOrFunc(NewValue, [&](TEvent& v, ...) { EventsToRemove.OldValues.push_back(std::move(v)); v = NewValue; }); // safe replace
-				RefreshChart<TEvent>(Course, Map);
+				RefreshChart<TEvent>(Course, Map, std::min(GetBeat(NewValue), GetFirstBeat(EventsToRemove.OldValues)));
 			}
 
 			Undo::MergeResult TryMerge(Undo::Command& commandToMerge) override { return Undo::MergeResult::Failed; }
@@ -245,8 +251,8 @@ namespace PeepoDrumKit
 			constexpr static auto EventList = TempoMapMemberPointer<TEvent>;
 			UpdateSingleChartEventBase(ChartCourse* course, ChartCourseListType* map, TEvent newValue) : Course(course), Map(map), NewValue(newValue), OldValue(*GetEventList<EventList>(*Map).TryFindExactAtBeat(GetBeat(newValue))) { assert(GetBeat(newValue) == GetBeat(OldValue)); }
 
-			void Undo() override { GetEventList<EventList>(*Map).InsertOrUpdate(OldValue); RefreshChart<TEvent>(Course, Map); }
-			void Redo() override { GetEventList<EventList>(*Map).InsertOrUpdate(NewValue); RefreshChart<TEvent>(Course, Map); }
+			void Undo() override { GetEventList<EventList>(*Map).InsertOrUpdate(OldValue); RefreshChart<TEvent>(Course, Map, GetBeat(OldValue)); }
+			void Redo() override { GetEventList<EventList>(*Map).InsertOrUpdate(NewValue); RefreshChart<TEvent>(Course, Map, GetBeat(NewValue)); }
 
 			Undo::MergeResult TryMerge(Command& commandToMerge) override
 			{
@@ -275,8 +281,8 @@ namespace PeepoDrumKit
 			constexpr static auto EventList = TempoMapMemberPointer<TEvent>;
 			ReplaceAllChartEventsBase(ChartCourse* course, ChartCourseListType* map, SortedEventsList newValues) : Course(course), Map(map), NewValues(std::move(newValues)), OldValues(GetEventList<EventList>(*map)) { }
 
-			void Undo() override { GetEventList<EventList>(*Map) = OldValues; RefreshChart<TEvent>(Course, Map); }
-			void Redo() override { GetEventList<EventList>(*Map) = NewValues; RefreshChart<TEvent>(Course, Map); }
+			void Undo() override { GetEventList<EventList>(*Map) = OldValues; RefreshChart<TEvent>(Course, Map, Beat::Zero()); }
+			void Redo() override { GetEventList<EventList>(*Map) = NewValues; RefreshChart<TEvent>(Course, Map, Beat::Zero()); }
 
 			Undo::MergeResult TryMerge(Command& commandToMerge) override
 			{
@@ -406,8 +412,17 @@ namespace PeepoDrumKit
 
 			ChangeSingleNoteAttributeBase(ChartCourse* course, SortedNotesList* notes, Data newData) : Course(course), Notes(notes), NewData(std::move(newData)) { NewData.OldValue = (*Notes)[NewData.Index].*Attr; }
 
-			void Undo() override { (*Notes)[NewData.Index].*Attr = NewData.OldValue; RefreshChart<Note>(Course, nullptr); }
-			void Redo() override { (*Notes)[NewData.Index].*Attr = NewData.NewValue; RefreshChart<Note>(Course, nullptr); }
+			void Undo() override { (*Notes)[NewData.Index].*Attr = NewData.OldValue; RefreshChart<Note>(Course, nullptr, GetFirstChangedBeat()); }
+			void Redo() override { (*Notes)[NewData.Index].*Attr = NewData.NewValue; RefreshChart<Note>(Course, nullptr, GetFirstChangedBeat()); }
+
+			Beat GetFirstChangedBeat() const
+			{
+				// NOTE: Also covering the old and new value in case of moving a note
+				if constexpr (std::is_same_v<TAttr, Beat>)
+					return std::min({ (*Notes)[NewData.Index].BeatTime, NewData.NewValue, NewData.OldValue });
+				else
+					return (*Notes)[NewData.Index].BeatTime;
+			}
 
 			Undo::MergeResult TryMerge(Undo::Command& commandToMerge) override
 			{
@@ -449,14 +464,26 @@ namespace PeepoDrumKit
 			{
 				for (const auto& newData : NewData)
 					(*Notes)[newData.Index].*Attr = newData.OldValue;
-				RefreshChart<Note>(Course, nullptr);
+				RefreshChart<Note>(Course, nullptr, GetFirstChangedBeat());
 			}
 
 			void Redo() override
 			{
 				for (const auto& newData : NewData)
 					(*Notes)[newData.Index].*Attr = newData.NewValue;
-				RefreshChart<Note>(Course, nullptr);
+				RefreshChart<Note>(Course, nullptr, GetFirstChangedBeat());
+			}
+
+			Beat GetFirstChangedBeat() const
+			{
+				Beat firstBeat = Beat::FromTicks(I32Max);
+				for (const auto& newData : NewData)
+				{
+					firstBeat = std::min(firstBeat, (*Notes)[newData.Index].BeatTime);
+					if constexpr (std::is_same_v<TAttr, Beat>)
+						firstBeat = std::min({ firstBeat, newData.NewValue, newData.OldValue });
+				}
+				return firstBeat;
 			}
 
 			Undo::MergeResult TryMerge(Undo::Command& commandToMerge) override
@@ -553,15 +580,18 @@ namespace PeepoDrumKit
 	{
 		struct AddMultipleGenericItems : Undo::Command
 		{
-			AddMultipleGenericItems(ChartCourse* course, std::vector<GenericListStructWithType> newData) : Course(course), UpdateTempoMap(false)
+			AddMultipleGenericItems(ChartCourse* course, std::vector<GenericListStructWithType> newData) : Course(course), UpdateTempoMap(false), UpdateNotes(false), FirstChangedBeat(GetFirstBeat(newData))
 			{
+				std::vector<GenericListStructWithType> newDataPerList[EnumCount<GenericList>];
 				for (const auto& data : newData) {
-					NewData[static_cast<size_t>(data.List)].InsertOrUpdate(data); // merge new data
+					newDataPerList[static_cast<size_t>(data.List)].push_back(data);
 					if (data.List == GenericList::TempoChanges)
 						UpdateTempoMap = true;
-					else if (IsNotesList(data.List))
+					else if (ListAffectsSENotes(data.List))
 						UpdateNotes = true;
 				}
+				for (size_t i = 0; i < EnumCount<GenericList>; i++)
+					NewData[i].Assign(std::move(newDataPerList[i])); // merge new data
 			}
 
 			void Undo() override
@@ -573,22 +603,23 @@ namespace PeepoDrumKit
 				for (const auto& data : ReplacedData)
 					TryAddOrReplaceGenericStruct(*Course, data.List, data.Value);
 				if (UpdateTempoMap)
-					Course->TempoMap.RebuildAccelerationStructure();
+					Course->TempoMap.RebuildAccelerationStructure(FirstChangedBeat);
 				if (UpdateTempoMap || UpdateNotes)
-					Course->RecalculateSENotes();
+					Course->RecalculateSENotes(FirstChangedBeat);
 			}
 
 			void Redo() override
 			{
 				ReplacedData.clear();
-				for (const auto& list : NewData) {
-					for (const auto& data : list)
-						TryAddOrFuncGenericStruct(*Course, data.List, data.Value, [&](auto& v, auto&& vNew) { ReplacedData.emplace_back(data.List, std::move(v)); v = vNew; }); // safe replace
+				for (size_t i = 0; i < EnumCount<GenericList>; i++) {
+					const GenericList list = static_cast<GenericList>(i);
+					if (!NewData[i].empty())
+						TryBulkAddOrFuncGenericStructs(*Course, list, NewData[i].Sorted, [&](auto& v, auto&& vNew) { ReplacedData.emplace_back(list, std::move(v)); v = vNew; }); // safe replace
 				}
 				if (UpdateTempoMap)
-					Course->TempoMap.RebuildAccelerationStructure();
+					Course->TempoMap.RebuildAccelerationStructure(FirstChangedBeat);
 				if (UpdateTempoMap || UpdateNotes)
-					Course->RecalculateSENotes();
+					Course->RecalculateSENotes(FirstChangedBeat);
 			}
 
 			Undo::MergeResult TryMerge(Undo::Command& commandToMerge) override { return Undo::MergeResult::Failed; }
@@ -598,17 +629,18 @@ namespace PeepoDrumKit
 			BeatSortedList<GenericListStructWithType> NewData[EnumCount<GenericList>];
 			std::vector<GenericListStructWithType> ReplacedData;
 			b8 UpdateTempoMap, UpdateNotes;
+			Beat FirstChangedBeat;
 		};
 
 		struct RemoveMultipleGenericItems : Undo::Command
 		{
-			RemoveMultipleGenericItems(ChartCourse* course, std::vector<GenericListStructWithType> oldData) : Course(course), OldData(std::move(oldData)), UpdateTempoMap(false)
+			RemoveMultipleGenericItems(ChartCourse* course, std::vector<GenericListStructWithType> oldData) : Course(course), OldData(std::move(oldData)), UpdateTempoMap(false), UpdateNotes(false), FirstChangedBeat(GetFirstBeat(OldData))
 			{
 				for (const auto& data : OldData)
 				{
 					if (data.List == GenericList::TempoChanges)
 						UpdateTempoMap = true;
-					else if (IsNotesList(data.List))
+					else if (ListAffectsSENotes(data.List))
 						UpdateNotes = true;
 				}
 			}
@@ -618,9 +650,9 @@ namespace PeepoDrumKit
 				for (const auto& data : OldData)
 					TryAddOrReplaceGenericStruct(*Course, data.List, data.Value);
 				if (UpdateTempoMap)
-					Course->TempoMap.RebuildAccelerationStructure();
+					Course->TempoMap.RebuildAccelerationStructure(FirstChangedBeat);
 				if (UpdateTempoMap || UpdateNotes)
-					Course->RecalculateSENotes();
+					Course->RecalculateSENotes(FirstChangedBeat);
 			}
 
 			void Redo() override
@@ -628,9 +660,9 @@ namespace PeepoDrumKit
 				for (const auto& data : OldData)
 					TryRemoveGenericStruct(*Course, data.List, data.Value);
 				if (UpdateTempoMap)
-					Course->TempoMap.RebuildAccelerationStructure();
+					Course->TempoMap.RebuildAccelerationStructure(FirstChangedBeat);
 				if (UpdateTempoMap || UpdateNotes)
-					Course->RecalculateSENotes();
+					Course->RecalculateSENotes(FirstChangedBeat);
 			}
 
 			Undo::MergeResult TryMerge(Undo::Command& commandToMerge) override { return Undo::MergeResult::Failed; }
@@ -639,6 +671,7 @@ namespace PeepoDrumKit
 			ChartCourse* Course;
 			std::vector<GenericListStructWithType> OldData;
 			b8 UpdateTempoMap, UpdateNotes;
+			Beat FirstChangedBeat;
 		};
 
 		struct AddMultipleGenericItems_Paste : AddMultipleGenericItems
@@ -676,7 +709,7 @@ namespace PeepoDrumKit
 			};
 
 			ChangeMultipleGenericProperties(ChartCourse* course, std::vector<Data> newData)
-				: Course(course), NewData(std::move(newData)), UpdateTempoMap(false)
+				: Course(course), NewData(std::move(newData)), UpdateTempoMap(false), UpdateNotes(false), FirstChangedBeat(Beat::FromTicks(I32Max))
 			{
 				for (auto& data : NewData)
 				{
@@ -684,8 +717,12 @@ namespace PeepoDrumKit
 					assert(success);
 					if (data.List == GenericList::TempoChanges)
 						UpdateTempoMap = true;
-					else if (IsNotesList(data.List))
+					else if (ListAffectsSENotes(data.List))
 						UpdateNotes = true;
+
+					FirstChangedBeat = std::min(FirstChangedBeat, GetBeat(*Course, data.List, data.Index));
+					if (data.Member == GenericMember::Beat_Start)
+						FirstChangedBeat = std::min({ FirstChangedBeat, data.NewValue.Beat, data.OldValue.Beat });
 				}
 			}
 
@@ -694,9 +731,9 @@ namespace PeepoDrumKit
 				for (const auto& newData : NewData)
 					TrySet(*Course, newData.List, newData.Index, newData.Member, newData.OldValue);
 				if (UpdateTempoMap)
-					Course->TempoMap.RebuildAccelerationStructure();
+					Course->TempoMap.RebuildAccelerationStructure(FirstChangedBeat);
 				if (UpdateTempoMap || UpdateNotes)
-					Course->RecalculateSENotes();
+					Course->RecalculateSENotes(FirstChangedBeat);
 			}
 
 			void Redo() override
@@ -704,9 +741,9 @@ namespace PeepoDrumKit
 				for (const auto& newData : NewData)
 					TrySet(*Course, newData.List, newData.Index, newData.Member, newData.NewValue);
 				if (UpdateTempoMap)
-					Course->TempoMap.RebuildAccelerationStructure();
+					Course->TempoMap.RebuildAccelerationStructure(FirstChangedBeat);
 				if (UpdateTempoMap || UpdateNotes)
-					Course->RecalculateSENotes();
+					Course->RecalculateSENotes(FirstChangedBeat);
 			}
 
 			Undo::MergeResult TryMerge(Undo::Command& commandToMerge) override
@@ -728,6 +765,7 @@ namespace PeepoDrumKit
 
 				for (size_t i = 0; i < NewData.size(); i++)
 					NewData[i].NewValue = other->NewData[i].NewValue;
+				FirstChangedBeat = std::min(FirstChangedBeat, other->FirstChangedBeat);
 
 				return Undo::MergeResult::ValueUpdated;
 			}
@@ -737,6 +775,7 @@ namespace PeepoDrumKit
 			ChartCourse* Course;
 			std::vector<Data> NewData;
 			b8 UpdateTempoMap, UpdateNotes;
+			Beat FirstChangedBeat;
 		};
 
 		struct ChangeMultipleGenericProperties_MoveItems : ChangeMultipleGenericProperties
@@ -2699,6 +2699,7 @@ namespace PeepoDrumKit
 
 	static void ConvertAllLyricsFromString(TimeSpace timeSpace, Time songOffset, const SortedTempoMap& tempoMap, std::string_view in, SortedLyricsList& out)
 	{
+		std::vector<LyricChange> parsedLyrics;
 		ASCII::ForEachLineInMultiLineString(in, false, [&](std::string_view line)
 		{
 			if (line.size() < ArrayCount("00:00.000"))
@@ -2725,8 +2726,9 @@ namespace PeepoDrumKit
 			if (!isOnlyWhitespace)
 				ResolveEscapeSequences(lyricSubStr, parsedLyrc, EscapeSequenceFlags::NewLines);
 
-			out.InsertOrUpdate(LyricChange { parsedBeat, std::move(parsedLyrc) });
+			parsedLyrics.push_back(LyricChange { parsedBeat, std::move(parsedLyrc) });
 		});
+		out.BulkInsertOrUpdate(std::move(parsedLyrics));
 	};
 
 	void ChartLyricsWindow::DrawGui(ChartContext& context, ChartTimeline& timeline)
@@ -5,10 +5,23 @@
 #include "chart_editor_timeline.h"
 #include "chart_editor_context.h"
 #include "chart_editor_theme.h"
+#include "chart_editor_i18n.h"
 #include "imgui/imgui_include.h"
 
 namespace PeepoDrumKit
 {
+	static inline std::string GetStyleName(i32 style, i32 playerSide)
+	{
+		if (style == 1)
+			return UI_Str("PLAYER_SIDE_STYLE_SINGLE");
+		char buf[32];
+		std::string res = (style == 2) ? UI_Str("PLAYER_SIDE_STYLE_DOUBLE")
+			: std::string(buf, sprintf_s(buf, UI_Str("PLAYER_SIDE_STYLE_FMT_%d_STYLE"), style));
+		std::string_view strPlaySide (buf, sprintf_s(buf, UI_Str("PLAYER_SIDE_PLAYER_FMT_%d_PLAYER"), playerSide));
+		res += " ("; res += strPlaySide; res += ")";
+		return res;
+	}
+
 	struct LoadingTextAnimation
 	{
 		b8 WasLoadingLastFrame = false;
@@ -249,8 +262,52 @@ namespace PeepoDrumKit
 		constexpr vec2 LaneToWorldSpace(f32 laneX, f32 laneY) const { return (LaneRect.TL + GameHitCircle.Center + vec2(laneX, laneY)); }
 		constexpr vec2 LaneToScreenSpace(const vec2& laneCoord) const { return WorldToScreenSpace(LaneToWorldSpace(laneCoord.x, laneCoord.y)); }
 
-		constexpr b8 IsPointVisibleOnLane(f32 laneX, f32 threshold = 280.0f) const { return (laneX >= -threshold) && (laneX <= (LaneWidth() + threshold)); }
-		constexpr b8 IsRangeVisibleOnLane(f32 laneHeadX, f32 laneTailX, f32 threshold = 280.0f) const { return (laneTailX >= -threshold) && (laneHeadX <= (LaneWidth() + threshold)); }
+		static constexpr f32 DefaultLaneVisibilityThreshold = 280.0f;
+		constexpr b8 IsPointVisibleOnLane(f32 laneX, f32 threshold = DefaultLaneVisibilityThreshold) const { return (laneX >= -threshold) && (laneX <= (LaneWidth() + threshold)); }
+		constexpr b8 IsRangeVisibleOnLane(f32 laneHeadX, f32 laneTailX, f32 threshold = DefaultLaneVisibilityThreshold) const { return (laneTailX >= -threshold) && (laneHeadX <= (LaneWidth() + threshold)); }
+	};
+
+	// NOTE: Per course branch index of the cursor positions at which each note could possibly be visible on the game preview lane,
+	//		 so that drawing only has to evaluate the coordinates of the notes actually on screen instead of those of every single note in the chart.
+	//		 The lane x position of a note is linear in either the cursor time (NMSCROLL) or the cursor HBSCROLL beat tick (HBSCROLL / BMSCROLL)
+	//		 so each note is indexed by conservative ranges in these two domains, computed for a lane x range (relative to the hit circle) covering at least the visible one.
+	//		 Edits only invalidate the notes from ChartCourse::NoteLaneFirstChangedBeat onwards
+	struct NoteLaneVisibilityIndex
+	{
+		enum class Domain : u8 { Time, HBScrollBeatTick, Count };
+
+		struct NoteEntry
+		{
+			// NOTE: With the note pointer only being resolved (by index) when queried
+			ForEachNoteLaneData Data;
+			Domain HeadDomain, TailDomain;
+			// NOTE: Cursor independent position (seconds or beat ticks) and lane units per unit of cursor movement
+			f64 HeadPosition, TailPosition;
+			f64 HeadSlope, TailSlope;
+		};
+
+		struct Range { f64 Begin, End; i32 NoteIndex; };
+		struct RangeList
+		{
+			// NOTE: Sorted by begin with the running maximum end for stopping the backwards scan of a query early.
+			//		 Ranges a lot longer than the typical one (or unbounded) are kept separately so that a single very slow scrolling note doesn't make every query scan through everything before it
+			std::vector<Range> SortedByBegin;
+			std::vector<f64> RunningMaxEnd;
+			std::vector<Range> Long;
+			f64 LongThreshold;
+		};
+
+		const ChartCourse* Course = nullptr;
+		BranchType Branch = BranchType::Normal;
+		std::vector<NoteEntry> Notes;
+		RangeList Ranges[EnumCount<Domain>] = {};
+		f32 IndexedLaneMinX = 0.0f, IndexedLaneMaxX = 0.0f;
+
+		// NOTE: Only used for detecting edits that didn't go through RecalculateSENotes(), in which case everything is rebuilt
+		size_t IndexedNoteCount = 0, IndexedTempoChangeCount = 0, IndexedScrollChangeCount = 0, IndexedScrollTypeCount = 0;
+
+		void Update(const ChartCourse& course, BranchType branch, f32 visibleLaneMinX, f32 visibleLaneMaxX);
+		void Query(Time cursorTime, f64 cursorHBScrollBeatTick, std::vector<i32>& outSortedNoteIndices) const;
 	};
 
 	struct ChartGamePreview
@@ -260,6 +317,16 @@ namespace PeepoDrumKit
 		struct DeferredNoteDrawData { f32 LaneHeadX, LaneTailX, LaneHeadY, LaneTailY; Tempo Tempo; Complex ScrollSpeed; const Note* OriginalNote; Time NoteStartTime, NoteEndTime; };
 		std::vector<DeferredNoteDrawData> ReverseNoteDrawBuffer;
 
+		std::vector<NoteLaneVisibilityIndex> VisibilityIndices;
+		std::vector<i32> VisibleNoteIndicesBuffer;
+
+		// NOTE: Returns the up to date visibility index of the course branch for the current lane rect and hit circle position
+		NoteLaneVisibilityIndex& UpdateVisibilityIndex(const ChartCourse& course, BranchType branch, vec2 hitCirclePosLane);
+
+		// NOTE: Fills the reverse note draw buffer with every note that has to be drawn at the specified cursor position,
+		//		 either from the candidates of the visibility index or (if null) by walking through every single note
+		void CollectNotesToDraw(const ChartCourse& course, BranchType branch, const NoteLaneVisibilityIndex* visibilityIndex, vec2 hitCirclePosLane, Time cursorTime, f64 cursorHBScrollBeatTick);
+
 		void DrawGui(ChartContext& context, Time animatedCursorTime);
 	};
 
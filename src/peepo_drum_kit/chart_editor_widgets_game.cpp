@@ -388,169 +388,303 @@ namespace PeepoDrumKit
 		});
 	}
 
-	struct ForEachNoteLaneData
+	// NOTE: Must match GameCamera::TimeToLaneSpace() (including the BMSCROLL scroll speed override of GameCamera::GetNoteCoordinatesLane())
+	static void GetNoteLaneDomainAndSlope(Tempo tempo, Complex scrollSpeed, ScrollMethod scrollType, NoteLaneVisibilityIndex::Domain& outDomain, f64& outSlope)
 	{
-		const Note* OriginalNote;
-		Beat Beat;
-		Time Time;
-		Tempo Tempo;
-		Complex ScrollSpeed;
-		ScrollMethod ScrollType;
-		struct {
-			struct Beat Beat;
-			struct Time Time;
-			struct Tempo Tempo;
-			Complex ScrollSpeed;
-			ScrollMethod ScrollType;
-		} Tail;
-	};
+		switch (scrollType)
+		{
+		case ScrollMethod::HBSCROLL:
+		{
+			outDomain = NoteLaneVisibilityIndex::Domain::HBScrollBeatTick;
+			outSlope = (static_cast<f64>(scrollSpeed.GetRealPart()) / Beat::TicksPerBeat) * GameWorldSpaceDistancePerLaneBeat;
+		} break;
+		case ScrollMethod::BMSCROLL:
+		{
+			outDomain = NoteLaneVisibilityIndex::Domain::HBScrollBeatTick;
+			outSlope = (1.0 / Beat::TicksPerBeat) * GameWorldSpaceDistancePerLaneBeat;
+		} break;
+		case ScrollMethod::NMSCROLL:
+		default:
+		{
+			outDomain = NoteLaneVisibilityIndex::Domain::Time;
+			outSlope = ((static_cast<f64>(tempo.BPM) * scrollSpeed.GetRealPart()) / 60.0) * GameWorldSpaceDistancePerLaneBeat;
+		} break;
+		}
+	}
 
-	template <typename Func>
-	static void ForEachNoteOnNoteLane(const ChartCourse& course, BranchType branch, Func perNoteFunc)
+	static NoteLaneVisibilityIndex::NoteEntry CreateNoteLaneEntry(const ForEachNoteLaneData& data, const TempoMapAccelerationStructure& tempoChanges)
 	{
-		BeatSortedForwardIterator<TempoChange> tempoChangeIt {};
-		BeatSortedForwardIterator<ScrollChange> scrollChangeIt {};
-		BeatSortedForwardIterator<ScrollType> scrollTypeIt {};
-		BeatSortedForwardIterator<JPOSScrollChange> JPOSscrollChangeIt {};
+		using Domain = NoteLaneVisibilityIndex::Domain;
+		NoteLaneVisibilityIndex::NoteEntry out {};
+		out.Data = data;
+		out.Data.OriginalNote = nullptr;
+		GetNoteLaneDomainAndSlope(data.Tempo, data.ScrollSpeed, data.ScrollType, out.HeadDomain, out.HeadSlope);
+		GetNoteLaneDomainAndSlope(data.Tail.Tempo, data.Tail.ScrollSpeed, data.Tail.ScrollType, out.TailDomain, out.TailSlope);
+		out.HeadPosition = (out.HeadDomain == Domain::Time) ? data.Time.Seconds : tempoChanges.ConvertBeatAndTimeToHBScrollBeatTickUsingLookupTableIndexing(data.Beat, data.Time);
+		out.TailPosition = (out.TailDomain == Domain::Time) ? data.Tail.Time.Seconds : tempoChanges.ConvertBeatAndTimeToHBScrollBeatTickUsingLookupTableIndexing(data.Tail.Beat, data.Tail.Time);
+		return out;
+	}
+
+	static void AppendNoteLaneRanges(const NoteLaneVisibilityIndex::NoteEntry& entry, NoteType noteType, i32 noteIndex, f64 laneMinX, f64 laneMaxX, std::vector<NoteLaneVisibilityIndex::Range>* outRangesPerDomain)
+	{
+		using Domain = NoteLaneVisibilityIndex::Domain;
+		using Range = NoteLaneVisibilityIndex::Range;
 
-		for (const Note& note : course.GetNotes(branch))
+		// NOTE: With (laneX - hitCircleX) = slope * (position - cursor) being inside the lane x range
+		auto getLaneRange = [&](f64 position, f64 slope) -> Range
 		{
-			const Beat beat = note.BeatTime;
-			const Time head = (course.TempoMap.BeatToTime(beat) + note.TimeOffset);
-			const Beat beatTail = (note.BeatDuration > Beat::Zero()) ? (beat + note.BeatDuration) : beat;
-			const Time tail = (note.BeatDuration > Beat::Zero()) ? (course.TempoMap.BeatToTime(beatTail) + note.TimeOffset) : head;
-			perNoteFunc(ForEachNoteLaneData { &note, beat, head,
-				TempoOrDefault(tempoChangeIt.Next(course.TempoMap.Tempo.Sorted, beat)),
-				ScrollOrDefault(scrollChangeIt.Next(course.ScrollChanges.Sorted, beat)),
-				ScrollTypeOrDefault(scrollTypeIt.Next(course.ScrollTypes.Sorted, beat)),
-				{
-					beatTail, tail,
-					TempoOrDefault(tempoChangeIt.Next(course.TempoMap.Tempo.Sorted, beatTail)),
-					ScrollOrDefault(scrollChangeIt.Next(course.ScrollChanges.Sorted, beatTail)),
-					ScrollTypeOrDefault(scrollTypeIt.Next(course.ScrollTypes.Sorted, beatTail)),
-				},
-			});
+			const f64 a = position - (laneMaxX / slope), b = position - (laneMinX / slope);
+			return Range { Min(a, b), Max(a, b), noteIndex };
+		};
+
+		// NOTE: Long notes are visible for as long as any part of their body is, which (with head and tail moving into the same direction) are exactly the cursor positions in between.
+		//		 Everything else (standing still, mixed scroll methods or head and tail moving apart) is simply always considered a candidate
+		const b8 hasBody = IsLongNote(noteType);
+		Domain laneDomain = entry.HeadDomain;
+		Range laneRange = { -F64Max, F64Max, noteIndex };
+		if (entry.HeadSlope == 0.0 || (hasBody && (entry.TailDomain != entry.HeadDomain || entry.TailSlope == 0.0 || (entry.HeadSlope > 0.0) != (entry.TailSlope > 0.0))))
+		{
+			laneDomain = Domain::Time;
+		}
+		else
+		{
+			laneRange = getLaneRange(entry.HeadPosition, entry.HeadSlope);
+			if (hasBody)
+			{
+				const Range tailRange = getLaneRange(entry.TailPosition, entry.TailSlope);
+				laneRange.Begin = Min(laneRange.Begin, tailRange.Begin);
+				laneRange.End = Max(laneRange.End, tailRange.End);
+			}
+		}
+
+		// NOTE: Once hit, notes keep being drawn (flying off or sitting on top of the hit circle) independent of their lane position, see ChartGamePreview::CollectNotesToDraw()
+		const Time hitEndTime =
+			IsBalloonNote(noteType) ? entry.Data.Tail.Time :
+			IsLongNote(noteType) ? (entry.Data.Tail.Time + GameNoteHitAnimationDuration) :
+			(entry.Data.Time + GetTotalGameNoteHitAnimationDuration(noteType));
+		const Range hitRange = { Min(entry.Data.Time.Seconds, hitEndTime.Seconds), Max(entry.Data.Time.Seconds, hitEndTime.Seconds), noteIndex };
+
+		if (laneDomain == Domain::Time)
+		{
+			outRangesPerDomain[EnumToIndex(Domain::Time)].push_back(Range { Min(laneRange.Begin, hitRange.Begin), Max(laneRange.End, hitRange.End), noteIndex });
+		}
+		else
+		{
+			outRangesPerDomain[EnumToIndex(laneDomain)].push_back(laneRange);
+			outRangesPerDomain[EnumToIndex(Domain::Time)].push_back(hitRange);
 		}
 	}
 
-	void ChartCourse::RecalculateSENotes(BranchType branch) const
+	static void UpdateNoteLaneRangeList(NoteLaneVisibilityIndex::RangeList& list, std::vector<NoteLaneVisibilityIndex::Range> newRanges, i32 firstChangedNoteIndex)
 	{
-		enum class SEFormType { Long, Short, Alternate, Final };
+		using Range = NoteLaneVisibilityIndex::Range;
+		auto sortByBegin = [](const Range& a, const Range& b) { return a.Begin < b.Begin; };
 
-		// prev, curr, next, n(ext)2nd
-		ForEachNoteLaneData noteDataRingBuffer[4] = {};
-		i32 noteDataRingOffset = 0;
-		auto getNoteData = [&](i32 idx) -> decltype(auto) { return noteDataRingBuffer[(noteDataRingOffset + idx) & 3]; };
+		if (firstChangedNoteIndex <= 0)
+		{
+			list.SortedByBegin.clear();
+			list.Long.clear();
+
+			// NOTE: Relative to the median so that the threshold adapts to the general scroll speed of the chart
+			std::vector<f64> lengths; lengths.reserve(newRanges.size());
+			for (const Range& range : newRanges)
+				if (range.Begin > -F64Max && range.End < F64Max)
+					lengths.push_back(range.End - range.Begin);
+			if (!lengths.empty())
+			{
+				std::nth_element(lengths.begin(), lengths.begin() + (lengths.size() / 2), lengths.end());
+				list.LongThreshold = ClampBot(lengths[lengths.size() / 2] * 8.0, 1.0);
+			}
+			else
+			{
+				list.LongThreshold = F64Max;
+			}
+		}
+		else
+		{
+			auto isOutdated = [&](const Range& range) { return range.NoteIndex >= firstChangedNoteIndex; };
+			list.SortedByBegin.erase(std::remove_if(list.SortedByBegin.begin(), list.SortedByBegin.end(), isOutdated), list.SortedByBegin.end());
+			list.Long.erase(std::remove_if(list.Long.begin(), list.Long.end(), isOutdated), list.Long.end());
+		}
 
-		// distance when curr is on the judgement mark
-		// other is NMScroll: visual beat distance = sec_time * visual_beat_per_second_other
-		// other is HBScroll: visual beat distance = scroll_other * beat_distance
-		auto getVisualBeat = [&](const auto& curr, const auto& other, f32 scrollOther, f32 vbpsOther, Time timeDistance)
+		const size_t unchangedCount = list.SortedByBegin.size();
+		for (const Range& range : newRanges)
 		{
-			return (other.OriginalNote == nullptr) ? F32Max
-				: (other.ScrollType == ScrollMethod::NMSCROLL) ? vbpsOther * timeDistance.Seconds
-				: (other.ScrollType == ScrollMethod::HBSCROLL) ? scrollOther * abs(curr.Beat - other.Beat).Ticks / Beat::TicksPerBeat
-				: /* (prev.ScrollType == ScrollMethod::BMSCROLL) ? */ abs(curr.Beat - other.Beat).Ticks / Beat::TicksPerBeat;
-		};
+			if ((range.End - range.Begin) > list.LongThreshold)
+				list.Long.push_back(range);
+			else
+				list.SortedByBegin.push_back(range);
+		}
+		std::sort(list.SortedByBegin.begin() + unchangedCount, list.SortedByBegin.end(), sortByBegin);
+		std::inplace_merge(list.SortedByBegin.begin(), list.SortedByBegin.begin() + unchangedCount, list.SortedByBegin.end(), sortByBegin);
 
-		auto getNoteDistance = [&]()
+		list.RunningMaxEnd.resize(list.SortedByBegin.size());
+		f64 runningMaxEnd = -F64Max;
+		for (size_t i = 0; i < list.SortedByBegin.size(); i++)
+			list.RunningMaxEnd[i] = runningMaxEnd = Max(runningMaxEnd, list.SortedByBegin[i].End);
+	}
+
+	void NoteLaneVisibilityIndex::Update(const ChartCourse& course, BranchType branch, f32 visibleLaneMinX, f32 visibleLaneMaxX)
+	{
+		static constexpr Beat upToDate = Beat::FromTicks(I32Max);
+		const SortedNotesList& notes = course.GetNotes(branch);
+		Beat& firstChangedBeat = course.NoteLaneFirstChangedBeat[EnumToIndex(branch)];
+
+		const b8 isUntrackedEdit = (firstChangedBeat == upToDate) && (IndexedNoteCount != notes.size() || IndexedTempoChangeCount != course.TempoMap.Tempo.size() ||
+			IndexedScrollChangeCount != course.ScrollChanges.size() || IndexedScrollTypeCount != course.ScrollTypes.size());
+		if (Course != &course || Branch != branch || isUntrackedEdit)
 		{
-			const auto& prev = getNoteData(0);
-			const auto& curr = getNoteData(1);
-			const auto& next = getNoteData(2);
-			const auto& n2nd = getNoteData(3);
-			const f32 scrollPrev = abs(prev.ScrollSpeed.cpx);
-			const f32 scrollNextCapped = std::min(1.0f, abs(next.ScrollSpeed.cpx));
-			// visual beat per second
-			const f32 vbpsPrev = scrollPrev * prev.Tempo.BPM / 60;
-			const f32 vbpsNextCapped = scrollNextCapped * next.Tempo.BPM / 60;
-			// time distance
-			const Time tdToPrev = (prev.OriginalNote == nullptr) ? Time::FromSec(F32Max) : (curr.Time - prev.Time);
-			const Time tdToNext = (next.OriginalNote == nullptr) ? Time::FromSec(F32Max) : (next.Time - curr.Time);
-			const Time tdToN2nd = (n2nd.OriginalNote == nullptr) ? Time::FromSec(F32Max) : (n2nd.Time - next.Time);
-			const f32 vbdToPrev = getVisualBeat(curr, prev, scrollPrev, vbpsPrev, tdToPrev);
-			const f32 vbdToNextCapped = getVisualBeat(curr, next, scrollNextCapped, vbpsNextCapped, tdToNext);
-			return std::tuple{ tdToPrev, vbdToPrev, tdToNext, vbdToNextCapped, tdToN2nd };
-		};
+			Course = &course;
+			Branch = branch;
+			firstChangedBeat = Beat::Zero();
+		}
 
-		const SortedNotesList& notes = GetNotes(branch);
-		std::vector<const Note*> alterChain;
-		b8 isAlterChain = true;
-		Time timeIntervalAlter = Time::Zero();
-		Time timeStartAlter = Time::Zero();
+		// NOTE: Indexing a bit more than the visible range so that a moving hit circle (JPOSSCROLL) or a slowly resized window doesn't cause a rebuild every frame
+		const f32 visibleWidth = (visibleLaneMaxX - visibleLaneMinX);
+		const b8 laneRangeChanged = (visibleLaneMinX < IndexedLaneMinX) || (visibleLaneMaxX > IndexedLaneMaxX) || ((IndexedLaneMaxX - IndexedLaneMinX) > (visibleWidth * 2.0f));
+		if (firstChangedBeat == upToDate && !laneRangeChanged)
+			return;
 
-		auto assignSingleNote = [&]()
+		if (laneRangeChanged)
 		{
-			auto& curr = getNoteData(1);
-			const Note& it = *getNoteData(1).OriginalNote;
-			auto [tdToPrev, vbdToPrev, tdToNext, vbdToNextCapped, tdToN2nd] = getNoteDistance();
-			const Time timeEpsilon = Time::FromMS(1e-3);
-			const b8 denseToSparse = (tdToNext >= tdToPrev + timeEpsilon);
-			const b8 sparseToDense = (tdToN2nd <= tdToNext - timeEpsilon);
-			const f32 beatsEpsilon = 4 / 192.0;
-			const b8 isLongAvoided = (vbdToPrev <= 4 / 16.0 - beatsEpsilon
-				|| vbdToNextCapped <= 4 / 12.0 - beatsEpsilon); // avoid text from overlapping or extending under next note
-			const b8 isPrePause = (vbdToNextCapped >= 4 / 8.0 + beatsEpsilon);
-			auto se = (!isLongAvoided && (denseToSparse || sparseToDense || isPrePause)) ? SEFormType::Long : SEFormType::Short;
-			if (isAlterChain) {
-				if (it.Type == NoteType::Don && alterChain.empty()) {
-					timeIntervalAlter = tdToNext;
-					timeStartAlter = curr.Time;
-					alterChain.push_back(&it);
-				} else if (it.Type == NoteType::Don && abs(tdToPrev - timeIntervalAlter) < timeEpsilon && abs(timeStartAlter - curr.Time) < Time::FromSec(0.5) + timeEpsilon) {
-					alterChain.push_back(&it);
-				} else {
-					isAlterChain = false;
-					alterChain.clear();
-				}
+			IndexedLaneMinX = visibleLaneMinX - (visibleWidth * 0.25f);
+			IndexedLaneMaxX = visibleLaneMaxX + (visibleWidth * 0.25f);
+		}
+
+		// NOTE: Notes before the first changed beat are unaffected by the edit (and keep their index), unless they are long notes ending after it
+		size_t firstChangedNoteIndex = notes.size();
+		if (firstChangedBeat != upToDate)
+		{
+			firstChangedNoteIndex = static_cast<size_t>(std::distance(notes.begin(), std::lower_bound(notes.begin(), notes.end(), firstChangedBeat, [](const Note& note, Beat b) { return note.BeatTime < b; })));
+			firstChangedNoteIndex = Min(firstChangedNoteIndex, Notes.size());
+			for (size_t i = 0; i < firstChangedNoteIndex; i++)
+			{
+				if (Notes[i].Data.Tail.Beat >= firstChangedBeat) { firstChangedNoteIndex = i; break; }
 			}
-			if (denseToSparse || sparseToDense) {
-				if (denseToSparse && isAlterChain && !isLongAvoided && size(alterChain) % 2 != 0 && abs(timeStartAlter - curr.Time) < Time::FromSec(0.5) + timeEpsilon) {
-					for (i32 ia = 0; ia < size(alterChain); ++ia) {
-						if (ia % 2 == 1)
-							alterChain[ia]->TempSEType = NoteSEType::Ko;
-					}
-				}
-				alterChain.clear();
-				isAlterChain = sparseToDense;
+
+			Notes.resize(firstChangedNoteIndex);
+			Notes.reserve(notes.size());
+			ForEachNoteOnNoteLane(course, branch, firstChangedNoteIndex, [&](const ForEachNoteLaneData& it) { Notes.push_back(CreateNoteLaneEntry(it, course.TempoMap.AccelerationStructure)); });
+		}
+
+		const size_t firstChangedRangeNoteIndex = laneRangeChanged ? 0 : firstChangedNoteIndex;
+		std::vector<Range> newRangesPerDomain[EnumCount<Domain>];
+		for (size_t i = firstChangedRangeNoteIndex; i < Notes.size(); i++)
+			AppendNoteLaneRanges(Notes[i], notes[i].Type, static_cast<i32>(i), IndexedLaneMinX, IndexedLaneMaxX, newRangesPerDomain);
+		for (size_t i = 0; i < EnumCount<Domain>; i++)
+			UpdateNoteLaneRangeList(Ranges[i], std::move(newRangesPerDomain[i]), static_cast<i32>(firstChangedRangeNoteIndex));
+
+		IndexedNoteCount = notes.size();
+		IndexedTempoChangeCount = course.TempoMap.Tempo.size();
+		IndexedScrollChangeCount = course.ScrollChanges.size();
+		IndexedScrollTypeCount = course.ScrollTypes.size();
+		firstChangedBeat = upToDate;
+	}
+
+	void NoteLaneVisibilityIndex::Query(Time cursorTime, f64 cursorHBScrollBeatTick, std::vector<i32>& outSortedNoteIndices) const
+	{
+		outSortedNoteIndices.clear();
+		const f64 cursorPerDomain[EnumCount<Domain>] = { cursorTime.Seconds, cursorHBScrollBeatTick };
+		for (size_t domain = 0; domain < EnumCount<Domain>; domain++)
+		{
+			const RangeList& list = Ranges[domain];
+			const f64 cursor = cursorPerDomain[domain];
+
+			const size_t endIndex = static_cast<size_t>(std::distance(list.SortedByBegin.begin(), std::upper_bound(list.SortedByBegin.begin(), list.SortedByBegin.end(), cursor, [](f64 c, const Range& range) { return c < range.Begin; })));
+			for (size_t i = endIndex; i-- > 0;)
+			{
+				if (list.RunningMaxEnd[i] < cursor)
+					break;
+				if (list.SortedByBegin[i].End >= cursor)
+					outSortedNoteIndices.push_back(list.SortedByBegin[i].NoteIndex);
 			}
 
-			switch (it.Type)
+			for (const Range& range : list.Long)
 			{
-			case NoteType::Don: { it.TempSEType = (se == SEFormType::Long) ? NoteSEType::Don : NoteSEType::Do; } break;
-			case NoteType::DonBig: { it.TempSEType = NoteSEType::DonBig; } break;
-			case NoteType::DonBigHand: { it.TempSEType = NoteSEType::DonHand; } break;
-			case NoteType::Ka: { it.TempSEType = (se == SEFormType::Long) ? NoteSEType::Katsu : NoteSEType::Ka; } break;
-			case NoteType::KaBig: { it.TempSEType = NoteSEType::KatsuBig; } break;
-			case NoteType::KaBigHand: { it.TempSEType = NoteSEType::KatsuHand; } break;
-			case NoteType::Drumroll: { it.TempSEType = NoteSEType::Drumroll; } break;
-			case NoteType::DrumrollBig: { it.TempSEType = NoteSEType::DrumrollBig; } break;
-			case NoteType::Balloon: { it.TempSEType = NoteSEType::Balloon; } break;
-			case NoteType::BalloonSpecial: { it.TempSEType = NoteSEType::BalloonSpecial; } break;
-			default: { it.TempSEType = NoteSEType::Count; } break;
+				if (range.Begin <= cursor && range.End >= cursor)
+					outSortedNoteIndices.push_back(range.NoteIndex);
+			}
+		}
+
+		// NOTE: Drawing order depends on the note order and a note can be a candidate in both domains
+		std::sort(outSortedNoteIndices.begin(), outSortedNoteIndices.end());
+		outSortedNoteIndices.erase(std::unique(outSortedNoteIndices.begin(), outSortedNoteIndices.end()), outSortedNoteIndices.end());
+	}
+
+	NoteLaneVisibilityIndex& ChartGamePreview::UpdateVisibilityIndex(const ChartCourse& course, BranchType branch, vec2 hitCirclePosLane)
+	{
+		auto it = std::find_if(VisibilityIndices.begin(), VisibilityIndices.end(), [&](const NoteLaneVisibilityIndex& index) { return (index.Course == &course && index.Branch == branch); });
+		NoteLaneVisibilityIndex& index = (it != VisibilityIndices.end()) ? *it : VisibilityIndices.emplace_back();
+
+		const f32 threshold = GameCamera::DefaultLaneVisibilityThreshold;
+		index.Update(course, branch, -threshold - hitCirclePosLane.x, Camera.LaneWidth() + threshold - hitCirclePosLane.x);
+		return index;
+	}
+
+	void ChartGamePreview::CollectNotesToDraw(const ChartCourse& course, BranchType branch, const NoteLaneVisibilityIndex* visibilityIndex, vec2 hitCirclePosLane, Time cursorTime, f64 cursorHBScrollBeatTick)
+	{
+		const TempoMapAccelerationStructure& tempoChanges = course.TempoMap.AccelerationStructure;
+		const SortedJPOSScrollChangesList& jposScrollChanges = course.JPOSScrollChanges;
+
+		auto collectNote = [&](const ForEachNoteLaneData& it)
+		{
+			vec2 laneHead = Camera.GetNoteCoordinatesLane(hitCirclePosLane, cursorTime, cursorHBScrollBeatTick, it.Time, it.Beat, it.Tempo, it.ScrollSpeed, it.ScrollType, tempoChanges, jposScrollChanges);
+			vec2 laneTail = Camera.GetNoteCoordinatesLane(hitCirclePosLane, cursorTime, cursorHBScrollBeatTick, it.Tail.Time, it.Tail.Beat, it.Tail.Tempo, it.Tail.ScrollSpeed, it.Tail.ScrollType, tempoChanges, jposScrollChanges);
+
+			b8 isVisible = true;
+
+			const Time timeSinceHeadHit = TimeSinceNoteHit(it.Time, cursorTime);
+			const Time timeSinceTailHit = TimeSinceNoteHit(it.Tail.Time, cursorTime);
+			if (IsRegularNote(it.OriginalNote->Type)) {
+				if (timeSinceHeadHit >= Time::Zero())
+					laneHead = laneTail = hitCirclePosLane; // temporary value, override when drawn
+				if (timeSinceHeadHit > GetTotalGameNoteHitAnimationDuration(it.OriginalNote->Type))
+					isVisible = false;
+			}
+			else if (IsBalloonNote(it.OriginalNote->Type)) {
+				if (timeSinceTailHit >= Time::Zero()) {
+					laneHead = laneTail;
+					isVisible = false;
+				}
+				else if (timeSinceHeadHit >= Time::Zero())
+					laneHead = hitCirclePosLane;
+			}
+			else { // is bar roll note
+				// flying notes in screen?
+				isVisible = ((timeSinceHeadHit >= Time::Zero() && timeSinceTailHit <= GameNoteHitAnimationDuration)
+					// roll body in screen?
+					|| Camera.IsRangeVisibleOnLane(Min(laneHead.x, laneTail.x), Max(laneHead.x, laneTail.x)));
 			}
+			if (isVisible)
+				ReverseNoteDrawBuffer.push_back(DeferredNoteDrawData{ laneHead.x, laneTail.x, laneHead.y, laneTail.y, it.Tempo, it.ScrollSpeed, it.OriginalNote, it.Time, it.Tail.Time });
 		};
 
-		// fetch 2nd next note, update current note
-		i32 lastFilled = 0;
-		ForEachNoteOnNoteLane(*this, branch, [&](const ForEachNoteLaneData& dataIt)
+		if (visibilityIndex == nullptr)
 		{
-			if (getNoteData(1).OriginalNote != nullptr)
-				assignSingleNote();
-			noteDataRingOffset = (noteDataRingOffset + 1) & 3;
-			getNoteData(3) = dataIt;
-			lastFilled = 3;
-		});
-		for (; lastFilled >= 1; --lastFilled) {
-			if (getNoteData(1).OriginalNote != nullptr)
-				assignSingleNote();
-			noteDataRingOffset = (noteDataRingOffset + 1) & 3;
-			getNoteData(3).OriginalNote = nullptr;
+			ForEachNoteOnNoteLane(course, branch, collectNote);
+			return;
+		}
+
+		const SortedNotesList& notes = course.GetNotes(branch);
+		assert(visibilityIndex->Course == &course && visibilityIndex->Branch == branch && visibilityIndex->Notes.size() == notes.size());
+
+		visibilityIndex->Query(cursorTime, cursorHBScrollBeatTick, VisibleNoteIndicesBuffer);
+		for (const i32 noteIndex : VisibleNoteIndicesBuffer)
+		{
+			ForEachNoteLaneData data = visibilityIndex->Notes[noteIndex].Data;
+			data.OriginalNote = &notes[noteIndex];
+			collectNote(data);
 		}
 	}
 
 	void ChartGamePreview::DrawGui(ChartContext& context, Time animatedCursorTime)
 	{
+		// NOTE: Dropping the indices of closed or removed courses
+		VisibilityIndices.erase(std::remove_if(VisibilityIndices.begin(), VisibilityIndices.end(), [&](const NoteLaneVisibilityIndex& index)
+		{
+			return std::none_of(context.Chart.Courses.begin(), context.Chart.Courses.end(), [&](const auto& course) { return course.get() == index.Course; });
+		}), VisibilityIndices.end());
+
 		const i32 nLanes = size(context.ChartsCompared);
 
 		static constexpr vec2 buttonMargin = vec2(8.0f);
@@ -750,38 +884,8 @@ namespace PeepoDrumKit
 #endif
 
 			drawList->ChannelsSetCurrent(3);
-			ForEachNoteOnNoteLane(*course, branch, [&](const ForEachNoteLaneData& it)
-			{
-				vec2 laneHead = Camera.GetNoteCoordinatesLane(hitCirclePosLane, cursorTimeOrAnimated, cursorHBScrollBeatOrAnimated, it.Time, it.Beat, it.Tempo, it.ScrollSpeed, it.ScrollType, tempoChanges, jposScrollChanges);
-				vec2 laneTail = Camera.GetNoteCoordinatesLane(hitCirclePosLane, cursorTimeOrAnimated, cursorHBScrollBeatOrAnimated, it.Tail.Time, it.Tail.Beat, it.Tail.Tempo, it.Tail.ScrollSpeed, it.Tail.ScrollType, tempoChanges, jposScrollChanges);
-
-				b8 isVisible = true;
-
-				const Time timeSinceHeadHit = TimeSinceNoteHit(it.Time, cursorTimeOrAnimated);
-				const Time timeSinceTailHit = TimeSinceNoteHit(it.Tail.Time, cursorTimeOrAnimated);
-				if (IsRegularNote(it.OriginalNote->Type)) {
-					if (timeSinceHeadHit >= Time::Zero())
-						laneHead = laneTail = hitCirclePosLane; // temporary value, override when drawn
-					if (timeSinceHeadHit > GetTotalGameNoteHitAnimationDuration(it.OriginalNote->Type))
-						isVisible = false;
-				}
-				else if (IsBalloonNote(it.OriginalNote->Type)) {
-					if (timeSinceTailHit >= Time::Zero()) {
-						laneHead = laneTail;
-						isVisible = false;
-					}
-					else if (timeSinceHeadHit >= Time::Zero())
-						laneHead = hitCirclePosLane;
-				}
-				else { // is bar roll note
-					// flying notes in screen?
-					isVisible = ((timeSinceHeadHit >= Time::Zero() && timeSinceTailHit <= GameNoteHitAnimationDuration)
-						// roll body in screen?
-						|| Camera.IsRangeVisibleOnLane(Min(laneHead.x, laneTail.x), Max(laneHead.x, laneTail.x)));
-				}
-				if (isVisible)
-					ReverseNoteDrawBuffer.push_back(DeferredNoteDrawData{ laneHead.x, laneTail.x, laneHead.y, laneTail.y, it.Tempo, it.ScrollSpeed, it.OriginalNote, it.Time, it.Tail.Time });
-			});
+			const NoteLaneVisibilityIndex& visibilityIndex = UpdateVisibilityIndex(*course, branch, hitCirclePosLane);
+			CollectNotesToDraw(*course, branch, &visibilityIndex, hitCirclePosLane, cursorTimeOrAnimated, cursorHBScrollBeatOrAnimated);
 
 			const Beat drummrollHitInterval = GetGridBeatSnap(*Settings.General.DrumrollAutoHitBarDivision);
 			for (auto it = ReverseNoteDrawBuffer.rbegin(); it != ReverseNoteDrawBuffer.rend(); it++)
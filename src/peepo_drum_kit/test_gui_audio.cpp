@@ -1,10 +1,18 @@
 #include "test_gui_audio.h"
+#include "audio/audio_waveform.h"
+#include "audio/audio_backend.h"
+#include "core_io.h"
 #include "imgui/imgui_include.h"
+#include <thread>
+#include <filesystem>
 
 namespace PeepoDrumKit
 {
 	void AudioTestWindow::DrawGui()
 	{
+		UpdateVoiceRenderBenchmark();
+		UpdateOneShotStressBenchmark();
+
 		const ImVec2 originalFramePadding = Gui::GetStyle().FramePadding;
 		Gui::PushStyleVar(ImGuiStyleVar_FramePadding, GuiScale(vec2(10.0f, 5.0f)));
 		Gui::PushStyleColor(ImGuiCol_TabHovered, Gui::GetStyleColorVec4(ImGuiCol_HeaderActive));
@@ -18,6 +26,7 @@ namespace PeepoDrumKit
 			beginEndTabItem("Audio Engine", [this] { AudioEngineTabContent(); });
 			beginEndTabItem("Active Voices", [this] { ActiveVoicesTabContent(); });
 			beginEndTabItem("Loaded Sources", [this] { LoadedSourcesTabContent(); });
+			beginEndTabItem("Benchmark", [this] { BenchmarkTabContent(); });
 			Gui::EndTabBar();
 		}
 		Gui::PopStyleColor(2);
@@ -133,6 +142,11 @@ namespace PeepoDrumKit
 					Gui::PlotLines("##CallbackProcessDuration", durationsMS, ArrayCountI32(durationsMS), 0, overlayTextBuffer, FLT_MAX, FLT_MAX, vec2(Gui::GetContentRegionAvail().x, 32.0f));
 				});
 
+				Gui::Property::PropertyTextValueFunc("Late Callbacks", [&]
+				{
+					Gui::Text("%lld", static_cast<long long>(Audio::Engine.DebugGetLateCallbackCount()));
+				});
+
 				Gui::Property::PropertyTextValueFunc("Rendered Samples", [&]
 				{
 					Gui::PushStyleColor(ImGuiCol_PlotLines, Gui::GetStyleColorVec4(ImGuiCol_PlotHistogram));
@@ -183,7 +197,7 @@ namespace PeepoDrumKit
 				Gui::TableNextColumn(); Gui::Text("%.0f%%", ToPercent(voiceIt.GetVolume()));
 				Gui::TableNextColumn(); Gui::Text("%.0f%%", ToPercent(voiceIt.GetPan()));
 				Gui::TableNextColumn(); Gui::Text("%.0f%%", ToPercent(voiceIt.GetPlaybackSpeed()));
-				Gui::TableNextColumn(); Gui::Text("0x%04X", static_cast<Audio::HandleBaseType>(voiceIt.Handle));
+				Gui::TableNextColumn(); Gui::Text("0x%08X", static_cast<u32>(voiceIt.Handle));
 				Gui::TableNextColumn(); Gui::Text("0x%04X", static_cast<Audio::HandleBaseType>(voiceIt.GetSource()));
 				static_assert(sizeof(Audio::HandleBaseType) == 2, "TODO: Update format strings");
 
@@ -289,9 +303,7 @@ namespace PeepoDrumKit
 			sourcePreviewVoice.SetPauseOnEnd(true);
 		}
 
-		sourcePreviewVoice.SetSource(source);
-		sourcePreviewVoice.SetPosition(startTime);
-		sourcePreviewVoice.SetIsPlaying(true);
+		sourcePreviewVoice.SetParams(Audio::VoiceParamBatch {}.SetSource(source).SetPosition(startTime).SetIsPlaying(true));
 	}
 
 	void AudioTestWindow::StopSourcePreview()
@@ -305,4 +317,1202 @@ namespace PeepoDrumKit
 		if (sourcePreviewVoiceHasBeenAdded)
 			Audio::Engine.RemoveVoice(sourcePreviewVoice);
 	}
+
+	void AudioTestWindow::BenchmarkTabContent()
+	{
+		if (Gui::CollapsingHeader("Voice Rendering", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			auto& benchmark = voiceRenderBenchmark;
+
+			Gui::BeginDisabled(benchmark.IsRunning);
+			if (Gui::Button("Run Voice Render Benchmark"))
+				StartVoiceRenderBenchmark();
+			Gui::EndDisabled();
+
+			if (benchmark.IsRunning)
+			{
+				Gui::SameLine();
+				Gui::TextDisabled("Measuring %d voices...", benchmark.VoiceCounts[benchmark.StageIndex]);
+			}
+
+			static constexpr cstr resultsTableFields[] = { "Live Voices", "Average", "Max", "Average Buffer Usage", };
+			if (Gui::BeginTable("VoiceRenderBenchmarkTable", ArrayCountI32(resultsTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+			{
+				for (cstr field : resultsTableFields)
+					Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+				Gui::TableHeadersRow();
+
+				for (const auto& result : benchmark.Results)
+				{
+					Gui::TableNextRow();
+					Gui::TableNextColumn(); Gui::Text("%d", result.VoiceCount);
+					Gui::TableNextColumn(); Gui::Text("%.6f ms", result.Average.ToMS());
+					Gui::TableNextColumn(); Gui::Text("%.6f ms", result.Max.ToMS());
+					Gui::TableNextColumn(); Gui::Text("%.2f%%", ToPercent(static_cast<f32>(result.Average / result.BufferDuration)));
+				}
+				Gui::EndTable();
+			}
+		}
+
+		if (Gui::CollapsingHeader("One-Shot Stress (Drumroll)", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			auto& benchmark = oneShotStressBenchmark;
+
+			Gui::BeginDisabled(benchmark.IsRunning);
+			if (Gui::Button("Run One-Shot Stress Benchmark"))
+				StartOneShotStressBenchmark();
+			Gui::EndDisabled();
+
+			if (benchmark.IsRunning)
+			{
+				Gui::SameLine();
+				Gui::TextDisabled("Firing %d one-shots per second...", benchmark.OneShotsPerSecond[benchmark.StageIndex]);
+			}
+
+			static constexpr cstr resultsTableFields[] = { "One-Shots / Second", "Fired", "Dropped", "Average", "Max", "Average Buffer Usage", };
+			if (Gui::BeginTable("OneShotStressBenchmarkTable", ArrayCountI32(resultsTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+			{
+				for (cstr field : resultsTableFields)
+					Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+				Gui::TableHeadersRow();
+
+				for (const auto& result : benchmark.Results)
+				{
+					Gui::TableNextRow();
+					Gui::TableNextColumn(); Gui::Text("%d", result.OneShotsPerSecond);
+					Gui::TableNextColumn(); Gui::Text("%lld", static_cast<long long>(result.FiredCount));
+					Gui::TableNextColumn();
+					if (result.DroppedCount == 0)
+						Gui::Text("%lld", static_cast<long long>(result.DroppedCount));
+					else
+						Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "%lld", static_cast<long long>(result.DroppedCount));
+					Gui::TableNextColumn(); Gui::Text("%.6f ms", result.Average.ToMS());
+					Gui::TableNextColumn(); Gui::Text("%.6f ms", result.Max.ToMS());
+					Gui::TableNextColumn(); Gui::Text("%.2f%%", ToPercent(static_cast<f32>(result.Average / result.BufferDuration)));
+				}
+				Gui::EndTable();
+			}
+		}
+
+		if (Gui::CollapsingHeader("Scheduled Sound Onsets", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			auto& benchmark = scheduledSoundBenchmark;
+			if (Gui::Button("Run Scheduled Sound Benchmark"))
+				RunScheduledSoundBenchmark();
+
+			if (!benchmark.ErrorMessage.empty())
+			{
+				Gui::SameLine();
+				Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "%s", benchmark.ErrorMessage.c_str());
+			}
+
+			static constexpr cstr resultsTableFields[] = { "Method", "Buffer Size", "Playback Speed", "Detected Onsets", "Mean Error", "Max Error" };
+			if (Gui::BeginTable("ScheduledSoundBenchmarkTable", ArrayCountI32(resultsTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+			{
+				for (cstr field : resultsTableFields)
+					Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+				Gui::TableHeadersRow();
+
+				for (const auto& result : benchmark.Results)
+				{
+					Gui::TableNextRow();
+					Gui::TableNextColumn(); Gui::TextUnformatted(result.Method);
+					Gui::TableNextColumn(); Gui::Text("%u frames", result.BufferFrameCount);
+					Gui::TableNextColumn(); Gui::Text("%.0f%%", ToPercent(result.PlaybackSpeed));
+					Gui::TableNextColumn();
+					if (result.DetectedCount == result.ExpectedCount)
+						Gui::Text("%d / %d", result.DetectedCount, result.ExpectedCount);
+					else
+						Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "%d / %d", result.DetectedCount, result.ExpectedCount);
+					Gui::TableNextColumn(); Gui::Text("%.3f ms", result.MeanAbsErrorMS);
+					Gui::TableNextColumn(); Gui::Text("%.3f ms", result.MaxAbsErrorMS);
+				}
+				Gui::EndTable();
+			}
+		}
+
+		if (Gui::CollapsingHeader("Null Backend Render", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			auto& test = nullBackendRenderTest;
+			if (Gui::Button("Run Null Backend Render Test"))
+				RunNullBackendRenderTest();
+
+			if (!test.ErrorMessage.empty())
+			{
+				Gui::SameLine();
+				Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "%s", test.ErrorMessage.c_str());
+			}
+
+			static constexpr cstr resultsTableFields[] = { "Buffer Size", "Rendered Frames", "Clicks", "Mismatched Frames", "Render Time", "Realtime Factor" };
+			if (Gui::BeginTable("NullBackendRenderTestTable", ArrayCountI32(resultsTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+			{
+				for (cstr field : resultsTableFields)
+					Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+				Gui::TableHeadersRow();
+
+				for (const auto& result : test.Results)
+				{
+					const Time renderedDuration = Audio::FramesToTime(result.RenderedFrameCount, Audio::AudioEngine::OutputSampleRate);
+					Gui::TableNextRow();
+					Gui::TableNextColumn(); Gui::Text("%u frames", result.BufferFrameCount);
+					Gui::TableNextColumn(); Gui::Text("%lld", static_cast<long long>(result.RenderedFrameCount));
+					Gui::TableNextColumn(); Gui::Text("%d", result.ClickCount);
+					Gui::TableNextColumn();
+					if (result.MismatchedFrameCount == 0)
+						Gui::TextUnformatted("None");
+					else
+						Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "%lld (first at frame %lld)", static_cast<long long>(result.MismatchedFrameCount), static_cast<long long>(result.FirstMismatchedFrame));
+					Gui::TableNextColumn(); Gui::Text("%.3f ms", result.RenderDuration.ToMS());
+					Gui::TableNextColumn(); Gui::Text("x%.1f", renderedDuration.ToSec() / Max(result.RenderDuration.ToSec(), 0.000001));
+				}
+				Gui::EndTable();
+			}
+		}
+
+		if (Gui::CollapsingHeader("Mix Kernels", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (Gui::Button("Run Mix Kernel Benchmark"))
+				RunMixKernelBenchmark();
+
+			if (Gui::BeginTable("MixKernelBenchmarkTable", 2 + EnumCount<Audio::MixKernelPath>, ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+			{
+				Gui::TableSetupColumn("Kernel", ImGuiTableColumnFlags_None);
+				for (cstr pathName : Audio::MixKernelPathNames)
+					Gui::TableSetupColumn(pathName, ImGuiTableColumnFlags_None);
+				Gui::TableSetupColumn("Bit Exact", ImGuiTableColumnFlags_None);
+				Gui::TableHeadersRow();
+
+				for (const auto& result : mixKernelBenchmark.Results)
+				{
+					Gui::TableNextRow();
+					Gui::TableNextColumn(); Gui::TextUnformatted(result.KernelName);
+					for (size_t path = 0; path < EnumCount<Audio::MixKernelPath>; path++)
+					{
+						Gui::TableNextColumn();
+						if (result.SamplesPerSecond[path] <= 0.0)
+							Gui::TextDisabled("(Unsupported)");
+						else
+							Gui::Text("%.1f MSamples/s (x%.2f)", result.SamplesPerSecond[path] / 1000000.0, result.SamplesPerSecond[path] / result.SamplesPerSecond[0]);
+					}
+					Gui::TableNextColumn();
+					if (result.IsBitExact)
+						Gui::TextColored(ImVec4(0.2f, 0.9f, 0.2f, 1.0f), "Yes");
+					else
+						Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "NO");
+				}
+				Gui::EndTable();
+			}
+		}
+
+		if (Gui::CollapsingHeader("Resampler", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (Gui::Button("Run Resampler Benchmark"))
+				RunResamplerBenchmark();
+
+			static constexpr cstr resultsTableFields[] = { "Conversion", "Linear", "Sinc", "Linear THD+N (Worst / Avg)", "Sinc THD+N (Worst / Avg)" };
+			if (Gui::BeginTable("ResamplerBenchmarkTable", ArrayCountI32(resultsTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+			{
+				for (cstr field : resultsTableFields)
+					Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+				Gui::TableHeadersRow();
+
+				for (const auto& result : resamplerBenchmark.Results)
+				{
+					Gui::TableNextRow();
+					Gui::TableNextColumn(); Gui::Text("%u Hz -> %u Hz (%.0f%% speed, %d tones)", result.Case.SourceSampleRate, Audio::AudioEngine::OutputSampleRate, ToPercent(static_cast<f32>(result.Case.PlaybackSpeed)), result.ToneCount);
+					for (size_t i = 0; i < 2; i++) { Gui::TableNextColumn(); Gui::Text("%.2f MFrames/s (x%.2f)", result.FramesPerSecond[i] / 1000000.0, result.FramesPerSecond[i] / result.FramesPerSecond[0]); }
+					for (size_t i = 0; i < 2; i++) { Gui::TableNextColumn(); Gui::Text("%.1f dB / %.1f dB", result.WorstTHDN[i], result.AverageTHDN[i]); }
+				}
+				Gui::EndTable();
+			}
+		}
+
+		if (Gui::CollapsingHeader("Song Loading", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			auto& benchmark = songLoadingBenchmark;
+			Gui::SetNextItemWidth(Gui::GetContentRegionAvail().x * 0.6f);
+			Gui::InputTextWithHint("##FilePath", "Audio file path...", &benchmark.FilePath);
+			Gui::SameLine();
+			if (Gui::Button("Run Song Loading Benchmark"))
+				RunSongLoadingBenchmark();
+
+			if (!benchmark.ErrorMessage.empty())
+				Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "%s", benchmark.ErrorMessage.c_str());
+
+			static constexpr cstr resultsTableFields[] = { "Method", "Time to First Audio", "Time to Waveform", "Peak Memory", "Resident Memory" };
+			if (Gui::BeginTable("SongLoadingBenchmarkTable", ArrayCountI32(resultsTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+			{
+				for (cstr field : resultsTableFields)
+					Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+				Gui::TableHeadersRow();
+
+				for (const auto& result : benchmark.Results)
+				{
+					Gui::TableNextRow();
+					Gui::TableNextColumn(); Gui::TextUnformatted(result.Method);
+					Gui::TableNextColumn(); Gui::Text("%.3f ms", result.TimeToFirstAudio.ToMS());
+					Gui::TableNextColumn(); Gui::Text("%.3f ms", result.TimeToWaveform.ToMS());
+					Gui::TableNextColumn(); Gui::Text("%.2f MB", static_cast<f64>(result.PeakByteSize) / (1024.0 * 1024.0));
+					Gui::TableNextColumn(); Gui::Text("%.2f MB", static_cast<f64>(result.ResidentByteSize) / (1024.0 * 1024.0));
+				}
+				Gui::EndTable();
+			}
+		}
+
+		if (Gui::CollapsingHeader("Decoding", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			auto& benchmark = decodeBenchmark;
+			Gui::SetNextItemWidth(Gui::GetContentRegionAvail().x * 0.6f);
+			Gui::InputTextWithHint("##CorpusDirectory", "Corpus directory path...", &benchmark.CorpusDirectory);
+			Gui::SameLine();
+			if (Gui::Button("Run Decode Benchmark"))
+				RunDecodeBenchmark();
+
+			if (!benchmark.ErrorMessage.empty())
+				Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "%s", benchmark.ErrorMessage.c_str());
+
+			static constexpr cstr resultsTableFields[] = { "Format", "Files", "File Size", "Audio Duration", "Decode Time", "Realtime Factor", "Throughput", "Peak Memory" };
+			if (benchmark.HasResults && Gui::BeginTable("DecodeBenchmarkTable", ArrayCountI32(resultsTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+			{
+				for (cstr field : resultsTableFields)
+					Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+				Gui::TableHeadersRow();
+
+				for (size_t i = 0; i < ArrayCount(benchmark.Results); i++)
+				{
+					const auto& result = benchmark.Results[i];
+					Gui::TableNextRow();
+					Gui::TableNextColumn(); Gui::TextUnformatted(Audio::SupportedFileFormatExtensions[i]);
+					Gui::TableNextColumn(); Gui::Text("%d", result.FileCount);
+					Gui::TableNextColumn(); Gui::Text("%.2f MB", static_cast<f64>(result.FileByteSize) / (1024.0 * 1024.0));
+					Gui::TableNextColumn(); Gui::Text("%.1f sec", result.AudioDuration.ToSec());
+					Gui::TableNextColumn(); Gui::Text("%.3f ms", result.DecodeDuration.ToMS());
+					Gui::TableNextColumn(); Gui::Text("x%.1f", (result.DecodeDuration.ToSec() > 0.0) ? (result.AudioDuration.ToSec() / result.DecodeDuration.ToSec()) : 0.0);
+					Gui::TableNextColumn(); Gui::Text("%.1f MB/s", (result.DecodeDuration.ToSec() > 0.0) ? (static_cast<f64>(result.DecodedByteSize) / (1024.0 * 1024.0) / result.DecodeDuration.ToSec()) : 0.0);
+					Gui::TableNextColumn(); Gui::Text("%.2f MB", static_cast<f64>(result.PeakByteSize) / (1024.0 * 1024.0));
+				}
+				Gui::EndTable();
+			}
+		}
+
+		if (Gui::CollapsingHeader("Waveform Generation", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			auto& benchmark = waveformBenchmark;
+			if (Gui::Button("Run Waveform Benchmark"))
+				RunWaveformBenchmark();
+			if (!benchmark.Results.empty())
+			{
+				Gui::SameLine();
+				Gui::Text("Mip chain arena size: %.2f MB per channel", static_cast<f64>(benchmark.ArenaByteSize) / (1024.0 * 1024.0));
+			}
+
+			if (Gui::BeginTable("WaveformBenchmarkTable", 2 + EnumCount<Audio::MixKernelPath>, ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+			{
+				Gui::TableSetupColumn("Method", ImGuiTableColumnFlags_None);
+				for (cstr pathName : Audio::MixKernelPathNames)
+					Gui::TableSetupColumn(pathName, ImGuiTableColumnFlags_None);
+				Gui::TableSetupColumn("Bit Exact", ImGuiTableColumnFlags_None);
+				Gui::TableHeadersRow();
+
+				const Time referenceDuration = benchmark.Results.empty() ? Time::Zero() : benchmark.Results[0].Durations[0];
+				for (const auto& result : benchmark.Results)
+				{
+					Gui::TableNextRow();
+					Gui::TableNextColumn(); Gui::TextUnformatted(result.Method);
+					for (size_t path = 0; path < EnumCount<Audio::MixKernelPath>; path++)
+					{
+						Gui::TableNextColumn();
+						if (result.Durations[path] <= Time::Zero())
+							Gui::TextDisabled("(Unsupported)");
+						else
+							Gui::Text("%.3f ms (x%.2f)", result.Durations[path].ToMS(), referenceDuration.ToSec() / result.Durations[path].ToSec());
+					}
+					Gui::TableNextColumn();
+					if (result.IsBitExact)
+						Gui::TextColored(ImVec4(0.2f, 0.9f, 0.2f, 1.0f), "Yes");
+					else
+						Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "NO");
+				}
+				Gui::EndTable();
+			}
+
+			static constexpr cstr zoomTableFields[] = { "Timeline Zoom", "Time per Pixel", "Frame Time (Avg)", "Frame Time (Max)" };
+			if (!benchmark.ZoomResults.empty() && Gui::BeginTable("WaveformZoomBenchmarkTable", ArrayCountI32(zoomTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+			{
+				for (cstr field : zoomTableFields)
+					Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+				Gui::TableHeadersRow();
+
+				for (const auto& result : benchmark.ZoomResults)
+				{
+					Gui::TableNextRow();
+					Gui::TableNextColumn(); Gui::Text("x%g (%d px, both channels)", result.Zoom, WaveformBenchmarkData::TimelineWidthInPixels);
+					Gui::TableNextColumn(); Gui::Text("%.3f ms", result.TimePerPixel.ToMS());
+					Gui::TableNextColumn(); Gui::Text("%.3f ms", result.AverageFrameTime.ToMS());
+					Gui::TableNextColumn(); Gui::Text("%.3f ms", result.MaxFrameTime.ToMS());
+				}
+				Gui::EndTable();
+			}
+		}
+	}
+
+	// NOTE: Least squares fit of a sine at the expected frequency, with everything not explained by it counting as distortion and noise
+	static f64 MeasureSineTHDNDecibel(const i16* interleavedSamples, i64 frameCount, u32 channelCount, f64 cyclesPerFrame)
+	{
+		// NOTE: Skip the edges where the kernels ramp in and out of the zero padding
+		const i64 startFrame = (frameCount / 8), endFrame = (frameCount - (frameCount / 8));
+		const auto phaseAt = [&](i64 frame) { return Angle::FromRadians(static_cast<f32>(2.0 * PI * Mod(cyclesPerFrame * static_cast<f64>(frame), 1.0))); };
+
+		f64 sinSin = 0.0, cosCos = 0.0, sinCos = 0.0, valueSin = 0.0, valueCos = 0.0;
+		for (i64 f = startFrame; f < endFrame; f++)
+		{
+			const f64 s = Sin(phaseAt(f)), c = Cos(phaseAt(f)), value = interleavedSamples[f * channelCount];
+			sinSin += (s * s); cosCos += (c * c); sinCos += (s * c); valueSin += (value * s); valueCos += (value * c);
+		}
+
+		const f64 determinant = (sinSin * cosCos) - (sinCos * sinCos);
+		const f64 sinAmplitude = ((valueSin * cosCos) - (valueCos * sinCos)) / determinant;
+		const f64 cosAmplitude = ((valueCos * sinSin) - (valueSin * sinCos)) / determinant;
+
+		f64 signalPower = 0.0, residualPower = 0.0;
+		for (i64 f = startFrame; f < endFrame; f++)
+		{
+			const f64 fit = (sinAmplitude * Sin(phaseAt(f))) + (cosAmplitude * Cos(phaseAt(f)));
+			const f64 residual = (interleavedSamples[f * channelCount] - fit);
+			signalPower += (fit * fit); residualPower += (residual * residual);
+		}
+
+		return 10.0 * ::log10(Max(residualPower, 1.0) / Max(signalPower, 1.0));
+	}
+
+	void AudioTestWindow::RunResamplerBenchmark()
+	{
+		static constexpr f64 toneFrequencies[] = { 100.0, 440.0, 1000.0, 2500.0, 5000.0, 8000.0, 11000.0, 14000.0, 17000.0 };
+		static constexpr u32 channelCount = 2;
+		static constexpr f64 outputSampleRate = static_cast<f64>(Audio::AudioEngine::OutputSampleRate);
+
+		resamplerBenchmark.Results.clear();
+		for (const auto& benchmarkCase : ResamplerBenchmarkData::Cases)
+		{
+			const f64 sourceRate = static_cast<f64>(benchmarkCase.SourceSampleRate);
+			const f64 sourceFramesPerOutputFrame = (benchmarkCase.PlaybackSpeed * sourceRate / outputSampleRate);
+
+			Audio::PCMSampleBuffer source = { channelCount, benchmarkCase.SourceSampleRate, static_cast<i64>(sourceRate), nullptr };
+			source.InterleavedSamples = std::make_unique<i16[]>(source.SampleCount());
+
+			const i64 outputFrameCount = static_cast<i64>(static_cast<f64>(source.FrameCount) / sourceFramesPerOutputFrame);
+			std::vector<i16> output(static_cast<size_t>(outputFrameCount * channelCount));
+
+			ResamplerBenchmarkData::Result result = { benchmarkCase };
+			Time totalDurations[2] = {};
+
+			for (const f64 toneFrequency : toneFrequencies)
+			{
+				// NOTE: Only measure tones inside the passband of both the source and the output as anything above is supposed to be filtered out
+				const f64 outputFrequency = (toneFrequency * benchmarkCase.PlaybackSpeed);
+				if (toneFrequency >= (sourceRate * 0.4) || outputFrequency >= (outputSampleRate * 0.4))
+					continue;
+
+				for (i64 f = 0; f < source.FrameCount; f++)
+				{
+					const i16 sample = static_cast<i16>(Sin(Angle::FromRadians(static_cast<f32>(2.0 * PI * Mod(toneFrequency * static_cast<f64>(f) / sourceRate, 1.0)))) * (I16Max * 0.7f));
+					for (u32 c = 0; c < channelCount; c++)
+						source.InterleavedSamples[(f * channelCount) + c] = sample;
+				}
+
+				for (size_t i = 0; i < 2; i++)
+				{
+					CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+					if (i == 0)
+					{
+						for (i64 f = 0; f < outputFrameCount; f++)
+						{
+							const f64 frameTimeSec = (static_cast<f64>(f) * sourceFramesPerOutputFrame / sourceRate);
+							for (u32 c = 0; c < channelCount; c++)
+								output[(f * channelCount) + c] = Audio::LinearSampleAtTimeOrZero<i16>(frameTimeSec, c, source.InterleavedSamples.get(), source.SampleCount(), sourceRate, channelCount);
+						}
+					}
+					else
+					{
+						Audio::SincResampler resampler = {};
+						resampler.Process(source, sourceFramesPerOutputFrame, output.data(), outputFrameCount);
+					}
+					totalDurations[i] += stopwatch.Stop();
+
+					const f64 thdn = MeasureSineTHDNDecibel(output.data(), outputFrameCount, channelCount, (outputFrequency / outputSampleRate));
+					result.WorstTHDN[i] = (result.ToneCount == 0) ? thdn : Max(result.WorstTHDN[i], thdn);
+					result.AverageTHDN[i] += thdn;
+				}
+				result.ToneCount++;
+			}
+
+			for (size_t i = 0; i < 2; i++)
+			{
+				result.FramesPerSecond[i] = static_cast<f64>(outputFrameCount * result.ToneCount) / totalDurations[i].ToSec();
+				result.AverageTHDN[i] /= Max(result.ToneCount, 1);
+			}
+			resamplerBenchmark.Results.push_back(result);
+		}
+	}
+
+	void AudioTestWindow::RunSongLoadingBenchmark()
+	{
+		auto& benchmark = songLoadingBenchmark;
+		benchmark.Results.clear();
+		benchmark.ErrorMessage.clear();
+
+		const std::string_view fileName = Path::GetFileName(benchmark.FilePath);
+		static constexpr i64 waveformChunkFrameCount = 16384;
+
+		// NOTE: Decoding the entire file up front, with the file content staying alive until the end
+		{
+			SongLoadingBenchmarkData::Result result = { "Decode Entire File" };
+			CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+
+			auto[fileContent, fileSize] = File::ReadAllBytes(benchmark.FilePath);
+			Audio::PCMSampleBuffer sampleBuffer = {};
+			if (fileContent == nullptr || Audio::DecodeEntireFile(fileName, fileContent.get(), fileSize, sampleBuffer) != Audio::DecodeFileResult::FeelsGoodMan)
+			{
+				benchmark.ErrorMessage = "Failed to read or decode file";
+				return;
+			}
+
+			result.PeakByteSize = fileSize + sampleBuffer.ByteSize();
+			result.ResidentByteSize = sampleBuffer.ByteSize();
+
+			const Audio::SourceHandle source = Audio::Engine.LoadSourceFromBufferMove("AudioTestWindow Benchmark Song", std::move(sampleBuffer));
+			result.TimeToFirstAudio = stopwatch.GetElapsed();
+
+			Audio::WaveformMipChain waveformL = {}, waveformR = {};
+			if (const Audio::PCMSampleBuffer* sourceBuffer = Audio::Engine.GetSourceSampleBufferView(source); sourceBuffer != nullptr)
+			{
+				if (sourceBuffer->ChannelCount == 2)
+					Audio::WaveformMipChain::GenerateStereoMipChainsFromSampleBuffer(*sourceBuffer, waveformL, waveformR);
+				else
+					waveformL.GenerateEntireMipChainFromSampleBuffer(*sourceBuffer, 0);
+			}
+			result.TimeToWaveform = stopwatch.Stop();
+
+			Audio::Engine.UnloadSource(source);
+			benchmark.Results.push_back(result);
+		}
+
+		// NOTE: Streaming from the encoded file content, with the first audio being available as soon as the worker has decoded its first chunk.
+		//		 The waveform is generated from a separate decoder meanwhile, which only ever needs a single chunk in memory
+		{
+			SongLoadingBenchmarkData::Result result = { "Streaming" };
+			CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+
+			auto[fileContent, fileSize] = File::ReadAllBytes(benchmark.FilePath);
+			std::shared_ptr<const u8[]> sharedFileContent = std::move(fileContent);
+			const Audio::SourceHandle source = Audio::Engine.LoadStreamingSourceFromFileContent(fileName, sharedFileContent, fileSize);
+			if (source == Audio::SourceHandle::Invalid)
+			{
+				benchmark.ErrorMessage = "Failed to stream file";
+				return;
+			}
+
+			static constexpr Time decodeTimeout = Time::FromSec(2.0);
+			while (Audio::Engine.DebugGetSourceDecodedFrameCount(source) <= 0 && stopwatch.GetElapsed() < decodeTimeout)
+				std::this_thread::yield();
+			result.TimeToFirstAudio = stopwatch.GetElapsed();
+
+			Audio::StreamingDecoder decoder;
+			Audio::WaveformMipChain waveformL = {}, waveformR = {};
+			if (decoder.OpenMemory(fileName, sharedFileContent.get(), fileSize) == Audio::DecodeFileResult::FeelsGoodMan)
+			{
+				const u32 channelCount = decoder.GetChannelCount();
+				auto chunkSamples = std::make_unique<i16[]>(waveformChunkFrameCount * channelCount);
+				waveformL.BeginIncrementalGeneration(decoder.GetFrameCount(), decoder.GetSampleRate());
+				if (channelCount == 2) waveformR.BeginIncrementalGeneration(decoder.GetFrameCount(), decoder.GetSampleRate());
+				for (i64 framesRead; (framesRead = decoder.ReadFrames(chunkSamples.get(), waveformChunkFrameCount)) > 0;)
+				{
+					if (channelCount == 2)
+						Audio::WaveformMipChain::AppendIncrementalStereoFrames(waveformL, waveformR, chunkSamples.get(), framesRead);
+					else
+						waveformL.AppendIncrementalFrames(chunkSamples.get(), framesRead, channelCount, 0);
+				}
+				if (channelCount == 2)
+					Audio::WaveformMipChain::EndIncrementalStereoGeneration(waveformL, waveformR);
+				else
+					waveformL.EndIncrementalGeneration();
+
+				result.PeakByteSize = Audio::Engine.DebugGetSourceMemoryByteSize(source) + (waveformChunkFrameCount * channelCount * sizeof(i16));
+			}
+			result.TimeToWaveform = stopwatch.Stop();
+			result.ResidentByteSize = Audio::Engine.DebugGetSourceMemoryByteSize(source);
+
+			Audio::Engine.UnloadSource(source);
+			benchmark.Results.push_back(result);
+		}
+	}
+
+	void AudioTestWindow::RunDecodeBenchmark()
+	{
+		auto& benchmark = decodeBenchmark;
+		for (auto& result : benchmark.Results)
+			result = {};
+		benchmark.ErrorMessage.clear();
+		benchmark.HasResults = false;
+
+		std::error_code error;
+		auto directoryIt = std::filesystem::directory_iterator(std::filesystem::u8path(benchmark.CorpusDirectory), error);
+		if (error)
+		{
+			benchmark.ErrorMessage = "Failed to open corpus directory";
+			return;
+		}
+
+		for (const auto& entry : directoryIt)
+		{
+			if (!entry.is_regular_file())
+				continue;
+
+			const std::string filePath = entry.path().u8string();
+			const Audio::SupportedFileFormat fileFormat = Audio::TryToDetermineFileFormatFromExtension(filePath);
+			if (fileFormat == Audio::SupportedFileFormat::Count)
+				continue;
+
+			// NOTE: Only measuring the decoding itself, not reading the file from disk
+			auto[fileContent, fileSize] = File::ReadAllBytes(filePath);
+			if (fileContent == nullptr)
+				continue;
+
+			Audio::PCMSampleBuffer sampleBuffer = {};
+			CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+			const Audio::DecodeFileResult decodeResult = Audio::DecodeEntireFile(filePath, fileContent.get(), fileSize, sampleBuffer);
+			const Time decodeDuration = stopwatch.Stop();
+			if (decodeResult != Audio::DecodeFileResult::FeelsGoodMan)
+				continue;
+
+			auto& result = benchmark.Results[EnumToIndex(fileFormat)];
+			result.FileCount++;
+			result.FileByteSize += fileSize;
+			result.DecodedByteSize += sampleBuffer.ByteSize();
+			result.PeakByteSize = Max(result.PeakByteSize, fileSize + sampleBuffer.ByteSize());
+			result.AudioDuration += Audio::FramesToTime(sampleBuffer.FrameCount, sampleBuffer.SampleRate);
+			result.DecodeDuration += decodeDuration;
+			benchmark.HasResults = true;
+		}
+
+		if (!benchmark.HasResults)
+			benchmark.ErrorMessage = "No supported audio files found";
+	}
+
+	void AudioTestWindow::RunWaveformBenchmark()
+	{
+		auto& benchmark = waveformBenchmark;
+
+		// NOTE: Deterministic noise covering the entire i16 range, including I16Min which mustn't wrap around when taking its absolute value
+		Audio::PCMSampleBuffer sampleBuffer = {};
+		sampleBuffer.ChannelCount = 2;
+		sampleBuffer.SampleRate = 48000;
+		sampleBuffer.FrameCount = (sampleBuffer.SampleRate * 60 * 10);
+		sampleBuffer.InterleavedSamples = std::make_unique<i16[]>(sampleBuffer.SampleCount());
+		u32 randomState = 0x9E3779B9;
+		for (size_t i = 0; i < sampleBuffer.SampleCount(); i++)
+		{
+			randomState ^= (randomState << 13); randomState ^= (randomState >> 17); randomState ^= (randomState << 5);
+			sampleBuffer.InterleavedSamples[i] = static_cast<i16>(randomState & 0xFFFF);
+		}
+
+		auto areMipChainsIdentical = [](const Audio::WaveformMipChain& a, const Audio::WaveformMipChain& b)
+		{
+			for (size_t i = 0; i < Audio::WaveformMipChain::MaxMipLevels; i++)
+			{
+				const Audio::WaveformMip& mipA = a.AllMips[i];
+				const Audio::WaveformMip& mipB = b.AllMips[i];
+				if (mipA.BucketCount != mipB.BucketCount || (mipA.BucketCount > 0 && memcmp(mipA.Buckets, mipB.Buckets, mipA.BucketCount * sizeof(Audio::WaveformBucket)) != 0))
+					return false;
+			}
+			return true;
+		};
+
+		Audio::WaveformMipChain referenceL = {}, referenceR = {};
+		auto measureMethod = [&](cstr methodName, auto&& generateMipChains)
+		{
+			WaveformBenchmarkData::Result result = { methodName, {}, true };
+			for (size_t path = 0; path < EnumCount<Audio::MixKernelPath>; path++)
+			{
+				const auto kernelPath = static_cast<Audio::MixKernelPath>(path);
+				if (!Audio::IsMixKernelPathSupported(kernelPath))
+					continue;
+
+				Audio::WaveformMipChain waveformL = {}, waveformR = {};
+				CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+				generateMipChains(waveformL, waveformR, kernelPath);
+				result.Durations[path] = stopwatch.Stop();
+
+				if (referenceL.IsEmpty())
+				{
+					referenceL = std::move(waveformL);
+					referenceR = std::move(waveformR);
+				}
+				else
+				{
+					result.IsBitExact &= areMipChainsIdentical(waveformL, referenceL) && areMipChainsIdentical(waveformR, referenceR);
+				}
+			}
+			benchmark.Results.push_back(result);
+		};
+
+		benchmark.Results.clear();
+		measureMethod("One Channel after the other", [&](Audio::WaveformMipChain& outL, Audio::WaveformMipChain& outR, Audio::MixKernelPath path)
+		{
+			outL.GenerateEntireMipChainFromSampleBuffer(sampleBuffer, 0, false, path);
+			outR.GenerateEntireMipChainFromSampleBuffer(sampleBuffer, 1, false, path);
+		});
+		measureMethod("Single Pass + Parallel Channels", [&](Audio::WaveformMipChain& outL, Audio::WaveformMipChain& outR, Audio::MixKernelPath path)
+		{
+			Audio::WaveformMipChain::GenerateStereoMipChainsFromSampleBuffer(sampleBuffer, outL, outR, path);
+		});
+
+		// NOTE: Each channel split off into its own mono source, which should still produce the exact same mips
+		Audio::PCMSampleBuffer monoSampleBuffers[2] = {};
+		for (u32 channel = 0; channel < 2; channel++)
+		{
+			Audio::PCMSampleBuffer& monoBuffer = monoSampleBuffers[channel];
+			monoBuffer.ChannelCount = 1;
+			monoBuffer.SampleRate = sampleBuffer.SampleRate;
+			monoBuffer.FrameCount = sampleBuffer.FrameCount;
+			monoBuffer.InterleavedSamples = std::make_unique<i16[]>(monoBuffer.SampleCount());
+			for (i64 frame = 0; frame < monoBuffer.FrameCount; frame++)
+				monoBuffer.InterleavedSamples[frame] = sampleBuffer.InterleavedSamples[(frame * 2) + channel];
+		}
+		measureMethod("Separate Mono Sources", [&](Audio::WaveformMipChain& outL, Audio::WaveformMipChain& outR, Audio::MixKernelPath path)
+		{
+			outL.GenerateEntireMipChainFromSampleBuffer(monoSampleBuffers[0], 0, false, path);
+			outR.GenerateEntireMipChainFromSampleBuffer(monoSampleBuffers[1], 0, false, path);
+		});
+		benchmark.ArenaByteSize = referenceL.GetBucketArenaByteSize();
+
+		// NOTE: Scrolling through the song while measuring to not just hit the same cached buckets every frame
+		static constexpr i32 framesPerZoomLevel = 64;
+		static constexpr f32 timelineWorldSpaceXUnitsPerSecond = 300.0f;
+		benchmark.ZoomResults.clear();
+		for (const f32 zoom : WaveformBenchmarkData::TimelineZoomLevels)
+		{
+			WaveformBenchmarkData::ZoomResult result = { zoom, Time::FromSec(1.0 / (timelineWorldSpaceXUnitsPerSecond * zoom)), Time::Zero(), Time::Zero() };
+			f32 amplitudeSum = 0.0f;
+			for (i32 frame = 0; frame < framesPerZoomLevel; frame++)
+			{
+				const Time scrollTime = referenceL.Duration * (static_cast<f64>(frame) / framesPerZoomLevel);
+				CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+				for (const Audio::WaveformMipChain* waveform : { &referenceL, &referenceR })
+				{
+					const Audio::WaveformMip& waveformMip = waveform->FindClosestMip(result.TimePerPixel);
+					for (i32 pixel = 0; pixel < WaveformBenchmarkData::TimelineWidthInPixels; pixel++)
+					{
+						const Audio::WaveformAmplitude amplitude = waveform->GetAmplitudeAt(waveformMip, scrollTime + (result.TimePerPixel * static_cast<f64>(pixel)), result.TimePerPixel);
+						amplitudeSum += (amplitude.Peak + amplitude.RMS);
+					}
+				}
+				const Time frameTime = stopwatch.Stop();
+				result.AverageFrameTime += frameTime;
+				result.MaxFrameTime = Max(result.MaxFrameTime, frameTime);
+			}
+			result.AverageFrameTime = result.AverageFrameTime / static_cast<f64>(framesPerZoomLevel);
+
+			// NOTE: Only here so that the amplitude lookups can't be optimized away
+			if (amplitudeSum < 0.0f)
+				result.MaxFrameTime = Time::Zero();
+			benchmark.ZoomResults.push_back(result);
+		}
+	}
+
+	void AudioTestWindow::RunMixKernelBenchmark()
+	{
+		constexpr size_t frameCount = 4096;
+		constexpr size_t sampleCount = (frameCount * Audio::MixKernelChannelCount);
+		constexpr i32 iterationCount = 1024;
+
+		// NOTE: Deterministic noise with the float samples exceeding the i16 range to also exercise the clamping
+		u32 randomState = 0x9E3779B9;
+		auto nextRandomUnit = [&]() { randomState ^= (randomState << 13); randomState ^= (randomState >> 17); randomState ^= (randomState << 5); return (static_cast<f32>(randomState & 0xFFFF) / 32768.0f) - 1.0f; };
+
+		std::vector<i16> inputI16(sampleCount);
+		std::vector<f32> inputF32(sampleCount), frameGains(frameCount);
+		for (i16& sample : inputI16) sample = static_cast<i16>(nextRandomUnit() * static_cast<f32>(I16Max));
+		for (f32& sample : inputF32) sample = nextRandomUnit() * static_cast<f32>(I16Max) * 1.5f;
+		for (f32& gain : frameGains) gain = (nextRandomUnit() * 0.5f) + 0.5f;
+
+		struct KernelOutput { std::vector<f32> F32; std::vector<i16> I16; };
+		auto measureKernel = [&](cstr kernelName, auto&& runKernel)
+		{
+			MixKernelBenchmarkData::Result result = { kernelName, {}, true };
+			KernelOutput referenceOutput = {};
+
+			for (size_t path = 0; path < EnumCount<Audio::MixKernelPath>; path++)
+			{
+				const auto kernelPath = static_cast<Audio::MixKernelPath>(path);
+				if (!Audio::IsMixKernelPathSupported(kernelPath))
+					continue;
+
+				KernelOutput output = { inputF32, inputI16 };
+				runKernel(output, kernelPath);
+				if (path == 0)
+					referenceOutput = output;
+				else
+					result.IsBitExact &= (memcmp(output.F32.data(), referenceOutput.F32.data(), sampleCount * sizeof(f32)) == 0) && (memcmp(output.I16.data(), referenceOutput.I16.data(), sampleCount * sizeof(i16)) == 0);
+
+				CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+				for (i32 i = 0; i < iterationCount; i++)
+					runKernel(output, kernelPath);
+				result.SamplesPerSecond[path] = static_cast<f64>(sampleCount * iterationCount) / stopwatch.Stop().ToSec();
+			}
+
+			mixKernelBenchmark.Results.push_back(result);
+		};
+
+		mixKernelBenchmark.Results.clear();
+		measureKernel("Voice I16 -> F32 (Constant Volume)", [&](KernelOutput& out, Audio::MixKernelPath path) { Audio::MixSamplesI16IntoF32(out.F32.data(), inputI16.data(), frameCount, { 0.8f, 0.6f }, path); });
+		measureKernel("Voice I16 -> F32 (Volume Map)", [&](KernelOutput& out, Audio::MixKernelPath path) { Audio::MixSamplesI16IntoF32PerFrameVolume(out.F32.data(), inputI16.data(), frameCount, frameGains.data(), { 0.8f, 0.6f }, path); });
+		measureKernel("Pre-Gain Scale", [&](KernelOutput& out, Audio::MixKernelPath path) { Audio::ScaleSamplesF32(out.F32.data(), sampleCount, 0.999f, path); });
+		measureKernel("Frame Peaks", [&](KernelOutput& out, Audio::MixKernelPath path) { Audio::FindFramePeaksF32(inputF32.data(), frameCount, out.F32.data(), path); });
+		measureKernel("Limiter Gain F32 -> F32", [&](KernelOutput& out, Audio::MixKernelPath path) { Audio::MixSamplesF32IntoF32PerFrameGain(out.F32.data(), inputF32.data(), frameCount, frameGains.data(), 0.9f, path); });
+		measureKernel("Limiter Gain F32 -> I16 (Clamped)", [&](KernelOutput& out, Audio::MixKernelPath path) { Audio::MixSamplesF32IntoI16PerFrameGainClamped(out.I16.data(), inputF32.data(), frameCount, frameGains.data(), 0.9f, path); });
+	}
+
+	void AudioTestWindow::RunScheduledSoundBenchmark()
+	{
+		static constexpr u32 bufferFrameCounts[] = { 64, 441, 1024 };
+		static constexpr f32 playbackSpeeds[] = { 1.0f, 0.75f };
+		static constexpr i32 clickCount = 200;
+		static constexpr f64 uiFrameRate = 60.0;
+		static constexpr Time scheduleAheadDuration = Time::FromMS(250.0);
+		static constexpr Time legacyFutureOffset = Time::FromSec(1.0 / 25.0);
+		static constexpr u32 channelCount = Audio::AudioEngine::OutputChannelCount;
+		static constexpr f64 outputSampleRate = static_cast<f64>(Audio::AudioEngine::OutputSampleRate);
+
+		auto& benchmark = scheduledSoundBenchmark;
+		benchmark.Results.clear();
+		benchmark.ErrorMessage.clear();
+
+		// NOTE: Anything else playing would end up in the offline render too
+		if (!Audio::Engine.GetAllVoicesAreIdle())
+		{
+			benchmark.ErrorMessage = "Stop all playback first";
+			return;
+		}
+
+		const b8 wasStreamRunning = Audio::Engine.GetIsStreamOpenRunning();
+		const f32 masterVolumeBefore = Audio::Engine.GetMasterVolume();
+		Audio::Engine.StopCloseStream();
+		Audio::Engine.SetMasterVolume(1.0f);
+
+		// NOTE: A single click followed by silence, so that each onset simply is the first (and only) non-silent output frame
+		Audio::PCMSampleBuffer clickBuffer = {};
+		clickBuffer.ChannelCount = channelCount;
+		clickBuffer.SampleRate = Audio::AudioEngine::OutputSampleRate;
+		clickBuffer.FrameCount = 256;
+		clickBuffer.InterleavedSamples = std::make_unique<i16[]>(clickBuffer.SampleCount());
+		for (u32 c = 0; c < channelCount; c++)
+			clickBuffer.InterleavedSamples[c] = (I16Max / 2);
+
+		const Audio::SourceHandle clickSource = Audio::Engine.LoadSourceFromBufferMove("AudioTestWindow Benchmark Click", std::move(clickBuffer));
+		Audio::Voice clockVoice = Audio::Engine.AddVoice(Audio::SourceHandle::Invalid, "AudioTestWindow Benchmark Clock", false);
+		Audio::Voice legacyVoices[8];
+		for (Audio::Voice& voice : legacyVoices)
+		{
+			voice = Audio::Engine.AddVoice(Audio::SourceHandle::Invalid, "AudioTestWindow Benchmark Legacy", false);
+			voice.SetPauseOnEnd(true);
+		}
+
+		// NOTE: Irregularly spaced like actual notes, but far enough apart for the clicks to never overlap
+		std::vector<Time> clickTimes;
+		{
+			u32 randomState = 0x9E3779B9;
+			auto nextRandom = [&]() { randomState ^= (randomState << 13); randomState ^= (randomState >> 17); randomState ^= (randomState << 5); return randomState; };
+
+			Time clickTime = Time::FromMS(100.0);
+			for (i32 i = 0; i < clickCount; i++)
+			{
+				clickTimes.push_back(clickTime);
+				clickTime += Time::FromMS(40.0 + static_cast<f64>(nextRandom() % 10000) / 100.0);
+			}
+		}
+
+		std::vector<i16> outputSamples;
+		std::vector<Audio::ScheduledSound> soundsToSchedule;
+		for (const u32 bufferFrameCount : bufferFrameCounts)
+		{
+			for (const f32 playbackSpeed : playbackSpeeds)
+			{
+				for (const b8 scheduled : { true, false })
+				{
+					const i64 totalFrameCount = static_cast<i64>(((clickTimes.back() + Time::FromMS(500.0)).ToSec() / playbackSpeed) * outputSampleRate);
+					outputSamples.assign(static_cast<size_t>(totalFrameCount + bufferFrameCount) * channelCount, 0);
+
+					clockVoice.SetParams(Audio::VoiceParamBatch {}.SetPosition(Time::Zero()).SetPlaybackSpeed(playbackSpeed).SetIsPlaying(true));
+
+					size_t nextClickIndex = 0;
+					Time lastCursorTime = Time::Zero();
+					size_t legacyVoiceRingIndex = 0;
+					auto updateUIFrame = [&]()
+					{
+						const Time cursorTime = clockVoice.GetPosition();
+						if (scheduled)
+						{
+							const Time scheduleEnd = cursorTime + (scheduleAheadDuration * playbackSpeed);
+							soundsToSchedule.clear();
+							for (; nextClickIndex < clickTimes.size() && clickTimes[nextClickIndex] < scheduleEnd; nextClickIndex++)
+								soundsToSchedule.push_back(Audio::ScheduledSound { clickTimes[nextClickIndex], clickSource, 1.0f, 0.0f, 0 });
+							Audio::Engine.ScheduleSounds(clockVoice, soundsToSchedule.data(), soundsToSchedule.size());
+						}
+						else
+						{
+							// NOTE: Same as the timeline used to do, triggering ahead by a "future offset" and starting the voice before the source to make up for it
+							const Time futureOffset = (legacyFutureOffset * Min(playbackSpeed, 1.0f));
+							for (const Time clickTime : clickTimes)
+							{
+								const Time offsetClickTime = (clickTime - futureOffset);
+								if (offsetClickTime >= lastCursorTime && offsetClickTime < cursorTime)
+								{
+									Audio::Voice& voice = legacyVoices[legacyVoiceRingIndex++ % ArrayCount(legacyVoices)];
+									voice.SetParams(Audio::VoiceParamBatch {}.SetSource(clickSource).SetPosition(Min(cursorTime - clickTime, Time::Zero())).SetIsPlaying(true));
+								}
+							}
+						}
+						lastCursorTime = cursorTime;
+					};
+
+					f64 nextUIFrame = 0.0;
+					for (i64 frame = 0; frame < totalFrameCount; frame += bufferFrameCount)
+					{
+						for (; nextUIFrame <= static_cast<f64>(frame); nextUIFrame += (outputSampleRate / uiFrameRate))
+							updateUIFrame();
+						Audio::Engine.RenderOffline(&outputSamples[static_cast<size_t>(frame) * channelCount], bufferFrameCount);
+					}
+
+					clockVoice.SetIsPlaying(false);
+					for (Audio::Voice& voice : legacyVoices)
+						voice.SetIsPlaying(false);
+					Audio::Engine.ClearScheduledSounds();
+
+					auto& result = benchmark.Results.emplace_back();
+					result.Method = scheduled ? "Scheduled" : "Per UI Frame (Legacy)";
+					result.BufferFrameCount = bufferFrameCount;
+					result.PlaybackSpeed = playbackSpeed;
+					result.ExpectedCount = clickCount;
+
+					f64 errorSumMS = 0.0;
+					for (i64 frame = 0; frame < totalFrameCount; frame++)
+					{
+						if (outputSamples[static_cast<size_t>(frame) * channelCount] == 0)
+							continue;
+
+						if (result.DetectedCount < clickCount)
+						{
+							const f64 idealFrame = (clickTimes[result.DetectedCount].ToSec() / playbackSpeed) * outputSampleRate;
+							const f64 errorMS = Absolute(static_cast<f64>(frame) - idealFrame) / outputSampleRate * 1000.0;
+							errorSumMS += errorMS;
+							result.MaxAbsErrorMS = Max(result.MaxAbsErrorMS, errorMS);
+						}
+						result.DetectedCount++;
+					}
+					result.MeanAbsErrorMS = (result.DetectedCount > 0) ? (errorSumMS / Min(result.DetectedCount, clickCount)) : 0.0;
+				}
+			}
+		}
+
+		Audio::Engine.RemoveVoice(clockVoice);
+		for (Audio::Voice& voice : legacyVoices)
+			Audio::Engine.RemoveVoice(voice);
+		Audio::Engine.UnloadSource(clickSource);
+		Audio::Engine.SetMasterVolume(masterVolumeBefore);
+		if (wasStreamRunning)
+			Audio::Engine.OpenStartStream();
+	}
+
+	void AudioTestWindow::RunNullBackendRenderTest()
+	{
+		static constexpr i32 clickCount = 64;
+		static constexpr i64 clickFrameCount = 48;
+		static constexpr u32 channelCount = Audio::AudioEngine::OutputChannelCount;
+		static constexpr u32 outputSampleRate = Audio::AudioEngine::OutputSampleRate;
+
+		auto& test = nullBackendRenderTest;
+		test.Results.clear();
+		test.ErrorMessage.clear();
+
+		// NOTE: Anything else playing would end up in the render too
+		if (!Audio::Engine.GetAllVoicesAreIdle())
+		{
+			test.ErrorMessage = "Stop all playback first";
+			return;
+		}
+
+		const b8 wasStreamRunning = Audio::Engine.GetIsStreamOpenRunning();
+		const f32 masterVolumeBefore = Audio::Engine.GetMasterVolume();
+		Audio::Engine.StopCloseStream();
+		Audio::Engine.SetMasterVolume(1.0f);
+
+		// NOTE: Short ramp with different values per channel, played at the output sample rate (so without any resampling) and at full volume and center pan
+		Audio::PCMSampleBuffer clickBuffer = {};
+		clickBuffer.ChannelCount = channelCount;
+		clickBuffer.SampleRate = outputSampleRate;
+		clickBuffer.FrameCount = clickFrameCount;
+		clickBuffer.InterleavedSamples = std::make_unique<i16[]>(clickBuffer.SampleCount());
+		for (i64 frame = 0; frame < clickFrameCount; frame++)
+		{
+			clickBuffer.InterleavedSamples[(frame * channelCount) + 0] = static_cast<i16>((frame + 1) * 256);
+			clickBuffer.InterleavedSamples[(frame * channelCount) + 1] = static_cast<i16>((frame + 1) * -128);
+		}
+
+		// NOTE: Irregularly spaced but far enough apart for the clicks to never overlap, with the expected output frame of each being known exactly
+		std::vector<i64> clickFrames;
+		for (i64 i = 0; i < clickCount; i++)
+			clickFrames.push_back(2000 + (i * 1789) + ((i * i * 7) % 613));
+
+		const i64 totalFrameCount = clickFrames.back() + 4000;
+		std::vector<i16> expectedSamples(static_cast<size_t>(totalFrameCount) * channelCount, 0);
+		for (const i64 clickFrame : clickFrames)
+		{
+			for (i64 frame = 0; frame < clickFrameCount; frame++)
+			{
+				for (u32 c = 0; c < channelCount; c++)
+					expectedSamples[static_cast<size_t>((clickFrame + frame) * channelCount) + c] = clickBuffer.InterleavedSamples[(frame * channelCount) + c];
+			}
+		}
+
+		const Audio::SourceHandle clickSource = Audio::Engine.LoadSourceFromBufferMove("AudioTestWindow Test Click", std::move(clickBuffer));
+		Audio::Voice clockVoice = Audio::Engine.AddVoice(Audio::SourceHandle::Invalid, "AudioTestWindow Test Clock", false);
+
+		std::vector<Audio::ScheduledSound> soundsToSchedule;
+		for (const i64 clickFrame : clickFrames)
+			soundsToSchedule.push_back(Audio::ScheduledSound { Audio::FramesToTime(clickFrame, outputSampleRate), clickSource, 1.0f, 0.0f, 0 });
+
+		std::vector<i16> renderedSamples;
+		renderedSamples.reserve(expectedSamples.size() + (static_cast<size_t>(Audio::AudioEngine::MaxBufferFrameCount) * channelCount));
+		for (const u32 bufferFrameCount : NullBackendRenderTestData::BufferFrameCounts)
+		{
+			renderedSamples.clear();
+			Audio::NullBackend nullBackend(Audio::NullBackendClock::Manual, [&](const i16* renderedBuffer, const u32 renderedFrameCount, const u32 renderedChannelCount)
+			{
+				renderedSamples.insert(renderedSamples.end(), renderedBuffer, renderedBuffer + (static_cast<size_t>(renderedFrameCount) * renderedChannelCount));
+			});
+
+			const Audio::BackendStreamParam streamParam = { outputSampleRate, channelCount, bufferFrameCount, Audio::StreamShareMode::Shared };
+			if (!nullBackend.OpenStartStream(streamParam, [](i16* outputBuffer, const u32 outputFrameCount, const u32) { Audio::Engine.RenderOffline(outputBuffer, outputFrameCount); }))
+			{
+				test.ErrorMessage = "Failed to open the null backend stream";
+				break;
+			}
+
+			clockVoice.SetParams(Audio::VoiceParamBatch {}.SetPosition(Time::Zero()).SetPlaybackSpeed(1.0f).SetIsPlaying(true));
+			Audio::Engine.ScheduleSounds(clockVoice, soundsToSchedule.data(), soundsToSchedule.size());
+
+			CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+			nullBackend.RenderFrames(totalFrameCount);
+			const Time renderDuration = stopwatch.Stop();
+
+			clockVoice.SetIsPlaying(false);
+			Audio::Engine.ClearScheduledSounds();
+			nullBackend.StopCloseStream();
+
+			auto& result = test.Results.emplace_back();
+			result.BufferFrameCount = bufferFrameCount;
+			result.RenderedFrameCount = nullBackend.GetRenderedFrameCount();
+			result.ClickCount = clickCount;
+			result.FirstMismatchedFrame = -1;
+			result.RenderDuration = renderDuration;
+
+			for (i64 frame = 0; frame < totalFrameCount; frame++)
+			{
+				const size_t sampleIndex = static_cast<size_t>(frame) * channelCount;
+				const b8 frameMatches = (sampleIndex + channelCount) <= renderedSamples.size() && memcmp(&renderedSamples[sampleIndex], &expectedSamples[sampleIndex], channelCount * sizeof(i16)) == 0;
+				if (frameMatches)
+					continue;
+
+				if (result.MismatchedFrameCount++ == 0)
+					result.FirstMismatchedFrame = frame;
+			}
+		}
+
+		Audio::Engine.RemoveVoice(clockVoice);
+		Audio::Engine.UnloadSource(clickSource);
+		Audio::Engine.SetMasterVolume(masterVolumeBefore);
+		if (wasStreamRunning)
+			Audio::Engine.OpenStartStream();
+	}
+
+	void AudioTestWindow::StartVoiceRenderBenchmark()
+	{
+		auto& benchmark = voiceRenderBenchmark;
+		if (benchmark.IsRunning)
+			return;
+
+		Audio::Engine.EnsureStreamRunning();
+		if (!Audio::Engine.GetIsStreamOpenRunning())
+			return;
+
+		// NOTE: One second of a 440 Hz sine wave, looped by all voices
+		Audio::PCMSampleBuffer sineBuffer = {};
+		sineBuffer.ChannelCount = Audio::AudioEngine::OutputChannelCount;
+		sineBuffer.SampleRate = Audio::AudioEngine::OutputSampleRate;
+		sineBuffer.FrameCount = Audio::AudioEngine::OutputSampleRate;
+		sineBuffer.InterleavedSamples = std::make_unique<i16[]>(sineBuffer.SampleCount());
+		for (i64 f = 0; f < sineBuffer.FrameCount; f++)
+		{
+			const i16 sample = static_cast<i16>(Sin(Angle::FromRadians((static_cast<f32>(f) / static_cast<f32>(sineBuffer.SampleRate)) * 440.0f * PI * 2.0f)) * static_cast<f32>(I16Max / 2));
+			for (u32 c = 0; c < sineBuffer.ChannelCount; c++)
+				sineBuffer.InterleavedSamples[(f * sineBuffer.ChannelCount) + c] = sample;
+		}
+
+		benchmark.Source = Audio::Engine.LoadSourceFromBufferMove("AudioTestWindow Benchmark Sine", std::move(sineBuffer));
+		benchmark.Results.clear();
+		benchmark.StageIndex = -1;
+		benchmark.IsRunning = true;
+	}
+
+	void AudioTestWindow::UpdateVoiceRenderBenchmark()
+	{
+		auto& benchmark = voiceRenderBenchmark;
+		if (!benchmark.IsRunning)
+			return;
+
+		if (!Audio::Engine.GetIsStreamOpenRunning())
+		{
+			StopVoiceRenderBenchmark();
+			return;
+		}
+
+		if (benchmark.StageIndex >= 0)
+		{
+			// NOTE: Wait for the entire render performance history to have been overwritten twice, with the first time only acting as a warm-up
+			const i64 requiredRenderedFrames = static_cast<i64>(Audio::AudioEngine::CallbackDurationRingBufferSize * 2) * Audio::Engine.GetBufferFrameSize();
+			if ((Audio::Engine.DebugGetTotalRenderedFrames() - benchmark.StageStartRenderedFrames) < requiredRenderedFrames)
+				return;
+
+			const auto durations = Audio::Engine.DebugGetRenderPerformanceHistory();
+			VoiceRenderBenchmarkData::Result result = { benchmark.VoiceCounts[benchmark.StageIndex], Time::Zero(), Time::Zero(), Audio::FramesToTime(Audio::Engine.GetBufferFrameSize(), Audio::AudioEngine::OutputSampleRate) };
+			for (const Time duration : durations) { result.Average += duration; result.Max = Max(result.Max, duration); }
+			result.Average = result.Average / static_cast<f64>(durations.size());
+			benchmark.Results.push_back(result);
+
+			for (Audio::Voice& voice : benchmark.Voices)
+				Audio::Engine.RemoveVoice(voice);
+			benchmark.Voices.clear();
+		}
+
+		if (++benchmark.StageIndex >= ArrayCountI32(benchmark.VoiceCounts))
+		{
+			StopVoiceRenderBenchmark();
+			return;
+		}
+
+		char nameBuffer[64];
+		for (i32 i = 0; i < benchmark.VoiceCounts[benchmark.StageIndex]; i++)
+		{
+			sprintf_s(nameBuffer, "AudioTestWindow Benchmark %d", i);
+			const i32 soundGroup = (i % static_cast<i32>(Audio::AudioEngine::MaxSoundGroups));
+			Audio::Voice voice = Audio::Engine.AddVoice(benchmark.Source, nameBuffer, false, 0.0f, 0.0f, false, soundGroup);
+			voice.SetParams(Audio::VoiceParamBatch {}.SetIsLooping(true).SetIsPlaying(true));
+			benchmark.Voices.push_back(voice);
+		}
+		benchmark.StageStartRenderedFrames = Audio::Engine.DebugGetTotalRenderedFrames();
+	}
+
+	void AudioTestWindow::StopVoiceRenderBenchmark()
+	{
+		auto& benchmark = voiceRenderBenchmark;
+		for (Audio::Voice& voice : benchmark.Voices)
+			Audio::Engine.RemoveVoice(voice);
+		benchmark.Voices.clear();
+
+		if (benchmark.Source != Audio::SourceHandle::Invalid)
+			Audio::Engine.UnloadSource(benchmark.Source);
+		benchmark.Source = Audio::SourceHandle::Invalid;
+		benchmark.IsRunning = false;
+	}
+
+	void AudioTestWindow::StartOneShotStressBenchmark()
+	{
+		auto& benchmark = oneShotStressBenchmark;
+		if (benchmark.IsRunning)
+			return;
+
+		Audio::Engine.EnsureStreamRunning();
+		if (!Audio::Engine.GetIsStreamOpenRunning())
+			return;
+
+		// NOTE: Roughly the length and shape of a drum hit, a short low sine wave decaying to silence
+		Audio::PCMSampleBuffer hitBuffer = {};
+		hitBuffer.ChannelCount = Audio::AudioEngine::OutputChannelCount;
+		hitBuffer.SampleRate = Audio::AudioEngine::OutputSampleRate;
+		hitBuffer.FrameCount = static_cast<i64>(Audio::AudioEngine::OutputSampleRate) / 20;
+		hitBuffer.InterleavedSamples = std::make_unique<i16[]>(hitBuffer.SampleCount());
+		for (i64 f = 0; f < hitBuffer.FrameCount; f++)
+		{
+			const f32 decay = 1.0f - (static_cast<f32>(f) / static_cast<f32>(hitBuffer.FrameCount));
+			const i16 sample = static_cast<i16>(Sin(Angle::FromRadians((static_cast<f32>(f) / static_cast<f32>(hitBuffer.SampleRate)) * 150.0f * PI * 2.0f)) * decay * decay * static_cast<f32>(I16Max / 2));
+			for (u32 c = 0; c < hitBuffer.ChannelCount; c++)
+				hitBuffer.InterleavedSamples[(f * hitBuffer.ChannelCount) + c] = sample;
+		}
+
+		benchmark.Source = Audio::Engine.LoadSourceFromBufferMove("AudioTestWindow Benchmark Hit", std::move(hitBuffer));
+		benchmark.Results.clear();
+		benchmark.StageIndex = -1;
+		benchmark.IsRunning = true;
+	}
+
+	void AudioTestWindow::UpdateOneShotStressBenchmark()
+	{
+		auto& benchmark = oneShotStressBenchmark;
+		if (!benchmark.IsRunning)
+			return;
+
+		if (!Audio::Engine.GetIsStreamOpenRunning())
+		{
+			StopOneShotStressBenchmark();
+			return;
+		}
+
+		if (benchmark.StageIndex >= 0)
+		{
+			// NOTE: Fired in bursts once per UI frame same as any sounds triggered by the UI, with the fractional remainder carried over to the next frame
+			benchmark.PendingOneShotCount += benchmark.FireStopwatch.Restart().ToSec() * static_cast<f64>(benchmark.OneShotsPerSecond[benchmark.StageIndex]);
+			for (; benchmark.PendingOneShotCount >= 1.0; benchmark.PendingOneShotCount -= 1.0)
+			{
+				const i32 soundGroup = static_cast<i32>(benchmark.FiredCount % static_cast<i64>(Audio::AudioEngine::MaxSoundGroups));
+				if (!Audio::Engine.PlayOneShotSound(benchmark.Source, "AudioTestWindow Benchmark OneShot", 0.0f, 0.0f, soundGroup))
+					benchmark.DroppedCount++;
+				benchmark.FiredCount++;
+			}
+
+			// NOTE: Wait for the entire render performance history to have been overwritten twice, with the first time only acting as a warm-up
+			const i64 requiredRenderedFrames = static_cast<i64>(Audio::AudioEngine::CallbackDurationRingBufferSize * 2) * Audio::Engine.GetBufferFrameSize();
+			if ((Audio::Engine.DebugGetTotalRenderedFrames() - benchmark.StageStartRenderedFrames) < requiredRenderedFrames)
+				return;
+
+			const auto durations = Audio::Engine.DebugGetRenderPerformanceHistory();
+			OneShotStressBenchmarkData::Result result = { benchmark.OneShotsPerSecond[benchmark.StageIndex], benchmark.FiredCount, benchmark.DroppedCount, Time::Zero(), Time::Zero(), Audio::FramesToTime(Audio::Engine.GetBufferFrameSize(), Audio::AudioEngine::OutputSampleRate) };
+			for (const Time duration : durations) { result.Average += duration; result.Max = Max(result.Max, duration); }
+			result.Average = result.Average / static_cast<f64>(durations.size());
+			benchmark.Results.push_back(result);
+		}
+
+		if (++benchmark.StageIndex >= ArrayCountI32(benchmark.OneShotsPerSecond))
+		{
+			StopOneShotStressBenchmark();
+			return;
+		}
+
+		benchmark.FiredCount = 0;
+		benchmark.DroppedCount = 0;
+		benchmark.PendingOneShotCount = 0.0;
+		benchmark.FireStopwatch.Restart();
+		benchmark.StageStartRenderedFrames = Audio::Engine.DebugGetTotalRenderedFrames();
+	}
+
+	void AudioTestWindow::StopOneShotStressBenchmark()
+	{
+		auto& benchmark = oneShotStressBenchmark;
+
+		// NOTE: Any one-shots still playing simply stop being rendered once their source is gone and are then removed on end
+		if (benchmark.Source != Audio::SourceHandle::Invalid)
+			Audio::Engine.UnloadSource(benchmark.Source);
+		benchmark.Source = Audio::SourceHandle::Invalid;
+		benchmark.IsRunning = false;
+	}
 }
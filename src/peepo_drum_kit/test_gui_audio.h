@@ -1,13 +1,16 @@
 #pragma once
 #include "core_types.h"
 #include "audio/audio_engine.h"
+#include "audio/audio_file_formats.h"
+#include "audio/audio_mix_kernels.h"
+#include "audio/audio_resampler.h"
 
 namespace PeepoDrumKit
 {
 	struct AudioTestWindow
 	{
 		AudioTestWindow() = default;
-		~AudioTestWindow() { RemoveSourcePreviewVoice(); }
+		~AudioTestWindow() { RemoveSourcePreviewVoice(); StopVoiceRenderBenchmark(); StopOneShotStressBenchmark(); }
 
 		void DrawGui();
 
@@ -15,15 +18,131 @@ namespace PeepoDrumKit
 		void AudioEngineTabContent();
 		void ActiveVoicesTabContent();
 		void LoadedSourcesTabContent();
+		void BenchmarkTabContent();
 
 		void StartSourcePreview(Audio::SourceHandle source, Time startTime = Time::Zero());
 		void StopSourcePreview();
 
 		void RemoveSourcePreviewVoice();
 
+		void StartVoiceRenderBenchmark();
+		void UpdateVoiceRenderBenchmark();
+		void StopVoiceRenderBenchmark();
+
+		void StartOneShotStressBenchmark();
+		void UpdateOneShotStressBenchmark();
+		void StopOneShotStressBenchmark();
+
+		void RunScheduledSoundBenchmark();
+		void RunNullBackendRenderTest();
+		void RunMixKernelBenchmark();
+		void RunResamplerBenchmark();
+		void RunSongLoadingBenchmark();
+		void RunDecodeBenchmark();
+		void RunWaveformBenchmark();
+
 		b8 sourcePreviewVoiceHasBeenAdded = false;
 		Audio::Voice sourcePreviewVoice = Audio::VoiceHandle::Invalid;
 		std::string voiceFlagsBuffer;
 		u32 newBufferFrameCount = 64;
+
+		// NOTE: Measures the render callback duration for an increasing number of (muted) live voices spread across all sound groups
+		struct VoiceRenderBenchmarkData
+		{
+			static constexpr i32 VoiceCounts[] = { 8, 32, 64 };
+			struct Result { i32 VoiceCount; Time Average, Max, BufferDuration; };
+
+			b8 IsRunning;
+			i32 StageIndex;
+			i64 StageStartRenderedFrames;
+			Audio::SourceHandle Source = Audio::SourceHandle::Invalid;
+			std::vector<Audio::Voice> Voices;
+			std::vector<Result> Results;
+		} voiceRenderBenchmark = {};
+
+		// NOTE: Fires (muted) one-shot drum hits from the UI thread at increasing rates, as previewing a drumroll at an absurdly fine bar division would,
+		//		 measuring the render callback duration together with how many of them didn't find a free voice slot to play with
+		struct OneShotStressBenchmarkData
+		{
+			static constexpr i32 OneShotsPerSecond[] = { 1000, 2000, 4000, 8000 };
+			struct Result { i32 OneShotsPerSecond; i64 FiredCount, DroppedCount; Time Average, Max, BufferDuration; };
+
+			b8 IsRunning;
+			i32 StageIndex;
+			i64 StageStartRenderedFrames;
+			i64 FiredCount, DroppedCount;
+			f64 PendingOneShotCount;
+			CPUStopwatch FireStopwatch;
+			Audio::SourceHandle Source = Audio::SourceHandle::Invalid;
+			std::vector<Result> Results;
+		} oneShotStressBenchmark = {};
+
+		// NOTE: Renders irregularly spaced clicks offline with UI frames being simulated at 60 FPS in between the buffers, once scheduled ahead through the audio engine
+		//		 and once triggered by the UI frames the way playback sounds used to be, measuring how far each click onset is off from its ideal output frame
+		struct ScheduledSoundBenchmarkData
+		{
+			struct Result { cstr Method; u32 BufferFrameCount; f32 PlaybackSpeed; i32 ExpectedCount, DetectedCount; f64 MeanAbsErrorMS, MaxAbsErrorMS; };
+			std::string ErrorMessage;
+			std::vector<Result> Results;
+		} scheduledSoundBenchmark = {};
+
+		// NOTE: Renders a fixed schedule of clicks through a manually clocked NullBackend into memory (the same way the preview mix is exported) for various buffer sizes,
+		//		 verifying that every click starts at exactly its expected output frame with its exact samples and that all frames in between stay silent
+		struct NullBackendRenderTestData
+		{
+			static constexpr u32 BufferFrameCounts[] = { 64, 441, 1024 };
+			struct Result { u32 BufferFrameCount; i64 RenderedFrameCount; i32 ClickCount; i64 MismatchedFrameCount, FirstMismatchedFrame; Time RenderDuration; };
+			std::string ErrorMessage;
+			std::vector<Result> Results;
+		} nullBackendRenderTest = {};
+
+		// NOTE: Measures the throughput of each mixing kernel for all supported code paths, verifying that they produce bit-identical results
+		struct MixKernelBenchmarkData
+		{
+			struct Result { cstr KernelName; f64 SamplesPerSecond[EnumCount<Audio::MixKernelPath>]; b8 IsBitExact; };
+			std::vector<Result> Results;
+		} mixKernelBenchmark = {};
+
+		// NOTE: Compares the throughput and THD+N (measured over a stepped sine sweep) of the linear and sinc resampler for typical source rates and playback speeds
+		struct ResamplerBenchmarkData
+		{
+			struct TestCase { u32 SourceSampleRate; f64 PlaybackSpeed; };
+			static constexpr TestCase Cases[] = { { 48000, 1.0 }, { 96000, 1.0 }, { 22050, 1.0 }, { 44100, 0.75 }, { 44100, 0.5 }, { 48000, 0.75 }, { 48000, 0.5 } };
+			struct Result { TestCase Case; i32 ToneCount; f64 FramesPerSecond[2]; f64 WorstTHDN[2], AverageTHDN[2]; };
+			std::vector<Result> Results;
+		} resamplerBenchmark = {};
+
+		// NOTE: Compares decoding an entire song file up front against streaming it, measuring the time until the first buffer can be rendered
+		//		 and the peak memory held while loading (computed from the sizes of all buffers involved rather than sampled from the process)
+		struct SongLoadingBenchmarkData
+		{
+			struct Result { cstr Method; Time TimeToFirstAudio, TimeToWaveform; size_t PeakByteSize, ResidentByteSize; };
+			std::string FilePath;
+			std::string ErrorMessage;
+			std::vector<Result> Results;
+		} songLoadingBenchmark = {};
+
+		// NOTE: Decodes every supported file inside a corpus directory (grouped by format), with the peak memory of a single load being its file content plus decoded samples
+		struct DecodeBenchmarkData
+		{
+			struct Result { i32 FileCount; size_t FileByteSize, DecodedByteSize, PeakByteSize; Time AudioDuration, DecodeDuration; };
+			std::string CorpusDirectory;
+			std::string ErrorMessage;
+			Result Results[EnumCount<Audio::SupportedFileFormat>];
+			b8 HasResults;
+		} decodeBenchmark = {};
+
+		// NOTE: Generates the waveform mip chains of both channels of a synthetic 10 minute 48 kHz stereo buffer, verifying that all methods produce identical mips.
+		//		 The generated waveform is then sampled for every pixel of a full HD wide timeline at various zoom levels, the same way the timeline draws it every frame
+		struct WaveformBenchmarkData
+		{
+			static constexpr f32 TimelineZoomLevels[] = { 0.001f, 0.01f, 0.1f, 1.0f, 10.0f, 100.0f };
+			static constexpr i32 TimelineWidthInPixels = 1920;
+			struct Result { cstr Method; Time Durations[EnumCount<Audio::MixKernelPath>]; b8 IsBitExact; };
+			struct ZoomResult { f32 Zoom; Time TimePerPixel, AverageFrameTime, MaxFrameTime; };
+			size_t ArenaByteSize;
+			std::vector<Result> Results;
+			std::vector<ZoomResult> ZoomResults;
+		} waveformBenchmark = {};
 	};
 }
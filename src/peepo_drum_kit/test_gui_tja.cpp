@@ -1,4 +1,14 @@
 #include "test_gui_tja.h"
+#include "chart_editor_undo.h"
+#include "chart_editor_widgets.h"
+#include "chart_editor_timeline.h"
+#include "core_string_shift_jis_table.h"
+#include <filesystem>
+#include <atomic>
+
+#if PEEPO_DEBUG
+#include <crtdbg.h>
+#endif
 
 namespace PeepoDrumKit
 {
@@ -174,6 +184,7 @@ namespace PeepoDrumKit
 			beginEndTabItem("Parsed", [this]() { DrawGuiParsedTabContent(); });
 			beginEndTabItem("Tokens", [this]() { DrawGuiTokensTabContent(); });
 			beginEndTabItem("File Content", [this]() { DrawGuiFileContentTabContent(); });
+			beginEndTabItem("Benchmark", [this]() { DrawGuiBenchmarkTabContent(); });
 			TabIndexToSelectThisFrame = -1;
 
 			Gui::EndTabBar();
@@ -399,10 +410,11 @@ namespace PeepoDrumKit
 							case TJA::ParsedChartCommandType::MeasureNotes:
 							{
 								static std::string strBuffer; strBuffer.clear();
-								for (const TJA::NoteType& note : param.MeasureNotes.Notes)
+								const auto measureNotes = LoadedTJAFile.Parsed.GetMeasureNotes(command);
+								for (const TJA::NoteType& note : measureNotes)
 								{
 									strBuffer += TJANoteTypeNames[EnumToIndex(note)];
-									if (&note != &param.MeasureNotes.Notes.back())
+									if (&note != &measureNotes.back())
 										strBuffer += " ";
 								}
 								if (!strBuffer.empty())
@@ -454,4 +466,1522 @@ namespace PeepoDrumKit
 			Gui::EndTabBar();
 		}
 	}
+
+	// NOTE: Deterministic (xorshift) pseudo random chart so that separate runs remain comparable
+	static std::unique_ptr<ChartCourse> CreateSyntheticBenchmarkCourse(i32 noteCount, i32 tempoChangeCount)
+	{
+		auto course = std::make_unique<ChartCourse>();
+		u32 randomState = 0x9E3779B9;
+		auto nextRandom = [&]() { randomState ^= (randomState << 13); randomState ^= (randomState >> 17); randomState ^= (randomState << 5); return randomState; };
+
+		Beat beat = Beat::Zero();
+		course->Notes_Normal.Sorted.reserve(noteCount);
+		for (i32 i = 0; i < noteCount; i++)
+		{
+			Note note = {};
+			note.BeatTime = beat;
+			note.Type = (nextRandom() % 3 == 0) ? NoteType::Ka : NoteType::Don;
+			course->Notes_Normal.Sorted.push_back(note);
+			beat += Beat::FromTicks(Beat::TicksPerBeat / ((nextRandom() % 4 == 0) ? 2 : 4));
+		}
+
+		course->TempoMap.Tempo.Sorted.reserve(tempoChangeCount);
+		for (i32 i = 0; i < tempoChangeCount; i++)
+		{
+			const Beat tempoBeat = Beat::FromTicks(static_cast<i32>((static_cast<i64>(beat.Ticks) * i) / tempoChangeCount));
+			course->TempoMap.Tempo.Sorted.push_back(TempoChange(tempoBeat, Tempo(static_cast<f32>(120 + (nextRandom() % 120)))));
+		}
+
+		course->TempoMap.RebuildAccelerationStructure();
+		course->RecalculateSENotes();
+		return course;
+	}
+
+	// NOTE: Counts the heap allocations made (by any thread) while alive, through an allocation hook of the debug CRT that is only installed for its own lifetime.
+	//		 Only used for comparing the allocation counts of different code paths, with Get() returning -1 in release builds
+	struct ScopedDebugAllocationCounter
+	{
+#if PEEPO_DEBUG
+		static inline std::atomic<i64> GlobalCount = 0;
+		static int __cdecl AllocHook(int allocType, void*, size_t, int blockType, long, const unsigned char*, int)
+		{
+			if ((allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC) && blockType != _CRT_BLOCK)
+				GlobalCount++;
+			return TRUE;
+		}
+
+		_CRT_ALLOC_HOOK PreviousHook = _CrtSetAllocHook(&AllocHook);
+		i64 CountOnConstruction = GlobalCount.load();
+
+		~ScopedDebugAllocationCounter() { _CrtSetAllocHook(PreviousHook); }
+		i64 Get() const { return GlobalCount.load() - CountOnConstruction; }
+#else
+		i64 Get() const { return -1; }
+#endif
+	};
+
+	template <typename Func>
+	static BenchmarkTiming MeasureBenchmarkIterations(i32 iterations, Func iterationFunc)
+	{
+		BenchmarkTiming out = { iterations, Time::Zero(), Time::FromSec(F64Max), Time::Zero() };
+		for (i32 i = 0; i < iterations; i++)
+		{
+			CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+			iterationFunc(i);
+			const Time elapsed = stopwatch.Stop();
+
+			out.Average += elapsed;
+			out.Min = Min(out.Min, elapsed);
+			out.Max = Max(out.Max, elapsed);
+		}
+		out.Average = (iterations > 0) ? (out.Average / iterations) : Time::Zero();
+		return out;
+	}
+
+	static void GuiBenchmarkTimingRow(cstr label, const BenchmarkTiming& timing)
+	{
+		Gui::TableNextRow();
+		Gui::TableNextColumn(); Gui::TextUnformatted(label);
+		Gui::TableNextColumn(); Gui::Text("%d", timing.Iterations);
+		Gui::TableNextColumn(); Gui::Text("%.3f ms", timing.Average.ToMS());
+		Gui::TableNextColumn(); Gui::Text("%.3f ms", timing.Min.ToMS());
+		Gui::TableNextColumn(); Gui::Text("%.3f ms", timing.Max.ToMS());
+	}
+
+	void TJATestWindow::DrawGuiBenchmarkTabContent()
+	{
+		Gui::BeginChild("BenchmarkChild", Gui::GetContentRegionAvail(), true);
+		defer { Gui::EndChild(); };
+
+		if (Gui::CollapsingHeader("Tempo Edit (10k Notes, 500 Tempo Changes)", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (Gui::Button("Run##TempoEdit"))
+				RunTempoEditBenchmark();
+
+			if (TempoEditBenchmark.HasResults)
+			{
+				Gui::SameLine();
+				if (TempoEditBenchmark.IncrementalMatchesFull)
+					Gui::TextColored(ImVec4(0.2f, 0.9f, 0.2f, 1.0f), "Incremental results match full recalculation");
+				else
+					Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "Incremental results DIFFER from full recalculation");
+
+				if (Gui::BeginTable("TempoEditBenchmarkTable", 5, ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+				{
+					Gui::TableSetupColumn("Drag Edit", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Iterations", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Average", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Min", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Max", ImGuiTableColumnFlags_None);
+					Gui::TableHeadersRow();
+					GuiBenchmarkTimingRow("Full Rebuild", TempoEditBenchmark.FullRebuild);
+					GuiBenchmarkTimingRow("Incremental (Undo Command)", TempoEditBenchmark.IncrementalRebuild);
+					Gui::EndTable();
+				}
+			}
+		}
+
+		if (Gui::CollapsingHeader("Import (7 Courses, 2000 Measures, Branches)", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (Gui::Button("Run##Import"))
+				RunImportBenchmark();
+
+			if (ImportBenchmark.HasResults)
+			{
+				Gui::SameLine();
+				if (ImportBenchmark.ParallelMatchesSerial)
+					Gui::TextColored(ImVec4(0.2f, 0.9f, 0.2f, 1.0f), "Parallel results match serial conversion");
+				else
+					Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "Parallel results DIFFER from serial conversion");
+				Gui::Text("%d courses, %.2f MB", ImportBenchmark.CourseCount, static_cast<f64>(ImportBenchmark.ByteSize) / (1024.0 * 1024.0));
+
+				if (Gui::BeginTable("ImportBenchmarkTable", 5, ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+				{
+					Gui::TableSetupColumn("Time to Editable", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Iterations", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Average", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Min", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Max", ImGuiTableColumnFlags_None);
+					Gui::TableHeadersRow();
+					GuiBenchmarkTimingRow("Serial Courses", ImportBenchmark.Serial);
+					GuiBenchmarkTimingRow("Parallel Courses", ImportBenchmark.Parallel);
+					Gui::EndTable();
+				}
+			}
+		}
+
+		if (Gui::CollapsingHeader("Parsing (7 Courses, 2000 Measures)", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (Gui::Button("Run##Parse"))
+				RunParseBenchmark();
+
+			if (ParseBenchmark.HasResults)
+			{
+				Gui::SameLine();
+				if (ParseBenchmark.StreamingMatchesVectors)
+					Gui::TextColored(ImVec4(0.2f, 0.9f, 0.2f, 1.0f), "Streaming results match parsing from vectors");
+				else
+					Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "Streaming results DIFFER from parsing from vectors");
+
+				if (Gui::BeginTable("ParseBenchmarkTable", 6, ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+				{
+					Gui::TableSetupColumn("File Content to ParsedTJA", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Iterations", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Average", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Min", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Max", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Allocations", ImGuiTableColumnFlags_None);
+					Gui::TableHeadersRow();
+					auto row = [](cstr label, const ParseBenchmarkData::Result& result)
+					{
+						GuiBenchmarkTimingRow(label, result.Timing);
+						Gui::TableNextColumn();
+						if (result.AllocationCount >= 0) Gui::Text("%lld", static_cast<long long>(result.AllocationCount)); else Gui::TextDisabled("(debug only)");
+					};
+					row("Lines + Tokens Vectors", ParseBenchmark.Vectors);
+					row("Token Stream", ParseBenchmark.Streaming);
+					Gui::EndTable();
+				}
+			}
+		}
+
+		if (Gui::CollapsingHeader("Shift-JIS Conversion (7 Courses, 2000 Measures)", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (Gui::Button("Run##ShiftJIS"))
+				RunShiftJISBenchmark();
+
+			if (ShiftJISBenchmark.HasResults)
+			{
+				Gui::SameLine();
+				if (ShiftJISBenchmark.DecodeMatchesWin32 && ShiftJISBenchmark.EncodeMatchesWin32)
+					Gui::TextColored(ImVec4(0.2f, 0.9f, 0.2f, 1.0f), "Lookup table results match Win32 conversion");
+				else
+					Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "Lookup table results DIFFER from Win32 conversion (decode: %s, encode: %s)",
+						ShiftJISBenchmark.DecodeMatchesWin32 ? "match" : "differ", ShiftJISBenchmark.EncodeMatchesWin32 ? "match" : "differ");
+				Gui::Text("%.2f MB", static_cast<f64>(ShiftJISBenchmark.ByteSize) / (1024.0 * 1024.0));
+
+				if (Gui::BeginTable("ShiftJISBenchmarkTable", 5, ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+				{
+					Gui::TableSetupColumn("Conversion", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Iterations", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Average", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Min", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Max", ImGuiTableColumnFlags_None);
+					Gui::TableHeadersRow();
+					GuiBenchmarkTimingRow("Shift-JIS -> UTF-8 (Lookup Table)", ShiftJISBenchmark.TableDecode);
+					GuiBenchmarkTimingRow("Shift-JIS -> UTF-8 (Win32 via UTF-16)", ShiftJISBenchmark.Win32Decode);
+					GuiBenchmarkTimingRow("UTF-8 -> Shift-JIS (Lookup Table)", ShiftJISBenchmark.TableEncode);
+					GuiBenchmarkTimingRow("UTF-8 -> Shift-JIS (Win32 via UTF-16)", ShiftJISBenchmark.Win32Encode);
+					Gui::EndTable();
+				}
+			}
+		}
+
+		if (Gui::CollapsingHeader("Writing (7 Courses, 2000 Measures)", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (Gui::Button("Run##Writer"))
+				RunWriterBenchmark();
+
+			if (WriterBenchmark.HasResults)
+			{
+				Gui::SameLine();
+				if (WriterBenchmark.OutputMatchesReference && WriterBenchmark.FractionalOutputMatchesReference && WriterBenchmark.LoadedFileOutputMatchesReference)
+					Gui::TextColored(ImVec4(0.2f, 0.9f, 0.2f, 1.0f), "Output matches reference writer byte-for-byte");
+				else
+					Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "Output DIFFERS from reference writer (synthetic: %s, fractional: %s, loaded file: %s)",
+						WriterBenchmark.OutputMatchesReference ? "match" : "differ", WriterBenchmark.FractionalOutputMatchesReference ? "match" : "differ", WriterBenchmark.LoadedFileOutputMatchesReference ? "match" : "differ");
+				Gui::Text("%.2f MB", static_cast<f64>(WriterBenchmark.ByteSize) / (1024.0 * 1024.0));
+
+				if (Gui::BeginTable("WriterBenchmarkTable", 6, ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+				{
+					Gui::TableSetupColumn("ParsedTJA to Text", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Iterations", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Average", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Min", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Max", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Allocations", ImGuiTableColumnFlags_None);
+					Gui::TableHeadersRow();
+					auto row = [](cstr label, const WriterBenchmarkData::Result& result)
+					{
+						GuiBenchmarkTimingRow(label, result.Timing);
+						Gui::TableNextColumn();
+						if (result.AllocationCount >= 0) Gui::Text("%lld", static_cast<long long>(result.AllocationCount)); else Gui::TextDisabled("(debug only)");
+					};
+					row("Reference (sprintf_s)", WriterBenchmark.Reference);
+					row("Writer (to_chars)", WriterBenchmark.Writer);
+					Gui::EndTable();
+				}
+			}
+		}
+
+		if (Gui::CollapsingHeader("Fumen (7 Courses, 2000 Measures)", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (Gui::Button("Run##Fumen"))
+				RunFumenBenchmark();
+
+			if (FumenBenchmark.HasResults)
+			{
+				Gui::SameLine();
+				if (FumenBenchmark.RoundTripNotesMatch && FumenBenchmark.RoundTripBytesMatch && FumenBenchmark.TruncatedFilesRejected && FumenBenchmark.CorruptedFilesRejected)
+					Gui::TextColored(ImVec4(0.2f, 0.9f, 0.2f, 1.0f), "Round trip through fumen preserves all notes");
+				else
+					Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "Round trip through fumen FAILED (notes: %s, bytes: %s, truncated files: %s, corrupted files: %s)",
+						FumenBenchmark.RoundTripNotesMatch ? "match" : "differ", FumenBenchmark.RoundTripBytesMatch ? "match" : "differ",
+						FumenBenchmark.TruncatedFilesRejected ? "rejected" : "accepted", FumenBenchmark.CorruptedFilesRejected ? "rejected" : "accepted");
+				Gui::Text("TJA %.2f MB, Fumen %.2f MB", static_cast<f64>(FumenBenchmark.TJAByteSize) / (1024.0 * 1024.0), static_cast<f64>(FumenBenchmark.FumenByteSize) / (1024.0 * 1024.0));
+
+				if (Gui::BeginTable("FumenBenchmarkTable", 5, ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+				{
+					Gui::TableSetupColumn("Conversion", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Iterations", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Average", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Min", ImGuiTableColumnFlags_None);
+					Gui::TableSetupColumn("Max", ImGuiTableColumnFlags_None);
+					Gui::TableHeadersRow();
+					GuiBenchmarkTimingRow("TJA Text -> ChartProject", FumenBenchmark.TJARead);
+					GuiBenchmarkTimingRow("Fumen -> ChartProject", FumenBenchmark.FumenRead);
+					GuiBenchmarkTimingRow("Fumen (Memory Mapped Files) -> ChartProject", FumenBenchmark.FumenMappedRead);
+					GuiBenchmarkTimingRow("ChartProject -> TJA Text", FumenBenchmark.TJAWrite);
+					GuiBenchmarkTimingRow("ChartProject -> Fumen", FumenBenchmark.FumenWrite);
+					Gui::EndTable();
+				}
+			}
+		}
+
+		if (Gui::CollapsingHeader("BeatSortedList Insertion (1k - 100k Tempo Changes)", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (Gui::Button("Run##BulkInsert"))
+				RunBulkInsertBenchmark();
+
+			if (BulkInsertBenchmark.HasResults)
+			{
+				Gui::SameLine();
+				if (BulkInsertBenchmark.AllResultsMatch)
+					Gui::TextColored(ImVec4(0.2f, 0.9f, 0.2f, 1.0f), "Bulk insertion matches one at a time insertion");
+				else
+					Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "Bulk insertion DIFFERS from one at a time insertion");
+
+				static constexpr cstr resultsTableFields[] = { "Changes", "Unique Beats", "InsertOrUpdate (Average)", "BulkInsertOrUpdate (Average)", "Speedup" };
+				if (Gui::BeginTable("BulkInsertBenchmarkTable", ArrayCountI32(resultsTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+				{
+					for (cstr field : resultsTableFields)
+						Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+					Gui::TableHeadersRow();
+
+					for (const auto& result : BulkInsertBenchmark.Results)
+					{
+						Gui::TableNextRow();
+						Gui::TableNextColumn(); Gui::Text("%d", result.EventCount);
+						Gui::TableNextColumn(); Gui::Text("%zu", result.UniqueCount);
+						Gui::TableNextColumn(); if (result.HasPerItem) Gui::Text("%.3f ms", result.PerItem.Average.ToMS()); else Gui::TextDisabled("(skipped)");
+						Gui::TableNextColumn(); Gui::Text("%.3f ms", result.Bulk.Average.ToMS());
+						Gui::TableNextColumn(); if (result.HasPerItem && result.Bulk.Average.ToMS() > 0.0) Gui::Text("%.1fx", result.PerItem.Average.ToMS() / result.Bulk.Average.ToMS()); else Gui::TextDisabled("-");
+					}
+					Gui::EndTable();
+				}
+			}
+		}
+
+		if (Gui::CollapsingHeader("Game Preview Note Culling (3k / 30k Notes)", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (Gui::Button("Run##GamePreviewCulling"))
+				RunGamePreviewCullingBenchmark();
+
+			if (GamePreviewCullingBenchmark.HasResults)
+			{
+				for (const auto& result : GamePreviewCullingBenchmark.Results)
+				{
+					Gui::SameLine();
+					if (result.IndexMatchesFullWalk && result.IncrementalMatchesFullBuild)
+						Gui::TextColored(ImVec4(0.2f, 0.9f, 0.2f, 1.0f), "%dk: Indexed notes match", result.NoteCount / 1000);
+					else if (!result.IndexMatchesFullWalk)
+						Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "%dk: Indexed notes MISS visible notes", result.NoteCount / 1000);
+					else
+						Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "%dk: Incremental update DIFFERS from full build", result.NoteCount / 1000);
+				}
+
+				static constexpr cstr resultsTableFields[] = { "Notes", "Full Walk (per Frame)", "Indexed (per Frame)", "Collected Notes (Full / Indexed)", "Index Build", "Incremental Update" };
+				if (Gui::BeginTable("GamePreviewCullingBenchmarkTable", ArrayCountI32(resultsTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+				{
+					for (cstr field : resultsTableFields)
+						Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+					Gui::TableHeadersRow();
+
+					for (const auto& result : GamePreviewCullingBenchmark.Results)
+					{
+						Gui::TableNextRow();
+						Gui::TableNextColumn(); Gui::Text("%d", result.NoteCount);
+						Gui::TableNextColumn(); Gui::Text("%.3f ms (max %.3f ms)", result.FullWalk.Average.ToMS(), result.FullWalk.Max.ToMS());
+						Gui::TableNextColumn(); Gui::Text("%.3f ms (max %.3f ms)", result.Indexed.Average.ToMS(), result.Indexed.Max.ToMS());
+						Gui::TableNextColumn(); Gui::Text("%.1f / %.1f", result.AverageFullWalkNoteCount, result.AverageIndexedNoteCount);
+						Gui::TableNextColumn(); Gui::Text("%.3f ms", result.FullIndexBuild.Average.ToMS());
+						Gui::TableNextColumn(); Gui::Text("%.3f ms", result.IncrementalIndexUpdate.Average.ToMS());
+					}
+					Gui::EndTable();
+				}
+			}
+		}
+
+		if (Gui::CollapsingHeader("Timeline Row Culling (50k Notes)", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			if (Gui::Button("Run##TimelineCulling"))
+				RunTimelineCullingBenchmark();
+
+			if (TimelineCullingBenchmark.HasResults)
+			{
+				b8 allResultsMatch = true;
+				for (const auto& result : TimelineCullingBenchmark.Results)
+					allResultsMatch &= result.CulledMatchesFullWalk;
+
+				Gui::SameLine();
+				if (allResultsMatch)
+					Gui::TextColored(ImVec4(0.2f, 0.9f, 0.2f, 1.0f), "Culled notes match");
+				else
+					Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "Culled notes DIFFER from full walk");
+
+				static constexpr cstr resultsTableFields[] = { "Visible Range", "Visible Notes", "Full Walk (per Frame)", "Culled (per Frame)" };
+				if (Gui::BeginTable("TimelineCullingBenchmarkTable", ArrayCountI32(resultsTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+				{
+					for (cstr field : resultsTableFields)
+						Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+					Gui::TableHeadersRow();
+
+					for (const auto& result : TimelineCullingBenchmark.Results)
+					{
+						Gui::TableNextRow();
+						Gui::TableNextColumn(); Gui::Text("%.0f sec", result.VisibleDurationSec);
+						Gui::TableNextColumn(); Gui::Text("%.1f", result.AverageVisibleNoteCount);
+						Gui::TableNextColumn(); Gui::Text("%.3f ms (max %.3f ms)", result.FullWalk.Average.ToMS(), result.FullWalk.Max.ToMS());
+						Gui::TableNextColumn(); Gui::Text("%.3f ms (max %.3f ms)", result.Culled.Average.ToMS(), result.Culled.Max.ToMS());
+					}
+					Gui::EndTable();
+				}
+			}
+		}
+
+		if (Gui::CollapsingHeader("Tokenizer", ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			auto& benchmark = TokenizerBenchmark;
+			Gui::SetNextItemWidth(Gui::GetContentRegionAvail().x * 0.6f);
+			Gui::InputTextWithHint("##CorpusDirectory", "Corpus directory path...", &benchmark.CorpusDirectory);
+			Gui::SameLine();
+			if (Gui::Button("Run##Tokenizer"))
+				RunTokenizerBenchmark();
+
+			if (!benchmark.ErrorMessage.empty())
+				Gui::TextColored(ImVec4(0.9f, 0.2f, 0.2f, 1.0f), "%s", benchmark.ErrorMessage.c_str());
+
+			if (benchmark.HasResults)
+			{
+				Gui::Text("%d files, %.2f MB, %zu lines, %zu tokens", benchmark.FileCount, static_cast<f64>(benchmark.ByteSize) / (1024.0 * 1024.0), benchmark.LineCount, benchmark.TokenCount);
+
+				static constexpr cstr resultsTableFields[] = { "Stage", "Total", "Per File", "Throughput" };
+				if (Gui::BeginTable("TokenizerBenchmarkTable", ArrayCountI32(resultsTableFields), ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_SizingStretchSame))
+				{
+					for (cstr field : resultsTableFields)
+						Gui::TableSetupColumn(field, ImGuiTableColumnFlags_None);
+					Gui::TableHeadersRow();
+
+					auto row = [&](cstr label, Time duration)
+					{
+						Gui::TableNextRow();
+						Gui::TableNextColumn(); Gui::TextUnformatted(label);
+						Gui::TableNextColumn(); Gui::Text("%.3f ms", duration.ToMS());
+						Gui::TableNextColumn(); Gui::Text("%.3f ms", (duration / static_cast<f64>(Max(benchmark.FileCount, 1))).ToMS());
+						Gui::TableNextColumn(); Gui::Text("%.1f MB/s", (duration.ToSec() > 0.0) ? (static_cast<f64>(benchmark.ByteSize) / (1024.0 * 1024.0) / duration.ToSec()) : 0.0);
+					};
+					row("Split Lines", benchmark.SplitLinesDuration);
+					row("Tokenize Lines", benchmark.TokenizeDuration);
+					row("Total", benchmark.SplitLinesDuration + benchmark.TokenizeDuration);
+					Gui::EndTable();
+				}
+			}
+		}
+	}
+
+	void TJATestWindow::RunTempoEditBenchmark()
+	{
+		constexpr i32 iterationCount = 64;
+		std::unique_ptr<ChartCourse> course = CreateSyntheticBenchmarkCourse(10000, 500);
+
+		// NOTE: Simulate dragging the tempo slider of a tempo change in the second half of the chart, one edit per frame
+		const TempoChange draggedTempoChange = course->TempoMap.Tempo[(course->TempoMap.Tempo.size() * 3) / 4];
+		auto getDraggedTempoChange = [&](i32 iteration) { TempoChange v = draggedTempoChange; v.Tempo.BPM += static_cast<f32>(iteration % 16); return v; };
+
+		TempoEditBenchmark.FullRebuild = MeasureBenchmarkIterations(iterationCount, [&](i32 i)
+		{
+			course->TempoMap.Tempo.InsertOrUpdate(getDraggedTempoChange(i));
+			course->TempoMap.RebuildAccelerationStructure();
+			course->RecalculateSENotes();
+		});
+
+		TempoEditBenchmark.IncrementalRebuild = MeasureBenchmarkIterations(iterationCount, [&](i32 i)
+		{
+			Commands::UpdateTempoChange(course.get(), &course->TempoMap, getDraggedTempoChange(i + 1)).Redo();
+		});
+
+		std::vector<NoteSEType> incrementalSETypes; incrementalSETypes.reserve(course->Notes_Normal.size());
+		std::vector<Time> incrementalNoteTimes; incrementalNoteTimes.reserve(course->Notes_Normal.size());
+		for (const Note& note : course->Notes_Normal) { incrementalSETypes.push_back(note.TempSEType); incrementalNoteTimes.push_back(course->TempoMap.BeatToTime(note.BeatTime)); }
+
+		course->TempoMap.RebuildAccelerationStructure();
+		course->RecalculateSENotes();
+
+		TempoEditBenchmark.IncrementalMatchesFull = true;
+		for (size_t i = 0; i < course->Notes_Normal.size(); i++)
+		{
+			const Note& note = course->Notes_Normal[i];
+			if (note.TempSEType != incrementalSETypes[i] || course->TempoMap.BeatToTime(note.BeatTime) != incrementalNoteTimes[i])
+				TempoEditBenchmark.IncrementalMatchesFull = false;
+		}
+		TempoEditBenchmark.HasResults = true;
+	}
+
+	// NOTE: Deterministic (xorshift) pseudo random TJA with every course having its own branches, tempo and scroll changes and gogo ranges
+	static std::string CreateSyntheticBenchmarkTJA(i32 measureCountPerCourse)
+	{
+		u32 randomState = 0x9E3779B9;
+		auto nextRandom = [&]() { randomState ^= (randomState << 13); randomState ^= (randomState >> 17); randomState ^= (randomState << 5); return randomState; };
+
+		static constexpr cstr measurePatterns[] = { "1000100010001000,", "1010201010102010,", "1120112011201120,", "3000400030004000,", "1011201110112011,", "5000000000000008,", "0,", };
+		static constexpr struct { cstr Course, Style, Start; } courses[] =
+		{
+			{ "Easy", "Single", "" }, { "Normal", "Single", "" }, { "Hard", "Single", "" }, { "Oni", "Single", "" }, { "Edit", "Single", "" },
+			{ "Oni", "Double", " P1" }, { "Oni", "Double", " P2" },
+		};
+
+		std::string tja;
+		tja += "TITLE:Benchmark\nSUBTITLE:--Synthetic\nBPM:160\nWAVE:benchmark.ogg\nOFFSET:0\n\n";
+		for (const auto& course : courses)
+		{
+			tja += "COURSE:"; tja += course.Course; tja += "\nLEVEL:10\nSTYLE:"; tja += course.Style; tja += "\n\n#START"; tja += course.Start; tja += "\n";
+			for (i32 measure = 0; measure < measureCountPerCourse; measure++)
+			{
+				if (nextRandom() % 16 == 0) { tja += "#BPMCHANGE "; tja += std::to_string(120 + (nextRandom() % 120)); tja += "\n"; }
+				if (nextRandom() % 16 == 0) { tja += "#SCROLL "; tja += std::to_string(1 + (nextRandom() % 3)); tja += "\n"; }
+				if (measure % 64 == 0) tja += "#GOGOSTART\n";
+				if (measure % 64 == 16) tja += "#GOGOEND\n";
+
+				if (measure % 32 == 0 && (measure + 4) < measureCountPerCourse)
+				{
+					tja += "#BRANCHSTART p,60,80\n";
+					for (cstr branch : { "#N\n", "#E\n", "#M\n" })
+					{
+						tja += branch;
+						for (i32 i = 0; i < 4; i++) { tja += measurePatterns[nextRandom() % ArrayCount(measurePatterns)]; tja += "\n"; }
+					}
+					tja += "#BRANCHEND\n";
+					measure += 3;
+					continue;
+				}
+
+				tja += measurePatterns[nextRandom() % ArrayCount(measurePatterns)];
+				tja += "\n";
+			}
+			tja += "#END\n\n";
+		}
+		return tja;
+	}
+
+	void TJATestWindow::RunImportBenchmark()
+	{
+		constexpr i32 iterationCount = 8;
+		const std::string fileContentUTF8 = CreateSyntheticBenchmarkTJA(2000);
+
+		auto importChart = [&](ChartProject& outChart, b8 convertCoursesInParallel)
+		{
+			TJA::ErrorList parseErrors;
+			const TJA::ParsedTJA parsed = TJA::ParseFileContent(fileContentUTF8, parseErrors);
+			CreateChartProjectFromTJA(parsed, outChart, convertCoursesInParallel);
+		};
+
+		ChartProject serialChart, parallelChart;
+		ImportBenchmark.Serial = MeasureBenchmarkIterations(iterationCount, [&](i32) { serialChart = {}; importChart(serialChart, false); });
+		ImportBenchmark.Parallel = MeasureBenchmarkIterations(iterationCount, [&](i32) { parallelChart = {}; importChart(parallelChart, true); });
+
+		b8 anyMismatch = (serialChart.Courses.size() != parallelChart.Courses.size()) || (serialChart.ChartDuration != parallelChart.ChartDuration);
+		DebugCompareCharts(serialChart, parallelChart, [](std::string_view, void* userData) { *static_cast<b8*>(userData) = true; }, &anyMismatch);
+		for (size_t i = 0; i < Min(serialChart.Courses.size(), parallelChart.Courses.size()); i++)
+		{
+			const ChartCourse& serialCourse = *serialChart.Courses[i];
+			const ChartCourse& parallelCourse = *parallelChart.Courses[i];
+			anyMismatch |= (serialCourse.Type != parallelCourse.Type) || (serialCourse.Style != parallelCourse.Style) || (serialCourse.PlayerSide != parallelCourse.PlayerSide);
+			for (size_t n = 0; n < Min(serialCourse.Notes_Normal.size(), parallelCourse.Notes_Normal.size()); n++)
+				anyMismatch |= (serialCourse.Notes_Normal[n].TempSEType != parallelCourse.Notes_Normal[n].TempSEType);
+		}
+
+		ImportBenchmark.ParallelMatchesSerial = !anyMismatch;
+		ImportBenchmark.CourseCount = static_cast<i32>(parallelChart.Courses.size());
+		ImportBenchmark.ByteSize = fileContentUTF8.size();
+		ImportBenchmark.HasResults = true;
+	}
+
+	void TJATestWindow::RunParseBenchmark()
+	{
+		constexpr i32 iterationCount = 8;
+		const std::string fileContentUTF8 = CreateSyntheticBenchmarkTJA(2000);
+
+		auto parseFromVectors = [&](TJA::ErrorList& outErrors)
+		{
+			const std::vector<std::string_view> lines = TJA::SplitLines(fileContentUTF8);
+			const std::vector<TJA::Token> tokens = TJA::TokenizeLines(lines);
+			return TJA::ParseTokens(tokens, outErrors);
+		};
+		auto parseStreaming = [&](TJA::ErrorList& outErrors)
+		{
+			return TJA::ParseFileContent(fileContentUTF8, outErrors);
+		};
+
+		auto measure = [&](auto parseFunc, std::string& outText, TJA::ErrorList& outErrors)
+		{
+			ParseBenchmarkData::Result result = {};
+			result.Timing = MeasureBenchmarkIterations(iterationCount, [&](i32) { TJA::ErrorList errors; TJA::ParsedTJA parsed = parseFunc(errors); });
+			{
+				const ScopedDebugAllocationCounter allocationCounter;
+				{ TJA::ErrorList errors; TJA::ParsedTJA parsed = parseFunc(errors); }
+				result.AllocationCount = allocationCounter.Get();
+			}
+			const TJA::ParsedTJA parsed = parseFunc(outErrors);
+			TJA::ConvertParsedToText(parsed, outText, TJA::Encoding::UTF8);
+			return result;
+		};
+
+		std::string vectorsText, streamingText;
+		TJA::ErrorList vectorsErrors, streamingErrors;
+		ParseBenchmark.Vectors = measure(parseFromVectors, vectorsText, vectorsErrors);
+		ParseBenchmark.Streaming = measure(parseStreaming, streamingText, streamingErrors);
+
+		ParseBenchmark.StreamingMatchesVectors = (vectorsText == streamingText) && (vectorsErrors.Errors.size() == streamingErrors.Errors.size());
+		for (size_t i = 0; ParseBenchmark.StreamingMatchesVectors && i < vectorsErrors.Errors.size(); i++)
+		{
+			if (vectorsErrors.Errors[i].LineIndex != streamingErrors.Errors[i].LineIndex || vectorsErrors.Errors[i].Description != streamingErrors.Errors[i].Description)
+				ParseBenchmark.StreamingMatchesVectors = false;
+		}
+		ParseBenchmark.HasResults = true;
+	}
+
+	void TJATestWindow::RunShiftJISBenchmark()
+	{
+		constexpr i32 iterationCount = 16;
+
+		// NOTE: Followed by every single and double byte character of the code page, so that the entire table gets verified and not just the (mostly ASCII) chart itself
+		std::string fileContentShiftJIS = ShiftJIS::FromUTF8(CreateSyntheticBenchmarkTJA(2000));
+		for (i32 byte = 0x01, leadIndex = 0; byte <= 0xFF; byte++)
+		{
+			const b8 isLeadByte = (byte >= 0x81 && byte <= 0x9F) || (byte >= 0xE0 && byte <= 0xFC);
+			if (!isLeadByte)
+			{
+				fileContentShiftJIS += static_cast<char>(byte);
+				continue;
+			}
+
+			for (i32 trail = 0x40; trail <= 0xFC; trail++)
+			{
+				if (ShiftJIS::DoubleByteToUTF16Table[leadIndex][trail - 0x40] != 0)
+				{
+					fileContentShiftJIS += static_cast<char>(byte);
+					fileContentShiftJIS += static_cast<char>(trail);
+				}
+			}
+			leadIndex++;
+		}
+
+		std::string tableDecoded, win32Decoded, tableEncoded, win32Encoded;
+		ShiftJISBenchmark.TableDecode = MeasureBenchmarkIterations(iterationCount, [&](i32) { tableDecoded = UTF8::FromShiftJIS(fileContentShiftJIS); });
+		ShiftJISBenchmark.Win32Decode = MeasureBenchmarkIterations(iterationCount, [&](i32) { win32Decoded = UTF8::Narrow(ShiftJIS::Widen(fileContentShiftJIS)); });
+		ShiftJISBenchmark.TableEncode = MeasureBenchmarkIterations(iterationCount, [&](i32) { tableEncoded = ShiftJIS::FromUTF8(tableDecoded); });
+		ShiftJISBenchmark.Win32Encode = MeasureBenchmarkIterations(iterationCount, [&](i32) { win32Encoded = ShiftJIS::Narrow(UTF8::Widen(tableDecoded)); });
+
+		ShiftJISBenchmark.DecodeMatchesWin32 = (tableDecoded == win32Decoded);
+		ShiftJISBenchmark.EncodeMatchesWin32 = (tableEncoded == win32Encoded);
+		ShiftJISBenchmark.ByteSize = fileContentShiftJIS.size();
+		ShiftJISBenchmark.HasResults = true;
+	}
+
+	// NOTE: Original sprintf_s() and temporary string based implementation of TJA::ConvertParsedToText(),
+	//		 only kept around as a reference for verifying that its output stays byte-for-byte identical
+	static void ConvertParsedToTextReference(const TJA::ParsedTJA& inContent, std::string& out, TJA::Encoding encoding)
+	{
+		using namespace TJA;
+		using TJA::NoteType;
+		using TJA::DifficultyType;
+		static const ParsedMainMetadata DefaultMainMetadata = {};
+		static const ParsedCourseMetadata DefaultCourseMetadata = {};
+
+		// TODO: ... or maybe tokenize first instead of going right to text..?
+		out.reserve(out.size() + 0x4000);
+		if (encoding == Encoding::UTF8)
+			out += std::string_view(UTF8::BOM_UTF8, sizeof(UTF8::BOM_UTF8));
+
+		static constexpr auto appendLine = [](std::string& out, std::string_view line) { out += line; out += '\n'; };
+		static constexpr auto appendProperyLine = [](std::string& out, Key key, std::string_view value) { out += GetKeyString(key); out += ':'; out += value; out += '\n'; };
+		static constexpr auto appendSuffixedPropertyLine = [](std::string& out, Key key, std::string_view suffix, std::string_view value)
+		{ out += GetKeyString(key); out += suffix; out += ':'; out += value; out += '\n'; };
+		static constexpr auto appendCommandLine = [](std::string& out, Key key, std::string_view value) { out += '#'; out += GetKeyString(key); if (!value.empty()) { out += ' '; out += value; }out += '\n'; };
+		static constexpr auto appendBalloonProperyLine = [](std::string& out, Key key, const std::vector<i32>& popCounts)
+		{
+			out += GetKeyString(key);
+			out += ':';
+			char buffer[16];
+			for (size_t i = 0; i < popCounts.size(); i++) { if (i != 0) { out += ','; } out += std::string_view(buffer, sprintf_s(buffer, "%d", popCounts[i])); }
+			out += '\n';
+		};
+		char buffer[512];
+
+		static constexpr auto noteTypeToChar = [](NoteType in) -> char
+		{
+			switch (in)
+			{
+			case NoteType::None: return '0';
+			case NoteType::Don: return '1';
+			case NoteType::Ka: return '2';
+			case NoteType::DonBig: return '3';
+			case NoteType::KaBig: return '4';
+			case NoteType::Start_Drumroll: return '5';
+			case NoteType::Start_DrumrollBig: return '6';
+			case NoteType::Start_Balloon: return '7';
+			case NoteType::End_BalloonOrDrumroll: return '8';
+			case NoteType::Start_BaloonSpecial: return '9';
+			case NoteType::DonBigBoth: return 'A';
+			case NoteType::KaBigBoth: return 'B';
+			case NoteType::Bomb: return 'C';
+			case NoteType::Fuse: return 'D';
+			case NoteType::Hidden: return 'F';
+			case NoteType::KaDon: return 'G';
+			default: return ' ';
+			}
+		};
+		static constexpr auto difficultyTypeToString = [](DifficultyType in) -> cstr
+		{
+			switch (in)
+			{
+			case DifficultyType::Easy: return "Easy";
+			case DifficultyType::Normal: return "Normal";
+			case DifficultyType::Hard: return "Hard";
+			case DifficultyType::Oni: return "Oni";
+			case DifficultyType::OniUra: return "Edit";
+			case DifficultyType::Tower: return "Tower";
+			case DifficultyType::Dan: return "Dan";
+			default: return "";
+			}
+		};
+		static auto styleModeToString = [&](i32 in) -> std::string
+		{
+			switch (in)
+			{
+			case 1: return "Single";
+			case 2: return "Double";
+			default: return std::to_string(in);
+			}
+		};
+		static constexpr auto sideToString = [](SongSelectSide in) -> cstr
+		{
+			switch (in)
+			{
+			case SongSelectSide::Normal: return "Normal";
+			case SongSelectSide::Ex: return "Ex";
+			case SongSelectSide::Both: return "Both";
+			default: return "";
+			}
+		};
+
+		// ヘッダー部分の云々かんぬん
+		if (inContent.HasPeepoDrumKitComment)
+		{
+			/*
+			out += "// ";
+			out += PeepoDrumKitCommentMarkerPrefix;
+			if (inContent.PeepoDrumKitCommentDate != Date::Zero())
+			{
+				out += " ";
+				out += inContent.PeepoDrumKitCommentDate.ToString().Data;
+			}
+			out += '\n';
+			*/
+		}
+
+		DifficultyType currentCourseScope = DifficultyType::Count; // default course scope
+
+		auto shouldEmitMainMetadata = [&, &inContent = inContent](auto ParsedMainMetadata::*... membs) // MSVC++ bug?: cannot implicitly capture variables when used in folder expression
+		{
+			return (... || (inContent.Metadata.*membs != DefaultMainMetadata.*membs));
+		};
+
+		appendProperyLine(out, Key::Main_TITLE, inContent.Metadata.TITLE); // Required for TaikoJiro
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::TITLE_localized)) {
+			for (const auto& [locale, val] : inContent.Metadata.TITLE_localized)
+				appendSuffixedPropertyLine(out, Key::Main_TITLE_localized, locale, val);
+		}
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::SUBTITLE, &ParsedMainMetadata::SUBTITLE_localized))
+			appendProperyLine(out, Key::Main_SUBTITLE, inContent.Metadata.SUBTITLE); // Better to be explicit if localized
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::SUBTITLE_localized)) {
+			for (const auto& [locale, val] : inContent.Metadata.SUBTITLE_localized)
+				appendSuffixedPropertyLine(out, Key::Main_SUBTITLE_localized, locale, val);
+		}
+		appendProperyLine(out, Key::Main_BPM, std::string_view(buffer, sprintf_s(buffer, "%g", inContent.Metadata.BPM.BPM))); // Better to be explicit
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::WAVE))
+			appendProperyLine(out, Key::Main_WAVE, inContent.Metadata.WAVE);
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::PREIMAGE))
+			appendProperyLine(out, Key::Main_PREIMAGE, inContent.Metadata.PREIMAGE);
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::WAVE, &ParsedMainMetadata::OFFSET)) // Better to be explicit if `WAVE:` is given
+			appendProperyLine(out, Key::Main_OFFSET, std::string_view(buffer, sprintf_s(buffer, "%g", inContent.Metadata.OFFSET.Seconds)));
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::DEMOSTART))
+			appendProperyLine(out, Key::Main_DEMOSTART, std::string_view(buffer, sprintf_s(buffer, "%g", inContent.Metadata.DEMOSTART.Seconds)));
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::GENRE))
+			appendProperyLine(out, Key::Main_GENRE, inContent.Metadata.GENRE);
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::SCOREMODE))
+			appendProperyLine(out, Key::Main_SCOREMODE, std::string_view(buffer, sprintf_s(buffer, "%d", static_cast<i32>(inContent.Metadata.SCOREMODE))));
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::MAKER))
+			appendProperyLine(out, Key::Main_MAKER, inContent.Metadata.MAKER);
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::LYRICS))
+			appendProperyLine(out, Key::Main_LYRICS, inContent.Metadata.LYRICS);
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::SONGVOL))
+			appendProperyLine(out, Key::Main_SONGVOL, std::string_view(buffer, sprintf_s(buffer, "%g", ToPercent(inContent.Metadata.SONGVOL))));
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::SEVOL))
+			appendProperyLine(out, Key::Main_SEVOL, std::string_view(buffer, sprintf_s(buffer, "%g", ToPercent(inContent.Metadata.SEVOL))));
+		// TODO: Key::Main_SIDE;
+		// TODO: Key::Main_GAME;
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::HEADSCROLL))
+			appendProperyLine(out, Key::Main_HEADSCROLL, std::string_view(buffer, sprintf_s(buffer, "%g", inContent.Metadata.HEADSCROLL)));
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::BGIMAGE))
+			appendProperyLine(out, Key::Main_BGIMAGE, inContent.Metadata.BGIMAGE);
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::BGMOVIE))
+			appendProperyLine(out, Key::Main_BGMOVIE, inContent.Metadata.BGMOVIE);
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::BGIMAGE, &ParsedMainMetadata::BGMOVIE, &ParsedMainMetadata::MOVIEOFFSET)) // Better to be explicit if bg is given
+			appendProperyLine(out, Key::Main_MOVIEOFFSET, std::string_view(buffer, sprintf_s(buffer, "%g", inContent.Metadata.MOVIEOFFSET.Seconds)));
+
+		if (shouldEmitMainMetadata(&ParsedMainMetadata::Others)) {
+			for (const auto& [header, val] : inContent.Metadata.Others)
+				appendSuffixedPropertyLine(out, Key::Main_Unknown, header, val);
+		}
+
+		appendLine(out, "");
+
+		// group difficulties by course scope
+		using CourseIter = decltype(inContent.Courses)::const_iterator;
+		std::vector<std::pair<CourseIter, CourseIter>> courseScopes = {};
+
+		for (auto it = begin(inContent.Courses); it != end(inContent.Courses); ++it) {
+			const auto& course = *it;
+			if (course.Metadata.COURSE == currentCourseScope)
+				continue;
+			// change course scope
+			if (!courseScopes.empty())
+				courseScopes.back().second = it;
+			courseScopes.emplace_back(it, end(inContent.Courses));
+			currentCourseScope = course.Metadata.COURSE;
+		}
+		// revert course scope
+		currentCourseScope = DifficultyType::Count;
+
+		static constexpr auto courseMetadataDifferWithin = [](CourseIter it, CourseIter itBeg, CourseIter itEnd, auto ParsedCourseMetadata::*... membs)
+		{
+			for (CourseIter itI = itBeg; itI != itEnd; ++itI) {
+				if ((... || (it->Metadata.*membs != itI->Metadata.*membs)))
+					return true;
+			}
+			return false;
+		};
+
+		auto convertCourse = [&](CourseIter it, CourseIter itBeg, CourseIter itEnd)
+		{
+			auto shouldEmitCourseMetadata = [&, &inContent = inContent](auto ParsedCourseMetadata::*... membs) // MSVC++ bug?: cannot implicitly capture variables when used in folder expression
+			{
+				if (it == itBeg) {
+					return (... || (it->Metadata.*membs != DefaultCourseMetadata.*membs)) // group-initial, non-default
+						|| courseMetadataDifferWithin(it, begin(inContent.Courses), end(inContent.Courses), membs...); // differ globally, better to be explicit
+				}
+				return courseMetadataDifferWithin(it, itBeg, itEnd, membs...); // differ in group, better to be explicit
+			};
+
+			const ParsedCourse& course = *it;
+			if (&course != &inContent.Courses[0])
+				appendLine(out, "");
+
+			b8 firstInGroup = (it == itBeg);
+			if (firstInGroup) { // change course scope
+				appendProperyLine(out, Key::Course_COURSE, difficultyTypeToString(course.Metadata.COURSE));
+				currentCourseScope = course.Metadata.COURSE;
+			}
+
+			// scope-like, omit mid-group when possible
+			if (firstInGroup ? shouldEmitCourseMetadata(&ParsedCourseMetadata::STYLE) : course.Metadata.STYLE != (it - 1)->Metadata.STYLE) {
+				if (firstInGroup)
+					appendLine(out, "");
+				appendProperyLine(out, Key::Course_STYLE, styleModeToString(course.Metadata.STYLE));
+				appendLine(out, "");
+			}
+
+			// Unspecified default value
+			if (firstInGroup || shouldEmitCourseMetadata(&ParsedCourseMetadata::LEVEL, &ParsedCourseMetadata::LEVEL_DECIMALTAG)) {
+				if (course.Metadata.LEVEL_DECIMALTAG == -1)
+					appendProperyLine(out, Key::Course_LEVEL, std::string_view(buffer, sprintf_s(buffer, "%d", course.Metadata.LEVEL)));
+				else
+					appendProperyLine(out, Key::Course_LEVEL, std::string_view(buffer, sprintf_s(buffer, "%.1f", course.Metadata.LEVEL + static_cast<float>(course.Metadata.LEVEL_DECIMALTAG) / 10.)));
+			}
+
+			// Better to be explicit
+			if (course.Metadata.COURSE == DifficultyType::Tower) {
+				appendProperyLine(out, Key::Course_LIFE, std::string_view(buffer, sprintf_s(buffer, "%d", course.Metadata.LIFE)));
+				appendProperyLine(out, Key::Course_SIDE, sideToString(course.Metadata.SIDE));
+			}
+
+			// Better to be explicit
+			if (!course.Metadata.BALLOON.empty() || !course.Metadata.BALLOON_Normal.empty() || !course.Metadata.BALLOON_Expert.empty() || !course.Metadata.BALLOON_Master.empty())
+				appendBalloonProperyLine(out, Key::Course_BALLOON, course.Metadata.BALLOON); // necessary for branched charts as branched BALLOON headers are not handled consistently across all simulators
+			if (!course.Metadata.BALLOON_Normal.empty() || !course.Metadata.BALLOON_Expert.empty() || !course.Metadata.BALLOON_Master.empty())
+			{
+				appendBalloonProperyLine(out, Key::Course_BALLOONNOR, course.Metadata.BALLOON_Normal);
+				appendBalloonProperyLine(out, Key::Course_BALLOONEXP, course.Metadata.BALLOON_Expert);
+				appendBalloonProperyLine(out, Key::Course_BALLOONMAS, course.Metadata.BALLOON_Master);
+			}
+
+			if (shouldEmitCourseMetadata(&ParsedCourseMetadata::SCOREINIT, &ParsedCourseMetadata::SCOREDIFF)) {
+				appendProperyLine(out, Key::Course_SCOREINIT, (course.Metadata.SCOREINIT == 0) ? "" : std::string_view(buffer, sprintf_s(buffer, "%d", course.Metadata.SCOREINIT)));
+				appendProperyLine(out, Key::Course_SCOREDIFF, (course.Metadata.SCOREDIFF == 0) ? "" : std::string_view(buffer, sprintf_s(buffer, "%d", course.Metadata.SCOREDIFF)));
+			}
+
+			if (shouldEmitCourseMetadata(&ParsedCourseMetadata::NOTESDESIGNER))
+				appendSuffixedPropertyLine(out, Key::Course_NOTESDESIGNERs, std::to_string(EnumToIndex(course.Metadata.COURSE)), course.Metadata.NOTESDESIGNER);
+
+			// TODO: Key::Course_EXAM1;
+			// TODO: Key::Course_EXAM2;
+			// TODO: Key::Course_EXAM3;
+			// TODO: Key::Course_GAUGEINCR;
+			// TODO: Key::Course_TOTAL;
+			// TODO: Key::Course_HIDDENBRANCH;
+
+			if (shouldEmitCourseMetadata(&ParsedCourseMetadata::Others)) {
+				for (const auto& [header, val] : course.Metadata.Others)
+					appendSuffixedPropertyLine(out, Key::Course_Unknown, header, val);
+			}
+
+			appendLine(out, "");
+
+			if (course.Metadata.STYLE <= 1)
+				appendCommandLine(out, Key::Chart_START, "");
+			else
+				appendCommandLine(out, Key::Chart_START, "P" + std::to_string(course.Metadata.START_PLAYERSIDE));
+
+			for (const ParsedChartCommand& command : course.ChartCommands)
+			{
+				switch (command.Type)
+				{
+				case ParsedChartCommandType::MeasureNotes:
+				{
+					for (const NoteType note : inContent.GetMeasureNotes(command))
+						out += noteTypeToChar(note);
+
+					if (ArrayItToIndex(&command, &course.ChartCommands[0]) + 1 < course.ChartCommands.size())
+					{
+						if ((&command + 1)->Type != ParsedChartCommandType::MeasureEnd)
+							appendLine(out, "");
+					}
+				} break;
+				case ParsedChartCommandType::MeasureEnd: { appendLine(out, ","); } break;
+				case ParsedChartCommandType::ChangeTimeSignature:
+				{
+					appendCommandLine(out, Key::Chart_MEASURE, std::string_view(buffer, sprintf_s(buffer, "%d/%d", command.Param.ChangeTimeSignature.Value.Numerator, command.Param.ChangeTimeSignature.Value.Denominator)));
+				} break;
+				case ParsedChartCommandType::ChangeTempo:
+				{
+					appendCommandLine(out, Key::Chart_BPMCHANGE, std::string_view(buffer, sprintf_s(buffer, "%g", command.Param.ChangeTempo.Value.BPM)));
+				} break;
+				case ParsedChartCommandType::ChangeDelay:
+				{
+					appendCommandLine(out, Key::Chart_DELAY, std::string_view(buffer, sprintf_s(buffer, "%g", command.Param.ChangeDelay.Value.ToSec())));
+				} break;
+				case ParsedChartCommandType::ChangeScrollSpeed:
+				{
+					appendCommandLine(out, Key::Chart_SCROLL, std::string_view(buffer, sprintf_s(buffer, "%s", command.Param.ChangeScrollSpeed.Value.toStringCompat().c_str())));
+				} break;
+				case ParsedChartCommandType::ChangeBarLine:
+				{
+					appendCommandLine(out, command.Param.ChangeBarLine.Visible ? Key::Chart_BARLINEON : Key::Chart_BARLINEOFF, "");
+				} break;
+				case ParsedChartCommandType::GoGoStart:
+				{
+					appendCommandLine(out, Key::Chart_GOGOSTART, "");
+				} break;
+				case ParsedChartCommandType::GoGoEnd:
+				{
+					appendCommandLine(out, Key::Chart_GOGOEND, "");
+				} break;
+				case ParsedChartCommandType::BranchStart:
+				{
+					appendCommandLine(out, Key::Chart_BRANCHSTART, std::string_view(buffer, sprintf_s(buffer, "%c,%d,%d", BranchConditionToChar(command.Param.BranchStart.Condition), command.Param.BranchStart.RequirementExpert, command.Param.BranchStart.RequirementMaster)));
+				} break;
+				case ParsedChartCommandType::BranchNormal:
+				{
+					appendCommandLine(out, Key::Chart_N, "");
+				} break;
+				case ParsedChartCommandType::BranchExpert:
+				{
+					appendCommandLine(out, Key::Chart_E, "");
+				} break;
+				case ParsedChartCommandType::BranchMaster:
+				{
+					appendCommandLine(out, Key::Chart_M, "");
+				} break;
+				case ParsedChartCommandType::BranchEnd:
+				{
+					appendCommandLine(out, Key::Chart_BRANCHEND, "");
+				} break;
+				case ParsedChartCommandType::BranchLevelHold:
+				{
+					// TODO:
+				} break;
+				case ParsedChartCommandType::ResetAccuracyValues:
+				{
+					// TODO:
+				} break;
+				case ParsedChartCommandType::SetLyricLine:
+				{
+					// TODO: Handle escape characters, most importantly "\n"
+					appendCommandLine(out, Key::Chart_LYRIC, command.Param.SetLyricLine.Value);
+				} break;
+				case ParsedChartCommandType::NMScroll:
+				{
+					appendCommandLine(out, Key::Chart_NMSCROLL, "");
+				} break;
+				case ParsedChartCommandType::BMScroll:
+				{
+					appendCommandLine(out, Key::Chart_BMSCROLL, "");
+				} break;
+				case ParsedChartCommandType::HBScroll:
+				{
+					appendCommandLine(out, Key::Chart_HBSCROLL, "");
+				} break;
+				case ParsedChartCommandType::SENoteChange:
+				{
+					// TODO: DEPRECATED (?)
+				} break;
+				case ParsedChartCommandType::SetNextSong:
+				{
+					// TODO:
+				} break;
+				case ParsedChartCommandType::ChangeDirection:
+				{
+					// TODO: DEPRECATED
+				} break;
+				case ParsedChartCommandType::SetSudden:
+				{
+					appendCommandLine(out, Key::Chart_SUDDEN, std::string_view(buffer, sprintf_s(buffer, "%g %g", command.Param.SetSudden.AppearanceOffset.ToSec(), command.Param.SetSudden.MovementWaitDelay.ToSec())));
+				} break;
+				case ParsedChartCommandType::SetJPOSScroll:
+				{
+					appendCommandLine(out, Key::Chart_JPOSSCROLL, std::string_view(buffer, sprintf_s(buffer, "%g %s 1", command.Param.ChangeJPOSScroll.Duration.ToSec(), command.Param.ChangeJPOSScroll.Move.toStringCompat().c_str())));
+				} break;
+				default: { assert(!"Unhandled ParsedChartCommandType switch case"); } break;
+				}
+			}
+			appendCommandLine(out, Key::Chart_END, "");
+		};
+
+		for (const auto& [itBeg, itEnd] : courseScopes) {
+			for (CourseIter it = itBeg; it != itEnd; ++it)
+				convertCourse(it, itBeg, itEnd);
+		}
+	}
+
+	void TJATestWindow::RunWriterBenchmark()
+	{
+		constexpr i32 iterationCount = 16;
+		TJA::ErrorList parseErrors;
+		const TJA::ParsedTJA parsed = TJA::ParseFileContent(CreateSyntheticBenchmarkTJA(2000), parseErrors);
+
+		auto measure = [&](auto writeFunc, std::string& outText)
+		{
+			WriterBenchmarkData::Result result = {};
+			result.Timing = MeasureBenchmarkIterations(iterationCount, [&](i32) { std::string text; writeFunc(parsed, text, TJA::Encoding::UTF8); });
+			{
+				const ScopedDebugAllocationCounter allocationCounter;
+				{ std::string text; writeFunc(parsed, text, TJA::Encoding::UTF8); }
+				result.AllocationCount = allocationCounter.Get();
+			}
+			writeFunc(parsed, outText, TJA::Encoding::UTF8);
+			return result;
+		};
+
+		auto outputsMatch = [](const TJA::ParsedTJA& tja)
+		{
+			std::string referenceText, writerText;
+			ConvertParsedToTextReference(tja, referenceText, TJA::Encoding::UTF8);
+			TJA::ConvertParsedToText(tja, writerText, TJA::Encoding::UTF8);
+			return (referenceText == writerText);
+		};
+
+		std::string referenceText, writerText;
+		WriterBenchmark.Reference = measure(ConvertParsedToTextReference, referenceText);
+		WriterBenchmark.Writer = measure(TJA::ConvertParsedToText, writerText);
+		WriterBenchmark.OutputMatchesReference = (referenceText == writerText);
+
+		// NOTE: The synthetic chart only contains whole numbers so also check the formatting of arbitrary (including very small, very large and negative) fractions
+		TJA::ParsedTJA fractional = parsed;
+		u32 randomState = 0x2545F491;
+		auto nextRandom = [&]() { randomState ^= (randomState << 13); randomState ^= (randomState >> 17); randomState ^= (randomState << 5); return randomState; };
+		auto nextFraction = [&]() { static constexpr f64 scales[] = { 1e-9, 1e-3, 1.0, 1e3, 1e9, 1e21 }; return (static_cast<f64>(static_cast<i32>(nextRandom())) / 2147483648.0) * scales[nextRandom() % ArrayCount(scales)]; };
+		fractional.Metadata.BPM.BPM = static_cast<f32>(nextFraction());
+		fractional.Metadata.OFFSET = Time::FromSec(nextFraction());
+		fractional.Metadata.SONGVOL = static_cast<f32>(nextFraction());
+		for (TJA::ParsedCourse& course : fractional.Courses)
+		{
+			for (TJA::ParsedChartCommand& command : course.ChartCommands)
+			{
+				switch (command.Type)
+				{
+				case TJA::ParsedChartCommandType::ChangeTempo: { command.Param.ChangeTempo.Value.BPM = static_cast<f32>(nextFraction()); } break;
+				case TJA::ParsedChartCommandType::ChangeDelay: { command.Param.ChangeDelay.Value = Time::FromSec(nextFraction()); } break;
+				case TJA::ParsedChartCommandType::ChangeScrollSpeed: { command.Param.ChangeScrollSpeed.Value = Complex(static_cast<f32>(nextFraction()), (nextRandom() % 2) ? static_cast<f32>(nextFraction()) : 0.0f); } break;
+				default: break;
+				}
+			}
+		}
+		WriterBenchmark.FractionalOutputMatchesReference = outputsMatch(fractional);
+		WriterBenchmark.LoadedFileOutputMatchesReference = outputsMatch(LoadedTJAFile.Parsed);
+
+		WriterBenchmark.ByteSize = writerText.size();
+		WriterBenchmark.HasResults = true;
+	}
+
+	void TJATestWindow::RunFumenBenchmark()
+	{
+		constexpr i32 iterationCount = 8;
+		const std::string fileContentUTF8 = CreateSyntheticBenchmarkTJA(2000);
+
+		ChartProject chart;
+		{
+			TJA::ErrorList parseErrors;
+			CreateChartProjectFromTJA(TJA::ParseFileContent(fileContentUTF8, parseErrors), chart);
+		}
+
+		std::vector<std::vector<u8>> fumenFiles(chart.Courses.size());
+		std::vector<std::string> fumenFilePaths(chart.Courses.size());
+		for (size_t i = 0; i < chart.Courses.size(); i++)
+		{
+			ConvertChartCourseToFumen(chart, *chart.Courses[i], fumenFiles[i]);
+			fumenFilePaths[i] = Directory::GetExecutableDirectory().append("/benchmark_fumen_").append(std::to_string(i)).append(Fumen::Extension);
+			File::WriteAllBytes(fumenFilePaths[i], fumenFiles[i].data(), fumenFiles[i].size());
+		}
+
+		// NOTE: Both sides convert their courses one after another for the sake of comparability
+		FumenBenchmark.TJARead = MeasureBenchmarkIterations(iterationCount, [&](i32)
+		{
+			TJA::ErrorList parseErrors;
+			ChartProject outChart;
+			CreateChartProjectFromTJA(TJA::ParseFileContent(fileContentUTF8, parseErrors), outChart, false);
+		});
+		FumenBenchmark.FumenRead = MeasureBenchmarkIterations(iterationCount, [&](i32)
+		{
+			ChartProject outChart;
+			for (const std::vector<u8>& fumenFile : fumenFiles)
+			{
+				Fumen::ChartView fumen;
+				if (Fumen::Read(fumenFile.data(), fumenFile.size(), fumen))
+					CreateChartProjectFromFumen(fumen, outChart);
+			}
+		});
+		FumenBenchmark.FumenMappedRead = MeasureBenchmarkIterations(iterationCount, [&](i32)
+		{
+			ChartProject outChart;
+			for (const std::string& fumenFilePath : fumenFilePaths)
+			{
+				const File::MemoryMappedFile mappedFile = File::MapReadOnly(fumenFilePath);
+				Fumen::ChartView fumen;
+				if (Fumen::Read(mappedFile.Content, mappedFile.Size, fumen))
+					CreateChartProjectFromFumen(fumen, outChart);
+			}
+		});
+		FumenBenchmark.TJAWrite = MeasureBenchmarkIterations(iterationCount, [&](i32)
+		{
+			TJA::ParsedTJA parsed;
+			std::string text;
+			ConvertChartProjectToTJA(chart, parsed);
+			TJA::ConvertParsedToText(parsed, text, TJA::Encoding::UTF8);
+		});
+		FumenBenchmark.FumenWrite = MeasureBenchmarkIterations(iterationCount, [&](i32)
+		{
+			for (const auto& course : chart.Courses)
+			{
+				std::vector<u8> fumenFile;
+				ConvertChartCourseToFumen(chart, *course, fumenFile);
+			}
+		});
+
+		for (const std::string& fumenFilePath : fumenFilePaths)
+		{
+			std::error_code error;
+			std::filesystem::remove(std::filesystem::u8path(fumenFilePath), error);
+		}
+
+		b8 notesMatch = true, bytesMatch = true, truncatedRejected = true, corruptedRejected = true;
+		FumenBenchmark.FumenByteSize = 0;
+		for (size_t i = 0; i < chart.Courses.size(); i++)
+		{
+			const std::vector<u8>& fumenFile = fumenFiles[i];
+			FumenBenchmark.FumenByteSize += fumenFile.size();
+
+			Fumen::ChartView fumen;
+			ChartProject roundTripChart;
+			if (!Fumen::Read(fumenFile.data(), fumenFile.size(), fumen) || !CreateChartProjectFromFumen(fumen, roundTripChart))
+			{
+				notesMatch = bytesMatch = false;
+				continue;
+			}
+
+			// NOTE: Time signatures and the exact measure layout don't survive the conversion (as the format has no notion of them) but the resulting notes should
+			const ChartCourse& course = *chart.Courses[i];
+			const ChartCourse& roundTripCourse = *roundTripChart.Courses[0];
+			for (BranchType branch = BranchType::Normal; branch < BranchType::Count; IncrementEnum(branch))
+			{
+				const SortedNotesList& notes = course.GetNotes(branch);
+				const SortedNotesList& roundTripNotes = roundTripCourse.GetNotes(branch);
+				notesMatch &= (notes.size() == roundTripNotes.size());
+				for (size_t n = 0; n < Min(notes.size(), roundTripNotes.size()); n++)
+				{
+					notesMatch &= (notes[n].BeatTime == roundTripNotes[n].BeatTime) && (notes[n].BeatDuration == roundTripNotes[n].BeatDuration) &&
+						(notes[n].Type == roundTripNotes[n].Type) && (notes[n].BalloonPopCount == roundTripNotes[n].BalloonPopCount);
+				}
+			}
+
+			std::vector<u8> roundTripFile;
+			ConvertChartCourseToFumen(roundTripChart, roundTripCourse, roundTripFile);
+			bytesMatch &= (roundTripFile == fumenFile);
+
+			const size_t truncationStep = ClampBot<size_t>(fumenFile.size() / 256, 1);
+			for (size_t truncatedSize = 0; truncatedSize < fumenFile.size(); truncatedSize += truncationStep)
+				truncatedRejected &= !Fumen::Read(fumenFile.data(), truncatedSize, fumen);
+			truncatedRejected &= !Fumen::Read(fumenFile.data(), fumenFile.size() - 1, fumen);
+
+			// NOTE: Non-finite values are already rejected by the reader, while finite ones too far away to be represented as a beat only fail the conversion
+			if (fumenFile.size() >= (sizeof(Fumen::FileHeader) + sizeof(Fumen::MeasureRecord)))
+			{
+				const size_t firstMeasureOffset = sizeof(Fumen::FileHeader);
+				static constexpr f32 nonFiniteBPM = std::numeric_limits<f32>::quiet_NaN(), farAwayOffsetMS = 1.0e30f;
+
+				std::vector<u8> corruptedFile = fumenFile;
+				::memcpy(corruptedFile.data() + firstMeasureOffset + offsetof(Fumen::MeasureRecord, BPM), &nonFiniteBPM, sizeof(f32));
+				corruptedRejected &= !Fumen::Read(corruptedFile.data(), corruptedFile.size(), fumen);
+
+				corruptedFile = fumenFile;
+				::memcpy(corruptedFile.data() + firstMeasureOffset + offsetof(Fumen::MeasureRecord, OffsetMS), &farAwayOffsetMS, sizeof(f32));
+				ChartProject corruptedChart;
+				corruptedRejected &= Fumen::Read(corruptedFile.data(), corruptedFile.size(), fumen) && (fumen.Measures.size() < 2 || !CreateChartProjectFromFumen(fumen, corruptedChart));
+			}
+		}
+
+		FumenBenchmark.RoundTripNotesMatch = notesMatch && !chart.Courses.empty();
+		FumenBenchmark.RoundTripBytesMatch = bytesMatch;
+		FumenBenchmark.TruncatedFilesRejected = truncatedRejected;
+		FumenBenchmark.CorruptedFilesRejected = corruptedRejected;
+		FumenBenchmark.TJAByteSize = fileContentUTF8.size();
+		FumenBenchmark.HasResults = true;
+	}
+
+	void TJATestWindow::RunBulkInsertBenchmark()
+	{
+		static constexpr i32 eventCounts[] = { 1000, 2000, 5000, 10000, 20000, 50000, 100000 };
+		static constexpr i32 maxPerItemEventCount = 20000;
+
+		BulkInsertBenchmark = {};
+		BulkInsertBenchmark.AllResultsMatch = true;
+		for (const i32 eventCount : eventCounts)
+		{
+			u32 randomState = 0x9E3779B9;
+			auto nextRandom = [&]() { randomState ^= (randomState << 13); randomState ^= (randomState >> 17); randomState ^= (randomState << 5); return randomState; };
+
+			// NOTE: Only 3/4 as many distinct beats as changes so that plenty of them end up on the same beat, with the tempo identifying which one was inserted last
+			std::vector<TempoChange> tempoChanges; tempoChanges.reserve(eventCount);
+			for (i32 i = 0; i < eventCount; i++)
+				tempoChanges.push_back(TempoChange(Beat::FromTicks(static_cast<i32>(nextRandom() % static_cast<u32>((eventCount * 3) / 4)) * (Beat::TicksPerBeat / 4)), Tempo(static_cast<f32>(i))));
+
+			auto& result = BulkInsertBenchmark.Results.emplace_back();
+			result.EventCount = eventCount;
+			result.HasPerItem = (eventCount <= maxPerItemEventCount);
+
+			SortedTempoChangesList perItemList, bulkList;
+			if (result.HasPerItem)
+			{
+				result.PerItem = MeasureBenchmarkIterations(2, [&](i32)
+				{
+					perItemList = {};
+					for (const TempoChange& tempoChange : tempoChanges)
+						perItemList.InsertOrUpdate(tempoChange);
+				});
+			}
+
+			result.Bulk = MeasureBenchmarkIterations(Clamp(200000 / eventCount, 2, 32), [&](i32)
+			{
+				bulkList = {};
+				bulkList.BulkInsertOrUpdate(tempoChanges);
+			});
+			result.UniqueCount = bulkList.size();
+
+			result.ResultsMatch = ValidateIsSortedByBeat(bulkList);
+			if (result.HasPerItem)
+			{
+				result.ResultsMatch &= (perItemList.size() == bulkList.size());
+				for (size_t i = 0; result.ResultsMatch && i < bulkList.size(); i++)
+					result.ResultsMatch &= (perItemList[i].Beat == bulkList[i].Beat && perItemList[i].Tempo.BPM == bulkList[i].Tempo.BPM);
+			}
+			BulkInsertBenchmark.AllResultsMatch &= result.ResultsMatch;
+		}
+		BulkInsertBenchmark.HasResults = true;
+	}
+
+	void TJATestWindow::RunGamePreviewCullingBenchmark()
+	{
+		static constexpr i32 noteCounts[] = { 3000, 30000 };
+		static constexpr i32 frameCount = 240;
+		static constexpr BranchType branch = BranchType::Normal;
+
+		GamePreviewCullingBenchmark = {};
+		for (const i32 noteCount : noteCounts)
+		{
+			std::unique_ptr<ChartCourse> course = CreateSyntheticBenchmarkCourse(noteCount, noteCount / 20);
+			{
+				u32 randomState = 0x9E3779B9;
+				auto nextRandom = [&]() { randomState ^= (randomState << 13); randomState ^= (randomState >> 17); randomState ^= (randomState << 5); return randomState; };
+
+				// NOTE: Some drumrolls and balloons for the long note paths, plus scroll speed changes every few measures switching between NMSCROLL and HBSCROLL every now and then
+				for (size_t i = 0; i + 1 < course->Notes_Normal.size(); i += 50)
+				{
+					Note& note = course->Notes_Normal[i];
+					note.Type = (nextRandom() % 2 == 0) ? NoteType::Drumroll : NoteType::Balloon;
+					note.BeatDuration = (course->Notes_Normal[i + 1].BeatTime - note.BeatTime);
+					note.BalloonPopCount = 5;
+				}
+
+				static constexpr f32 scrollSpeeds[] = { 0.5f, 1.0f, 1.0f, 1.5f, 2.0f, 4.0f, -1.0f };
+				const Beat lastBeat = course->Notes_Normal.Sorted.back().BeatTime;
+				for (Beat beat = Beat::Zero(); beat < lastBeat; beat += Beat::FromBars(4))
+				{
+					course->ScrollChanges.Sorted.push_back(ScrollChange { beat, Complex(scrollSpeeds[nextRandom() % ArrayCount(scrollSpeeds)], 0.0f) });
+					if (nextRandom() % 8 == 0)
+						course->ScrollTypes.Sorted.push_back(ScrollType { beat, (course->ScrollTypes.empty() || course->ScrollTypes.Sorted.back().Method == ScrollMethod::NMSCROLL) ? ScrollMethod::HBSCROLL : ScrollMethod::NMSCROLL });
+				}
+				course->RecalculateSENotes();
+			}
+
+			auto& result = GamePreviewCullingBenchmark.Results.emplace_back();
+			result.NoteCount = noteCount;
+			result.IndexMatchesFullWalk = true;
+			result.IncrementalMatchesFullBuild = true;
+
+			ChartGamePreview preview = {};
+			preview.Camera.LaneRect = Rect::FromTLSize(vec2(0.0f), vec2(GameLaneStandardWidth, GameLaneSlice.TotalHeight()));
+			const vec2 hitCirclePosLane = vec2(0.0f);
+
+			const Time chartDuration = course->TempoMap.BeatToTime(course->Notes_Normal.Sorted.back().BeatTime);
+			auto getCursor = [&](i32 frame) -> std::pair<Time, f64>
+			{
+				const Time cursorTime = chartDuration * ((static_cast<f64>(frame) + 0.5) / frameCount);
+				return { cursorTime, course->TempoMap.BeatAndTimeToHBScrollBeatTick(course->TempoMap.TimeToBeat(cursorTime, true), cursorTime) };
+			};
+
+			result.FullIndexBuild = MeasureBenchmarkIterations(8, [&](i32)
+			{
+				preview.VisibilityIndices.clear();
+				preview.UpdateVisibilityIndex(*course, branch, hitCirclePosLane);
+			});
+
+			size_t fullWalkNoteCount = 0, indexedNoteCount = 0;
+			result.FullWalk = MeasureBenchmarkIterations(frameCount, [&](i32 frame)
+			{
+				const auto[cursorTime, cursorHBScrollBeatTick] = getCursor(frame);
+				preview.ReverseNoteDrawBuffer.clear();
+				preview.CollectNotesToDraw(*course, branch, nullptr, hitCirclePosLane, cursorTime, cursorHBScrollBeatTick);
+				fullWalkNoteCount += preview.ReverseNoteDrawBuffer.size();
+			});
+			result.Indexed = MeasureBenchmarkIterations(frameCount, [&](i32 frame)
+			{
+				const auto[cursorTime, cursorHBScrollBeatTick] = getCursor(frame);
+				preview.ReverseNoteDrawBuffer.clear();
+				preview.CollectNotesToDraw(*course, branch, &preview.UpdateVisibilityIndex(*course, branch, hitCirclePosLane), hitCirclePosLane, cursorTime, cursorHBScrollBeatTick);
+				indexedNoteCount += preview.ReverseNoteDrawBuffer.size();
+			});
+			result.AverageFullWalkNoteCount = static_cast<f64>(fullWalkNoteCount) / frameCount;
+			result.AverageIndexedNoteCount = static_cast<f64>(indexedNoteCount) / frameCount;
+
+			// NOTE: The full walk also collects (and leaves to clipping) notes that haven't been hit yet but are far off screen, so only those actually on the lane have to be found by the index
+			std::vector<const Note*> indexedNotes;
+			for (i32 frame = 0; frame < frameCount; frame++)
+			{
+				const auto[cursorTime, cursorHBScrollBeatTick] = getCursor(frame);
+				preview.ReverseNoteDrawBuffer.clear();
+				preview.CollectNotesToDraw(*course, branch, &preview.UpdateVisibilityIndex(*course, branch, hitCirclePosLane), hitCirclePosLane, cursorTime, cursorHBScrollBeatTick);
+				indexedNotes.clear();
+				for (const auto& it : preview.ReverseNoteDrawBuffer)
+					indexedNotes.push_back(it.OriginalNote);
+
+				preview.ReverseNoteDrawBuffer.clear();
+				preview.CollectNotesToDraw(*course, branch, nullptr, hitCirclePosLane, cursorTime, cursorHBScrollBeatTick);
+				for (const auto& it : preview.ReverseNoteDrawBuffer)
+				{
+					const b8 isOnScreen = (it.NoteStartTime <= cursorTime) || preview.Camera.IsRangeVisibleOnLane(Min(it.LaneHeadX, it.LaneTailX), Max(it.LaneHeadX, it.LaneTailX));
+					if (isOnScreen && std::find(indexedNotes.begin(), indexedNotes.end(), it.OriginalNote) == indexedNotes.end())
+						result.IndexMatchesFullWalk = false;
+				}
+			}
+
+			// NOTE: Simulate dragging the speed of a scroll change in the last quarter of the chart, one edit per frame
+			ScrollChange& draggedScrollChange = course->ScrollChanges[(course->ScrollChanges.size() * 3) / 4];
+			result.IncrementalIndexUpdate = MeasureBenchmarkIterations(64, [&](i32 i)
+			{
+				draggedScrollChange.ScrollSpeed = Complex(1.0f + static_cast<f32>(i % 8) * 0.25f, 0.0f);
+				course->NoteLaneFirstChangedBeat[EnumToIndex(branch)] = draggedScrollChange.BeatTime;
+				preview.UpdateVisibilityIndex(*course, branch, hitCirclePosLane);
+			});
+
+			ChartGamePreview fullBuildPreview = {};
+			fullBuildPreview.Camera = preview.Camera;
+			std::vector<i32> fullBuildNoteIndices;
+			for (i32 frame = 0; frame < frameCount; frame++)
+			{
+				const auto[cursorTime, cursorHBScrollBeatTick] = getCursor(frame);
+				preview.UpdateVisibilityIndex(*course, branch, hitCirclePosLane).Query(cursorTime, cursorHBScrollBeatTick, preview.VisibleNoteIndicesBuffer);
+				fullBuildPreview.UpdateVisibilityIndex(*course, branch, hitCirclePosLane).Query(cursorTime, cursorHBScrollBeatTick, fullBuildNoteIndices);
+				if (preview.VisibleNoteIndicesBuffer != fullBuildNoteIndices)
+					result.IncrementalMatchesFullBuild = false;
+			}
+		}
+		GamePreviewCullingBenchmark.HasResults = true;
+	}
+
+	void TJATestWindow::RunTimelineCullingBenchmark()
+	{
+		static constexpr f64 visibleDurationsSec[] = { 2.0, 10.0, 60.0 };
+		static constexpr i32 frameCount = 240;
+
+		std::unique_ptr<ChartCourse> course = CreateSyntheticBenchmarkCourse(50000, 2500);
+		{
+			u32 randomState = 0x9E3779B9;
+			auto nextRandom = [&]() { randomState ^= (randomState << 13); randomState ^= (randomState >> 17); randomState ^= (randomState << 5); return randomState; };
+
+			// NOTE: Some drumrolls for the look-back and judgement offsets in both directions for the time slop
+			for (size_t i = 0; i + 1 < course->Notes_Normal.size(); i += 40)
+			{
+				Note& note = course->Notes_Normal[i];
+				note.Type = NoteType::Drumroll;
+				note.BeatDuration = (course->Notes_Normal[i + 1].BeatTime - note.BeatTime);
+			}
+			for (size_t i = 7; i < course->Notes_Normal.size(); i += 64)
+				course->Notes_Normal[i].TimeOffset = Time::FromMS(static_cast<f64>(nextRandom() % 400) - 200.0);
+			course->RecalculateSENotes();
+		}
+
+		const BeatSortedList<Note>& notes = course->Notes_Normal;
+		const Time chartDuration = course->TempoMap.BeatToTime(notes.Sorted.back().GetEnd());
+
+		// NOTE: Same per note checks as the timeline note rows, minus the drawing itself
+		auto collectVisibleNotes = [&](size_t firstIndex, size_t lastIndex, Time minTime, Time maxTime, std::vector<size_t>& outIndices)
+		{
+			for (size_t i = firstIndex; i < lastIndex; i++)
+			{
+				const Note& it = notes[i];
+				const Time startTime = course->TempoMap.BeatToTime(it.GetStart()) + it.TimeOffset;
+				const Time endTime = (it.BeatDuration > Beat::Zero()) ? course->TempoMap.BeatToTime(it.GetEnd()) + it.TimeOffset : startTime;
+				if (endTime < minTime || startTime > maxTime)
+					continue;
+				outIndices.push_back(i);
+			}
+		};
+
+		TimelineCullingBenchmark = {};
+		std::vector<size_t> fullWalkIndices, culledIndices;
+		for (const f64 visibleDurationSec : visibleDurationsSec)
+		{
+			auto& result = TimelineCullingBenchmark.Results.emplace_back();
+			result.VisibleDurationSec = visibleDurationSec;
+			result.CulledMatchesFullWalk = true;
+
+			const Time visibleDuration = Time::FromSec(visibleDurationSec);
+			auto getVisibleTime = [&](i32 frame) -> std::pair<Time, Time>
+			{
+				const Time minTime = (chartDuration - visibleDuration) * ((static_cast<f64>(frame) + 0.5) / frameCount);
+				return { minTime, minTime + visibleDuration };
+			};
+
+			size_t visibleNoteCount = 0;
+			result.FullWalk = MeasureBenchmarkIterations(frameCount, [&](i32 frame)
+			{
+				const auto[minTime, maxTime] = getVisibleTime(frame);
+				fullWalkIndices.clear();
+				collectVisibleNotes(0, notes.size(), minTime, maxTime, fullWalkIndices);
+				visibleNoteCount += fullWalkIndices.size();
+			});
+			result.Culled = MeasureBenchmarkIterations(frameCount, [&](i32 frame)
+			{
+				const auto[minTime, maxTime] = getVisibleTime(frame);
+				const auto[firstIndex, lastIndex] = GetTimelineItemIndexRangeWithinTime(*course, notes, minTime, maxTime);
+				culledIndices.clear();
+				collectVisibleNotes(firstIndex, lastIndex, minTime, maxTime, culledIndices);
+			});
+			result.AverageVisibleNoteCount = static_cast<f64>(visibleNoteCount) / frameCount;
+
+			for (i32 frame = 0; frame < frameCount; frame++)
+			{
+				const auto[minTime, maxTime] = getVisibleTime(frame);
+				const auto[firstIndex, lastIndex] = GetTimelineItemIndexRangeWithinTime(*course, notes, minTime, maxTime);
+				fullWalkIndices.clear();
+				culledIndices.clear();
+				collectVisibleNotes(0, notes.size(), minTime, maxTime, fullWalkIndices);
+				collectVisibleNotes(firstIndex, lastIndex, minTime, maxTime, culledIndices);
+				if (fullWalkIndices != culledIndices)
+					result.CulledMatchesFullWalk = false;
+			}
+		}
+		TimelineCullingBenchmark.HasResults = true;
+	}
+
+	void TJATestWindow::RunTokenizerBenchmark()
+	{
+		auto& benchmark = TokenizerBenchmark;
+		const std::string corpusDirectory = benchmark.CorpusDirectory;
+		benchmark = {};
+		benchmark.CorpusDirectory = corpusDirectory;
+
+		std::error_code error;
+		auto directoryIt = std::filesystem::recursive_directory_iterator(std::filesystem::u8path(corpusDirectory), error);
+		if (error)
+		{
+			benchmark.ErrorMessage = "Failed to open corpus directory";
+			return;
+		}
+
+		for (const auto& entry : directoryIt)
+		{
+			if (!entry.is_regular_file())
+				continue;
+
+			const std::string filePath = entry.path().u8string();
+			if (!ASCII::EndsWithInsensitive(filePath, ".tja"))
+				continue;
+
+			auto[fileContent, fileSize] = File::ReadAllBytes(filePath);
+			if (fileContent == nullptr)
+				continue;
+
+			const std::string_view fileContentView = std::string_view(reinterpret_cast<const char*>(fileContent.get()), fileSize);
+			const std::string fileContentUTF8 = UTF8::HasBOM(fileContentView) ? std::string(UTF8::TrimBOM(fileContentView)) : UTF8::FromShiftJIS(fileContentView);
+
+			CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+			const std::vector<std::string_view> lines = TJA::SplitLines(fileContentUTF8);
+			const Time splitLinesDuration = stopwatch.Restart();
+			const std::vector<TJA::Token> tokens = TJA::TokenizeLines(lines);
+			const Time tokenizeDuration = stopwatch.Stop();
+
+			benchmark.FileCount++;
+			benchmark.ByteSize += fileContentUTF8.size();
+			benchmark.LineCount += lines.size();
+			benchmark.TokenCount += tokens.size();
+			benchmark.SplitLinesDuration += splitLinesDuration;
+			benchmark.TokenizeDuration += tokenizeDuration;
+		}
+
+		if (benchmark.FileCount > 0)
+			benchmark.HasResults = true;
+		else
+			benchmark.ErrorMessage = "No .tja files found";
+	}
 }
@@ -57,11 +57,131 @@ namespace PeepoDrumKit
 		}
 	};
 
+	struct BenchmarkTiming
+	{
+		i32 Iterations;
+		Time Average, Min, Max;
+	};
+
 	struct TJATestWindow
 	{
 		std::future<ParsedAndConvertedTJAFile> LoadTJAFuture = {};
 		ParsedAndConvertedTJAFile LoadedTJAFile;
 
+		struct TempoEditBenchmarkData
+		{
+			b8 HasResults;
+			b8 IncrementalMatchesFull;
+			BenchmarkTiming FullRebuild;
+			BenchmarkTiming IncrementalRebuild;
+		} TempoEditBenchmark = {};
+
+		// NOTE: Splits and tokenizes every .tja file found (recursively) inside a corpus directory, excluding reading and converting the files to UTF-8
+		struct TokenizerBenchmarkData
+		{
+			std::string CorpusDirectory;
+			std::string ErrorMessage;
+			i32 FileCount;
+			size_t ByteSize, LineCount, TokenCount;
+			Time SplitLinesDuration, TokenizeDuration;
+			b8 HasResults;
+		} TokenizerBenchmark = {};
+
+		// NOTE: Imports a large synthetic multi-course chart with branches from its file content up to an editable chart (the same steps as opening a file),
+		//		 once converting its courses one after another and once in parallel, verifying that both result in the same chart
+		struct ImportBenchmarkData
+		{
+			b8 HasResults;
+			b8 ParallelMatchesSerial;
+			i32 CourseCount;
+			size_t ByteSize;
+			BenchmarkTiming Serial;
+			BenchmarkTiming Parallel;
+		} ImportBenchmark = {};
+
+		// NOTE: Parses the same synthetic chart once through intermediate Lines and Tokens vectors and once streaming straight from its file content,
+		//		 counting the heap allocations of a single parse (only available in debug builds)
+		struct ParseBenchmarkData
+		{
+			struct Result { BenchmarkTiming Timing; i64 AllocationCount; };
+			b8 HasResults;
+			b8 StreamingMatchesVectors;
+			Result Vectors, Streaming;
+		} ParseBenchmark = {};
+
+		// NOTE: Converts a large synthetic Shift-JIS chart and every mapped character of the code page from Shift-JIS to UTF-8 and back,
+		//		 once through the lookup tables and once via UTF-16 through the Win32 code page functions, verifying that both produce the same output
+		struct ShiftJISBenchmarkData
+		{
+			b8 HasResults;
+			b8 DecodeMatchesWin32;
+			b8 EncodeMatchesWin32;
+			size_t ByteSize;
+			BenchmarkTiming TableDecode, Win32Decode;
+			BenchmarkTiming TableEncode, Win32Encode;
+		} ShiftJISBenchmark = {};
+
+		// NOTE: Writes the parsed synthetic chart (plus a copy with its tempo, scroll and delay values scrambled into arbitrary fractions) back to text,
+		//		 once through the original sprintf_s() based reference writer and once through the current one, verifying that both outputs are byte-for-byte identical
+		struct WriterBenchmarkData
+		{
+			struct Result { BenchmarkTiming Timing; i64 AllocationCount; };
+			b8 HasResults;
+			b8 OutputMatchesReference;
+			b8 FractionalOutputMatchesReference;
+			b8 LoadedFileOutputMatchesReference;
+			size_t ByteSize;
+			Result Reference, Writer;
+		} WriterBenchmark = {};
+
+		// NOTE: Converts every course of the synthetic chart to a binary fumen file and back, timing both directions against the equivalent TJA text path,
+		//		 verifying that all notes survive the round trip unchanged, that converting them again reproduces the same bytes and that truncated files are rejected
+		struct FumenBenchmarkData
+		{
+			b8 HasResults;
+			b8 RoundTripNotesMatch;
+			b8 RoundTripBytesMatch;
+			b8 TruncatedFilesRejected;
+			b8 CorruptedFilesRejected;
+			size_t TJAByteSize, FumenByteSize;
+			BenchmarkTiming TJARead, FumenRead, FumenMappedRead;
+			BenchmarkTiming TJAWrite, FumenWrite;
+		} FumenBenchmark = {};
+
+		// NOTE: Inserts the same shuffled tempo changes (with duplicate beats, of which the last one has to win) into an empty list one at a time and all at once,
+		//		 for 1k up to 100k changes. The one at a time path is quadratic and therefore skipped for the largest counts
+		struct BulkInsertBenchmarkData
+		{
+			struct Result { i32 EventCount; b8 HasPerItem; b8 ResultsMatch; size_t UniqueCount; BenchmarkTiming PerItem, Bulk; };
+			b8 HasResults;
+			b8 AllResultsMatch;
+			std::vector<Result> Results;
+		} BulkInsertBenchmark = {};
+
+		// NOTE: Collects the notes to draw on the game preview lane of synthetic 3k and 30k note charts (with mixed scroll methods and speeds) at evenly spaced cursor positions,
+		//		 once by walking through every note and once from the candidates of the visibility index, which have to include every note the full walk found on screen
+		struct GamePreviewCullingBenchmarkData
+		{
+			struct Result
+			{
+				i32 NoteCount;
+				b8 IndexMatchesFullWalk, IncrementalMatchesFullBuild;
+				f64 AverageFullWalkNoteCount, AverageIndexedNoteCount;
+				BenchmarkTiming FullWalk, Indexed, FullIndexBuild, IncrementalIndexUpdate;
+			};
+			b8 HasResults;
+			std::vector<Result> Results;
+		} GamePreviewCullingBenchmark = {};
+
+		// NOTE: Collects the notes of a synthetic 50k note chart (with drumrolls and judgement offsets) within evenly spaced visible time ranges the way the timeline note rows do,
+		//		 once by converting the beat of every single note to time and once only for those within the binary searched index range, which have to yield the same notes
+		struct TimelineCullingBenchmarkData
+		{
+			struct Result { f64 VisibleDurationSec; b8 CulledMatchesFullWalk; f64 AverageVisibleNoteCount; BenchmarkTiming FullWalk, Culled; };
+			b8 HasResults;
+			std::vector<Result> Results;
+		} TimelineCullingBenchmark = {};
+
 		::TextEditor TJATextEditor = CreateImGuiColorTextEditWithNiceTheme();
 		
 		b8 IsFirstFrame = true;
@@ -75,5 +195,17 @@ namespace PeepoDrumKit
 		void DrawGuiFileContentTabContent();
 		void DrawGuiTokensTabContent();
 		void DrawGuiParsedTabContent();
+		void DrawGuiBenchmarkTabContent();
+
+		void RunTempoEditBenchmark();
+		void RunTokenizerBenchmark();
+		void RunImportBenchmark();
+		void RunParseBenchmark();
+		void RunShiftJISBenchmark();
+		void RunWriterBenchmark();
+		void RunFumenBenchmark();
+		void RunBulkInsertBenchmark();
+		void RunGamePreviewCullingBenchmark();
+		void RunTimelineCullingBenchmark();
 	};
 }
@@ -0,0 +1,129 @@
+#include "batch_tja.h"
+#include "core_io.h"
+#include <stdio.h>
+
+namespace PeepoDrumKit::Batch
+{
+	static constexpr cstr UsageText =
+		"Usage: PeepoDrumKitBatch <validate|convert> <input-directory> [options]\n"
+		"\n"
+		"  validate                Import, export, re-import and compare every .tja file\n"
+		"  convert                 Same as validate but also write the exported .tja files to the output directory\n"
+		"\n"
+		"  --output <directory>    Output directory for converted files (required for convert)\n"
+		"  --threads <count>       Number of worker threads (default: one per hardware thread)\n"
+		"  --quiet                 Only print files that failed or have parse errors\n";
+
+	static b8 ParseArguments(const std::vector<std::string_view>& args, BatchOptions& out)
+	{
+		if (args.size() < 3)
+			return false;
+
+		if (ASCII::MatchesInsensitive(args[1], "validate"))
+			out.Mode = BatchMode::Validate;
+		else if (ASCII::MatchesInsensitive(args[1], "convert"))
+			out.Mode = BatchMode::Convert;
+		else
+			return false;
+
+		out.InputDirectory = args[2];
+		for (size_t i = 3; i < args.size(); i++)
+		{
+			const b8 hasValue = (i + 1 < args.size());
+			if (args[i] == "--output" && hasValue)
+				out.OutputDirectory = args[++i];
+			else if (args[i] == "--threads" && hasValue)
+			{
+				if (!ASCII::TryParse(args[++i], out.ThreadCount) || out.ThreadCount < 0)
+					return false;
+			}
+			else if (args[i] == "--quiet")
+				out.Quiet = true;
+			else
+				return false;
+		}
+
+		return (out.Mode != BatchMode::Convert) || !out.OutputDirectory.empty();
+	}
+
+	static void PrintFileResult(const FileResult& result)
+	{
+		cstr status = result.ReadFailed ? "READ FAILED" : result.ImportFailed ? "IMPORT FAILED" : result.WriteFailed ? "WRITE FAILED" : !result.RoundTripMismatches.empty() ? "MISMATCH" : "OK";
+		printf("[%s] %.*s (%.1f KB, worker %d)\n", status, FmtStrViewArgs(result.FilePath), static_cast<f64>(result.FileSize) / 1024.0, result.WorkerIndex);
+		printf("    %.3f ms total | read %.3f, import %.3f, export %.3f, re-import %.3f, compare %.3f\n",
+			result.TotalDuration.ToMS(), result.ReadDuration.ToMS(), result.ImportDuration.ToMS(), result.ExportDuration.ToMS(), result.ReimportDuration.ToMS(), result.CompareDuration.ToMS());
+
+		for (const std::string& error : result.ParseErrors)
+			printf("    Parse Error: %.*s\n", FmtStrViewArgs(error));
+		for (const std::string& mismatch : result.RoundTripMismatches)
+			printf("    Round Trip: %.*s\n", FmtStrViewArgs(mismatch));
+	}
+
+	static void PrintSummary(const BatchSummary& summary)
+	{
+		const f64 wallSec = summary.WallDuration.ToSec();
+		const f64 totalMB = static_cast<f64>(summary.TotalByteSize) / (1024.0 * 1024.0);
+
+		printf("\n");
+		printf("Files:             %zu (%zu failed, %zu with parse errors)\n", summary.FileCount, summary.FailedFileCount, summary.FilesWithParseErrorsCount);
+		printf("Workers:           %d (%zu files stolen)\n", summary.WorkerCount, summary.StolenFileCount);
+		printf("Wall Time:         %.3f ms\n", summary.WallDuration.ToMS());
+		printf("Throughput:        %.1f files/sec, %.2f MB/sec\n", (wallSec > 0.0) ? (summary.FileCount / wallSec) : 0.0, (wallSec > 0.0) ? (totalMB / wallSec) : 0.0);
+		printf("Summed Stage Time: import %.3f ms, export %.3f ms, re-import %.3f ms, compare %.3f ms\n",
+			summary.ImportDuration.ToMS(), summary.ExportDuration.ToMS(), summary.ReimportDuration.ToMS(), summary.CompareDuration.ToMS());
+	}
+
+	static int EntryPoint(const std::vector<std::string_view>& args)
+	{
+		BatchOptions options {};
+		if (!ParseArguments(args, options))
+		{
+			fputs(UsageText, stderr);
+			return 2;
+		}
+
+		std::string errorMessage;
+		std::vector<std::string> skippedErrors;
+		const std::vector<std::string> filePaths = FindTJAFilesRecursive(options.InputDirectory, errorMessage, skippedErrors);
+		if (!errorMessage.empty())
+		{
+			fprintf(stderr, "%s '%s'\n", errorMessage.c_str(), options.InputDirectory.c_str());
+			return 2;
+		}
+
+		for (const std::string& skippedError : skippedErrors)
+			fprintf(stderr, "Skipped %s\n", skippedError.c_str());
+
+		BatchSummary summary {};
+		const std::vector<FileResult> results = ProcessFilesParallel(filePaths, options, summary);
+
+		for (const FileResult& result : results)
+		{
+			if (!options.Quiet || result.HasFailed() || !result.ParseErrors.empty())
+				PrintFileResult(result);
+		}
+		PrintSummary(summary);
+
+		return (summary.FailedFileCount > 0) ? 1 : 0;
+	}
+}
+
+#if PEEPO_WIN32
+#include <Windows.h>
+#include <fcntl.h>
+#include <io.h>
+int main(int, const char**)
+{
+	::SetConsoleOutputCP(CP_UTF8);
+	::_setmode(::_fileno(stdout), _O_BINARY);
+
+	// NOTE: The narrow argv is in the current code page instead of UTF-8
+	const CommandLine::CommandLineArrayView commandLine = CommandLine::GetCommandLineUTF8();
+	return PeepoDrumKit::Batch::EntryPoint(std::vector<std::string_view>(commandLine.Arguments, commandLine.Arguments + commandLine.Count));
+}
+#else
+int main(int argc, const char** argv)
+{
+	return PeepoDrumKit::Batch::EntryPoint(std::vector<std::string_view>(argv, argv + argc));
+}
+#endif
@@ -0,0 +1,218 @@
+#include "batch_tja.h"
+#include "core_io.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+namespace PeepoDrumKit::Batch
+{
+	std::vector<std::string> FindTJAFilesRecursive(std::string_view directoryPath, std::string& outErrorMessage, std::vector<std::string>& outSkippedErrors)
+	{
+		std::vector<std::string> filePaths;
+
+		std::error_code error;
+		auto directoryIt = std::filesystem::recursive_directory_iterator(std::filesystem::u8path(directoryPath), std::filesystem::directory_options::skip_permission_denied, error);
+		if (error)
+		{
+			outErrorMessage = "Failed to open input directory";
+			return filePaths;
+		}
+
+		// NOTE: Stepped manually instead of using a range-for, as the implicit operator++ would throw on the first unreadable entry.
+		//		 Directories without read permission are skipped silently, any other error is reported and only skips the entry it occurred on
+		//		 (though a failed increment may also end the iteration early, depending on the standard library implementation)
+		const std::filesystem::recursive_directory_iterator end {};
+		while (directoryIt != end)
+		{
+			const std::filesystem::path entryPath = directoryIt->path();
+			const b8 isRegularFile = directoryIt->is_regular_file(error);
+			if (error)
+			{
+				outSkippedErrors.push_back("'" + entryPath.u8string() + "': " + error.message());
+				error.clear();
+			}
+			else if (isRegularFile)
+			{
+				std::string filePath = entryPath.u8string();
+				if (ASCII::EndsWithInsensitive(filePath, TJA::Extension))
+					filePaths.push_back(std::move(filePath));
+			}
+
+			directoryIt.increment(error);
+			if (error)
+			{
+				outSkippedErrors.push_back("'" + entryPath.u8string() + "': " + error.message());
+				error.clear();
+			}
+		}
+
+		std::sort(filePaths.begin(), filePaths.end());
+		return filePaths;
+	}
+
+	static b8 WriteConvertedFile(std::string_view filePath, const BatchOptions& options, std::string_view tjaText)
+	{
+		std::error_code error;
+		const std::filesystem::path relativePath = std::filesystem::relative(std::filesystem::u8path(filePath), std::filesystem::u8path(options.InputDirectory), error);
+		if (error || relativePath.empty())
+			return false;
+
+		const std::filesystem::path outputPath = std::filesystem::u8path(options.OutputDirectory) / relativePath;
+		std::filesystem::create_directories(outputPath.parent_path(), error);
+		if (error)
+			return false;
+
+		return File::WriteAllBytes(outputPath.u8string(), tjaText);
+	}
+
+	FileResult ProcessFile(std::string_view filePath, const BatchOptions& options)
+	{
+		FileResult result {};
+		result.FilePath = filePath;
+		CPUStopwatch totalStopwatch = CPUStopwatch::StartNew();
+		CPUStopwatch stopwatch = CPUStopwatch::StartNew();
+
+		auto[fileContent, fileSize] = File::ReadAllBytes(filePath);
+		result.ReadDuration = stopwatch.Restart();
+		result.FileSize = fileSize;
+		if (fileContent == nullptr)
+		{
+			result.ReadFailed = true;
+			result.TotalDuration = totalStopwatch.Stop();
+			return result;
+		}
+
+		const std::string_view fileContentView = std::string_view(reinterpret_cast<const char*>(fileContent.get()), fileSize);
+		const std::string fileContentUTF8 = UTF8::HasBOM(fileContentView) ? std::string(UTF8::TrimBOM(fileContentView)) : UTF8::FromShiftJIS(fileContentView);
+
+		TJA::ErrorList parseErrors;
+		const TJA::ParsedTJA parsed = TJA::ParseFileContent(fileContentUTF8, parseErrors);
+		ChartProject chart;
+		const b8 importSucceeded = CreateChartProjectFromTJA(parsed, chart);
+		result.ImportDuration = stopwatch.Restart();
+
+		char lineBuffer[32];
+		for (const auto& error : parseErrors.Errors)
+			result.ParseErrors.push_back(std::string(lineBuffer, snprintf(lineBuffer, sizeof(lineBuffer), "Line %d: ", error.LineIndex + 1)).append(error.Description));
+
+		if (!importSucceeded)
+		{
+			result.ImportFailed = true;
+			result.TotalDuration = totalStopwatch.Stop();
+			return result;
+		}
+
+		TJA::ParsedTJA exported;
+		ConvertChartProjectToTJA(chart, exported);
+		std::string exportedText;
+		TJA::ConvertParsedToText(exported, exportedText, TJA::Encoding::UTF8);
+		result.ExportDuration = stopwatch.Restart();
+
+		// NOTE: Any errors in a file that was just written by the exporter itself count as round trip mismatches too
+		TJA::ErrorList reimportErrors;
+		const TJA::ParsedTJA reparsed = TJA::ParseFileContent(UTF8::TrimBOM(exportedText), reimportErrors);
+		ChartProject reimportedChart;
+		const b8 reimportSucceeded = CreateChartProjectFromTJA(reparsed, reimportedChart);
+		result.ReimportDuration = stopwatch.Restart();
+
+		for (const auto& error : reimportErrors.Errors)
+			result.RoundTripMismatches.push_back(std::string(lineBuffer, snprintf(lineBuffer, sizeof(lineBuffer), "Exported Line %d: ", error.LineIndex + 1)).append(error.Description));
+
+		if (reimportSucceeded)
+			DebugCompareCharts(chart, reimportedChart, [](std::string_view message, void* userData) { static_cast<std::vector<std::string>*>(userData)->emplace_back(message); }, &result.RoundTripMismatches);
+		else
+			result.RoundTripMismatches.push_back("Failed to re-import exported chart");
+		result.CompareDuration = stopwatch.Stop();
+
+		if (options.Mode == BatchMode::Convert)
+			result.WriteFailed = !WriteConvertedFile(filePath, options, exportedText);
+
+		result.TotalDuration = totalStopwatch.Stop();
+		return result;
+	}
+
+	struct WorkerQueue
+	{
+		std::mutex Mutex;
+		std::deque<size_t> FileIndices;
+	};
+
+	std::vector<FileResult> ProcessFilesParallel(const std::vector<std::string>& filePaths, const BatchOptions& options, BatchSummary& outSummary)
+	{
+		CPUStopwatch wallStopwatch = CPUStopwatch::StartNew();
+		std::vector<FileResult> results(filePaths.size());
+
+		const i32 hardwareThreadCount = static_cast<i32>(std::thread::hardware_concurrency());
+		const i32 workerCount = Clamp((options.ThreadCount > 0) ? options.ThreadCount : ClampBot(hardwareThreadCount, 1), 1, ClampBot(static_cast<i32>(filePaths.size()), 1));
+
+		// NOTE: File size is only a rough estimate for how long a file takes to process, stealing takes care of the rest
+		std::vector<std::pair<size_t, size_t>> sizeSortedIndices; sizeSortedIndices.reserve(filePaths.size());
+		for (size_t i = 0; i < filePaths.size(); i++)
+		{
+			std::error_code error;
+			const auto fileSize = std::filesystem::file_size(std::filesystem::u8path(filePaths[i]), error);
+			sizeSortedIndices.push_back({ error ? 0 : static_cast<size_t>(fileSize), i });
+		}
+		std::stable_sort(sizeSortedIndices.begin(), sizeSortedIndices.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+		std::vector<WorkerQueue> queues(workerCount);
+		for (size_t i = 0; i < sizeSortedIndices.size(); i++)
+			queues[i % workerCount].FileIndices.push_back(sizeSortedIndices[i].second);
+
+		std::atomic<size_t> stolenFileCount = 0;
+		auto workerFunc = [&](i32 workerIndex)
+		{
+			while (true)
+			{
+				size_t fileIndex = filePaths.size();
+				{
+					WorkerQueue& ownQueue = queues[workerIndex];
+					std::scoped_lock lock(ownQueue.Mutex);
+					if (!ownQueue.FileIndices.empty()) { fileIndex = ownQueue.FileIndices.front(); ownQueue.FileIndices.pop_front(); }
+				}
+
+				// NOTE: Stealing from the back (the smallest remaining files) of the other queues, starting with the next worker over to spread out contention
+				for (i32 i = 1; i < workerCount && fileIndex == filePaths.size(); i++)
+				{
+					WorkerQueue& otherQueue = queues[(workerIndex + i) % workerCount];
+					std::scoped_lock lock(otherQueue.Mutex);
+					if (!otherQueue.FileIndices.empty()) { fileIndex = otherQueue.FileIndices.back(); otherQueue.FileIndices.pop_back(); stolenFileCount++; }
+				}
+
+				// NOTE: No new work is ever added so all queues being empty means the batch is done
+				if (fileIndex == filePaths.size())
+					return;
+
+				results[fileIndex] = ProcessFile(filePaths[fileIndex], options);
+				results[fileIndex].WorkerIndex = workerIndex;
+			}
+		};
+
+		std::vector<std::thread> workerThreads; workerThreads.reserve(workerCount - 1);
+		for (i32 i = 1; i < workerCount; i++)
+			workerThreads.emplace_back(workerFunc, i);
+		workerFunc(0);
+		for (auto& thread : workerThreads)
+			thread.join();
+
+		outSummary = {};
+		outSummary.WorkerCount = workerCount;
+		outSummary.FileCount = results.size();
+		outSummary.StolenFileCount = stolenFileCount.load();
+		for (const FileResult& result : results)
+		{
+			outSummary.FailedFileCount += result.HasFailed() ? 1 : 0;
+			outSummary.FilesWithParseErrorsCount += result.ParseErrors.empty() ? 0 : 1;
+			outSummary.TotalByteSize += result.FileSize;
+			outSummary.ImportDuration += result.ImportDuration;
+			outSummary.ExportDuration += result.ExportDuration;
+			outSummary.ReimportDuration += result.ReimportDuration;
+			outSummary.CompareDuration += result.CompareDuration;
+		}
+		outSummary.WallDuration = wallStopwatch.Stop();
+		return results;
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "core_types.h"
+#include "core_string.h"
+#include "peepo_drum_kit/chart.h"
+#include <vector>
+
+namespace PeepoDrumKit::Batch
+{
+	enum class BatchMode : u8
+	{
+		// NOTE: Import, export, re-import and compare each file without writing anything
+		Validate,
+		// NOTE: Same as validate but also writing the exported (UTF-8) .tja of each file to the output directory, mirroring the input directory structure
+		Convert,
+		Count
+	};
+
+	struct BatchOptions
+	{
+		BatchMode Mode = BatchMode::Validate;
+		std::string InputDirectory;
+		std::string OutputDirectory;
+		// NOTE: Zero meaning one worker per hardware thread
+		i32 ThreadCount = 0;
+		// NOTE: Only print the files that failed or have parse errors instead of every single one
+		b8 Quiet = false;
+	};
+
+	struct FileResult
+	{
+		std::string FilePath;
+		size_t FileSize;
+		b8 ReadFailed;
+		b8 ImportFailed;
+		b8 WriteFailed;
+		i32 WorkerIndex;
+
+		// NOTE: Errors of the original file, followed by mismatches between the imported and the re-imported chart
+		std::vector<std::string> ParseErrors;
+		std::vector<std::string> RoundTripMismatches;
+
+		Time ReadDuration;
+		Time ImportDuration;
+		Time ExportDuration;
+		Time ReimportDuration;
+		Time CompareDuration;
+		Time TotalDuration;
+
+		inline b8 HasFailed() const { return ReadFailed || ImportFailed || WriteFailed || !RoundTripMismatches.empty(); }
+	};
+
+	struct BatchSummary
+	{
+		i32 WorkerCount;
+		size_t FileCount;
+		size_t FailedFileCount;
+		size_t FilesWithParseErrorsCount;
+		size_t TotalByteSize;
+		// NOTE: Total wall clock time of the entire batch, with the per stage durations being summed up across all workers
+		Time WallDuration;
+		Time ImportDuration, ExportDuration, ReimportDuration, CompareDuration;
+		// NOTE: Number of files a worker took off the queue of another worker after running out of its own
+		size_t StolenFileCount;
+	};
+
+	// NOTE: Sorted by path so that the output stays stable between runs, with entries that couldn't be read being skipped and described in "outSkippedErrors"
+	std::vector<std::string> FindTJAFilesRecursive(std::string_view directoryPath, std::string& outErrorMessage, std::vector<std::string>& outSkippedErrors);
+
+	FileResult ProcessFile(std::string_view filePath, const BatchOptions& options);
+
+	// NOTE: Every worker owns a queue of file indices (pre-distributed largest first) that it takes from the front of
+	//		 and, once empty, steals from the back of the other queues so that a few very large files at the end don't leave all but one thread idle.
+	//		 The results are stored in the same order as the input file paths
+	std::vector<FileResult> ProcessFilesParallel(const std::vector<std::string>& filePaths, const BatchOptions& options, BatchSummary& outSummary);
+}